@@ -0,0 +1,20 @@
+AC_DEFUN([CHECK_SLAB_ALLOCATOR], [
+AH_TEMPLATE([USE_SLAB_ALLOCATOR], [Define to allocate events, packets, and credits from per-thread slab pools])
+AC_ARG_ENABLE(slab-allocator,
+  [AS_HELP_STRING(
+    [--(dis|en)able-slab-allocator],
+    [Control whether events, packets, and credits are allocated from per-thread size-class slab pools [default=yes]],
+    )],
+  [
+    enable_slab_allocator=$enableval
+  ], [
+    enable_slab_allocator=yes
+  ]
+)
+if test "X$enable_slab_allocator" = "Xyes"; then
+    AC_DEFINE_UNQUOTED([USE_SLAB_ALLOCATOR], 1, [Whether to use slab pools for events])
+else
+    AC_DEFINE_UNQUOTED([USE_SLAB_ALLOCATOR], 0, [Whether to use slab pools for events])
+fi
+])
+
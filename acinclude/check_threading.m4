@@ -37,6 +37,22 @@ AC_ARG_WITH(ucontext,
   ]
 )
 
+AH_TEMPLATE([HAVE_FCONTEXT], [Define to make assembly context switching available for threading])
+AC_ARG_WITH(fcontext,
+  [AS_HELP_STRING(
+    [--with-fcontext],
+    [Control whether or not assembly context switching (x86-64 and aarch64 only) is available.
+    Default is yes, but it is only used if selected with --with-default-threading or SSTMAC_THREADING.]
+    )],
+  [
+    user_with_fcontext=yes
+    enable_fcontext=$withval
+  ], [
+    user_with_fcontext=no
+    enable_fcontext=yes
+  ]
+)
+
 AH_TEMPLATE([HAVE_GNU_PTH], [Define to make pth available for threading])
 AC_ARG_WITH(pth,
   [AS_HELP_STRING(
@@ -140,6 +156,33 @@ else
   AM_CONDITIONAL(HAVE_UCONTEXT, false)
 fi
 
+if test "$enable_fcontext" != no; then
+  AC_MSG_CHECKING([whether assembly context switching is supported on this architecture])
+  AC_COMPILE_IFELSE(
+    [AC_LANG_PROGRAM(
+      [
+        #if !defined(__x86_64__) && !defined(__aarch64__)
+        #error no fcontext implementation for this architecture
+        #endif
+      ], [])],
+    [
+      AC_MSG_RESULT([yes])
+      enable_fcontext="yes"
+      AC_DEFINE(HAVE_FCONTEXT)
+      AM_CONDITIONAL(HAVE_FCONTEXT, true)
+    ], [
+      AC_MSG_RESULT([no])
+      enable_fcontext="no"
+      AM_CONDITIONAL(HAVE_FCONTEXT, false)
+      if test "$user_with_fcontext" = yes; then
+        AC_MSG_ERROR([fcontext is only supported on x86-64 and aarch64])
+      fi
+    ]
+  )
+else
+  AM_CONDITIONAL(HAVE_FCONTEXT, false)
+fi
+
 if test "$enable_pth" != "no"; then
   AC_MSG_CHECKING([whether GNU pth is present and usable])
   SAVE_LDFLAGS=$LDFLAGS
@@ -177,7 +220,7 @@ fi
 
 AC_ARG_WITH(default-threading,
   [AS_HELP_STRING(
-    [--with-default-threading=(pth|ucontext|pthread)],
+    [--with-default-threading=(pth|ucontext|fcontext|pthread)],
     [Select the default threading method.]
     )],
   [
@@ -190,6 +233,8 @@ if test "$default_threading" = pth -a "$enable_pth" = no; then
   AC_MSG_ERROR([Default threading method GNU pth is unavailable])
 elif test "$default_threading" = ucontext -a "$enable_ucontext" = no; then
   AC_MSG_ERROR([Default threading method uncontext is unavailable])
+elif test "$default_threading" = fcontext -a "$enable_fcontext" = no; then
+  AC_MSG_ERROR([Default threading method fcontext is unavailable])
 elif test "$default_threading" = pthread -a "$enable_pthread" = no; then
   AC_MSG_ERROR([Default threading method pthreads is unavailable])
 fi
@@ -198,20 +243,25 @@ fi
 #let that be chosen by logic within operating_system.cc
 AH_TEMPLATE([USE_PTH], [Use Pth for threading by default.])
 AH_TEMPLATE([USE_UCONTEXT], [Use ucontext for threading by default.])
+AH_TEMPLATE([USE_FCONTEXT], [Use assembly context switching for threading by default.])
 AH_TEMPLATE([USE_PTHREAD], [Use pthread for threading by default.])
 if test "$default_threading" = pth -a "$enable_pth" != no; then
   AC_DEFINE(USE_PTH)
 elif test "$default_threading" = ucontext -a "$enable_ucontext" != no; then
   AC_DEFINE(USE_UCONTEXT)
+elif test "$default_threading" = fcontext -a "$enable_fcontext" != no; then
+  AC_DEFINE(USE_FCONTEXT)
 elif test "$default_threading" = pthread -a "$enable_pthread" != no; then
   AC_DEFINE(USE_PTHREAD)
 fi
 
 #make sure we have an acceptable threading capabilites
-#pthreads only counts if it has been explicitly given as the default
+#pthreads and fcontext only count if explicitly given as the default
 at_least_one_threading=no
 if test "$default_threading" = pthread -a "$enable_pthread" != no; then
   at_least_one_threading=yes
+elif test "$default_threading" = fcontext -a "$enable_fcontext" != no; then
+  at_least_one_threading=yes
 elif test "$enable_ucontext" != no -o "$enable_pth" != no; then 
   at_least_one_threading=yes
 fi
@@ -219,6 +269,7 @@ fi
 if test "X$at_least_one_threading" = "Xno"; then
 AC_MSG_ERROR([Insufficient virtual threading interfaces available
 must have pth or ucontext for best performance
+use --with-default-threading=fcontext to allow assembly context switching only
 use --with-default-threading=pthread to allow pthread only (good for debugging but low performance)
 ucontext is not available on Mac OS X
 pthread is not compatible with integrated SST core
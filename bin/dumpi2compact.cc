@@ -0,0 +1,37 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/dumpi_util/dumpi_compact.h>
+#include <iostream>
+#include <exception>
+
+/**
+ * Converts a DUMPI trace into a compact trace for the compact_replay app
+ */
+int
+main(int argc, char **argv)
+{
+  if (argc != 3){
+    std::cerr << "usage: " << argv[0] << " <dumpi meta file> <compact trace fileroot>"
+              << std::endl;
+    return 1;
+  }
+
+  try {
+    long bytes = sstmac::sw::dumpi_meta_to_compact(argv[1], argv[2]);
+    std::cout << "Wrote " << bytes << " bytes of compact trace to "
+              << argv[2] << "-*.sct" << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -191,12 +191,6 @@ debug::print_all_debug_slots(std::ostream& os)
 
 
 
-bool
-debug::slot_active(const debug_int& allowed){
-  debug_int bitmask = current_bitmask_ & allowed;
-  return bool(bitmask);
-}
-
 debug_prefix_fxn::~debug_prefix_fxn()
 {
 }
@@ -190,7 +190,10 @@ class debug
    *                    any of the active debug slots
    */
   static bool
-  slot_active(const debug_int& allowed);
+  slot_active(const debug_int& allowed){
+    //inline - this guards every debug print on hot paths
+    return current_bitmask_.fields & allowed.fields;
+  }
 
   /**
    * @brief print_all_debug_slots Print all of the possible debug slots
@@ -500,8 +500,7 @@ sim_parameters::get_optional_long_param(const std::string &key, long def)
 double
 sim_parameters::get_time_param(const std::string& key)
 {
-  return get_time_from_str(get_param(key).c_str(), key.c_str());
-
+  return get_quantity(key, parameter_entry::time_quantity);
 }
 
 void*
@@ -526,8 +525,9 @@ double
 sim_parameters::get_optional_time_param(const std::string &key,
                                         double def)
 {
-  if (has_param(key)) {
-    return get_time_param(key);
+  parameter_entry* entry = find_entry(key);
+  if (entry) {
+    return get_quantity(key, *entry, parameter_entry::time_quantity);
   }
   return def;
 }
@@ -556,21 +556,69 @@ sim_parameters::reread_optional_double_param(const std::string &key,
 double
 sim_parameters::get_quantity(const std::string& key)
 {
-  bool error = false;
-  std::string value = get_param(key);
-  return get_quantity_with_units(value.c_str(), key.c_str());
+  return get_quantity(key, parameter_entry::any_quantity);
 }
 
 double
 sim_parameters::get_optional_quantity(const std::string &key, double def)
 {
-  if (has_param(key)){
-    return get_quantity(key);
+  parameter_entry* entry = find_entry(key);
+  if (entry){
+    return get_quantity(key, *entry, parameter_entry::any_quantity);
   } else {
     return def;
   }
 }
 
+double
+sim_parameters::get_quantity(const std::string& key,
+                             parameter_entry::quantity_t type)
+{
+  debug_printf(dbg::params | dbg::read_params,
+    "sim_parameters: getting key %s\n",
+    key.c_str());
+
+  parameter_entry* entry = find_entry(key);
+  if (!entry){
+    throw_key_error(key);
+  }
+  return get_quantity(key, *entry, type);
+}
+
+double
+sim_parameters::get_quantity(const std::string& key,
+                             parameter_entry& entry,
+                             parameter_entry::quantity_t type)
+{
+  if (entry.parsed == type){
+    return entry.quantity;
+  }
+
+  const char* val = entry.value.c_str();
+  switch (type){
+    case parameter_entry::time_quantity:
+      entry.quantity = get_time_from_str(val, key.c_str());
+      break;
+    case parameter_entry::bandwidth_quantity:
+      entry.quantity = get_bandwidth_from_str(val, key.c_str());
+      break;
+    case parameter_entry::freq_quantity:
+      entry.quantity = get_freq_from_str(val, key.c_str());
+      break;
+    case parameter_entry::byte_length_quantity:
+      entry.quantity = get_byte_length_from_str(val, key.c_str());
+      break;
+    case parameter_entry::any_quantity:
+      entry.quantity = get_quantity_with_units(val, key.c_str());
+      break;
+    case parameter_entry::not_parsed:
+      spkt_abort_printf("sim_parameters::get_quantity: no units given for %s",
+                        key.c_str());
+  }
+  entry.parsed = type;
+  return entry.quantity;
+}
+
 double
 sim_parameters::get_double_param(const std::string& key)
 {
@@ -734,9 +782,7 @@ sim_parameters::get_vector_param(const std::string& key, std::vector<int>& vals)
 double
 sim_parameters::get_freq_param(const std::string &key)
 {
-  bool errorflag = false;
-  std::string param_value_str = get_param(key);
-  return get_freq_from_str(param_value_str.c_str(), key.c_str());
+  return get_quantity(key, parameter_entry::freq_quantity);
 }
 
 double
@@ -754,18 +800,17 @@ sim_parameters::deprecated_optional_freq_param(const std::string &key, double de
 double
 sim_parameters::get_optional_freq_param(const std::string &key, double def)
 {
-  bool errorflag = false;
-  std::string freq_str = printf("%eHz", def);
-  std::string param_value_str = get_optional_param(key, freq_str);
-  return get_freq_from_str(param_value_str.c_str(), key.c_str());
+  parameter_entry* entry = find_entry(key);
+  if (entry){
+    return get_quantity(key, *entry, parameter_entry::freq_quantity);
+  }
+  return def;
 }
 
 long
 sim_parameters::get_byte_length_param(const std::string &key)
 {
-  bool errorflag = false;
-  std::string param_value_str = get_param(key);
-  return get_byte_length_from_str(param_value_str.c_str(), key.c_str());
+  return get_quantity(key, parameter_entry::byte_length_quantity);
 }
 
 long
@@ -783,16 +828,17 @@ sim_parameters::deprecated_optional_byte_length_param(const std::string &key, lo
 long
 sim_parameters::get_optional_byte_length_param(const std::string& key, long length)
 {
-  std::string length_str = printf("%ldB", length);
-  std::string param_value_str = get_optional_param(key, length_str);
-  return get_byte_length_from_str(param_value_str.c_str(), key.c_str());
+  parameter_entry* entry = find_entry(key);
+  if (entry){
+    return get_quantity(key, *entry, parameter_entry::byte_length_quantity);
+  }
+  return length;
 }
 
 double
 sim_parameters::get_bandwidth_param(const std::string &key)
 {
-  std::string param_value_str = get_param(key);
-  return get_bandwidth_from_str(param_value_str.c_str(), key.c_str());
+  return get_quantity(key, parameter_entry::bandwidth_quantity);
 }
 
 double
@@ -835,8 +881,11 @@ sim_parameters::get_optional_bandwidth_param(const std::string &key, const std::
 double
 sim_parameters::get_optional_bandwidth_param(const std::string &key, double def)
 {
-  std::string bwstr = printf("%ebytes/sec", def);
-  return get_optional_bandwidth_param(key, bwstr);
+  parameter_entry* entry = find_entry(key);
+  if (entry){
+    return get_quantity(key, *entry, parameter_entry::bandwidth_quantity);
+  }
+  return def;
 }
 
 void
@@ -1096,6 +1145,20 @@ sim_parameters::get_scoped_param(std::string& inout,
   return true;
 }
 
+sim_parameters::parameter_entry*
+sim_parameters::find_entry(const std::string& key)
+{
+  auto it = params_.find(key);
+  if (it != params_.end()){
+    it->second.read = true;
+    return &it->second;
+  } else if (parent_){
+    return parent_->find_entry(key);
+  } else {
+    return nullptr;
+  }
+}
+
 bool
 sim_parameters::get_param(std::string& inout, const std::string& key)
 {
@@ -1200,6 +1263,7 @@ sim_parameters::do_add_param(
       parameter_entry& entry = it->second;
       entry.value = val;
       entry.read = mark_as_read;
+      entry.parsed = parameter_entry::not_parsed;
     } else {
       //do nothing - don't override and don't fail
     }
@@ -1211,12 +1275,47 @@ sim_parameters::do_add_param(
   }
 }
 
+void
+sim_parameters::combine_entry(
+  const std::string& key,
+  const parameter_entry& src,
+  bool fail_on_existing,
+  bool override_existing,
+  bool mark_as_read)
+{
+  debug_printf(dbg::params,
+    "sim_parameters: setting key %s to value %s\n",
+    key.c_str(), src.value.c_str());
+
+  key_value_map::iterator it = params_.find(key);
+  if (it == params_.end()){
+    parameter_entry& entry = params_[key];
+    entry = src;
+    entry.read = mark_as_read;
+  } else if (fail_on_existing){
+    spkt_abort_printf("sim_parameters::add_param - key already in params: %s", key.c_str());
+  } else if (override_existing){
+    parameter_entry& entry = it->second;
+    //the same namespace often gets combined into every component,
+    //so keep the existing entry and its parsed value if nothing changed
+    if (entry.value != src.value){
+      entry.value = src.value;
+      entry.parsed = src.parsed;
+      entry.quantity = src.quantity;
+    }
+    entry.read = mark_as_read;
+  }
+}
+
 param_assign
 sim_parameters::operator[](const std::string& key)
 {
   std::string final_key;
   sim_parameters* scope = get_scope_and_key(key, final_key);
-  return param_assign(scope->params_[final_key].value, key);
+  parameter_entry& entry = scope->params_[final_key];
+  //the value is about to be assigned
+  entry.parsed = parameter_entry::not_parsed;
+  return param_assign(entry.value, key);
 }
 
 void
@@ -1241,19 +1340,61 @@ sim_parameters::add_param_override(
    true/*mark as read*/);
 }
 
+void
+sim_parameters::copy_into(sim_parameters* sp) const
+{
+  for (auto& pair : params_){
+    sp->params_[pair.first] = pair.second;
+  }
+  for (auto& pair : variables_){
+    sp->variables_[pair.first] = pair.second;
+  }
+  sp->extra_data_ = extra_data_;
+  for (auto& pair : subspaces_){
+    pair.second->copy_into(sp->get_optional_local_namespace(pair.first));
+  }
+}
+
+sim_parameters*
+sim_parameters::copy_scope(sim_parameters*& root) const
+{
+  //record the names leading from the root down to this namespace
+  std::vector<std::string> path;
+  const sim_parameters* scope = this;
+  while (scope->parent_){
+    const sim_parameters* parent = scope->parent_;
+    auto it = parent->subspaces_.begin(), end = parent->subspaces_.end();
+    while (it != end && it->second != scope) ++it;
+    if (it == end){
+      spkt_abort_printf("sim_parameters::copy_scope: namespace %s is not owned by its parent %s",
+        scope->namespace_.c_str(), parent->namespace_.c_str());
+    }
+    path.push_back(it->first);
+    scope = parent;
+  }
+
+  root = new sim_parameters;
+  root->namespace_ = scope->namespace_;
+  scope->copy_into(root);
+
+  sim_parameters* copy = root;
+  for (auto it = path.rbegin(); it != path.rend(); ++it){
+    copy = copy->subspaces_[*it];
+  }
+  return copy;
+}
+
 void
 sim_parameters::combine_into(sim_parameters* sp,
                              bool fail_on_existing,
                              bool override_existing,
                              bool mark_as_read)
 {
-  {key_value_map::iterator it, end = params_.end();
-  for (it=params_.begin(); it != end; ++it){
-    const std::string& key = it->first;
-    const parameter_entry& value = it->second;
-    sp->parse_keyval(key, value.value,
+  //keys here are already validated and scoped, values already expanded
+  for (auto& pair : params_){
+    sp->combine_entry(pair.first, pair.second,
                  fail_on_existing, override_existing, mark_as_read);
-  }}
+  }
 
   {std::map<std::string, sim_parameters*>::iterator it, end = subspaces_.end();
   for (it=subspaces_.begin(); it != end; ++it){
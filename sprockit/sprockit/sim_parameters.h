@@ -82,9 +82,25 @@ class sim_parameters  {
  public:
   struct parameter_entry
   {
-    parameter_entry() : read(false) {}
+    /** The units a value was last parsed with, if any */
+    typedef enum {
+      not_parsed,
+      time_quantity,
+      bandwidth_quantity,
+      freq_quantity,
+      byte_length_quantity,
+      any_quantity
+    } quantity_t;
+
+    parameter_entry() : read(false), parsed(not_parsed), quantity(0) {}
     std::string value;
     bool read;
+    /**
+     * Parsing units dominates reading a parameter, so the parsed value
+     * is kept until the value is overwritten
+     */
+    quantity_t parsed;
+    double quantity;
   };
 
   void
@@ -201,6 +217,16 @@ class sim_parameters  {
                bool override_existing = true,
                bool mark_as_read = true);
 
+  /**
+   * @brief copy_scope Deep copy the whole parameter tree this namespace
+   *        belongs to. Reads and overrides on the copy never touch the
+   *        original, so each thread can construct components from its own copy.
+   * @param root [out] The root of the copied tree, owned by the caller
+   * @return The namespace in the copied tree at the same scope as this one
+   */
+  sim_parameters*
+  copy_scope(sim_parameters*& root) const;
+
   std::string
   print_scoped_params(std::ostream& os) const;
 
@@ -508,6 +534,35 @@ class sim_parameters  {
   void
   throw_key_error(const std::string& key) const;
 
+  /**
+   * @brief find_entry Look up a parameter in this namespace or any parent
+   *        and mark it as read
+   * @return The entry, null if the key is not found
+   */
+  parameter_entry*
+  find_entry(const std::string& key);
+
+  /**
+   * @brief get_quantity Parse the value with units, or return the value
+   *        cached by a previous parse with the same units
+   */
+  double
+  get_quantity(const std::string& key, parameter_entry& entry,
+               parameter_entry::quantity_t type);
+
+  double
+  get_quantity(const std::string& key, parameter_entry::quantity_t type);
+
+  void
+  copy_into(sim_parameters* sp) const;
+
+  void
+  combine_entry(const std::string& key,
+    const parameter_entry& entry,
+    bool fail_on_existing,
+    bool override_existing,
+    bool mark_as_read);
+
   void
   set_parent(sim_parameters* p) {
     parent_ = p;
@@ -0,0 +1,182 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_BACKENDS_COMMON_BATCH_CODEC_H_INCLUDED
+#define SSTMAC_BACKENDS_COMMON_BATCH_CODEC_H_INCLUDED
+
+#include <sstmac/common/event_location.h>
+#include <vector>
+#include <cstring>
+#include <stdint.h>
+
+/**
+ * Encoding of the events batched by parallel_runtime for one LP.
+ * Headers are delta encoded against the previous event as varints,
+ * payloads against the previous payload when they have the same size.
+ */
+
+namespace sstmac {
+
+inline void
+put_varint(std::vector<char>& buf, uint64_t val)
+{
+  while (val >= 0x80){
+    buf.push_back(char(val | 0x80));
+    val >>= 7;
+  }
+  buf.push_back(char(val));
+}
+
+inline uint64_t
+get_varint(const char*& ptr)
+{
+  uint64_t val = 0;
+  int shift = 0;
+  uint8_t byte;
+  do {
+    byte = uint8_t(*ptr++);
+    val |= uint64_t(byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  return val;
+}
+
+/** Small differences of either sign become small varints */
+inline void
+put_delta(std::vector<char>& buf, int64_t delta)
+{
+  put_varint(buf, (uint64_t(delta) << 1) ^ uint64_t(delta >> 63));
+}
+
+inline int64_t
+get_delta(const char*& ptr)
+{
+  uint64_t val = get_varint(ptr);
+  return int64_t(val >> 1) ^ -int64_t(val & 1);
+}
+
+inline void
+put_device(std::vector<char>& buf, device_id id, device_id last)
+{
+  buf.push_back(char(id.type()));
+  put_delta(buf, int64_t(id.id()) - int64_t(last.id()));
+}
+
+inline device_id
+get_device(const char*& ptr, device_id last)
+{
+  device_id::type_t ty = device_id::type_t(*ptr++);
+  uint32_t id = last.id() + get_delta(ptr);
+  return device_id(id, ty);
+}
+
+/**
+ * Encode a payload against the previous one of the same size as
+ * alternating runs of unchanged bytes and new bytes. Consecutive events
+ * to the same LP tend to differ in only a few fields.
+ */
+inline void
+put_payload_delta(std::vector<char>& buf, const char* payload,
+                  const char* prev, int size)
+{
+  int i = 0;
+  while (i < size){
+    int same_start = i;
+    while (i < size && payload[i] == prev[i]) ++i;
+    int diff_start = i;
+    while (i < size){
+      if (payload[i] != prev[i]){
+        ++i;
+        continue;
+      }
+      //a short unchanged run costs less as part of the new bytes
+      int j = i;
+      while (j < size && j < i + 3 && payload[j] == prev[j]) ++j;
+      if (j == size || j == i + 3) break;
+      i = j;
+    }
+    put_varint(buf, diff_start - same_start);
+    put_varint(buf, i - diff_start);
+    buf.insert(buf.end(), payload + diff_start, payload + i);
+  }
+}
+
+inline void
+get_payload_delta(const char*& ptr, char* payload, const char* prev, int size)
+{
+  int i = 0;
+  while (i < size){
+    int num_same = get_varint(ptr);
+    ::memcpy(payload + i, prev + i, num_same);
+    i += num_same;
+    int num_diff = get_varint(ptr);
+    ::memcpy(payload + i, ptr, num_diff);
+    ptr += num_diff;
+    i += num_diff;
+  }
+}
+
+/**
+ * Append a payload, delta encoded if there is a previous payload
+ * of the same size and the encoding is smaller.
+ * @param scratch Reused to hold the trial delta encoding
+ * @param prev The previous payload in the batch, null for the first event
+ * @return Whether the payload was delta encoded
+ */
+inline bool
+put_payload(std::vector<char>& buf, std::vector<char>& scratch,
+            const char* payload, int size,
+            const char* prev, int prev_size)
+{
+  bool use_delta = false;
+  if (prev && prev_size == size){
+    scratch.clear();
+    put_payload_delta(scratch, payload, prev, size);
+    use_delta = int(scratch.size()) < size;
+  }
+  put_varint(buf, (uint64_t(size) << 1) | use_delta);
+  if (use_delta){
+    buf.insert(buf.end(), scratch.begin(), scratch.end());
+  } else {
+    buf.insert(buf.end(), payload, payload + size);
+  }
+  return use_delta;
+}
+
+/**
+ * @return The size of the next payload, which get_payload will write
+ */
+inline int
+peek_payload_size(const char* ptr)
+{
+  return get_varint(ptr) >> 1;
+}
+
+/**
+ * @param payload [out] Must hold peek_payload_size bytes
+ * @param prev The previously decoded payload in the batch
+ */
+inline void
+get_payload(const char*& ptr, char* payload, const char* prev)
+{
+  uint64_t size_flag = get_varint(ptr);
+  int size = size_flag >> 1;
+  if (size_flag & 1){
+    get_payload_delta(ptr, payload, prev, size);
+  } else {
+    ::memcpy(payload, ptr, size);
+    ptr += size;
+  }
+}
+
+}
+
+#endif
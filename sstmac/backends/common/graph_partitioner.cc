@@ -0,0 +1,506 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/backends/common/graph_partitioner.h>
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <utility>
+
+namespace sstmac {
+
+/** Stop coarsening once the graph is this small */
+static const int coarsest_size = 64;
+/** Stop coarsening if a level shrinks the graph by less than this */
+static const double min_coarsen_ratio = 0.9;
+static const int num_initial_trials = 8;
+static const int max_refine_passes = 8;
+/** Give up a refinement pass after this many moves without improvement */
+static const int max_fruitless_moves = 100;
+
+/**
+ * Every rank has to come up with the same partition,
+ * so use a fixed-seed generator rather than anything global
+ */
+class partition_rng
+{
+ public:
+  partition_rng(uint64_t seed) : state_(seed) {}
+
+  uint32_t
+  next(){
+    state_ = state_ * 6364136223846793005ULL + 1442695040888963407ULL;
+    return uint32_t(state_ >> 33);
+  }
+
+ private:
+  uint64_t state_;
+};
+
+typedef std::pair<int64_t,int> gain_entry;
+
+graph_partitioner::graph_partitioner(double imbalance) :
+  imbalance_(imbalance)
+{
+}
+
+void
+graph_partitioner::partition(const graph& g, int nparts, std::vector<int>& part) const
+{
+  part.assign(g.nvtx(), 0);
+  if (nparts <= 1) return;
+
+  std::vector<int> vertices(g.nvtx());
+  for (int i=0; i < g.nvtx(); ++i){
+    vertices[i] = i;
+  }
+  int depth = 0;
+  while ((1 << depth) < nparts) ++depth;
+  recursive_bisect(g, vertices, 0, nparts, ::pow(imbalance_, 1.0/depth), part);
+}
+
+void
+graph_partitioner::recursive_bisect(const graph& g, const std::vector<int>& vertices,
+                                    int first_part, int nparts, double ubfactor,
+                                    std::vector<int>& part) const
+{
+  if (nparts == 1){
+    for (int v : vertices){
+      part[v] = first_part;
+    }
+    return;
+  }
+  if (g.nvtx() == 0) return;
+
+  int nparts0 = nparts / 2;
+  int64_t total = 0;
+  for (int64_t w : g.vwgt) total += w;
+  int64_t target0 = total * nparts0 / nparts;
+
+  std::vector<int> side;
+  bisect(g, target0, ubfactor, side);
+
+  for (int which=0; which < 2; ++which){
+    graph sub;
+    std::vector<int> sub_vertices;
+    subgraph(g, side, which, sub, sub_vertices);
+    for (int& v : sub_vertices){
+      v = vertices[v];
+    }
+    if (which == 0){
+      recursive_bisect(sub, sub_vertices, first_part, nparts0, ubfactor, part);
+    } else {
+      recursive_bisect(sub, sub_vertices, first_part + nparts0, nparts - nparts0,
+                       ubfactor, part);
+    }
+  }
+}
+
+void
+graph_partitioner::bisect(const graph& g, int64_t target0, double ubfactor,
+                          std::vector<int>& side) const
+{
+  std::vector<level> levels;
+  while (1){
+    const graph& current = levels.empty() ? g : levels.back().g;
+    if (current.nvtx() <= coarsest_size) break;
+    level next;
+    coarsen(current, next.cmap, next.g);
+    if (next.g.nvtx() > min_coarsen_ratio * current.nvtx()){
+      //mostly unmatchable - e.g. a star - so further levels buy nothing
+      break;
+    }
+    levels.push_back(std::move(next));
+  }
+
+  initial_bisection(levels.empty() ? g : levels.back().g, target0, ubfactor, side);
+
+  //project back one level at a time, refining as we go
+  for (int l=levels.size()-1; l >= 0; --l){
+    const graph& fine = l == 0 ? g : levels[l-1].g;
+    const std::vector<int>& cmap = levels[l].cmap;
+    std::vector<int> fine_side(fine.nvtx());
+    for (int v=0; v < fine.nvtx(); ++v){
+      fine_side[v] = side[cmap[v]];
+    }
+    side.swap(fine_side);
+    refine(fine, target0, ubfactor, side);
+  }
+}
+
+void
+graph_partitioner::coarsen(const graph& fine, std::vector<int>& cmap, graph& coarse) const
+{
+  int n = fine.nvtx();
+  int64_t total = 0;
+  for (int64_t w : fine.vwgt) total += w;
+  //keep any one coarse vertex from swallowing too much of the graph
+  int64_t max_vwgt = std::max(int64_t(1), int64_t(1.5 * total / coarsest_size));
+
+  std::vector<int> order(n);
+  for (int i=0; i < n; ++i) order[i] = i;
+  partition_rng rng(n);
+  for (int i=n-1; i > 0; --i){
+    std::swap(order[i], order[rng.next() % (i+1)]);
+  }
+
+  //heavy edge matching
+  std::vector<int> match(n, -1);
+  for (int u : order){
+    if (match[u] != -1) continue;
+    int best = -1;
+    int64_t best_wgt = -1;
+    for (int e=fine.xadj[u]; e < fine.xadj[u+1]; ++e){
+      int v = fine.adjncy[e];
+      if (v == u || match[v] != -1) continue;
+      if (fine.vwgt[u] + fine.vwgt[v] > max_vwgt) continue;
+      if (fine.adjwgt[e] > best_wgt){
+        best = v;
+        best_wgt = fine.adjwgt[e];
+      }
+    }
+    if (best == -1){
+      match[u] = u;
+    } else {
+      match[u] = best;
+      match[best] = u;
+    }
+  }
+
+  cmap.assign(n, -1);
+  int ncoarse = 0;
+  for (int u=0; u < n; ++u){
+    if (cmap[u] == -1){
+      cmap[u] = cmap[match[u]] = ncoarse++;
+    }
+  }
+
+  coarse.xadj.assign(1, 0);
+  coarse.adjncy.clear();
+  coarse.adjwgt.clear();
+  coarse.vwgt.assign(ncoarse, 0);
+  std::vector<int> pos(ncoarse, -1);
+  int next = 0;
+  for (int u=0; u < n; ++u){
+    if (cmap[u] != next) continue; //not the first member of its coarse vertex
+    int c = next++;
+    int members[] = { u, match[u] };
+    int num_members = match[u] == u ? 1 : 2;
+    int start = coarse.adjncy.size();
+    for (int m=0; m < num_members; ++m){
+      int fv = members[m];
+      coarse.vwgt[c] += fine.vwgt[fv];
+      for (int e=fine.xadj[fv]; e < fine.xadj[fv+1]; ++e){
+        int cv = cmap[fine.adjncy[e]];
+        if (cv == c) continue; //collapsed edge
+        if (pos[cv] == -1){
+          pos[cv] = coarse.adjncy.size();
+          coarse.adjncy.push_back(cv);
+          coarse.adjwgt.push_back(fine.adjwgt[e]);
+        } else {
+          coarse.adjwgt[pos[cv]] += fine.adjwgt[e];
+        }
+      }
+    }
+    for (int e=start; e < coarse.adjncy.size(); ++e){
+      pos[coarse.adjncy[e]] = -1;
+    }
+    coarse.xadj.push_back(coarse.adjncy.size());
+  }
+}
+
+void
+graph_partitioner::grow_region(const graph& g, int seed, int64_t target0,
+                               std::vector<int>& side) const
+{
+  int n = g.nvtx();
+  side.assign(n, 1);
+  //how much the cut shrinks if the vertex joins the region
+  std::vector<int64_t> gain(n);
+  for (int v=0; v < n; ++v){
+    gain[v] = 0;
+    for (int e=g.xadj[v]; e < g.xadj[v+1]; ++e){
+      gain[v] -= g.adjwgt[e];
+    }
+  }
+
+  std::priority_queue<gain_entry> frontier;
+  frontier.push(gain_entry(gain[seed], seed));
+  int64_t weight0 = 0;
+  int next_unreached = 0;
+  while (weight0 < target0){
+    int v = -1;
+    while (!frontier.empty()){
+      gain_entry top = frontier.top();
+      frontier.pop();
+      if (side[top.second] == 1 && gain[top.second] == top.first){
+        v = top.second;
+        break;
+      }
+    }
+    if (v == -1){
+      //the region filled its connected component - jump to another one
+      while (next_unreached < n && side[next_unreached] == 0) ++next_unreached;
+      if (next_unreached == n) break;
+      v = next_unreached;
+    }
+
+    //stop if adding the vertex misses the target by more than leaving it out
+    if (weight0 > 0 && weight0 + g.vwgt[v] - target0 > target0 - weight0) break;
+
+    side[v] = 0;
+    weight0 += g.vwgt[v];
+    for (int e=g.xadj[v]; e < g.xadj[v+1]; ++e){
+      int u = g.adjncy[e];
+      if (side[u] == 1){
+        gain[u] += 2*g.adjwgt[e];
+        frontier.push(gain_entry(gain[u], u));
+      }
+    }
+  }
+}
+
+void
+graph_partitioner::initial_bisection(const graph& g, int64_t target0, double ubfactor,
+                                     std::vector<int>& side) const
+{
+  int n = g.nvtx();
+  int64_t total = 0;
+  for (int64_t w : g.vwgt) total += w;
+  int64_t target[] = { target0, total - target0 };
+
+  partition_rng rng(n + 1);
+  int ntrials = std::min(n, num_initial_trials);
+  int64_t best_cut = -1;
+  int64_t best_excess = 0;
+  std::vector<int> trial;
+  for (int t=0; t < ntrials; ++t){
+    int seed = t == 0 ? 0 : rng.next() % n;
+    grow_region(g, seed, target0, trial);
+    refine(g, target0, ubfactor, trial);
+
+    int64_t weight[] = { 0, 0 };
+    for (int v=0; v < n; ++v) weight[trial[v]] += g.vwgt[v];
+    int64_t excess = 0;
+    for (int s=0; s < 2; ++s){
+      int64_t allowed = std::max(target[s], int64_t(target[s] * ubfactor));
+      excess += std::max(int64_t(0), weight[s] - allowed);
+    }
+    int64_t cut = edge_cut(g, trial);
+    if (best_cut < 0 || excess < best_excess
+        || (excess == best_excess && cut < best_cut)){
+      best_cut = cut;
+      best_excess = excess;
+      side = trial;
+    }
+  }
+
+  if (best_cut < 0){
+    side.assign(n, 0);
+  }
+}
+
+void
+graph_partitioner::refine(const graph& g, int64_t target0, double ubfactor,
+                          std::vector<int>& side) const
+{
+  int n = g.nvtx();
+  int64_t weight[] = { 0, 0 };
+  int64_t max_vwgt = 0;
+  for (int v=0; v < n; ++v){
+    weight[side[v]] += g.vwgt[v];
+    max_vwgt = std::max(max_vwgt, g.vwgt[v]);
+  }
+  int64_t total = weight[0] + weight[1];
+  int64_t target[] = { target0, total - target0 };
+  //the balance the final bisection is judged by
+  int64_t allowed_weight[2];
+  //moves within a pass can go up to one vertex past that to escape local minima
+  int64_t max_weight[2];
+  for (int s=0; s < 2; ++s){
+    allowed_weight[s] = std::max(target[s], int64_t(target[s] * ubfactor));
+    max_weight[s] = allowed_weight[s] + max_vwgt;
+  }
+
+  //internal and external degree for each vertex
+  std::vector<int64_t> id(n), ed(n);
+  std::vector<bool> locked(n);
+  std::vector<int> moves;
+  for (int pass=0; pass < max_refine_passes; ++pass){
+    int64_t cut = 0;
+    std::priority_queue<gain_entry> queues[2];
+    for (int v=0; v < n; ++v){
+      id[v] = ed[v] = 0;
+      for (int e=g.xadj[v]; e < g.xadj[v+1]; ++e){
+        if (side[g.adjncy[e]] == side[v]) id[v] += g.adjwgt[e];
+        else ed[v] += g.adjwgt[e];
+      }
+      cut += ed[v];
+      locked[v] = false;
+      if (ed[v] > 0){
+        queues[side[v]].push(gain_entry(ed[v] - id[v], v));
+      }
+    }
+    cut /= 2;
+
+    auto excess = [&](){
+      return std::max(int64_t(0), weight[0] - allowed_weight[0])
+           + std::max(int64_t(0), weight[1] - allowed_weight[1]);
+    };
+
+    int64_t start_cut = cut;
+    int64_t start_excess = excess();
+    int64_t best_cut = cut;
+    int64_t best_excess = start_excess;
+    int best_num_moves = 0;
+    moves.clear();
+    int fruitless = 0;
+    while (fruitless < max_fruitless_moves){
+      //pick the best feasible move from either side
+      int v = -1;
+      int64_t v_gain = 0;
+      for (int s=0; s < 2; ++s){
+        std::priority_queue<gain_entry>& q = queues[s];
+        while (!q.empty()){
+          gain_entry top = q.top();
+          int u = top.second;
+          if (locked[u] || side[u] != s || ed[u] - id[u] != top.first){
+            q.pop(); //stale
+            continue;
+          }
+          break;
+        }
+        if (q.empty()) continue;
+        int u = q.top().second;
+        int64_t g_u = q.top().first;
+        int other = 1 - s;
+        bool fits = weight[other] + g.vwgt[u] <= max_weight[other];
+        bool rebalances = weight[s] > allowed_weight[s];
+        if (!fits && !rebalances) continue;
+        //moving off an overweight side always takes priority
+        if (v == -1 || rebalances || g_u > v_gain){
+          v = u;
+          v_gain = g_u;
+          if (rebalances) break;
+        }
+      }
+      if (v == -1) break;
+
+      int from = side[v];
+      int to = 1 - from;
+      queues[from].pop();
+      side[v] = to;
+      locked[v] = true;
+      weight[from] -= g.vwgt[v];
+      weight[to] += g.vwgt[v];
+      cut -= v_gain;
+      std::swap(id[v], ed[v]);
+      moves.push_back(v);
+      for (int e=g.xadj[v]; e < g.xadj[v+1]; ++e){
+        int u = g.adjncy[e];
+        if (side[u] == to){
+          id[u] += g.adjwgt[e];
+          ed[u] -= g.adjwgt[e];
+        } else {
+          id[u] -= g.adjwgt[e];
+          ed[u] += g.adjwgt[e];
+        }
+        if (!locked[u] && ed[u] > 0){
+          queues[side[u]].push(gain_entry(ed[u] - id[u], u));
+        }
+      }
+
+      int64_t exc = excess();
+      if (exc < best_excess || (exc == best_excess && cut < best_cut)){
+        best_excess = exc;
+        best_cut = cut;
+        best_num_moves = moves.size();
+        fruitless = 0;
+      } else {
+        ++fruitless;
+      }
+    }
+
+    //undo everything after the best point in the pass
+    for (int m=moves.size()-1; m >= best_num_moves; --m){
+      int v = moves[m];
+      int from = side[v];
+      side[v] = 1 - from;
+      weight[from] -= g.vwgt[v];
+      weight[1-from] += g.vwgt[v];
+    }
+
+    if (best_excess == start_excess && best_cut >= start_cut){
+      break; //converged
+    }
+  }
+}
+
+void
+graph_partitioner::subgraph(const graph& g, const std::vector<int>& side, int which,
+                            graph& sub, std::vector<int>& vertices)
+{
+  int n = g.nvtx();
+  std::vector<int> local(n, -1);
+  vertices.clear();
+  for (int v=0; v < n; ++v){
+    if (side[v] == which){
+      local[v] = vertices.size();
+      vertices.push_back(v);
+    }
+  }
+
+  sub.xadj.assign(1, 0);
+  sub.adjncy.clear();
+  sub.adjwgt.clear();
+  sub.vwgt.resize(vertices.size());
+  for (int i=0; i < vertices.size(); ++i){
+    int v = vertices[i];
+    sub.vwgt[i] = g.vwgt[v];
+    for (int e=g.xadj[v]; e < g.xadj[v+1]; ++e){
+      int u = local[g.adjncy[e]];
+      if (u != -1){
+        sub.adjncy.push_back(u);
+        sub.adjwgt.push_back(g.adjwgt[e]);
+      }
+    }
+    sub.xadj.push_back(sub.adjncy.size());
+  }
+}
+
+int64_t
+graph_partitioner::edge_cut(const graph& g, const std::vector<int>& part)
+{
+  int64_t cut = 0;
+  for (int v=0; v < g.nvtx(); ++v){
+    for (int e=g.xadj[v]; e < g.xadj[v+1]; ++e){
+      if (part[g.adjncy[e]] != part[v]) cut += g.adjwgt[e];
+    }
+  }
+  //every edge was counted from both ends
+  return cut / 2;
+}
+
+double
+graph_partitioner::load_imbalance(const graph& g, const std::vector<int>& part, int nparts)
+{
+  std::vector<int64_t> weight(nparts, 0);
+  int64_t total = 0;
+  for (int v=0; v < g.nvtx(); ++v){
+    weight[part[v]] += g.vwgt[v];
+    total += g.vwgt[v];
+  }
+  if (total == 0) return 1.0;
+  int64_t max_weight = *std::max_element(weight.begin(), weight.end());
+  return double(max_weight) * nparts / total;
+}
+
+}
@@ -0,0 +1,112 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_BACKENDS_COMMON_GRAPH_PARTITIONER_H_INCLUDED
+#define SSTMAC_BACKENDS_COMMON_GRAPH_PARTITIONER_H_INCLUDED
+
+#include <vector>
+#include <stdint.h>
+
+namespace sstmac {
+
+/**
+ * Multilevel graph partitioner in the style of METIS.
+ * The graph is split by recursive bisection. Each bisection coarsens the graph
+ * by heavy-edge matching, bisects the coarsest graph by greedy region growing,
+ * then projects the bisection back level by level with Fiduccia-Mattheyses
+ * refinement at each level.
+ * Undirected graphs are given in compressed sparse row form with
+ * every edge listed from both of its endpoints.
+ */
+class graph_partitioner
+{
+ public:
+  struct graph {
+    /** Offsets into adjncy for each vertex, size nvtx+1 */
+    std::vector<int> xadj;
+    std::vector<int> adjncy;
+    std::vector<int64_t> adjwgt;
+    std::vector<int64_t> vwgt;
+
+    int
+    nvtx() const {
+      return vwgt.size();
+    }
+  };
+
+  /**
+   * @param imbalance The allowed ratio of the heaviest part to the average part
+   */
+  graph_partitioner(double imbalance = 1.05);
+
+  /**
+   * @param g The graph to partition
+   * @param nparts The number of parts
+   * @param [out] part The part for each vertex
+   */
+  void
+  partition(const graph& g, int nparts, std::vector<int>& part) const;
+
+  /**
+   * @return The total weight of edges between different parts
+   */
+  static int64_t
+  edge_cut(const graph& g, const std::vector<int>& part);
+
+  /**
+   * @return The weight of the heaviest part over the average part weight
+   */
+  static double
+  load_imbalance(const graph& g, const std::vector<int>& part, int nparts);
+
+ private:
+  struct level {
+    graph g;
+    /** The vertex in the next coarser graph each vertex collapsed into */
+    std::vector<int> cmap;
+  };
+
+  /**
+   * @param ubfactor The imbalance allowed in each bisection so that
+   *        the imbalance compounded over all levels stays within imbalance_
+   */
+  void
+  recursive_bisect(const graph& g, const std::vector<int>& vertices,
+                   int first_part, int nparts, double ubfactor,
+                   std::vector<int>& part) const;
+
+  void
+  bisect(const graph& g, int64_t target0, double ubfactor, std::vector<int>& side) const;
+
+  void
+  coarsen(const graph& fine, std::vector<int>& cmap, graph& coarse) const;
+
+  void
+  initial_bisection(const graph& g, int64_t target0, double ubfactor,
+                    std::vector<int>& side) const;
+
+  void
+  grow_region(const graph& g, int seed, int64_t target0, std::vector<int>& side) const;
+
+  void
+  refine(const graph& g, int64_t target0, double ubfactor, std::vector<int>& side) const;
+
+  static void
+  subgraph(const graph& g, const std::vector<int>& side, int which,
+           graph& sub, std::vector<int>& vertices);
+
+  double imbalance_;
+
+};
+
+}
+
+#endif
@@ -1,11 +1,13 @@
 #include <sstmac/backends/common/sim_partition.h>
 #include <sstmac/backends/common/parallel_runtime.h>
+#include <sstmac/backends/common/batch_codec.h>
 #include <sstmac/common/sstmac_config.h>
 #include <sstmac/common/serializable.h>
 #include <sstmac/common/sst_event.h>
 #include <sprockit/output.h>
 #include <sprockit/fileio.h>
 #include <fstream>
+#include <cstring>
 #include <sprockit/keyword_registration.h>
 
 ImplementFactory(sstmac::parallel_runtime);
@@ -16,6 +18,7 @@ RegisterKeywords(
 "serialization_num_bufs_allocation",
 "partition",
 "runtime",
+"sst_nthread",
 );
 
 namespace sstmac {
@@ -23,6 +26,22 @@ namespace sstmac {
 const int parallel_runtime::global_root = -1;
 parallel_runtime* parallel_runtime::static_runtime_ = nullptr;
 
+/** Each batch starts with its size in bytes and its number of events */
+static const int batch_header_size = 2*sizeof(uint32_t);
+
+/** The header of an event serialized on its own */
+static const int event_header_size = 2*sizeof(device_id) + sizeof(uint32_t) + sizeof(timestamp);
+
+void
+parallel_runtime::exchange_stats::add(const exchange_stats& other)
+{
+  events_sent += other.events_sent;
+  bytes_sent += other.bytes_sent;
+  unbatched_bytes_sent += other.unbatched_bytes_sent;
+  events_recvd += other.events_recvd;
+  bytes_recvd += other.bytes_recvd;
+}
+
 void
 parallel_runtime::bcast_string(std::string& str, int root)
 {
@@ -121,7 +140,7 @@ parallel_runtime::init_runtime_params(sprockit::sim_parameters *params)
   buf_size_ = params->get_optional_byte_length_param("serialization_buffer_size", 512);
   int num_bufs_window = params->get_optional_int_param("serialization_num_bufs_allocation", 100);
   send_buffer_pools_.resize(nthread_, message_buffer_cache(buf_size_, num_bufs_window));
-  send_buffers_.resize(nthread_);
+  send_batches_.resize(nproc_);
   recv_buffer_pool_.init(buf_size_, num_bufs_window);
 }
 
@@ -165,19 +184,18 @@ parallel_runtime::send_event(int thread_id,
   sprockit::serializer ser;
   void* buffer = send_buffer_pools_[thread_id].pop();
   ser.start_packing((char*)buffer, buf_size_);
-  ser & dst;
-  ser & src;
-  ser & seqnum;
-  ser & t;
   ser & ev;
-  if (ser.packer().size() > buf_size_){
+  int payload_size = ser.packer().size();
+  //the receiver expands the event back into a buffer of the same size
+  if (event_header_size + payload_size > buf_size_){
     spkt_throw_printf(sprockit::value_error,
         "parallel_runtime::send_message:: buffer overrun %d > %d: set param serialization_buffer_size larger",
-        ser.packer().size(), buf_size_);
+        event_header_size + payload_size, buf_size_);
   }
   int lp;
   switch (dst.type()){
     case device_id::router:
+    case device_id::router_credit:
       lp = part_->lpid_for_switch(dst.id());
       break;
     case device_id::logp_overlay:
@@ -187,13 +205,102 @@ parallel_runtime::send_event(int thread_id,
       spkt_abort_printf("Invalid IPC handler of type %d", dst.type());
   }
 
-  send_buffers_[thread_id].push_back(buffer);
   lock();
-  do_send_message(lp, buffer, ser.packer().size());
+  event_batch& batch = send_batches_[lp];
+  std::vector<char>& buf = batch.buffer;
+  if (batch.num_events == 0){
+    active_batches_.push_back(lp);
+    buf.resize(batch_header_size);
+    batch.last_dst = device_id(0, device_id::null);
+    batch.last_src = device_id(0, device_id::null);
+    batch.last_seqnum = 0;
+    batch.last_ticks = 0;
+  }
+  put_device(buf, dst, batch.last_dst);
+  put_device(buf, src, batch.last_src);
+  put_delta(buf, int64_t(seqnum) - int64_t(batch.last_seqnum));
+  put_delta(buf, t.ticks_int64() - batch.last_ticks);
+  const char* payload = (const char*) buffer;
+  const char* prev = batch.num_events > 0 ? batch.last_payload.data() : nullptr;
+  put_payload(buf, delta_scratch_, payload, payload_size,
+              prev, batch.last_payload.size());
+  batch.last_payload.assign(payload, payload + payload_size);
+  batch.last_dst = dst;
+  batch.last_src = src;
+  batch.last_seqnum = seqnum;
+  batch.last_ticks = t.ticks_int64();
+  ++batch.num_events;
+  last_exchange_.unbatched_bytes_sent += event_header_size + payload_size;
   unlock();
+
+  //the event has been copied into the batch
+  send_buffer_pools_[thread_id].push(buffer);
 #endif
 }
 
+void
+parallel_runtime::flush_batches()
+{
+  for (int lp : active_batches_){
+    event_batch& batch = send_batches_[lp];
+    std::vector<char>& buf = batch.buffer;
+    uint32_t header[2];
+    header[0] = buf.size();
+    header[1] = batch.num_events;
+    ::memcpy(buf.data(), header, batch_header_size);
+    last_exchange_.events_sent += batch.num_events;
+    last_exchange_.bytes_sent += buf.size();
+    do_send_message(lp, buf.data(), buf.size());
+  }
+}
+
+void
+parallel_runtime::unpack_batches(const std::vector<void*>& batches,
+                                 std::vector<void*>& incoming)
+{
+  for (void* batch : batches){
+    const char* ptr = (const char*) batch;
+    uint32_t header[2];
+    ::memcpy(header, ptr, batch_header_size);
+    ptr += batch_header_size;
+    int num_events = header[1];
+    last_exchange_.events_recvd += num_events;
+    last_exchange_.bytes_recvd += header[0];
+
+    device_id dst(0, device_id::null);
+    device_id src(0, device_id::null);
+    uint32_t seqnum = 0;
+    int64_t ticks = 0;
+    const char* prev_payload = nullptr;
+    for (int i=0; i < num_events; ++i){
+      dst = get_device(ptr, dst);
+      src = get_device(ptr, src);
+      seqnum += get_delta(ptr);
+      ticks += get_delta(ptr);
+      int payload_size = peek_payload_size(ptr);
+      timestamp t(ticks, timestamp::exact);
+
+      //lay the event out exactly as if it had been sent on its own
+      void* buffer = recv_buffer_pool_.pop();
+      sprockit::serializer ser;
+      ser.start_packing((char*)buffer, buf_size_);
+      ser & dst;
+      ser & src;
+      ser & seqnum;
+      ser & t;
+      if (ser.packer().size() + payload_size > buf_size_){
+        spkt_throw_printf(sprockit::value_error,
+            "parallel_runtime::unpack_batches: event of %d bytes overruns buffer of %d",
+            ser.packer().size() + payload_size, buf_size_);
+      }
+      char* payload = (char*)buffer + ser.packer().size();
+      get_payload(ptr, payload, prev_payload);
+      prev_payload = payload;
+      incoming.push_back(buffer);
+    }
+  }
+}
+
 void
 parallel_runtime::free_recv_buffers(const std::vector<void*>& buffers)
 {
@@ -215,17 +322,50 @@ parallel_runtime::send_recv_messages(std::vector<void*>& recv_buffers)
     spkt_throw(sprockit::illformed_error,
         "recv buffers should be empty in send/recv messages");
   }
-  do_send_recv_messages(recv_buffers);
+  flush_batches();
+  do_send_recv_messages(incoming_batches_);
+  unpack_batches(incoming_batches_, recv_buffers);
 
   //and all the send buffers are now done
-  for (int t=0; t < nthread(); ++t){
-    std::vector<void*>& bufs = send_buffers_[t];
-    int num_bufs = bufs.size();
-    for (int i=0; i < num_bufs; ++i){
-      send_buffer_pools_[t].push(bufs[i]);
-    }
-    bufs.clear();
+  release_send_buffers();
+}
+
+void
+parallel_runtime::send_recv_null_messages(const std::vector<int>& neighbors,
+  const std::vector<int64_t>& out_times,
+  std::vector<int64_t>& in_times,
+  std::vector<void*>& recv_buffers)
+{
+  in_times.resize(neighbors.size());
+  if (nproc_ == 1)
+    return;
+
+  if (recv_buffers.size()){
+    spkt_throw(sprockit::illformed_error,
+        "recv buffers should be empty in send/recv null messages");
   }
+  flush_batches();
+  do_send_recv_null_messages(neighbors, out_times, in_times, incoming_batches_);
+  unpack_batches(incoming_batches_, recv_buffers);
+  release_send_buffers();
+}
+
+void
+parallel_runtime::release_send_buffers()
+{
+  for (int lp : active_batches_){
+    send_batches_[lp].num_events = 0;
+  }
+  active_batches_.clear();
+  incoming_batches_.clear();
+
+  debug_printf(sprockit::dbg::parallel,
+    "Rank %d: sent %ld events in %ld bytes (%ld unbatched), received %ld events in %ld bytes",
+    me_, last_exchange_.events_sent, last_exchange_.bytes_sent,
+    last_exchange_.unbatched_bytes_sent, last_exchange_.events_recvd,
+    last_exchange_.bytes_recvd);
+  total_exchange_.add(last_exchange_);
+  last_exchange_ = exchange_stats();
 }
 
 }
@@ -28,6 +28,28 @@ class parallel_runtime :
     void* buffer;
   };
 
+  /**
+   * Counts of the events this rank exchanged with other ranks
+   */
+  struct exchange_stats {
+    exchange_stats() :
+      events_sent(0), bytes_sent(0), unbatched_bytes_sent(0),
+      events_recvd(0), bytes_recvd(0)
+    {
+    }
+
+    void
+    add(const exchange_stats& other);
+
+    long events_sent;
+    /** Bytes put on the wire after batching and delta encoding */
+    long bytes_sent;
+    /** Bytes the same events would take sent one message per event */
+    long unbatched_bytes_sent;
+    long events_recvd;
+    long bytes_recvd;
+  };
+
   static const int global_root;
 
   virtual int64_t
@@ -99,6 +121,22 @@ class parallel_runtime :
   virtual void
   send_recv_messages(std::vector<void*>& incoming);
 
+  /**
+   * Exchange events and null messages with neighboring LPs only.
+   * Unlike send_recv_messages, this is not a collective - each LP only waits
+   * on the LPs it actually shares links with.
+   * @param neighbors The LPs this LP exchanges events with
+   * @param out_times For each neighbor, the promise that no event sent to it
+   *                  before the next exchange will be earlier than this time
+   * @param in_times  [out] For each neighbor, the time promised to this LP
+   * @param incoming  [out] Serialized events received from all neighbors
+   */
+  virtual void
+  send_recv_null_messages(const std::vector<int>& neighbors,
+    const std::vector<int64_t>& out_times,
+    std::vector<int64_t>& in_times,
+    std::vector<void*>& incoming);
+
   /**
    * @param The topology id to send a remote message to
    * @param buffer The buffer containing a serialized message
@@ -132,6 +170,22 @@ class parallel_runtime :
     return buf_size_;
   }
 
+  /**
+   * @return The counts for the most recent exchange of events
+   */
+  const exchange_stats&
+  last_exchange() const {
+    return last_exchange_;
+  }
+
+  /**
+   * @return The counts summed over all exchanges so far
+   */
+  const exchange_stats&
+  total_exchange() const {
+    return total_exchange_;
+  }
+
   partition*
   topology_partition() const {
     return part_;
@@ -162,11 +216,62 @@ class parallel_runtime :
   parallel_runtime(sprockit::sim_parameters* params,
                    int me, int nproc);
 
+  /**
+   * @param lp The rank to send the batch of events to
+   * @param buffer A batch of events built by send_event
+   * @param size The size of the batch in bytes
+   */
   virtual void
   do_send_message(int lp, void* buffer, int size) = 0;
 
+  /**
+   * @param batches [out] The batches of events sent to this rank,
+   *                valid until the next exchange
+   */
   virtual void
-  do_send_recv_messages(std::vector<void*>& buffers) = 0;
+  do_send_recv_messages(std::vector<void*>& batches) = 0;
+
+  virtual void
+  do_send_recv_null_messages(const std::vector<int>& neighbors,
+    const std::vector<int64_t>& out_times,
+    std::vector<int64_t>& in_times,
+    std::vector<void*>& batches) = 0;
+
+  void
+  release_send_buffers();
+
+  /**
+   * Send the batch built up for each LP this epoch
+   */
+  void
+  flush_batches();
+
+  /**
+   * Expand each batch back into one serialized event per buffer
+   * @param batches The batches received this epoch
+   * @param incoming [out] The serialized events
+   */
+  void
+  unpack_batches(const std::vector<void*>& batches,
+                 std::vector<void*>& incoming);
+
+  /**
+   * Events sent to one LP during an epoch.
+   * Event headers are delta encoded against the previous event in the batch,
+   * as are payloads the same size as the previous payload.
+   * The buffers keep their capacity from one epoch to the next.
+   */
+  struct event_batch {
+    event_batch() : num_events(0) {}
+
+    std::vector<char> buffer;
+    int num_events;
+    device_id last_dst;
+    device_id last_src;
+    uint32_t last_seqnum;
+    int64_t last_ticks;
+    std::vector<char> last_payload;
+  };
 
  protected:
    int nproc_;
@@ -174,8 +279,14 @@ class parallel_runtime :
    int me_;
    std::vector<message_buffer_cache> send_buffer_pools_;
    message_buffer_cache recv_buffer_pool_;
-   typedef std::pair<int, void*> send_buf_t;
-   std::vector<std::vector<void*> > send_buffers_;
+   /** Indexed by destination LP */
+   std::vector<event_batch> send_batches_;
+   /** The LPs with a non-empty batch this epoch */
+   std::vector<int> active_batches_;
+   std::vector<void*> incoming_batches_;
+   std::vector<char> delta_scratch_;
+   exchange_stats last_exchange_;
+   exchange_stats total_exchange_;
    int buf_size_;
    partition* part_;
    static parallel_runtime* static_runtime_;
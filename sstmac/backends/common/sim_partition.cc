@@ -14,17 +14,29 @@
 #include <sstmac/hardware/topology/topology.h>
 #include <sstmac/hardware/interconnect/interconnect.h>
 #include <sstmac/hardware/topology/index_subset.h>
+#include <sstmac/backends/common/graph_partitioner.h>
 
 #include <sprockit/fileio.h>
 #include <sprockit/util.h>
 #include <sprockit/basic_string_tokenizer.h>
 #include <sprockit/errors.h>
+#include <sprockit/output.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
 
 #include <cstring>
+#include <fstream>
+#include <sstream>
+#include <map>
 
 ImplementFactory(sstmac::partition);
 RegisterDebugSlot(partition);
 
+RegisterKeywords(
+"partition_imbalance",
+"partition_switch_weights",
+);
+
 #define part_debug(...) \
   debug_printf(sprockit::dbg::partition, "Rank %d: %s", me_, sprockit::printf(__VA_ARGS__).c_str())
 
@@ -35,6 +47,7 @@ SpktRegister("occupied_block", partition, occupied_block_partition);
 SpktRegister("metis", partition, metis_partition);
 SpktRegister("topology", partition, topology_partition);
 SpktRegister("serial", partition, serial_partition);
+SpktRegister("graph", partition, graph_partition);
 
 partition::partition(sprockit::sim_parameters* params, parallel_runtime* rt) :
   rt_(rt),
@@ -403,8 +416,141 @@ occupied_block_partition::thread_for_local_switch(int local_idx) const
   }
 }
 
+graph_partition::~graph_partition()
+{
+  delete[] num_switches_per_lp_;
+  delete[] switch_to_lpid_;
 }
 
+graph_partition::graph_partition(sprockit::sim_parameters* params, parallel_runtime* rt)
+  : partition(params, rt)
+{
+  sprockit::sim_parameters* top_params = params->get_namespace("topology");
+  hw::topology* fake_top = hw::topology_factory::get_param("name", top_params);
+  num_switches_total_ = fake_top->num_switches();
+
+  graph_partitioner::graph g;
+  g.vwgt.assign(num_switches_total_, 1);
+  if (params->has_param("partition_switch_weights")){
+    read_switch_weights(params->get_param("partition_switch_weights"), g.vwgt);
+  } else {
+    //without measurements, assume work goes with the attached nodes
+    std::vector<hw::topology::injection_port> nodes;
+    for (int i=0; i < num_switches_total_; ++i){
+      fake_top->nodes_connected_to_injection_switch(switch_id(i), nodes);
+      for (hw::topology::injection_port& port : nodes){
+        if (fake_top->node_id_slot_filled(port.nid)) g.vwgt[i]++;
+      }
+    }
+  }
 
+  //links are directed - fold both directions into one undirected edge
+  sprockit::sim_parameters* switch_params = params->get_optional_namespace("switch");
+  //the simple (LogP) network has no per-link bandwidths to weight by
+  bool have_links = switch_params->has_namespace("link")
+    && params->get_optional_param("interconnect", "switch") != "simple";
+  bool all_ports_same = fake_top->uniform_network_ports();
+  int64_t link_wgt = 1;
+  if (have_links && all_ports_same){
+    double bw = switch_params->get_namespace("link")->get_bandwidth_param("bandwidth");
+    link_wgt = std::max(int64_t(1), int64_t(bw / 1e6));
+  }
+  std::vector<std::map<int,int64_t> > adj(num_switches_total_);
+  std::vector<hw::topology::connection> conns;
+  for (int i=0; i < num_switches_total_; ++i){
+    switch_id src(i);
+    fake_top->connected_outports(src, conns);
+    if (have_links && !all_ports_same){
+      fake_top->configure_individual_port_params(src, switch_params);
+    }
+    for (hw::topology::connection& conn : conns){
+      if (conn.dst == src) continue;
+      int64_t wgt = link_wgt;
+      if (have_links && !all_ports_same){
+        sprockit::sim_parameters* port_params =
+          hw::topology::get_port_params(switch_params, conn.src_outport);
+        double bw = port_params->get_bandwidth_param("bandwidth");
+        wgt = std::max(int64_t(1), int64_t(bw / 1e6));
+      }
+      adj[src][conn.dst] += wgt;
+      adj[conn.dst][src] += wgt;
+    }
+  }
+  g.xadj.push_back(0);
+  for (int i=0; i < num_switches_total_; ++i){
+    for (auto& pair : adj[i]){
+      g.adjncy.push_back(pair.first);
+      g.adjwgt.push_back(pair.second);
+    }
+    g.xadj.push_back(g.adjncy.size());
+  }
 
+  //every rank computes the same partition, so no communication is needed
+  int nparts = nproc_ * nthread_;
+  double imbalance = params->get_optional_double_param("partition_imbalance", 1.05);
+  graph_partitioner partitioner(imbalance);
+  std::vector<int> part;
+  partitioner.partition(g, nparts, part);
 
+  switch_to_lpid_ = new int[num_switches_total_];
+  num_switches_per_lp_ = new int[nproc_];
+  for (int i=0; i < nproc_; ++i) num_switches_per_lp_[i] = 0;
+  local_num_switches_ = 0;
+  for (int i=0; i < num_switches_total_; ++i){
+    int lp = part[i] / nthread_;
+    switch_to_lpid_[i] = lp;
+    num_switches_per_lp_[lp]++;
+    if (lp == me_) ++local_num_switches_;
+    part_debug("putting switch %d on rank %d, thread %d", i, lp, part[i] % nthread_);
+  }
+  init_local_switches();
+
+  local_switch_to_thread_.resize(local_num_switches_);
+  for (int i=0; i < local_num_switches_; ++i){
+    local_switch_to_thread_[i] = part[local_switches_[i]] % nthread_;
+  }
+
+  int64_t total_wgt = 0;
+  for (int64_t w : g.adjwgt) total_wgt += w;
+  total_wgt /= 2;
+  int64_t cut = graph_partitioner::edge_cut(g, part);
+  cout0 << sprockit::printf("Graph partition into %d parts: edge cut %lld of %lld (%.1f%%), load imbalance %.3f\n",
+             nparts, (long long) cut, (long long) total_wgt,
+             total_wgt ? 100.0 * cut / total_wgt : 0.0,
+             graph_partitioner::load_imbalance(g, part, nparts));
+
+  delete fake_top;
+}
+
+void
+graph_partition::read_switch_weights(const std::string& fname, std::vector<int64_t>& vwgt)
+{
+  std::ifstream in(fname.c_str());
+  if (!in.is_open()){
+    spkt_throw_printf(sprockit::input_error,
+      "graph_partition: could not open switch weights file %s",
+      fname.c_str());
+  }
+
+  //lines of "switch weight", e.g. the switch_event_counts_file from a prior run
+  std::string line;
+  while (std::getline(in, line)){
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream sstr(line);
+    long long sid, wgt;
+    if (!(sstr >> sid >> wgt)){
+      spkt_throw_printf(sprockit::input_error,
+        "graph_partition: bad line '%s' in switch weights file %s",
+        line.c_str(), fname.c_str());
+    }
+    if (sid < 0 || sid >= vwgt.size()){
+      spkt_throw_printf(sprockit::input_error,
+        "graph_partition: switch %lld in %s is out of range for %d switches",
+        sid, fname.c_str(), int(vwgt.size()));
+    }
+    //idle switches still cost something to simulate
+    vwgt[sid] = std::max(1LL, wgt);
+  }
+}
+
+}
@@ -21,6 +21,7 @@
 #include <sstmac/hardware/interconnect/interconnect_fwd.h>
 
 #include <vector>
+#include <stdint.h>
 
 DeclareDebugSlot(partition);
 
@@ -224,6 +225,34 @@ class occupied_block_partition :
 
 };
 
+/**
+ * Partition the switch graph with the in-tree multilevel partitioner.
+ * Edges are weighted by link bandwidth and switches by the number of
+ * attached nodes or by event counts measured in a prior run.
+ * Each thread on each rank gets its own part.
+ */
+class graph_partition :
+  public partition
+{
+ public:
+  graph_partition(sprockit::sim_parameters* params, parallel_runtime* rt);
+
+  virtual ~graph_partition();
+
+  virtual int
+  thread_for_local_switch(int local_idx) const {
+    return local_switch_to_thread_[local_idx];
+  }
+
+ protected:
+  void
+  read_switch_weights(const std::string& fname, std::vector<int64_t>& vwgt);
+
+ protected:
+  std::vector<int> local_switch_to_thread_;
+
+};
+
 }
 
 #endif 
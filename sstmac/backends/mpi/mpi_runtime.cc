@@ -121,6 +121,8 @@ mpi_runtime::mpi_runtime(sprockit::sim_parameters* params) :
 
   num_sent_ = new int[nproc_];
   ::memset(num_sent_, 0, nproc_ * sizeof(int));
+
+  MPI_Comm_dup(MPI_COMM_WORLD, &null_comm_);
 }
 
 int
@@ -267,32 +269,100 @@ mpi_runtime::do_send_recv_messages(std::vector<void*>& buffers)
 
   buffers.resize(num_sent_to_me);
 
-  mpi_debug("receiving %d messages on epoch %d",
+  mpi_debug("receiving %d batches on epoch %d",
     num_sent_to_me, epoch_);
 
-
   for (int i=0; i < num_sent_to_me; ++i){
-    int reqidx = i + total_num_sent_;
-    if (reqidx >= max_num_requests_){
-      reallocate_requests();
-    }
-    MPI_Request* reqptr = &requests_[reqidx];
-    void* buffer = recv_buffer_pool_.pop();
-    MPI_Irecv(buffer, buf_size_, MPI_BYTE, MPI_ANY_SOURCE, epoch_, MPI_COMM_WORLD, reqptr);
-    buffers[i] = buffer;
+    buffers[i] = recv_batch(MPI_ANY_SOURCE, i);
   }
 
-
-  int total_pending_ops = num_sent_to_me + total_num_sent_;
-  mpi_debug("waiting on %d requests: %d recvs and %d sends",
-    total_pending_ops, num_sent_to_me, total_num_sent_);
-  MPI_Waitall(total_pending_ops, requests_, MPI_STATUSES_IGNORE);
+  mpi_debug("waiting on %d sends", total_num_sent_);
+  MPI_Waitall(total_num_sent_, requests_, MPI_STATUSES_IGNORE);
 
   ::memset(num_sent_, 0, nproc_ * sizeof(int));
   total_num_sent_ = 0;
   ++epoch_;
 }
 
+void
+mpi_runtime::do_send_recv_null_messages(const std::vector<int>& neighbors,
+  const std::vector<int64_t>& out_times,
+  std::vector<int64_t>& in_times,
+  std::vector<void*>& buffers)
+{
+  int num_neighbors = neighbors.size();
+  null_send_bufs_.resize(2*num_neighbors);
+  null_recv_bufs_.resize(2*num_neighbors);
+  null_requests_.resize(2*num_neighbors);
+
+  //each null message carries the number of events sent this round and the promised time
+  int num_sent_to_neighbors = 0;
+  for (int i=0; i < num_neighbors; ++i){
+    int lp = neighbors[i];
+    null_send_bufs_[2*i] = num_sent_[lp];
+    null_send_bufs_[2*i+1] = out_times[i];
+    num_sent_to_neighbors += num_sent_[lp];
+    num_sent_[lp] = 0;
+    MPI_Irecv(&null_recv_bufs_[2*i], 2, MPI_LONG_LONG, lp, 0, null_comm_, &null_requests_[i]);
+  }
+
+  if (num_sent_to_neighbors != total_num_sent_){
+    spkt_throw_printf(sprockit::illformed_error,
+        "mpi_runtime::do_send_recv_null_messages: %d of %d events sent to non-neighbor LPs",
+        total_num_sent_ - num_sent_to_neighbors, total_num_sent_);
+  }
+
+  for (int i=0; i < num_neighbors; ++i){
+    MPI_Isend(&null_send_bufs_[2*i], 2, MPI_LONG_LONG, neighbors[i], 0, null_comm_,
+              &null_requests_[num_neighbors + i]);
+  }
+  MPI_Waitall(num_neighbors, &null_requests_[0], MPI_STATUSES_IGNORE);
+
+  int num_sent_to_me = 0;
+  for (int i=0; i < num_neighbors; ++i){
+    num_sent_to_me += null_recv_bufs_[2*i];
+    in_times[i] = null_recv_bufs_[2*i+1];
+  }
+
+  buffers.resize(num_sent_to_me);
+  mpi_debug("receiving %d batches from %d neighbors on epoch %d",
+    num_sent_to_me, num_neighbors, epoch_);
+
+  //unlike the global exchange, we know exactly who sent what
+  int idx = 0;
+  for (int i=0; i < num_neighbors; ++i){
+    int num_from_lp = null_recv_bufs_[2*i];
+    for (int m=0; m < num_from_lp; ++m, ++idx){
+      buffers[idx] = recv_batch(neighbors[i], idx);
+    }
+  }
+
+  MPI_Waitall(total_num_sent_, requests_, MPI_STATUSES_IGNORE);
+  MPI_Waitall(num_neighbors, &null_requests_[num_neighbors], MPI_STATUSES_IGNORE);
+
+  total_num_sent_ = 0;
+  ++epoch_;
+}
+
+void*
+mpi_runtime::recv_batch(int src, int idx)
+{
+  //batches vary in size - probe for the size before receiving
+  MPI_Status stat;
+  MPI_Probe(src, epoch_, MPI_COMM_WORLD, &stat);
+  int size;
+  MPI_Get_count(&stat, MPI_BYTE, &size);
+  if (idx >= int(recv_batches_.size())){
+    recv_batches_.resize(idx + 1);
+  }
+  std::vector<char>& batch = recv_batches_[idx];
+  //keeps its capacity for later epochs
+  batch.resize(size);
+  MPI_Recv(batch.data(), size, MPI_BYTE, stat.MPI_SOURCE, epoch_,
+           MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  return batch.data();
+}
+
 void
 mpi_runtime::reallocate_requests()
 {
@@ -309,12 +379,6 @@ mpi_runtime::reallocate_requests()
 void
 mpi_runtime::do_send_message(int lp, void *buffer, int size)
 {
-#if SST_SANITY_CHECK
-  if (size > buf_size_){
-    spkt_throw(sprockit::illformed_error,
-        "mpi_runtime::do_send_message: sending buffer that is too large");
-  }
-#endif
   num_sent_[lp]++;
   if (total_num_sent_ == max_num_requests_){
     reallocate_requests();
@@ -354,7 +418,12 @@ mpi_runtime::allgather(void *send_buffer, int num_bytes, void *recv_buffer)
 void
 mpi_runtime::finalize()
 {
+  mpi_debug("sent %ld events in %ld bytes (%ld unbatched), received %ld events in %ld bytes",
+    total_exchange_.events_sent, total_exchange_.bytes_sent,
+    total_exchange_.unbatched_bytes_sent, total_exchange_.events_recvd,
+    total_exchange_.bytes_recvd);
   MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm_free(&null_comm_);
   if(finalize_needed_) {
     MPI_Finalize();
   }
@@ -74,6 +74,12 @@ class mpi_runtime :
   void
   do_send_recv_messages(std::vector<void*>& buffers) override;
 
+  void
+  do_send_recv_null_messages(const std::vector<int>& neighbors,
+    const std::vector<int64_t>& out_times,
+    std::vector<int64_t>& in_times,
+    std::vector<void*>& buffers) override;
+
   void
   do_send_message(int lp, void *buffer, int size) override;
 
@@ -89,6 +95,15 @@ class mpi_runtime :
   void
   reallocate_requests();
 
+  /**
+   * Receive one batch of events sent this epoch
+   * @param src The sending rank or MPI_ANY_SOURCE
+   * @param idx The slot of the reusable receive buffer to fill
+   * @return The received batch
+   */
+  void*
+  recv_batch(int src, int idx);
+
   void finalize() override;
 
  private:
@@ -113,6 +128,15 @@ class mpi_runtime :
    int total_num_sent_;
    int epoch_;
 
+   /** Separate communicator so null messages never match event messages */
+   MPI_Comm null_comm_;
+   std::vector<int64_t> null_send_bufs_;
+   std::vector<int64_t> null_recv_bufs_;
+   std::vector<MPI_Request> null_requests_;
+
+   /** Receive buffers for event batches, reused across epochs */
+   std::vector<std::vector<char> > recv_batches_;
+
    bool finalize_needed_;
 
 };
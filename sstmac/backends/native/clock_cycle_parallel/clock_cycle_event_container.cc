@@ -1,6 +1,7 @@
 #include <sstmac/common/sstmac_config.h>
 #if !SSTMAC_INTEGRATED_SST_CORE
 #include <sstmac/backends/native/clock_cycle_parallel/clock_cycle_event_container.h>
+#include <sstmac/backends/native/clock_cycle_parallel/thread_balancer.h>
 #include <sstmac/common/thread_info.h>
 #include <sstmac/hardware/switch/network_switch.h>
 #include <sstmac/hardware/network/network_message.h>
@@ -8,6 +9,7 @@
 #include <sstmac/hardware/nic/nic.h>
 #include <sstmac/hardware/interconnect/interconnect.h>
 #include <sprockit/util.h>
+#include <sprockit/keyword_registration.h>
 #include <limits>
 #include <cinttypes>
 
@@ -16,6 +18,11 @@
 
 RegisterDebugSlot(event_manager_time_vote);
 
+RegisterKeywords(
+"pdes_sync",
+"null_message_vote_interval",
+);
+
 #if SSTMAC_DEBUG_THREAD_EVENTS
 DeclareDebugSlot(thread_events)
 RegisterDebugSlot(thread_events)
@@ -30,11 +37,31 @@ SpktRegister("clock_cycle_parallel", event_manager, clock_cycle_event_map,
 clock_cycle_event_map::clock_cycle_event_map(
   sprockit::sim_parameters* params, parallel_runtime* rt) :
   event_map(params, rt),
-  epoch_(0)
+  epoch_(0),
+  null_messages_(false),
+  num_drains_(0),
+  num_barriers_(0),
+  balancer_(nullptr)
 {
   int64_t max_ticks = std::numeric_limits<int64_t>::max() - 100;
   no_events_left_time_ = timestamp(max_ticks, timestamp::exact);
+  min_sent_time_ = no_events_left_time_;
   thread_incoming_.resize(nthread());
+
+  std::string sync = params->get_optional_param("pdes_sync", "epoch");
+  if (sync == "null_message"){
+    null_messages_ = true;
+  } else if (sync != "epoch"){
+    spkt_throw_printf(sprockit::value_error,
+      "clock_cycle_event_map: invalid pdes_sync %s - must be epoch or null_message",
+      sync.c_str());
+  }
+  null_message_vote_interval_ = params->get_optional_int_param("null_message_vote_interval", 16);
+  if (null_message_vote_interval_ < 1){
+    spkt_throw_printf(sprockit::value_error,
+      "clock_cycle_event_map: null_message_vote_interval must be positive, got %d",
+      null_message_vote_interval_);
+  }
 }
 
 void
@@ -70,7 +97,10 @@ clock_cycle_event_map::schedule_incoming(const std::vector<void*>& buffers)
         dst_handler = interconn_->logp_switch_at(dst.id())->payload_handler(0);
         break;
       case device_id::router:
-        dst_handler = interconn_->switch_at(dst.id())->payload_handler(0); //port 0 for now - hack - all the same
+        dst_handler = interconn_->local_switch_at(dst.id())->payload_handler(0); //port 0 for now - hack - all the same
+        break;
+      case device_id::router_credit:
+        dst_handler = interconn_->local_switch_at(dst.id())->credit_handler(0);
         break;
       default:
         spkt_abort_printf("Invalid device type %d in parallel run", dst.type());
@@ -96,7 +126,12 @@ clock_cycle_event_map::receive_incoming_events()
   }
 #endif
   rt_->send_recv_messages(all_incoming_);
+  distribute_incoming();
+}
 
+void
+clock_cycle_event_map::distribute_incoming()
+{
   if (nthread() == 1){
     schedule_incoming(all_incoming_);
   }
@@ -104,8 +139,24 @@ clock_cycle_event_map::receive_incoming_events()
     int num_incoming = all_incoming_.size();
     for (int i=0; i < num_incoming; ++i){
       void* buffer = all_incoming_[i];
-      int sid = *(reinterpret_cast<int*>(buffer));
-      int thr = interconn_->thread_for_switch(switch_id(sid));
+      //the destination device is serialized first
+      device_id dst = *(reinterpret_cast<device_id*>(buffer));
+      int thr;
+      switch (dst.type()){
+        case device_id::router:
+        case device_id::router_credit:
+          thr = interconn_->thread_for_switch(switch_id(dst.id()));
+          break;
+        case device_id::logp_overlay:
+          thr = interconn_->logp_switch_at(dst.id())->thread_id();
+          break;
+        case device_id::node:
+          thr = interconn_->node_at(dst.id())->thread_id();
+          break;
+        default:
+          spkt_abort_printf("Invalid device type %d in parallel run", dst.type());
+          break;
+      }
       thread_incoming_[thr].push_back(buffer);
     }
   }
@@ -136,9 +187,82 @@ clock_cycle_event_map::vote_next_round(timestamp time, vote_type_t ty)
   return final_time;
 }
 
+timestamp
+clock_cycle_event_map::add_lookahead(timestamp t, timestamp lookahead) const
+{
+  //do not overflow - a promise of no more events stays that way
+  int64_t max_ticks = no_events_left_time_.ticks_int64() - lookahead.ticks_int64();
+  if (t.ticks_int64() >= max_ticks){
+    return no_events_left_time_;
+  }
+  return t + lookahead;
+}
+
+timestamp
+clock_cycle_event_map::local_min_time() const
+{
+  return (empty() || stopped_) ? no_events_left_time_ : next_event_time();
+}
+
+timestamp
+clock_cycle_event_map::exchange_null_messages(timestamp min_time)
+{
+  //events from neighbors not yet received are no earlier than their last promise
+  timestamp lower_bound = std::min(min_time, neighbor_horizon_);
+  int num_neighbors = neighbor_lps_.size();
+  for (int i=0; i < num_neighbors; ++i){
+    out_times_[i] = add_lookahead(lower_bound, neighbor_lookahead_[i]).ticks_int64();
+  }
+  rt_->send_recv_null_messages(neighbor_lps_, out_times_, in_times_, all_incoming_);
+  distribute_incoming();
+
+  neighbor_horizon_ = no_events_left_time_;
+  for (int i=0; i < num_neighbors; ++i){
+    neighbor_horizon_ = std::min(neighbor_horizon_, timestamp(in_times_[i], timestamp::exact));
+  }
+  timestamp horizon = neighbor_horizon_;
+  if (nthread() > 1){
+    //threads on this LP can still send to each other with the global lookahead
+    horizon = std::min(horizon, add_lookahead(lower_bound, lookahead_));
+  }
+  return horizon;
+}
+
+timestamp
+clock_cycle_event_map::null_message_vote()
+{
+  return exchange_null_messages(local_min_time());
+}
+
+bool
+clock_cycle_event_map::null_message_round()
+{
+  timestamp horizon = null_message_vote();
+  ++epoch_;
+
+  if (epoch_ % null_message_vote_interval_ == 0){
+    //null messages alone only creep forward one lookahead per round
+    //a global vote detects termination and skips over idle periods
+    timestamp min_time = vote_next_round(local_min_time(), vote_type_t::min);
+    if (min_time == no_events_left_time_){
+      return true;
+    }
+    horizon = std::max(horizon, add_lookahead(min_time, min_lookahead_));
+  }
+
+  next_time_horizon_ = horizon;
+  event_debug("epoch %d: null message horizon is %12.8e on thread %d",
+    epoch_, next_time_horizon_.sec(), thread_id());
+  return false;
+}
+
 bool
 clock_cycle_event_map::vote_to_terminate()
 {
+  if (null_messages_){
+    return null_message_round();
+  }
+
   event_debug("epoch %d: voting to terminate on thread %d", 
     epoch_, thread_id());
 
@@ -167,7 +291,18 @@ std::map<device_id,std::ofstream*> outs;
 void
 clock_cycle_event_map::do_next_event()
 {
+  poll_incoming();
   timestamp ev_time = next_event_time();
+  while (null_messages_ && ev_time >= next_time_horizon_){
+    //cannot terminate - there are still events left
+    null_message_round();
+    if (empty()){
+      //a rebalance moved everything to other threads - vote to terminate instead
+      return;
+    }
+    ev_time = next_event_time();
+  }
+
   while (ev_time >= next_time_horizon_){
     receive_incoming_events();
 
@@ -186,6 +321,12 @@ clock_cycle_event_map::do_next_event()
 
 
     ++epoch_;
+    if (empty()){
+      //same as above - nothing left here to run this window
+      return;
+    }
+    //events drained after the vote may fall inside the new window
+    ev_time = next_event_time();
   }
 
   event_queue_entry* ev = pop_next_event();
@@ -211,6 +352,8 @@ clock_cycle_event_map::do_next_event()
                     ev->time().msec(), ev->to_string().c_str());
   }
 #endif
+  if (count_events_) count_event(ev);
+  if (balancer_) balancer_->count_event(thread_id_, ev->event_location());
   ev->execute();
   delete ev;
 }
@@ -256,6 +399,33 @@ clock_cycle_event_map::set_interconnect(hw::interconnect* interconn)
     lookahead_ = interconn_->lookahead();
   }
   next_time_horizon_ = lookahead_;
+
+  neighbor_lps_.clear();
+  neighbor_lookahead_.clear();
+  min_lookahead_ = nthread() > 1 ? lookahead_ : no_events_left_time_;
+  const std::map<int,timestamp>& lp_lookahead = interconn_->lp_lookahead();
+  std::map<int,timestamp>::const_iterator it, end = lp_lookahead.end();
+  for (it=lp_lookahead.begin(); it != end; ++it){
+    if (null_messages_ && it->second.ticks_int64() == 0){
+      spkt_throw_printf(sprockit::value_error,
+        "clock_cycle_event_map: null message sync needs nonzero link latency to LP %d",
+        it->first);
+    }
+    neighbor_lps_.push_back(it->first);
+    neighbor_lookahead_.push_back(it->second);
+    min_lookahead_ = std::min(min_lookahead_, it->second);
+  }
+  out_times_.resize(neighbor_lps_.size());
+
+  //nothing can arrive before the smallest link latency has elapsed
+  neighbor_horizon_ = no_events_left_time_;
+  int num_neighbors = neighbor_lps_.size();
+  for (int i=0; i < num_neighbors; ++i){
+    neighbor_horizon_ = std::min(neighbor_horizon_, neighbor_lookahead_[i]);
+  }
+  if (null_messages_){
+    next_time_horizon_ = min_lookahead_;
+  }
 }
 
 void
@@ -13,6 +13,8 @@ DeclareDebugSlot(event_manager_time_vote);
 namespace sstmac {
 namespace native {
 
+class thread_balancer;
+
 enum class vote_type_t {
   max,
   min
@@ -63,6 +65,49 @@ class clock_cycle_event_map :
   virtual void
   receive_incoming_events();
 
+  void
+  distribute_incoming();
+
+  /**
+   * Run one round of null-message synchronization with the neighboring LPs.
+   * Every few rounds this also votes globally to detect termination.
+   * @return Whether the simulation is complete
+   */
+  bool
+  null_message_round();
+
+  /**
+   * @return The time up to which this thread can safely execute events
+   */
+  virtual timestamp
+  null_message_vote();
+
+  /**
+   * Send each neighbor LP a promise based on its link lookahead,
+   * receive its promise and any events it sent this round.
+   * Only one thread per LP should call this.
+   * @param min_time The earliest event queued anywhere on this LP
+   * @return The time up to which this LP can safely execute events
+   */
+  timestamp
+  exchange_null_messages(timestamp min_time);
+
+  /**
+   * @return The time of the next event or no_events_left_time if idle
+   */
+  timestamp
+  local_min_time() const;
+
+  timestamp
+  add_lookahead(timestamp t, timestamp lookahead) const;
+
+  /**
+   * Pick up events other threads have handed off since the last check.
+   * They are never earlier than the current time horizon.
+   */
+  virtual void
+  poll_incoming(){}
+
  protected:
   timestamp next_time_horizon_;
   timestamp lookahead_;
@@ -72,6 +117,30 @@ class clock_cycle_event_map :
   hw::interconnect* interconn_;
   int epoch_;
 
+  /** Synchronize only with neighbor LPs rather than in global epochs */
+  bool null_messages_;
+  /** Number of null message rounds between global termination votes */
+  int null_message_vote_interval_;
+  /** The remote LPs with links into this LP */
+  std::vector<int> neighbor_lps_;
+  /** The minimum link latency to each neighbor LP */
+  std::vector<timestamp> neighbor_lookahead_;
+  /** The smallest lookahead across all neighbors and local threads */
+  timestamp min_lookahead_;
+  /** No event still to be received from a neighbor LP can be earlier */
+  timestamp neighbor_horizon_;
+  std::vector<int64_t> out_times_;
+  std::vector<int64_t> in_times_;
+
+  /** The earliest event this thread sent to another thread since its last vote */
+  timestamp min_sent_time_;
+  /** The number of times this thread drained events from other threads */
+  int num_drains_;
+  /** The number of thread barriers this thread has gone through */
+  int num_barriers_;
+  /** Only set if threads move components between each other */
+  thread_balancer* balancer_;
+
 #if SSTMAC_DEBUG_THREAD_EVENTS
   void open_debug_file();
 
@@ -0,0 +1,105 @@
+#ifndef EVENT_MAILBOX_H
+#define EVENT_MAILBOX_H
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+#include <sstmac/common/sst_event_fwd.h>
+#include <atomic>
+#include <cstddef>
+#include <stdint.h>
+
+namespace sstmac {
+namespace native {
+
+/**
+ * Bounded lock-free queue handing events from any number of producer threads
+ * to a single consumer thread. Each slot carries a sequence number
+ * telling producers and the consumer whose turn it is, so a push is a single
+ * compare-and-swap with no node allocation. A full mailbox refuses the push
+ * and the producer is expected to stage the event elsewhere.
+ */
+class event_mailbox
+{
+ public:
+  event_mailbox(int min_size) :
+    head_(0)
+  {
+    size_t size = 2;
+    while (size < size_t(min_size)) size *= 2;
+    mask_ = size - 1;
+    slots_ = new slot[size];
+    for (size_t i=0; i < size; ++i){
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    tail_.store(0, std::memory_order_relaxed);
+  }
+
+  ~event_mailbox(){
+    delete[] slots_;
+  }
+
+  /**
+   * Can be called concurrently from any thread
+   * @return Whether there was room for the event
+   */
+  bool
+  push(event_queue_entry* ev){
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    while (1){
+      slot& s = slots_[pos & mask_];
+      size_t seq = s.seq.load(std::memory_order_acquire);
+      intptr_t diff = intptr_t(seq) - intptr_t(pos);
+      if (diff == 0){
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+          s.ev = ev;
+          s.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0){
+        return false; //full
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Only the owning thread can call this
+   * @return The next event or null if nothing has been published yet
+   */
+  event_queue_entry*
+  pop(){
+    slot& s = slots_[head_ & mask_];
+    size_t seq = s.seq.load(std::memory_order_acquire);
+    if (seq != head_ + 1){
+      return nullptr;
+    }
+    event_queue_entry* ev = s.ev;
+    s.seq.store(head_ + mask_ + 1, std::memory_order_release);
+    ++head_;
+    return ev;
+  }
+
+ private:
+  struct slot {
+    std::atomic<size_t> seq;
+    event_queue_entry* ev;
+  };
+
+  slot* slots_;
+  size_t mask_;
+  //keep the producer and consumer indices on separate cache lines
+  char pad0_[64];
+  std::atomic<size_t> tail_;
+  char pad1_[64];
+  size_t head_;
+  char pad2_[64];
+};
+
+}
+}
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
+
+#endif // EVENT_MAILBOX_H
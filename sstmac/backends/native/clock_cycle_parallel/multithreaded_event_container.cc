@@ -9,12 +9,14 @@
 #include <signal.h>
 #include <iostream>
 #include <sprockit/keyword_registration.h>
+#include <sprockit/output.h>
 
 RegisterDebugSlot(multithread_event_manager);
 RegisterDebugSlot(cpu_affinity);
 
 RegisterKeywords(
   "cpu_affinity",
+  "thread_mailbox_size",
 );
 
 namespace sstmac {
@@ -48,7 +50,7 @@ thread_event_schedule_map::init(int nthread)
   events_.resize(total_slots);
 }
 
-std::list<event_queue_entry*>&
+std::vector<event_queue_entry*>&
 thread_event_schedule_map::pending_events(int srcthread, int dstthread)
 {
   int idx = array_index(srcthread, dstthread);
@@ -80,6 +82,9 @@ multithreaded_event_container::set_interconnect(hw::interconnect* interconn)
     subthreads_[i]->set_interconnect(interconn);
   }
   clock_cycle_event_map::set_interconnect(interconn);
+  if (balancer_){
+    balancer_->init(interconn, topology_partition());
+  }
 }
 
 static void
@@ -116,6 +121,8 @@ multithreaded_event_container::multithreaded_event_container(
 
   send_recv_functor_.parent = this;
   vote_functor_.parent = this;
+  null_message_functor_.parent = this;
+  rebalance_functor_.parent = this;
 
   int nthread_ = nthread();
   me_ = rt_->me();
@@ -125,8 +132,8 @@ multithreaded_event_container::multithreaded_event_container(
     //it would be nice to check that size of cpu_offsets matches task per node
   }
 
-  send_recv_barrier_.init(nthread_);
-  vote_barrier_.init(nthread_);
+  barriers_[0].init(nthread_);
+  barriers_[1].init(nthread_);
 
   subthreads_.resize(nthread_);
   for (int i=1; i < nthread_; ++i){
@@ -134,7 +141,27 @@ multithreaded_event_container::multithreaded_event_container(
     subthreads_[i] = ev_man;
   }
 
-  pending_event_map_.init(nthread_);
+  if (nthread_ > 1 && params->get_optional_bool_param("thread_rebalance", false)){
+    if (nproc_ > 1){
+      spkt_throw(sprockit::input_error,
+        "multithreaded_event_container: thread_rebalance requires a single MPI rank");
+    }
+    balancer_ = new thread_balancer(params, nthread_);
+#if SSTMAC_USE_MULTITHREAD
+    components_migrate_ = true;
+#endif
+    for (int i=1; i < nthread_; ++i){
+      subthreads_[i]->balancer_ = balancer_;
+    }
+  }
+
+  int mailbox_size = params->get_optional_int_param("thread_mailbox_size", 4096);
+  mailboxes_.resize(nthread_);
+  for (int i=0; i < nthread_; ++i){
+    mailboxes_[i] = new event_mailbox(mailbox_size);
+  }
+  overflow_events_[0].init(nthread_);
+  overflow_events_[1].init(nthread_);
 
   pthreads_.resize(nthread_);
   pthread_attrs_.resize(nthread_);
@@ -149,6 +176,14 @@ multithreaded_event_container::multithreaded_event_container(
 
 }
 
+multithreaded_event_container::~multithreaded_event_container() throw ()
+{
+  for (event_mailbox* mailbox : mailboxes_){
+    delete mailbox;
+  }
+  if (balancer_) delete balancer_;
+}
+
 void
 multithreaded_event_container::schedule_stop(timestamp until)
 {
@@ -193,6 +228,10 @@ multithreaded_event_container::run()
   sched_setaffinity(0,sizeof(cpu_set_t), &cpuset);
 #endif
 
+  if (balancer_){
+    balancer_->start_timing();
+  }
+
   //launch all the subthreads
   int status;
   int thread_affinity;
@@ -238,59 +277,201 @@ multithreaded_event_container::run()
             "multithreaded_event_container::run: failed joining pthread");
     }
   }
+
+  if (balancer_){
+    balancer_->print_report(cout0);
+  }
+}
+
+thread_barrier&
+multithreaded_event_container::next_barrier(clock_cycle_event_map* mgr)
+{
+  //a fast thread reusing the same barrier could grab the lock
+  //its partner has not yet picked up from the previous use
+  int idx = mgr->num_barriers_ % 2;
+  ++mgr->num_barriers_;
+  return barriers_[idx];
 }
 
 timestamp
-multithreaded_event_container::time_vote_barrier(int thread_id, timestamp time, vote_type_t ty)
+multithreaded_event_container::time_vote_barrier(int thread_id,
+  clock_cycle_event_map* mgr, timestamp time, vote_type_t ty)
 {
+  if (balancer_) balancer_->enter_barrier(thread_id);
+  bool drain = ty == vote_type_t::min;
+  if (drain){
+    //events handed to other threads are not in any queue yet
+    time = std::min(time, mgr->min_sent_time_);
+    mgr->min_sent_time_ = no_events_left_time_;
+  }
   int64_t ticks = time.ticks_int64();
   //std::cout << sprockit::printf("Thread %d epoch %d: voting for t=%lld\n",
   //  thread_id, epoch_, ticks);
-  int64_t final_vote = vote_barrier_.vote(thread_id, ticks, ty, &vote_functor_);
+  int64_t final_vote = next_barrier(mgr).vote(thread_id, ticks, ty, &vote_functor_);
   timestamp newtime = timestamp(final_vote, timestamp::exact);
   //std::cout << sprockit::printf("Thread %d epoch %d: received t=%lld\n",
   //  thread_id, epoch_, newtime.ticks());
+  if (drain){
+    end_window(thread_id, mgr);
+  } else if (balancer_){
+    balancer_->leave_barrier(thread_id);
+  }
   return newtime;
 }
 
 void
-multithreaded_event_container::send_recv_barrier(int thread_id)
+multithreaded_event_container::end_window(int thread_id, clock_cycle_event_map* mgr)
 {
-  send_recv_barrier_.start(thread_id, &send_recv_functor_);
+  drain_incoming(thread_id, mgr);
+  if (balancer_){
+    //every thread drains the same number of times, so all agree on when to check
+    if (balancer_->check_due(mgr->num_drains_)){
+      next_barrier(mgr).start(thread_id, &rebalance_functor_);
+    }
+    balancer_->leave_barrier(thread_id);
+  }
+}
+
+void
+multithreaded_event_container::rebalance()
+{
+  if (!balancer_->rebalance()){
+    return;
+  }
+
+  //queued events follow their destination to its new thread
+  //mailboxes and overflow lists were all drained before this barrier
+  int nthread_ = nthread();
+  std::vector<event_queue_entry*> moved;
+  for (int i=0; i < nthread_; ++i){
+    clock_cycle_event_map* mgr = static_cast<clock_cycle_event_map*>(ev_man_for_thread(i));
+    queue_t::iterator it = mgr->queue_.begin();
+    while (it != mgr->queue_.end()){
+      int owner = balancer_->owner((*it)->event_location());
+      if (owner >= 0 && owner != i){
+        moved.push_back(*it);
+        it = mgr->queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  for (event_queue_entry* ev : moved){
+    int owner = balancer_->owner(ev->event_location());
+    static_cast<clock_cycle_event_map*>(ev_man_for_thread(owner))->add_event(ev);
+  }
+  debug_printf(sprockit::dbg::multithread_event_manager,
+    "rebalance moved %d queued events between threads",
+    int(moved.size()));
+}
+
+void
+multithreaded_event_container::schedule(timestamp t, uint32_t seqnum, event_queue_entry* ev)
+{
+  if (balancer_ && schedule_on_owner(this, t, seqnum, ev)){
+    return;
+  }
+  clock_cycle_event_map::schedule(t, seqnum, ev);
+}
+
+bool
+multithreaded_event_container::schedule_on_owner(clock_cycle_event_map* mgr,
+    timestamp t, uint32_t& seqnum, event_queue_entry* ev)
+{
+  int src = mgr->thread_id();
+  if (ev->src_location().type() == device_id::logp_overlay){
+    //the overlay switch runs on whichever thread sent to it
+    seqnum = balancer_->overlay_seqnum(src);
+  }
+  int dst = balancer_->owner(ev->event_location());
+  if (dst < 0 || dst == src){
+    return false;
+  }
+
+  ev->set_time(t);
+  if (!mgr->running_){
+    //still setting up - no other thread is touching the queues
+    ev->set_seqnum(seqnum);
+    static_cast<clock_cycle_event_map*>(ev_man_for_thread(dst))->add_event(ev);
+    return true;
+  }
+
+  if (t < mgr->next_time_horizon_){
+    device_id loc = ev->event_location();
+    spkt_throw_printf(sprockit::illformed_error,
+      "thread_rebalance: event for device %d of type %d at t=%12.8e crosses from thread %d "
+      "to thread %d inside the current window - all events between switches need at least the lookahead",
+      int(loc.id()), int(loc.type()), t.sec(), src, dst);
+  }
+  post_event(mgr, src, dst, seqnum, ev);
+  return true;
+}
+
+void
+multithreaded_event_container::send_recv_barrier(int thread_id, clock_cycle_event_map* mgr)
+{
+  if (nproc_ == 1){
+    //nothing to exchange - events from other threads are picked up after the vote
+    return;
+  }
+  //this will invoke clock_cycle_event_map::receive_incoming_events()
+  next_barrier(mgr).start(thread_id, &send_recv_functor_);
+  std::vector<void*>& mpi_buffers = thread_incoming_[thread_id];
+  mgr->schedule_incoming(mpi_buffers);
+  mpi_buffers.clear();
 }
 
 void
 multithreaded_event_container::receive_incoming_events()
 {
-  send_recv_barrier(thread_id_); //this will invoke clock_cycle_event_map::receive_incoming_events()
-  schedule_incoming(thread_id(), this);
+  send_recv_barrier(thread_id_, this);
+}
+
+void
+multithreaded_event_container::poll_incoming()
+{
+  poll_mailbox(thread_id_, this);
+}
+
+void
+multithreaded_event_container::poll_mailbox(int thread_id, clock_cycle_event_map* mgr)
+{
+  event_mailbox* mailbox = mailboxes_[thread_id];
+  event_queue_entry* ev = mailbox->pop();
+  while (ev){
+    mgr->add_event(ev);
+    ev = mailbox->pop();
+  }
 }
 
 void
-multithreaded_event_container::schedule_incoming(int thread_id, clock_cycle_event_map* mgr)
+multithreaded_event_container::drain_incoming(int thread_id, clock_cycle_event_map* mgr)
 {
-  //receive all the mpi messages
-  debug_printf(sprockit::dbg::event_manager, 
-    "thread barrier to scheduling incoming on thread %d, epoch %d",
+  debug_printf(sprockit::dbg::event_manager,
+    "draining incoming on thread %d, epoch %d",
     thread_id, epoch_);
-  thread_barrier();
 
   std::vector<void*>& mpi_buffers = thread_incoming_[thread_id];
   mgr->schedule_incoming(mpi_buffers);
   mpi_buffers.clear();
 
+  poll_mailbox(thread_id, mgr);
+
+  //every thread has moved on to the other overflow window
+  thread_event_schedule_map& overflow = overflow_events_[mgr->num_drains_ % 2];
   int nthread_ = nthread();
   for (int i=0; i < nthread_; ++i){
-    std::list<event_queue_entry*>& events = pending_events(i, thread_id);
-    std::list<event_queue_entry*>::iterator it, end = events.end();
+    std::vector<event_queue_entry*>& events = overflow.pending_events(i, thread_id);
     debug_printf(sprockit::dbg::event_manager,
-      "scheduling %d events on thread %d from thread %d on epoch %d",
-      events.size(), thread_id_, i, epoch_);
-    for (it=events.begin(); it != end; ++it){
-      mgr->add_event(*it);
+      "scheduling %d overflow events on thread %d from thread %d on epoch %d",
+      events.size(), thread_id, i, epoch_);
+    for (event_queue_entry* ev : events){
+      mgr->add_event(ev);
     }
     events.clear();
   }
+  ++mgr->num_drains_;
 }
 
 timestamp
@@ -300,7 +481,44 @@ multithreaded_event_container::vote_next_round(timestamp my_time, vote_type_t ty
     "Rank %d thread barrier to start vote on thread %d, epoch %d\n",
     rt_->me(), thread_id(), epoch_);
 
-  return time_vote_barrier(thread_id_, my_time, ty);
+  return time_vote_barrier(thread_id_, this, my_time, ty);
+}
+
+timestamp
+multithreaded_event_container::null_message_barrier(int thread_id,
+  clock_cycle_event_map* mgr)
+{
+  if (balancer_) balancer_->enter_barrier(thread_id);
+  //events handed to other threads are not in any queue yet
+  timestamp my_time = std::min(mgr->local_min_time(), mgr->min_sent_time_);
+  mgr->min_sent_time_ = no_events_left_time_;
+
+  //the minimum over all threads is the bound for the whole LP
+  //once every thread has arrived, thread 0 exchanges null messages for the LP
+  int64_t horizon = next_barrier(mgr).vote(thread_id, my_time.ticks_int64(),
+                                     vote_type_t::min, &null_message_functor_);
+  end_window(thread_id, mgr);
+  return timestamp(horizon, timestamp::exact);
+}
+
+timestamp
+multithreaded_event_container::null_message_vote()
+{
+  return null_message_barrier(thread_id_, this);
+}
+
+void
+multithreaded_event_container::post_event(clock_cycle_event_map* src_mgr,
+    int srcthread, int dstthread, uint32_t seqnum, event_queue_entry* ev)
+{
+  ev->set_seqnum(seqnum);
+  src_mgr->min_sent_time_ = std::min(src_mgr->min_sent_time_, ev->time());
+  if (!mailboxes_[dstthread]->push(ev)){
+    //only this thread writes to this list during the window
+    //and the destination does not read it until the window closes
+    int window = src_mgr->num_drains_ % 2;
+    overflow_events_[window].pending_events(srcthread, dstthread).push_back(ev);
+  }
 }
 
 void
@@ -310,9 +528,12 @@ multithreaded_event_container::multithread_schedule(
     uint32_t seqnum,
     event_queue_entry* ev)
 {
-  ev->set_seqnum(seqnum);
-  std::list<event_queue_entry*>& pending = pending_events(srcthread, dstthread);
-  pending.push_back(ev);
+  if (balancer_){
+    //the threads components were built on are stale once groups move
+    schedule(ev->time(), seqnum, ev);
+    return;
+  }
+  post_event(this, srcthread, dstthread, seqnum, ev);
 }
 
 }
@@ -7,6 +7,8 @@
 #include <sstmac/backends/native/clock_cycle_parallel/clock_cycle_event_container.h>
 #include <sstmac/backends/native/clock_cycle_parallel/multithreaded_subcontainer.h>
 #include <sstmac/backends/native/clock_cycle_parallel/thread_barrier.h>
+#include <sstmac/backends/native/clock_cycle_parallel/event_mailbox.h>
+#include <sstmac/backends/native/clock_cycle_parallel/thread_balancer.h>
 #include <pthread.h>
 
 
@@ -19,7 +21,7 @@ namespace native {
 class thread_event_schedule_map
 {
  public:
-  std::list<event_queue_entry*>&
+  std::vector<event_queue_entry*>&
   pending_events(int srcthread, int dstthread);
 
   void
@@ -31,7 +33,7 @@ class thread_event_schedule_map
  protected:
   int nthread_;
 
-  std::vector<std::list<event_queue_entry*> > events_;
+  std::vector<std::vector<event_queue_entry*> > events_;
 
 };
 
@@ -42,7 +44,7 @@ class multithreaded_event_container :
  public:
   multithreaded_event_container(sprockit::sim_parameters* params, parallel_runtime* rt);
 
-  ~multithreaded_event_container() throw () {}
+  ~multithreaded_event_container() throw ();
 
   virtual void
   run() override;
@@ -57,10 +59,36 @@ class multithreaded_event_container :
     uint32_t seqnum,
     event_queue_entry* ev) override;
 
-  std::list<event_queue_entry*>&
-  pending_events(int srcthread, int dstthread) {
-    return pending_event_map_.pending_events(srcthread, dstthread);
-  }
+  /**
+   * Hand off an event to another thread.
+   * Can be called concurrently by all threads.
+   */
+  void
+  post_event(clock_cycle_event_map* src_mgr, int srcthread, int dstthread,
+             uint32_t seqnum, event_queue_entry* ev);
+
+  /**
+   * When rebalancing, hand an event to the thread that owns its destination.
+   * @param seqnum [inout] Replaced if the source cannot keep its numbering unique across threads
+   * @return Whether the event went to another thread, otherwise the caller queues it
+   */
+  bool
+  schedule_on_owner(clock_cycle_event_map* mgr, timestamp t,
+                    uint32_t& seqnum, event_queue_entry* ev);
+
+  /**
+   * Move whatever is in a thread's mailbox into its event queue.
+   * Safe to call at any time from the owning thread.
+   */
+  void
+  poll_mailbox(int thread_id, clock_cycle_event_map* mgr);
+
+  /**
+   * Move all events handed to a thread during the last window into its queue.
+   * Only valid after a barrier every thread has passed.
+   */
+  void
+  drain_incoming(int thread_id, clock_cycle_event_map* mgr);
 
   virtual void
   set_interconnect(hw::interconnect* interconn) override;
@@ -69,17 +97,24 @@ class multithreaded_event_container :
   receive_incoming_events() override;
 
   void
-  schedule_incoming(int thread_id, clock_cycle_event_map* mgr);
+  poll_incoming() override;
 
   void
-  send_recv_barrier(int thread_id);
+  send_recv_barrier(int thread_id, clock_cycle_event_map* mgr);
 
   timestamp
-  time_vote_barrier(int thread_id, timestamp min_time, vote_type_t ty);
+  time_vote_barrier(int thread_id, clock_cycle_event_map* mgr,
+                    timestamp min_time, vote_type_t ty);
 
   timestamp
   vote_next_round(timestamp my_time, vote_type_t ty) override;
 
+  timestamp
+  null_message_barrier(int thread_id, clock_cycle_event_map* mgr);
+
+  timestamp
+  null_message_vote() override;
+
   event_manager*
   ev_man_for_thread(int thread_id) const override;
 
@@ -106,12 +141,56 @@ class multithreaded_event_container :
   };
   send_recv_thread_functor send_recv_functor_;
 
+  struct rebalance_thread_functor : public thread_barrier_functor {
+    virtual int64_t
+    execute(int64_t){
+      parent->rebalance();
+      return 0;
+    }
+    multithreaded_event_container* parent;
+  };
+  rebalance_thread_functor rebalance_functor_;
+
+  struct null_message_thread_functor : public thread_barrier_functor {
+    virtual int64_t
+    execute(int64_t min_time){
+      timestamp min(min_time, timestamp::exact);
+      return parent->exchange_null_messages(min).ticks_int64();
+    }
+    multithreaded_event_container* parent;
+  };
+  null_message_thread_functor null_message_functor_;
+
+  thread_barrier&
+  next_barrier(clock_cycle_event_map* mgr);
+
+  void
+  schedule(timestamp t, uint32_t seqnum, event_queue_entry* ev) override;
+
+  /**
+   * Pick up events from other threads once every thread has voted,
+   * then give the balancer a chance to move components.
+   */
+  void
+  end_window(int thread_id, clock_cycle_event_map* mgr);
+
+  /**
+   * Move components between threads along with their queued events.
+   * Only called while every other thread waits in a barrier.
+   */
+  void
+  rebalance();
+
   std::vector<multithreaded_subcontainer*> subthreads_;
 
-  thread_barrier send_recv_barrier_;
-  thread_barrier vote_barrier_;
+  /** Threads alternate between the two so no barrier is reused back to back */
+  thread_barrier barriers_[2];
+
+  /** One mailbox per destination thread */
+  std::vector<event_mailbox*> mailboxes_;
 
-  thread_event_schedule_map pending_event_map_;
+  /** Events that did not fit in a mailbox, double buffered by window */
+  thread_event_schedule_map overflow_events_[2];
 
   std::vector<int> cpu_affinity_;
   int me_;
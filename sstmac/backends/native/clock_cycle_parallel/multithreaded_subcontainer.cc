@@ -26,8 +26,13 @@ void
 multithreaded_subcontainer::receive_incoming_events()
 {
   //make sure everyone has arrived and that all messages are received
-  parent_->send_recv_barrier(thread_id_);
-  parent_->schedule_incoming(thread_id_, this);
+  parent_->send_recv_barrier(thread_id_, this);
+}
+
+void
+multithreaded_subcontainer::poll_incoming()
+{
+  parent_->poll_mailbox(thread_id_, this);
 }
 
 void
@@ -42,7 +47,22 @@ multithreaded_subcontainer::vote_next_round(timestamp my_time, vote_type_t ty)
   debug_printf(sprockit::dbg::event_manager | sprockit::dbg::event_manager_time_vote,
     "Rank %d thread barrier to start vote on thread %d, epoch %d\n",
     rt_->me(), thread_id(), epoch_);
-  return parent_->time_vote_barrier(thread_id_, my_time, ty);
+  return parent_->time_vote_barrier(thread_id_, this, my_time, ty);
+}
+
+timestamp
+multithreaded_subcontainer::null_message_vote()
+{
+  return parent_->null_message_barrier(thread_id_, this);
+}
+
+void
+multithreaded_subcontainer::schedule(timestamp t, uint32_t seqnum, event_queue_entry* ev)
+{
+  if (balancer_ && parent_->schedule_on_owner(this, t, seqnum, ev)){
+    return;
+  }
+  clock_cycle_event_map::schedule(t, seqnum, ev);
 }
 
 void
@@ -55,13 +75,18 @@ multithreaded_subcontainer::multithread_schedule(
   debug_printf(sprockit::dbg::multithread_event_manager,
     "scheduling events on thread %d from thread %d",
     dstthread, srcthread);
+  if (balancer_){
+    //the threads components were built on are stale once groups move
+    schedule(ev->time(), seqnum, ev);
+    return;
+  }
 #if SSTMAC_SANITY_CHECK
   if (ev->time() < next_time_horizon_){
     spkt_throw(sprockit::illformed_error,
         "multithread_schedule: scheduling before next time horizon");
   }
 #endif
-  parent_->multithread_schedule(srcthread, dstthread, seqnum, ev);
+  parent_->post_event(this, srcthread, dstthread, seqnum, ev);
 }
 
 }
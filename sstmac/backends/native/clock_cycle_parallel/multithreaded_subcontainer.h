@@ -26,9 +26,15 @@ class multithreaded_subcontainer :
   void
   receive_incoming_events() override;
 
+  void
+  poll_incoming() override;
+
   timestamp
   vote_next_round(timestamp my_time, vote_type_t ty) override;
 
+  timestamp
+  null_message_vote() override;
+
   void run() override;
 
   multithreaded_subcontainer(
@@ -38,6 +44,9 @@ class multithreaded_subcontainer :
     multithreaded_event_container* parent);
 
  protected:
+  void
+  schedule(timestamp t, uint32_t seqnum, event_queue_entry* ev) override;
+
   multithreaded_event_container* parent_;
 
 };
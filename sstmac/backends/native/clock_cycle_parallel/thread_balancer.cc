@@ -0,0 +1,276 @@
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+#include <sstmac/backends/native/clock_cycle_parallel/thread_balancer.h>
+#include <sstmac/backends/common/sim_partition.h>
+#include <sstmac/hardware/interconnect/interconnect.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+#include <sprockit/spkt_string.h>
+#include <sprockit/errors.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+RegisterKeywords(
+  "thread_rebalance",
+  "thread_rebalance_interval",
+  "thread_rebalance_threshold",
+);
+
+namespace sstmac {
+namespace native {
+
+thread_balancer::thread_balancer(sprockit::sim_parameters* params, int nthread) :
+  nthread_(nthread),
+  threads_(nthread),
+  num_checks_(0),
+  num_rebalances_(0),
+  groups_moved_(0),
+  first_imbalance_(0),
+  last_imbalance_(0)
+{
+  interval_ = params->get_optional_int_param("thread_rebalance_interval", 256);
+  if (interval_ < 1){
+    spkt_throw_printf(sprockit::input_error,
+      "thread_balancer: thread_rebalance_interval must be positive, got %d",
+      interval_);
+  }
+  threshold_ = params->get_optional_double_param("thread_rebalance_threshold", 1.1);
+  if (threshold_ < 1.0){
+    spkt_throw_printf(sprockit::input_error,
+      "thread_balancer: thread_rebalance_threshold must be at least 1, got %f",
+      threshold_);
+  }
+
+  for (thread_state& st : threads_){
+    st.overlay_seqnum = 0;
+    st.busy[0] = st.busy[1] = 0;
+    st.idle[0] = st.idle[1] = 0;
+    st.phase = 0;
+  }
+}
+
+static int
+find_root(std::vector<int>& parent, int idx)
+{
+  while (parent[idx] != idx){
+    parent[idx] = parent[parent[idx]];
+    idx = parent[idx];
+  }
+  return idx;
+}
+
+void
+thread_balancer::init(hw::interconnect* interconn, partition* part)
+{
+  hw::topology* top = interconn->topol();
+  int num_local = part->local_num_switches();
+
+  //index of each switch among the switches on this rank
+  std::vector<int> local_idx(top->max_switch_id(), -1);
+  for (int i=0; i < num_local; ++i){
+    local_idx[part->local_switch(i)] = i;
+  }
+
+  //a node that injects and ejects on different switches ties them together
+  std::vector<int> parent(num_local);
+  for (int i=0; i < num_local; ++i){
+    parent[i] = i;
+  }
+  int num_nodes = top->max_node_id();
+  for (int n=0; n < num_nodes; ++n){
+    node_id nid(n);
+    if (!top->node_id_slot_filled(nid)) continue;
+    int port;
+    int inj = local_idx[top->node_to_injection_switch(nid, port)];
+    int ej = local_idx[top->node_to_ejection_switch(nid, port)];
+    if (inj >= 0 && ej >= 0){
+      parent[find_root(parent, inj)] = find_root(parent, ej);
+    }
+  }
+  int num_netlinks = top->max_netlink_id();
+  for (int n=0; n < num_netlinks; ++n){
+    netlink_id nlid(n);
+    if (!top->netlink_id_slot_filled(node_id(n))) continue;
+    int port;
+    int inj = local_idx[top->netlink_to_injection_switch(nlid, port)];
+    int ej = local_idx[top->netlink_to_ejection_switch(nlid, port)];
+    if (inj >= 0 && ej >= 0){
+      parent[find_root(parent, inj)] = find_root(parent, ej);
+    }
+  }
+
+  std::vector<int> root_group(num_local, -1);
+  switch_group_.assign(top->max_switch_id(), -1);
+  group_owner_.clear();
+  for (int i=0; i < num_local; ++i){
+    int root = find_root(parent, i);
+    if (root_group[root] < 0){
+      root_group[root] = group_owner_.size();
+      //the group starts wherever the partition put its first switch
+      group_owner_.push_back(part->thread_for_local_switch(i));
+    }
+    switch_group_[part->local_switch(i)] = root_group[root];
+  }
+
+  node_group_.assign(num_nodes, -1);
+  for (int n=0; n < num_nodes; ++n){
+    node_id nid(n);
+    if (!top->node_id_slot_filled(nid)) continue;
+    int port;
+    node_group_[n] = switch_group_[top->node_to_injection_switch(nid, port)];
+  }
+  netlink_group_.assign(num_netlinks, -1);
+  for (int n=0; n < num_netlinks; ++n){
+    if (!top->netlink_id_slot_filled(node_id(n))) continue;
+    int port;
+    netlink_group_[n] = switch_group_[top->netlink_to_injection_switch(netlink_id(n), port)];
+  }
+
+  for (thread_state& st : threads_){
+    st.group_events.assign(group_owner_.size(), 0);
+  }
+}
+
+bool
+thread_balancer::rebalance()
+{
+  ++num_checks_;
+  int ngroups = group_owner_.size();
+  std::vector<int64_t> group_load(ngroups, 0);
+  for (thread_state& st : threads_){
+    for (int g=0; g < ngroups; ++g){
+      group_load[g] += st.group_events[g];
+      st.group_events[g] = 0;
+    }
+  }
+
+  std::vector<int64_t> thread_load(nthread_, 0);
+  int64_t total = 0;
+  for (int g=0; g < ngroups; ++g){
+    thread_load[group_owner_[g]] += group_load[g];
+    total += group_load[g];
+  }
+  if (total == 0){
+    return false;
+  }
+
+  double avg = double(total) / nthread_;
+  int64_t max_load = 0;
+  for (int64_t load : thread_load){
+    max_load = std::max(max_load, load);
+  }
+  last_imbalance_ = max_load / avg;
+  if (last_imbalance_ <= threshold_){
+    return false;
+  }
+
+  //repeatedly move a group from the busiest to the idlest thread
+  //moving load w < gap always lowers the busier of the two, so this terminates
+  int num_moved = 0;
+  while (num_moved < ngroups){
+    int src = 0, dst = 0;
+    for (int t=1; t < nthread_; ++t){
+      if (thread_load[t] > thread_load[src]) src = t;
+      if (thread_load[t] < thread_load[dst]) dst = t;
+    }
+    int64_t gap = thread_load[src] - thread_load[dst];
+    //the best group leaves the two threads closest to even
+    int best = -1;
+    int64_t best_dist = gap;
+    for (int g=0; g < ngroups; ++g){
+      int64_t load = group_load[g];
+      if (group_owner_[g] != src || load == 0 || load >= gap) continue;
+      int64_t dist = std::abs(gap - 2*load);
+      if (dist < best_dist){
+        best = g;
+        best_dist = dist;
+      }
+    }
+    if (best < 0){
+      break;
+    }
+    group_owner_[best] = dst;
+    thread_load[src] -= group_load[best];
+    thread_load[dst] += group_load[best];
+    ++num_moved;
+  }
+
+  if (num_moved == 0){
+    return false;
+  }
+
+  if (num_rebalances_ == 0){
+    first_imbalance_ = last_imbalance_;
+  }
+  ++num_rebalances_;
+  groups_moved_ += num_moved;
+  return true;
+}
+
+void
+thread_balancer::start_timing()
+{
+  wall_clock::time_point now = wall_clock::now();
+  for (thread_state& st : threads_){
+    st.mark = now;
+  }
+}
+
+void
+thread_balancer::enter_barrier(int thread)
+{
+  thread_state& st = threads_[thread];
+  wall_clock::time_point now = wall_clock::now();
+  st.busy[st.phase] += std::chrono::duration<double>(now - st.mark).count();
+  st.mark = now;
+}
+
+void
+thread_balancer::leave_barrier(int thread)
+{
+  thread_state& st = threads_[thread];
+  wall_clock::time_point now = wall_clock::now();
+  st.idle[st.phase] += std::chrono::duration<double>(now - st.mark).count();
+  st.mark = now;
+  st.phase = num_rebalances_ > 0 ? 1 : 0;
+}
+
+void
+thread_balancer::print_phase(std::ostream& os, int phase, const char* label) const
+{
+  os << sprockit::printf("Thread busy and idle time %s:\n", label);
+  for (int t=0; t < nthread_; ++t){
+    const thread_state& st = threads_[t];
+    double total = st.busy[phase] + st.idle[phase];
+    os << sprockit::printf("  thread %3d: busy %10.4fs idle %10.4fs (%5.1f%% busy)\n",
+            t, st.busy[phase], st.idle[phase],
+            total > 0 ? 100.0 * st.busy[phase] / total : 0.0);
+  }
+}
+
+void
+thread_balancer::print_report(std::ostream& os) const
+{
+  if (num_rebalances_ == 0){
+    os << sprockit::printf("Thread rebalancing: no rebalance needed in %d checks"
+                           " - event imbalance %.3f at last check\n",
+                           num_checks_, last_imbalance_);
+    print_phase(os, 0, "over the whole run");
+    return;
+  }
+
+  os << sprockit::printf("Thread rebalancing: %d rebalances in %d checks moved %d switch groups"
+                         " - event imbalance %.3f at first rebalance, %.3f at last check\n",
+                         num_rebalances_, num_checks_, groups_moved_,
+                         first_imbalance_, last_imbalance_);
+  print_phase(os, 0, "before the first rebalance");
+  print_phase(os, 1, "after the first rebalance");
+}
+
+}
+}
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
@@ -0,0 +1,166 @@
+#ifndef THREAD_BALANCER_H
+#define THREAD_BALANCER_H
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+#include <sstmac/common/event_location.h>
+#include <sstmac/hardware/interconnect/interconnect_fwd.h>
+#include <sstmac/backends/common/sim_partition_fwd.h>
+#include <sprockit/sim_parameters_fwd.h>
+#include <chrono>
+#include <iosfwd>
+#include <vector>
+#include <stdint.h>
+
+namespace sstmac {
+namespace native {
+
+/**
+ * Moves work between threads while the simulation runs so that every thread
+ * executes roughly the same number of events.
+ * Each switch is grouped with the nodes and netlinks attached to it,
+ * so events between groups always cross a network link and arrive
+ * no earlier than the lookahead. Whole groups move between threads.
+ */
+class thread_balancer
+{
+ public:
+  thread_balancer(sprockit::sim_parameters* params, int nthread);
+
+  /**
+   * Build the groups from the topology.
+   * Each group starts on the thread the partition gave its switch.
+   */
+  void
+  init(hw::interconnect* interconn, partition* part);
+
+  /**
+   * @return The thread currently running events for the location,
+   *         -1 if the location can run on any thread
+   */
+  int
+  owner(device_id loc) const {
+    int grp = group(loc);
+    return grp < 0 ? -1 : group_owner_[grp];
+  }
+
+  void
+  count_event(int thread, device_id loc){
+    int grp = group(loc);
+    if (grp >= 0) ++threads_[thread].group_events[grp];
+  }
+
+  /**
+   * The overlay switch is not owned by any thread, so every thread
+   * sending through it needs its own stream of sequence numbers
+   * @return A sequence number unique across threads
+   */
+  uint32_t
+  overlay_seqnum(int thread){
+    return threads_[thread].overlay_seqnum++ * nthread_ + thread;
+  }
+
+  /**
+   * @param num_windows The number of windows completed so far
+   * @return Whether the load should be checked at the end of this window
+   */
+  bool
+  check_due(int num_windows) const {
+    return num_windows % interval_ == 0;
+  }
+
+  /**
+   * Reassign groups based on the events executed since the last check.
+   * Must only be called while every other thread waits in a barrier.
+   * @return Whether any group moved to another thread
+   */
+  bool
+  rebalance();
+
+  /**
+   * Start the busy clock on every thread.
+   * Must be called before the threads are launched.
+   */
+  void
+  start_timing();
+
+  void
+  enter_barrier(int thread);
+
+  void
+  leave_barrier(int thread);
+
+  /**
+   * Print the busy and idle time of each thread before and after the first rebalance
+   */
+  void
+  print_report(std::ostream& os) const;
+
+ private:
+  typedef std::chrono::steady_clock wall_clock;
+
+  struct thread_state {
+    /** Events executed for each group since the last check */
+    std::vector<int64_t> group_events;
+    uint32_t overlay_seqnum;
+    /** Seconds spent running events, indexed by before/after the first rebalance */
+    double busy[2];
+    /** Seconds spent waiting on other threads */
+    double idle[2];
+    wall_clock::time_point mark;
+    int phase;
+    /** Keep each thread's counters on its own cache line */
+    char pad[64];
+  };
+
+  int
+  group(device_id loc) const {
+    const std::vector<int>* groups;
+    switch (loc.type()){
+      case device_id::router:
+      case device_id::router_credit:
+        groups = &switch_group_;
+        break;
+      case device_id::node:
+        groups = &node_group_;
+        break;
+      case device_id::netlink:
+        groups = &netlink_group_;
+        break;
+      default:
+        return -1;
+    }
+    return loc.id() < groups->size() ? (*groups)[loc.id()] : -1;
+  }
+
+  void
+  print_phase(std::ostream& os, int phase, const char* label) const;
+
+  int nthread_;
+  int interval_;
+  double threshold_;
+
+  std::vector<int> switch_group_;
+  std::vector<int> node_group_;
+  std::vector<int> netlink_group_;
+  std::vector<int> group_owner_;
+
+  std::vector<thread_state> threads_;
+
+  int num_checks_;
+  int num_rebalances_;
+  int groups_moved_;
+  /** The imbalance that triggered the first rebalance */
+  double first_imbalance_;
+  /** The imbalance seen at the last check */
+  double last_imbalance_;
+
+};
+
+}
+}
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
+
+#endif // THREAD_BALANCER_H
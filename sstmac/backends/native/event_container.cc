@@ -23,6 +23,7 @@ event_container::event_container(sprockit::sim_parameters* params, parallel_runt
   event_manager(params, rt)
 {
   set_now(timestamp(0));
+  count_events_ = params->has_param("switch_event_counts_file");
 }
 
 
@@ -34,6 +35,7 @@ event_container::do_next_event()
   debug_printf(sprockit::dbg::all_events,
     "running event %s", sprockit::to_string(ev).c_str());
 
+  if (count_events_) count_event(ev);
   ev->execute();
   delete ev;
 }
@@ -54,6 +56,9 @@ event_container::run()
   }
   running_ = true;
   stopped_ = false;
+#if SSTMAC_USE_MULTITHREAD
+  active_ = this;
+#endif
 
 #if SSTMAC_SANITY_CHECK
   int n_events = 0;
@@ -79,6 +84,9 @@ event_container::run()
 #endif
 
   running_ = false;
+#if SSTMAC_USE_MULTITHREAD
+  active_ = nullptr;
+#endif
 
   if (empty() || finish_on_stop_) {
     complete_ = true;
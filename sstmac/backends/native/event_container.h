@@ -42,6 +42,24 @@ class event_container : public event_manager
   virtual void
   run();
 
+  /**
+   * Only filled in if switch_event_counts_file is given
+   * @return The number of events executed on each node, indexed by node id
+   */
+  const std::vector<long long>&
+  node_event_counts() const {
+    return node_event_counts_;
+  }
+
+  /**
+   * Only filled in if switch_event_counts_file is given
+   * @return The number of events executed on each switch, indexed by switch id
+   */
+  const std::vector<long long>&
+  switch_event_counts() const {
+    return switch_event_counts_;
+  }
+
  protected:
   event_container(sprockit::sim_parameters* params, parallel_runtime* rt);
 
@@ -63,9 +81,27 @@ class event_container : public event_manager
     return true;
   }
 
+  void
+  count_event(event_queue_entry* ev){
+    device_id loc = ev->event_location();
+    std::vector<long long>* counts;
+    if (loc.is_switch_id()) counts = &switch_event_counts_;
+    else if (loc.is_node_id()) counts = &node_event_counts_;
+    else return;
+    if (loc.id() >= counts->size()) counts->resize(loc.id() + 1, 0);
+    ++(*counts)[loc.id()];
+  }
+
   /// Sentinel to track whether the event handler is running or not.
   bool running_;
 
+  /// Whether to keep per-device event counts for a later partition
+  bool count_events_;
+
+  std::vector<long long> node_event_counts_;
+
+  std::vector<long long> switch_event_counts_;
+
    /// Time of last event executed.
   timestamp last_update_sim_;
 
@@ -55,8 +55,21 @@ class event_heap :
   cancel_all_messages(device_id canceled_loc);
 
  protected:
-  typedef std::priority_queue<event*,
-          std::vector<event_queue_entry*>, std::greater<event_queue_entry*> > queue_t;
+  /** Min-heap with the same (time, src_location, seqnum) ordering as event_map */
+  struct event_compare {
+    bool operator()(const event_queue_entry* lhs, const event_queue_entry* rhs) const {
+      if (lhs->time() != rhs->time()) return lhs->time() > rhs->time();
+
+      if (lhs->src_location() == rhs->src_location()){
+        return lhs->seqnum() > rhs->seqnum();
+      } else {
+        return rhs->src_location() < lhs->src_location();
+      }
+    }
+  };
+
+  typedef std::priority_queue<event_queue_entry*,
+          std::vector<event_queue_entry*>, event_compare> queue_t;
 
   event_queue_entry*
   pop_next_event();
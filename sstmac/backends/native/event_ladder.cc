@@ -0,0 +1,252 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+#include <sstmac/backends/native/event_ladder.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+#include <sprockit/errors.h>
+#include <sprockit/util.h>
+#include <algorithm>
+
+RegisterKeywords(
+"ladder_bucket_threshold",
+"ladder_max_rungs",
+);
+
+namespace sstmac {
+namespace native {
+
+SpktRegister("ladder", event_manager, event_ladder,
+    "Implements the event queue as a ladder queue with O(1) amortized insertion");
+
+/** Reverse ordering so that sorted buckets pop the earliest event from the back */
+struct reverse_event_compare {
+  bool operator()(const event_queue_entry* lhs, const event_queue_entry* rhs) const {
+    return event_ladder::event_compare()(rhs, lhs);
+  }
+};
+
+event_ladder::event_ladder(sprockit::sim_parameters* params, parallel_runtime* rt) :
+  event_container(params, rt),
+  num_events_(0),
+  top_start_(0),
+  top_min_(0),
+  top_max_(0),
+  num_rungs_(0)
+{
+  bucket_threshold_ = params->get_optional_int_param("ladder_bucket_threshold", 50);
+  max_rungs_ = params->get_optional_int_param("ladder_max_rungs", 8);
+  if (max_rungs_ < 1){
+    spkt_throw_printf(sprockit::value_error,
+      "event_ladder: ladder_max_rungs must be at least 1, got %d",
+      max_rungs_);
+  }
+  rungs_.reserve(max_rungs_);
+}
+
+event_ladder::~event_ladder() throw ()
+{
+}
+
+void
+event_ladder::add_event(event_queue_entry* ev)
+{
+  ++num_events_;
+  int64_t t = ticks(ev);
+  if (t >= top_start_){
+    if (top_.empty()){
+      top_min_ = top_max_ = t;
+    } else {
+      top_min_ = std::min(top_min_, t);
+      top_max_ = std::max(top_max_, t);
+    }
+    top_.push_back(ev);
+    return;
+  }
+
+  for (int i=0; i < num_rungs_; ++i){
+    rung& r = rungs_[i];
+    if (t >= r.current_start()){
+      size_t idx = (t - r.start) / r.width;
+      r.buckets[idx].push_back(ev);
+      ++r.num_events;
+      return;
+    }
+  }
+
+  insert_bottom(ev);
+}
+
+void
+event_ladder::insert_bottom(event_queue_entry* ev)
+{
+  bool spread_out = !bottom_.empty() && ticks(bottom_.front()) != ticks(bottom_.back());
+  if (spread_out && bottom_.size() >= bucket_threshold_ && num_rungs_ < max_rungs_){
+    //the bottom is getting too big to keep sorted - push it back onto the ladder
+    //the new rung has to end exactly where the next coarser tier begins
+    int64_t end = num_rungs_ ? rungs_[num_rungs_-1].current_start() : top_start_;
+    int64_t start = std::min(ticks(bottom_.back()), ticks(ev));
+    bucket_t events;
+    events.swap(bottom_);
+    events.push_back(ev);
+    spawn_rung(events, start, end);
+    return;
+  }
+
+  bucket_t::iterator pos = std::upper_bound(bottom_.begin(), bottom_.end(),
+                                            ev, reverse_event_compare());
+  bottom_.insert(pos, ev);
+}
+
+void
+event_ladder::spawn_rung(bucket_t& events, int64_t start, int64_t end)
+{
+  if (num_rungs_ == int(rungs_.size())){
+    rungs_.push_back(rung());
+  }
+  rung& r = rungs_[num_rungs_];
+  ++num_rungs_;
+
+  int64_t span = end - start;
+  int64_t nevents = events.size();
+  r.width = std::max(int64_t(1), (span + nevents - 1) / nevents);
+  r.start = start;
+  r.current = 0;
+  r.num_events = events.size();
+  size_t nbuckets = (span + r.width - 1) / r.width;
+  r.buckets.resize(nbuckets);
+
+  int num = events.size();
+  for (int i=0; i < num; ++i){
+    event_queue_entry* ev = events[i];
+    size_t idx = (ticks(ev) - start) / r.width;
+    r.buckets[idx].push_back(ev);
+  }
+  events.clear();
+}
+
+void
+event_ladder::refill_bottom()
+{
+  while (bottom_.empty()){
+    if (num_rungs_ == 0){
+      if (top_.empty()){
+        spkt_throw(sprockit::illformed_error,
+          "event_ladder::refill_bottom: no events left to refill");
+      }
+      spawn_rung(top_, top_min_, top_max_ + 1);
+      top_start_ = rungs_[0].end();
+      continue;
+    }
+
+    int last = num_rungs_ - 1;
+    rung& r = rungs_[last];
+    if (r.num_events == 0){
+      --num_rungs_;
+      continue;
+    }
+
+    while (r.buckets[r.current].empty()){
+      ++r.current;
+    }
+
+    int64_t bucket_start = r.current_start();
+    int64_t bucket_width = r.width;
+    bucket_t& next = r.buckets[r.current];
+    r.num_events -= next.size();
+    ++r.current;
+
+    if (next.size() > bucket_threshold_ && bucket_width > 1 && num_rungs_ < max_rungs_){
+      //too many to sort - subdivide into a finer rung
+      //swap out first since spawning may reallocate the rung array
+      bucket_t events;
+      events.swap(next);
+      spawn_rung(events, bucket_start, bucket_start + bucket_width);
+    } else {
+      bottom_.swap(next);
+      std::sort(bottom_.begin(), bottom_.end(), reverse_event_compare());
+    }
+  }
+}
+
+event_queue_entry*
+event_ladder::pop_next_event()
+{
+  if (bottom_.empty()){
+    refill_bottom();
+  }
+  event_queue_entry* ev = bottom_.back();
+  bottom_.pop_back();
+  --num_events_;
+  return ev;
+}
+
+//
+// Clear all events and set time back to a zero of your choice.
+//
+void
+event_ladder::clear(timestamp zero_time)
+{
+  if (running_) {
+    spkt_throw(sprockit::illformed_error,
+      "event_ladder::clear: event manager is running");
+  }
+  top_.clear();
+  bottom_.clear();
+  for (int i=0; i < num_rungs_; ++i){
+    rung& r = rungs_[i];
+    for (bucket_t& b : r.buckets) b.clear();
+  }
+  num_rungs_ = 0;
+  num_events_ = 0;
+  top_start_ = 0;
+  set_now(zero_time);
+}
+
+static size_t
+remove_canceled(std::vector<event_queue_entry*>& events, device_id canceled_loc)
+{
+  size_t num_kept = 0;
+  size_t num = events.size();
+  for (size_t i=0; i < num; ++i){
+    event_queue_entry* ev = events[i];
+    if (ev->event_location() == canceled_loc){
+      delete ev;
+    } else {
+      events[num_kept++] = ev;
+    }
+  }
+  events.resize(num_kept);
+  return num - num_kept;
+}
+
+void
+event_ladder::cancel_all_messages(device_id canceled_loc)
+{
+  num_events_ -= remove_canceled(top_, canceled_loc);
+  num_events_ -= remove_canceled(bottom_, canceled_loc);
+  for (int i=0; i < num_rungs_; ++i){
+    rung& r = rungs_[i];
+    for (size_t b=r.current; b < r.buckets.size(); ++b){
+      size_t num_removed = remove_canceled(r.buckets[b], canceled_loc);
+      r.num_events -= num_removed;
+      num_events_ -= num_removed;
+    }
+  }
+}
+
+}
+} // end of namespace sstmac
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
@@ -0,0 +1,139 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_BACKENDS_NATIVE_EVENT_LADDER_H_INCLUDED
+#define SSTMAC_BACKENDS_NATIVE_EVENT_LADDER_H_INCLUDED
+
+#include <sstmac/common/sstmac_config.h>
+#if !SSTMAC_INTEGRATED_SST_CORE
+
+#include <sstmac/backends/native/event_container.h>
+#include <sstmac/common/sst_event.h>
+#include <sstmac/common/timestamp.h>
+#include <vector>
+
+namespace sstmac {
+namespace native {
+
+/**
+ * An event manager implementing the ladder queue of Tang, Goh, and Thng.
+ * Events are staged in three tiers:
+ *  top:    an unsorted bag of far-future events
+ *  ladder: rungs of time buckets, each rung subdividing a single bucket
+ *          of the rung above it until buckets are small enough to sort
+ *  bottom: a small sorted list from which events are dequeued
+ * Insertion is O(1) amortized. Only the bottom is ever sorted, and it is
+ * sorted with the same (time, src_location, seqnum) ordering as event_map
+ * so that event execution order is identical to the other event managers.
+ */
+class event_ladder :
+  public event_container
+{
+ public:
+  event_ladder(sprockit::sim_parameters* params, parallel_runtime* rt);
+
+  ~event_ladder() throw ();
+
+  void
+  clear(timestamp zero_time = timestamp(0));
+
+  void
+  cancel_all_messages(device_id canceled_loc);
+
+  bool
+  empty() const {
+    return num_events_ == 0;
+  }
+
+  struct event_compare {
+    bool operator()(const event_queue_entry* lhs, const event_queue_entry* rhs) const {
+      if (lhs->time() != rhs->time()) return lhs->time() < rhs->time();
+
+      if (lhs->src_location() == rhs->src_location()){
+        return lhs->seqnum() < rhs->seqnum();
+      } else {
+        return lhs->src_location() < rhs->src_location();
+      }
+    }
+  };
+
+ protected:
+  event_queue_entry*
+  pop_next_event();
+
+  void
+  add_event(event_queue_entry* ev);
+
+ private:
+  typedef std::vector<event_queue_entry*> bucket_t;
+
+  struct rung {
+    int64_t start;
+    int64_t width;
+    /** Index of the first bucket that has not been drained */
+    size_t current;
+    /** Number of events currently stored in this rung */
+    size_t num_events;
+    std::vector<bucket_t> buckets;
+
+    int64_t
+    current_start() const {
+      return start + int64_t(current) * width;
+    }
+
+    int64_t
+    end() const {
+      return start + int64_t(buckets.size()) * width;
+    }
+  };
+
+  void
+  insert_bottom(event_queue_entry* ev);
+
+  void
+  refill_bottom();
+
+  void
+  spawn_rung(bucket_t& events, int64_t start, int64_t end);
+
+  static int64_t
+  ticks(event_queue_entry* ev) {
+    return ev->time().ticks_int64();
+  }
+
+  size_t num_events_;
+
+  /** Top tier: unsorted events at or after top_start_ */
+  bucket_t top_;
+  int64_t top_start_;
+  int64_t top_min_;
+  int64_t top_max_;
+
+  /** Rungs in use - rung 0 is the coarsest */
+  std::vector<rung> rungs_;
+  int num_rungs_;
+
+  /** Sorted in reverse order so that the next event is popped from the back */
+  bucket_t bottom_;
+
+  /** Buckets larger than this spawn a finer rung instead of being sorted */
+  size_t bucket_threshold_;
+
+  int max_rungs_;
+
+};
+
+}
+} // end of namespace sstmac
+
+#endif // !SSTMAC_INTEGRATED_SST_CORE
+
+#endif
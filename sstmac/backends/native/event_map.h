@@ -62,7 +62,7 @@ class event_map :
 
  protected:
   struct event_compare {
-    bool operator()(event_queue_entry* lhs, event_queue_entry* rhs) {
+    bool operator()(const event_queue_entry* lhs, const event_queue_entry* rhs) const {
       bool neq = lhs->time() != rhs->time();
       if (neq) return lhs->time() < rhs->time();
 
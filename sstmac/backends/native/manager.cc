@@ -11,6 +11,8 @@
 
 #include <sstmac/hardware/interconnect/interconnect.h>
 #include <sstmac/hardware/node/node.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <sstmac/hardware/router/routing_table.h>
 
 #include <sstmac/common/sstmac_env.h>
 #include <sstmac/backends/common/sim_partition.h>
@@ -21,6 +23,7 @@
 #include <sstmac/backends/native/clock_cycle_parallel/clock_cycle_event_container.h>
 
 #include <sstmac/common/runtime.h>
+#include <sstmac/common/slab_allocator.h>
 
 #include <sstmac/dumpi_util/dumpi_meta.h>
 
@@ -37,6 +40,7 @@
 #include <sprockit/sim_parameters.h>
 
 #include <iostream>
+#include <fstream>
 #include <iterator>
 #include <cstdlib>
 
@@ -45,6 +49,8 @@ RegisterKeywords(
 "sst_rank",
 "sst_nproc",
 "nworkers",
+"switch_event_counts_file",
+"sweep_divergence_time",
 );
 
 
@@ -161,6 +167,9 @@ manager::manager(sprockit::sim_parameters* params, parallel_runtime* rt) :
   interconnect_ = hw::interconnect::static_interconnect(params, event_manager_);
 
   event_manager_->set_interconnect(interconnect_);
+
+  switch_event_counts_file_ = params->get_optional_param("switch_event_counts_file", "");
+  divergence_time_ = params->get_optional_time_param("sweep_divergence_time", -1.);
 }
 
 manager::~manager() throw ()
@@ -191,6 +200,10 @@ manager::run(timestamp until)
     event_manager_->schedule_stop(until);
   }
 
+  if (divergence_time_.sec() > 0) {
+    event_manager_->schedule_divergence(divergence_time_);
+  }
+
   event_manager_->run();
 
   running_ = false;
@@ -214,9 +227,53 @@ manager::finish()
 {
   //interconnect_->deadlock_check();
   event_manager_->finish_stats();
+  if (!switch_event_counts_file_.empty()){
+    write_switch_event_counts();
+  }
   event_manager::global = nullptr;
+  if (sprockit::debug::slot_active(sprockit::dbg::slab_allocator)){
+    slab_allocator::print_stats(std::cout);
+  }
+  if (hw::routing_table::num_tables() > 0){
+    hw::routing_table::print_stats(std::cout);
+  }
 }
 
+void
+manager::write_switch_event_counts()
+{
+  hw::topology* top = interconnect_->topol();
+  std::vector<long long> counts(top->num_switches(), 0);
+  for (int t=0; t < event_manager_->nthread(); ++t){
+    event_container* mgr = safe_cast(event_container, event_manager_->ev_man_for_thread(t));
+    const std::vector<long long>& sw_counts = mgr->switch_event_counts();
+    for (int i=0; i < sw_counts.size(); ++i){
+      counts[i] += sw_counts[i];
+    }
+    const std::vector<long long>& node_counts = mgr->node_event_counts();
+    for (int i=0; i < node_counts.size(); ++i){
+      if (node_counts[i] == 0) continue;
+      int port;
+      switch_id sid = top->node_to_injection_switch(node_id(i), port);
+      counts[sid] += node_counts[i];
+    }
+  }
+
+  int root = 0;
+  rt_->global_sum(counts.data(), counts.size(), root);
+  if (rt_->me() == root){
+    std::ofstream out(switch_event_counts_file_.c_str());
+    if (!out.is_open()){
+      spkt_throw_printf(sprockit::io_error,
+        "could not open switch event counts file %s",
+        switch_event_counts_file_.c_str());
+    }
+    out << "# switch events\n";
+    for (int i=0; i < counts.size(); ++i){
+      out << i << " " << counts[i] << "\n";
+    }
+  }
+}
 
 #endif
 
@@ -61,8 +61,19 @@ class manager {
  private:
   void start();
 
+  /**
+   * Sum the events executed on each switch (and the nodes injecting into it)
+   * over all threads and ranks for use as partition_switch_weights in a later run
+   */
+  void write_switch_event_counts();
+
   event_manager* event_manager_;
 
+  std::string switch_event_counts_file_;
+
+  /** When a warm-start sweep forks, negative if only apps mark it */
+  timestamp divergence_time_;
+
   bool running_;
 
   sstmac::sw::app_id next_ppid_;
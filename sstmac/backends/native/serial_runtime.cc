@@ -138,5 +138,15 @@ serial_runtime::do_send_recv_messages(std::vector<void*>& buffers)
      "serial_runtime::do_send_recv_messages: should not be sending any messages");
 }
 
+void
+serial_runtime::do_send_recv_null_messages(const std::vector<int>& neighbors,
+  const std::vector<int64_t>& out_times,
+  std::vector<int64_t>& in_times,
+  std::vector<void*>& buffers)
+{
+  spkt_throw_printf(sprockit::illformed_error,
+     "serial_runtime::do_send_recv_null_messages: should not be sending any messages");
+}
+
 }
 }
@@ -78,6 +78,12 @@ class serial_runtime :
   virtual void
   do_send_recv_messages(std::vector<void*>& buffers) override;
 
+  void
+  do_send_recv_null_messages(const std::vector<int>& neighbors,
+    const std::vector<int64_t>& out_times,
+    std::vector<int64_t>& in_times,
+    std::vector<void*>& buffers) override;
+
   std::map<int, int> merge_refcounts_;
 
 };
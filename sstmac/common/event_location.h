@@ -14,6 +14,7 @@ struct device_id {
     logp_overlay=3,
     control_event=4,
     null=5,
+    router_credit=6
   } type_t;
 
   explicit device_id(uint32_t id, type_t ty) :
@@ -48,7 +49,7 @@ struct device_id {
 
   bool
   is_switch_id() const {
-    return type_ == router;
+    return type_ == router || type_ == router_credit;
   }
 
   bool
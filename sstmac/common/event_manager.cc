@@ -11,6 +11,8 @@
 
 #include <sstmac/common/event_manager.h>
 #include <sstmac/common/sst_event.h>
+#include <sstmac/common/thread_lock.h>
+#include <sstmac/common/runtime.h>
 #include <sstmac/hardware/interconnect/interconnect.h>
 #include <sstmac/backends/common/sim_partition.h>
 #include <sstmac/backends/common/parallel_runtime.h>
@@ -44,8 +46,33 @@ class stop_event : public event_queue_entry
 
 };
 
+class divergence_event : public event_queue_entry
+{
+ public:
+  virtual ~divergence_event() {}
+
+  void execute(){
+    runtime::diverge();
+  }
+
+  divergence_event() :
+    event_queue_entry(device_id::ctrl_event(), device_id::ctrl_event())
+  {
+  }
+
+};
 
 event_manager* event_manager::global = nullptr;
+#if SSTMAC_USE_MULTITHREAD
+thread_local event_manager* event_manager::active_ = nullptr;
+bool event_manager::components_migrate_ = false;
+
+event_manager*
+event_manager::active()
+{
+  return active_;
+}
+#endif
 
 event_manager::event_manager(sprockit::sim_parameters *params, parallel_runtime *rt) :
   rt_(rt),
@@ -85,6 +112,12 @@ event_manager::schedule_stop(timestamp until)
   schedule(until, 0, stopper);
 }
 
+void
+event_manager::schedule_divergence(timestamp t)
+{
+  schedule(t, 0, new divergence_event);
+}
+
 void
 event_manager::multithread_schedule(
     int srcthread,
@@ -115,21 +148,30 @@ event_manager::set_now(const timestamp &ts)
   now_ = ts;
 }
 
+//switches may be built on several threads at startup
+static thread_lock stats_lock;
+
 stat_collector*
 event_manager::register_thread_unique_stat(
   stat_collector *stat,
   stat_descr_t* descr)
 {
+  stats_lock.lock();
   std::map<std::string, stats_entry>::iterator it = stats_.find(stat->fileroot());
   if (it != stats_.end()){
+    //another component on this thread already registered one
     stats_entry& entry = it->second;
-    return entry.collectors.front();
+    stat_collector* main = entry.collectors.front();
+    stats_lock.unlock();
+    if (stat != main){
+      delete stat;
+    }
+    return main;
   }
 
-  //clone a stat collector for this thread
-  stat_collector* cln = stat->clone();
-  register_stat(cln, descr);
-  return cln;
+  add_stat(stat, descr);
+  stats_lock.unlock();
+  return stat;
 }
 
 static stat_descr_t default_descr;
@@ -138,6 +180,16 @@ void
 event_manager::register_stat(
   stat_collector* stat,
   stat_descr_t* descr)
+{
+  stats_lock.lock();
+  add_stat(stat, descr);
+  stats_lock.unlock();
+}
+
+void
+event_manager::add_stat(
+  stat_collector* stat,
+  stat_descr_t* descr)
 {
   if (stat->registered())
     return;
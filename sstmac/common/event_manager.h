@@ -177,6 +177,34 @@ class event_manager
   virtual void
   schedule_stop(timestamp until);
 
+  /**
+   * Schedule runtime::diverge at a given time for warm-start sweeps
+   */
+  void
+  schedule_divergence(timestamp t);
+
+#if SSTMAC_USE_MULTITHREAD
+  /**
+   * Components can move between threads, so the manager they were
+   * built with is not necessarily the one running their events.
+   * Not inline: a user-space thread can block on one thread and resume
+   * on another, so the thread-local slot must be looked up on every call.
+   * @return The event manager running events on the calling thread,
+   *         null outside of run()
+   */
+  static event_manager*
+  active();
+
+  /**
+   * @return Whether components can move between threads while running.
+   *         Only then do they need active() to find their manager.
+   */
+  static bool
+  components_migrate() {
+    return components_migrate_;
+  }
+#endif
+
  protected:
   event_manager(sprockit::sim_parameters* params, parallel_runtime* rt);
 
@@ -199,6 +227,12 @@ class event_manager
 
   int nthread_;
 
+#if SSTMAC_USE_MULTITHREAD
+  static thread_local event_manager* active_;
+
+  static bool components_migrate_;
+#endif
+
  private:
   struct stats_entry {
     bool reduce_all;
@@ -212,6 +246,9 @@ class event_manager
 
   timestamp now_;
 
+  void
+  add_stat(stat_collector* stat, stat_descr_t* descr);
+
  private:
   virtual void
   schedule(timestamp start_time, uint32_t seqnum, event_queue_entry* event_queue_entry) = 0;
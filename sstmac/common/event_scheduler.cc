@@ -13,6 +13,7 @@
 #include <sstmac/common/sstmac_config.h>
 #include <sstmac/common/event_handler.h>
 #include <sstmac/common/event_manager.h>
+#include <sstmac/common/stats/stat_collector.h>
 #include <sstmac/common/sst_event.h>
 #include <sstmac/common/sstmac_env.h>
 #include <sstmac/hardware/node/node.h>
@@ -35,7 +36,7 @@ event_component::cancel_all_messages()
   spkt_throw(sprockit::unimplemented_error,
     "event_scheduler::cancel_all_messages: cannot cancel messages currently in integrated core");
 #else
-  event_mgr()->cancel_all_messages(event_location());
+  active_mgr()->cancel_all_messages(event_location());
 #endif
 }
 
@@ -312,19 +313,23 @@ event_scheduler::schedule(timestamp t, event_queue_entry* ev)
                      "time has gone backwards %8.4e seconds", delta_t);
   }
 #endif
-  eventman_->schedule(t, (*seqnum_)++, ev);
+  active_mgr()->schedule(t, (*seqnum_)++, ev);
 }
 
-void
+stat_collector*
 event_scheduler::register_stat(stat_collector *coll, stat_descr_t* descr)
 {
+  if (coll->thread_unique()){
+    return eventman_->register_thread_unique_stat(coll, descr);
+  }
   eventman_->register_stat(coll, descr);
+  return coll;
 }
 
 void
 event_scheduler::ipc_schedule(timestamp t, event_handler* handler, event* ev)
 {
-  eventman_->ipc_schedule(t, handler->event_location(), event_location(), (*seqnum_)++, ev);
+  active_mgr()->ipc_schedule(t, handler->event_location(), event_location(), (*seqnum_)++, ev);
 }
 
 void
@@ -348,11 +353,11 @@ event_scheduler::multithread_schedule(int src_thread, int dst_thread,
   if (dst_thread != event_handler::null_threadid
      && dst_thread != src_thread){
     ev->set_time(t);
-    eventman_->multithread_schedule(
+    active_mgr()->multithread_schedule(
       src_thread, dst_thread,
       (*seqnum_)++, ev);
   } else {
-    eventman_->schedule(t, (*seqnum_)++, ev);
+    active_mgr()->schedule(t, (*seqnum_)++, ev);
   }
 }
 
@@ -109,7 +109,10 @@ class event_scheduler :
   send_delayed_to_link(timestamp extra_delay,
                event_handler* lnk, event* ev);
 
-  void
+  /**
+   * @return The collector to use, see stat_collector::register_optional_stat
+   */
+  stat_collector*
   register_stat(stat_collector* coll, stat_descr_t* descr);
 
 #if SSTMAC_INTEGRATED_SST_CORE
@@ -161,7 +164,7 @@ class event_scheduler :
  public:
   timestamp
   now() const {
-    return eventman_->now();
+    return active_mgr()->now();
   }
 
   int
@@ -198,6 +201,23 @@ class event_scheduler :
   event_manager* eventman_;
   uint32_t* seqnum_;
 
+ protected:
+  /**
+   * @return The manager running this component's events, which is
+   *         not necessarily the one it was built with if threads rebalance
+   */
+  event_manager*
+  active_mgr() const {
+#if SSTMAC_USE_MULTITHREAD
+    //skip the thread-local lookup unless threads rebalance
+    if (event_manager::components_migrate()){
+      event_manager* active = event_manager::active();
+      return active ? active : eventman_;
+    }
+#endif
+    return eventman_;
+  }
+
  private:
   void sanity_check(timestamp t);
 
@@ -15,6 +15,7 @@ bool runtime::do_deadlock_check_ = false;
 std::list<deadlock_check*> runtime::deadlock_checks_;
 sw::job_launcher* runtime::launcher_ = nullptr;
 hw::topology* runtime::topology_ = nullptr;
+divergence_handler* runtime::divergence_handler_ = nullptr;
 
 void
 runtime::check_deadlock()
@@ -28,6 +29,17 @@ runtime::check_deadlock()
   }
 }
 
+void
+runtime::diverge()
+{
+  if (!divergence_handler_) return;
+
+  //only the first marker diverges
+  divergence_handler* handler = divergence_handler_;
+  divergence_handler_ = nullptr;
+  handler->diverge();
+}
+
 void
 runtime::clear_statics()
 {
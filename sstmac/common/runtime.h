@@ -43,6 +43,18 @@ new_deadlock_check(T* t, Fxn f){
   return new deadlock_check_impl<T,Fxn>(t,f);
 }
 
+/**
+ * Called once a simulation reaches the end of the startup phase shared
+ * by every point of a warm-start sweep
+ */
+class divergence_handler {
+ public:
+  virtual void diverge() = 0;
+
+  virtual ~divergence_handler(){}
+
+};
+
 class runtime
 {
  protected:
@@ -99,6 +111,20 @@ class runtime
     launcher_ = launcher;
   }
 
+  /**
+   * Marks the end of the startup phase shared by all points of a sweep.
+   * Apps can call this directly, or the sweep_divergence_time parameter
+   * triggers it. Only the first call does anything, and only if a sweep
+   * installed a handler; in any other run this is a no-op.
+   */
+  static void
+  diverge();
+
+  static void
+  set_divergence_handler(divergence_handler* handler){
+    divergence_handler_ = handler;
+  }
+
  protected:
   static bool do_deadlock_check_;
 
@@ -108,6 +134,8 @@ class runtime
 
   static std::list<deadlock_check*> deadlock_checks_;
 
+  static divergence_handler* divergence_handler_;
+
 };
 
 }
@@ -0,0 +1,238 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/common/slab_allocator.h>
+#include <sstmac/common/thread_lock.h>
+#include <sprockit/errors.h>
+#include <sprockit/spkt_string.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+RegisterDebugSlot(slab_allocator,
+    "print the hit/miss statistics of the per-thread event/packet slab allocator at the end of the simulation");
+
+namespace sstmac {
+
+/** Free chunks are linked through their first word */
+struct free_chunk {
+  free_chunk* next;
+};
+
+/** Starts every slab, chunks are carved from the rest */
+struct slab_header {
+  /** The thread_pool that carved the slab */
+  void* owner;
+  /** Keep chunks aligned the same as ::operator new */
+  char pad[slab_allocator::size_class_bytes - sizeof(void*)];
+};
+
+struct slab_allocator::thread_pool {
+  free_chunk* free_lists[num_size_classes];
+  uint64_t hits[num_size_classes];
+  uint64_t misses[num_size_classes];
+  uint64_t oversize;
+  uint64_t bytes_reserved;
+  /** Chunks freed by other threads, pushed there and only taken here */
+  std::atomic<free_chunk*> remote_frees[num_size_classes];
+
+  thread_pool() : oversize(0), bytes_reserved(0)
+  {
+    ::memset(free_lists, 0, sizeof(free_lists));
+    ::memset(hits, 0, sizeof(hits));
+    ::memset(misses, 0, sizeof(misses));
+    for (int i=0; i < num_size_classes; ++i){
+      remote_frees[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  void
+  free_remote(int cls, free_chunk* chunk)
+  {
+    free_chunk* head = remote_frees[cls].load(std::memory_order_relaxed);
+    do {
+      chunk->next = head;
+    } while (!remote_frees[cls].compare_exchange_weak(head, chunk,
+              std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  /**
+   * Take back everything other threads freed in this size class
+   * @return Whether any chunks came back
+   */
+  bool
+  drain_remote_frees(int cls)
+  {
+    if (!remote_frees[cls].load(std::memory_order_relaxed)){
+      return false;
+    }
+    //the owner takes the whole list, so pushes never race with a pop
+    free_chunk* head = remote_frees[cls].exchange(nullptr, std::memory_order_acquire);
+    free_lists[cls] = head;
+    return head != nullptr;
+  }
+
+  void
+  refill(int cls)
+  {
+    size_t chunk_size = (cls+1) * size_class_bytes;
+    size_t nchunks = (slab_size - sizeof(slab_header)) / chunk_size;
+    void* mem = nullptr;
+    if (::posix_memalign(&mem, slab_size, slab_size) != 0){
+      throw std::bad_alloc();
+    }
+    bytes_reserved += slab_size;
+    slab_header* hdr = static_cast<slab_header*>(mem);
+    hdr->owner = this;
+    char* slab = static_cast<char*>(mem) + sizeof(slab_header);
+    free_chunk* head = free_lists[cls];
+    for (size_t i=0; i < nchunks; ++i, slab += chunk_size){
+      free_chunk* chunk = reinterpret_cast<free_chunk*>(slab);
+      chunk->next = head;
+      head = chunk;
+    }
+    free_lists[cls] = head;
+  }
+};
+
+std::vector<slab_allocator::thread_pool*>* slab_allocator::all_pools_ = 0;
+thread_local slab_allocator::thread_pool* slab_allocator::local_pool_ = 0;
+static thread_lock pools_lock_;
+
+slab_allocator::thread_pool*
+slab_allocator::local_pool()
+{
+  if (!local_pool_){
+    local_pool_ = new thread_pool;
+    pools_lock_.lock();
+    if (!all_pools_) all_pools_ = new std::vector<thread_pool*>;
+    all_pools_->push_back(local_pool_);
+    pools_lock_.unlock();
+  }
+  return local_pool_;
+}
+
+slab_allocator::thread_pool*
+slab_allocator::owner(void* chunk)
+{
+  uintptr_t slab = reinterpret_cast<uintptr_t>(chunk) & ~uintptr_t(slab_size - 1);
+  return static_cast<thread_pool*>(reinterpret_cast<slab_header*>(slab)->owner);
+}
+
+void*
+slab_allocator::allocate(size_t size)
+{
+  thread_pool* pool = local_pool();
+  if (size > max_pooled_size || size == 0){
+    ++pool->oversize;
+    return ::operator new(size);
+  }
+
+  int cls = size_class(size);
+  free_chunk* chunk = pool->free_lists[cls];
+  if (chunk || pool->drain_remote_frees(cls)){
+    ++pool->hits[cls];
+  } else {
+    ++pool->misses[cls];
+    pool->refill(cls);
+  }
+  chunk = pool->free_lists[cls];
+  pool->free_lists[cls] = chunk->next;
+  return chunk;
+}
+
+void
+slab_allocator::free(void* ptr, size_t size)
+{
+  if (!ptr) return;
+
+  if (size > max_pooled_size || size == 0){
+    ::operator delete(ptr);
+    return;
+  }
+
+  thread_pool* pool = owner(ptr);
+  int cls = size_class(size);
+  free_chunk* chunk = static_cast<free_chunk*>(ptr);
+  if (pool == local_pool_){
+    chunk->next = pool->free_lists[cls];
+    pool->free_lists[cls] = chunk;
+  } else {
+    pool->free_remote(cls, chunk);
+  }
+}
+
+uint64_t
+slab_allocator::num_hits()
+{
+  uint64_t total = 0;
+  pools_lock_.lock();
+  if (all_pools_){
+    for (thread_pool* pool : *all_pools_){
+      for (int i=0; i < num_size_classes; ++i) total += pool->hits[i];
+    }
+  }
+  pools_lock_.unlock();
+  return total;
+}
+
+uint64_t
+slab_allocator::num_misses()
+{
+  uint64_t total = 0;
+  pools_lock_.lock();
+  if (all_pools_){
+    for (thread_pool* pool : *all_pools_){
+      for (int i=0; i < num_size_classes; ++i) total += pool->misses[i];
+    }
+  }
+  pools_lock_.unlock();
+  return total;
+}
+
+void
+slab_allocator::print_stats(std::ostream& os)
+{
+  uint64_t hits[num_size_classes];
+  uint64_t misses[num_size_classes];
+  ::memset(hits, 0, sizeof(hits));
+  ::memset(misses, 0, sizeof(misses));
+  uint64_t oversize = 0;
+  uint64_t reserved = 0;
+  int npools = 0;
+
+  pools_lock_.lock();
+  if (all_pools_){
+    npools = all_pools_->size();
+    for (thread_pool* pool : *all_pools_){
+      for (int i=0; i < num_size_classes; ++i){
+        hits[i] += pool->hits[i];
+        misses[i] += pool->misses[i];
+      }
+      oversize += pool->oversize;
+      reserved += pool->bytes_reserved;
+    }
+  }
+  pools_lock_.unlock();
+
+  os << sprockit::printf("Slab allocator: %d thread pools, %lu bytes reserved, %lu oversize allocations\n",
+                         npools, reserved, oversize);
+  for (int i=0; i < num_size_classes; ++i){
+    uint64_t total = hits[i] + misses[i];
+    if (total == 0) continue;
+    os << sprockit::printf("  %4d bytes: %12lu hits %8lu misses (%6.2f%% hit rate)\n",
+                           (i+1)*size_class_bytes, hits[i], misses[i],
+                           100.0*double(hits[i])/double(total));
+  }
+}
+
+}
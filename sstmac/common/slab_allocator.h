@@ -0,0 +1,112 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_COMMON_SLAB_ALLOCATOR_H_INCLUDED
+#define SSTMAC_COMMON_SLAB_ALLOCATOR_H_INCLUDED
+
+#include <sstmac/common/sstmac_config.h>
+#include <sprockit/debug.h>
+#include <cstddef>
+#include <stdint.h>
+#include <iostream>
+#include <vector>
+
+DeclareDebugSlot(slab_allocator)
+
+namespace sstmac {
+
+/**
+ * @brief The slab_allocator class
+ * Size-class allocator for small, short-lived objects (events, packets, credits).
+ * Every physical thread owns its own set of free lists so that no locking
+ * is needed on the allocate/free path. Slabs are aligned to their size and
+ * record the pool that carved them, so a chunk always returns to its owner.
+ * Chunks freed by another thread, e.g. events executed on another thread in
+ * the multithreaded event manager, are pushed onto a lock-free mailbox
+ * that the owner drains before carving a new slab. A pool therefore never
+ * holds more slabs than its peak number of live chunks requires.
+ * Slabs are kept for reuse until the process exits.
+ * Requests larger than the biggest size class fall through to ::operator new.
+ */
+class slab_allocator
+{
+ public:
+  static const int size_class_bytes = 16;
+
+  static const int num_size_classes = 32;
+
+  static const size_t max_pooled_size = size_class_bytes * num_size_classes;
+
+  /** Each refill carves a slab of this many bytes into chunks.
+      Must be a power of two, slabs are aligned to it. */
+  static const size_t slab_size = 64*1024;
+
+  static void*
+  allocate(size_t size);
+
+  static void
+  free(void* ptr, size_t size);
+
+  /**
+   * @brief print_stats Print pool hits/misses aggregated over all threads
+   * @param os The stream to print to
+   */
+  static void
+  print_stats(std::ostream& os);
+
+  static uint64_t
+  num_hits();
+
+  static uint64_t
+  num_misses();
+
+ private:
+  struct thread_pool;
+
+  static thread_pool*
+  local_pool();
+
+  /** All pools ever created, only touched at creation and for stats */
+  static std::vector<thread_pool*>* all_pools_;
+
+  /** Pools live for the lifetime of the process */
+  static thread_local thread_pool* local_pool_;
+
+  static thread_pool*
+  owner(void* chunk);
+
+  static int
+  size_class(size_t size){
+    return (size - 1) / size_class_bytes;
+  }
+};
+
+}
+
+/**
+ * Add class-level operator new/delete that route through the slab allocator.
+ * The sized operator delete receives the size of the dynamic type
+ * as long as the class hierarchy has a virtual destructor.
+ */
+#if SSTMAC_USE_SLAB_ALLOCATOR
+#define SlabAllocated() \
+ public: \
+  static void* operator new(size_t size){ \
+    return sstmac::slab_allocator::allocate(size); \
+  } \
+  static void operator delete(void* ptr, size_t size){ \
+    sstmac::slab_allocator::free(ptr, size); \
+  }
+#else
+#define SlabAllocated()
+#endif
+
+#endif // SSTMAC_COMMON_SLAB_ALLOCATOR_H_INCLUDED
@@ -18,6 +18,7 @@
 #include <sstmac/common/sstmac_config.h>
 #include <sstmac/common/event_scheduler_fwd.h>
 #include <sstmac/common/event_location.h>
+#include <sstmac/common/slab_allocator.h>
 #if SSTMAC_INTEGRATED_SST_CORE
 #include <sst/core/event.h>
 #include <sst/core/output.h>
@@ -41,6 +42,7 @@ class event :
 class event_queue_entry : public event
 {
   NotSerializable(event_queue_entry)
+  SlabAllocated()
  public:
   virtual ~event_queue_entry() {}
 
@@ -111,10 +111,10 @@ stat_collector::optional_build(sprockit::sim_parameters* params,
   return stats;
 }
 
-void
+stat_collector*
 stat_collector::register_optional_stat(event_scheduler* parent, stat_collector *coll, stat_descr_t* descr)
 {
-  parent->register_stat(coll, descr);
+  return parent->register_stat(coll, descr);
 }
 
 stat_value_base::stat_value_base(sprockit::sim_parameters *params) :
@@ -73,6 +73,15 @@ class stat_collector : public sprockit::printable
   virtual void
   clear() = 0;
 
+  /**
+   * @return Whether every component on a thread should share a single
+   *         collector rather than each registering its own
+   */
+  virtual bool
+  thread_unique() const {
+    return false;
+  }
+
   bool
   registered() const {
     return registered_;
@@ -143,7 +152,11 @@ class stat_collector : public sprockit::printable
              const std::string& ns,
              const std::string& deflt);
 
-  static void
+  /**
+   * @return The collector to use, which for thread-unique stats may be
+   *         one already registered on this thread in place of coll
+   */
+  static stat_collector*
   register_optional_stat(event_scheduler* parent, stat_collector* coll, stat_descr_t* descr);
 
  protected:
@@ -222,8 +235,7 @@ required_stats(event_scheduler* parent,
   if (!t){
     stat_collector::stats_error(params, ns, deflt);
   }
-  stat_collector::register_optional_stat(parent, t, descr);
-  return t;
+  return static_cast<T*>(stat_collector::register_optional_stat(parent, t, descr));
 }
 
 template <class T>
@@ -255,8 +267,7 @@ optional_stats(event_scheduler* parent,
     if (!t){
       stat_collector::stats_error(params, ns, deflt);
     }
-    stat_collector::register_optional_stat(parent, t, descr);
-    return t;
+    return static_cast<T*>(stat_collector::register_optional_stat(parent, t, descr));
   }
   else return nullptr;
 }
@@ -5,13 +5,22 @@
 #include <sprockit/errors.h>
 #include <sprockit/sim_parameters.h>
 #include <sprockit/util.h>
+#include <sprockit/keyword_registration.h>
 #include <algorithm>
+#include <cstring>
 #include <list>
 
+RegisterKeywords(
+"block_size",
+"png",
+"png_max_pixels",
+);
+
 namespace sstmac {
 
 SpktRegister("ascii", stat_collector, stat_spyplot);
 SpktRegister("png", stat_collector, stat_spyplot_png);
+SpktRegister("dense", stat_collector, stat_spyplot_dense);
 
 void
 stat_spyplot::add_one(int source, int dest)
@@ -360,6 +369,272 @@ stat_spyplot_png::dump_to_file(const std::string& froot)
     }
 }
 
-} //end namespace
+stat_spyplot_dense::stat_spyplot_dense(sprockit::sim_parameters* params) :
+  stat_spyplot(params),
+  dim_(0)
+{
+  block_size_ = params->get_optional_int_param("block_size", 64);
+  block_shift_ = 0;
+  while ((1 << block_shift_) < block_size_) ++block_shift_;
+  if ((1 << block_shift_) != block_size_){
+    spkt_throw_printf(sprockit::value_error,
+      "stat_spyplot_dense: block_size %d is not a power of two",
+      block_size_);
+  }
+  png_ = params->get_optional_bool_param("png", false);
+  png_max_pixels_ = params->get_optional_int_param("png_max_pixels", 1024);
+  normalization_ = params->get_optional_long_param("normalization", -1);
+}
+
+stat_spyplot_dense::~stat_spyplot_dense()
+{
+  clear();
+}
 
+long*
+stat_spyplot_dense::block(int brow, int bcol)
+{
+  if (brow >= blocks_.size()){
+    blocks_.resize(brow + 1);
+  }
+  std::vector<long*>& row = blocks_[brow];
+  if (bcol >= row.size()){
+    row.resize(bcol + 1, nullptr);
+  }
+  long*& blk = row[bcol];
+  if (!blk){
+    blk = new long[block_size_*block_size_];
+    ::memset(blk, 0, block_size_*block_size_*sizeof(long));
+  }
+  return blk;
+}
+
+void
+stat_spyplot_dense::add(int source, int dest, long num)
+{
+  int mask = block_size_ - 1;
+  long* blk = block(source >> block_shift_, dest >> block_shift_);
+  blk[(source & mask)*block_size_ + (dest & mask)] += num;
+  dim_ = std::max(dim_, std::max(source, dest) + 1);
+}
+
+long
+stat_spyplot_dense::get(int source, int dest) const
+{
+  int brow = source >> block_shift_;
+  int bcol = dest >> block_shift_;
+  if (brow >= blocks_.size() || bcol >= blocks_[brow].size()
+      || !blocks_[brow][bcol]){
+    return 0;
+  }
+  int mask = block_size_ - 1;
+  return blocks_[brow][bcol][(source & mask)*block_size_ + (dest & mask)];
+}
+
+void
+stat_spyplot_dense::reduce(stat_collector* coll)
+{
+  stat_spyplot_dense* other = safe_cast(stat_spyplot_dense, coll);
+  if (other->block_size_ != block_size_){
+    spkt_throw_printf(sprockit::value_error,
+      "stat_spyplot_dense::reduce: block sizes %d and %d do not match",
+      block_size_, other->block_size_);
+  }
+  int nvals = block_size_*block_size_;
+  for (int brow=0; brow < other->blocks_.size(); ++brow){
+    std::vector<long*>& row = other->blocks_[brow];
+    for (int bcol=0; bcol < row.size(); ++bcol){
+      long* his = row[bcol];
+      if (his){
+        long* mine = block(brow, bcol);
+        for (int i=0; i < nvals; ++i){
+          mine[i] += his[i];
+        }
+      }
+    }
+  }
+  dim_ = std::max(dim_, other->dim_);
+}
+
+void
+stat_spyplot_dense::global_reduce(parallel_runtime* rt)
+{
+  if (rt->nproc() == 1)
+    return;
+
+  //agree on which blocks anyone touched, then sum only those
+  dim_ = rt->global_max(dim_);
+  int nblocks = (dim_ + block_size_ - 1) >> block_shift_;
+  std::vector<int> touched(nblocks*nblocks, 0);
+  for (int brow=0; brow < blocks_.size(); ++brow){
+    std::vector<long*>& row = blocks_[brow];
+    for (int bcol=0; bcol < row.size(); ++bcol){
+      if (row[bcol]) touched[brow*nblocks + bcol] = 1;
+    }
+  }
+  rt->global_max(touched.data(), touched.size(), parallel_runtime::global_root);
+
+  int nvals = block_size_*block_size_;
+  std::vector<long*> order;
+  for (int idx=0; idx < touched.size(); ++idx){
+    if (touched[idx]){
+      order.push_back(block(idx / nblocks, idx % nblocks));
+    }
+  }
+
+  std::vector<long> buf(order.size()*nvals);
+  long* bufptr = buf.data();
+  for (long* blk : order){
+    ::memcpy(bufptr, blk, nvals*sizeof(long));
+    bufptr += nvals;
+  }
 
+  int root = 0;
+  rt->global_sum(buf.data(), buf.size(), root);
+
+  bufptr = buf.data();
+  for (long* blk : order){
+    ::memcpy(blk, bufptr, nvals*sizeof(long));
+    bufptr += nvals;
+  }
+}
+
+void
+stat_spyplot_dense::clear()
+{
+  for (std::vector<long*>& row : blocks_){
+    for (long* blk : row){
+      if (blk) delete[] blk;
+    }
+  }
+  blocks_.clear();
+  dim_ = 0;
+}
+
+void
+stat_spyplot_dense::dump_to_file(const std::string& froot)
+{
+  /**
+   * Binary layout, in native byte order:
+   *  char    magic[8] = SSTMSPY1
+   *  int64_t dim
+   *  int64_t nnz
+   *  int64_t row_offsets[dim+1]
+   *  int32_t cols[nnz]
+   *  int64_t vals[nnz]
+   */
+  std::vector<int64_t> offsets(dim_ + 1, 0);
+  std::vector<int32_t> cols;
+  std::vector<int64_t> vals;
+  int mask = block_size_ - 1;
+  for (int src=0; src < dim_; ++src){
+    int brow = src >> block_shift_;
+    if (brow < blocks_.size()){
+      std::vector<long*>& row = blocks_[brow];
+      for (int bcol=0; bcol < row.size(); ++bcol){
+        long* blk = row[bcol];
+        if (!blk) continue;
+        long* blk_row = blk + (src & mask)*block_size_;
+        for (int j=0; j < block_size_; ++j){
+          if (blk_row[j]){
+            cols.push_back(bcol*block_size_ + j);
+            vals.push_back(blk_row[j]);
+          }
+        }
+      }
+    }
+    offsets[src+1] = cols.size();
+  }
+
+  std::string filename = froot + ".bin";
+  std::fstream myfile;
+  check_open(myfile, filename, std::ios::out | std::ios::binary);
+  int64_t dim = dim_;
+  int64_t nnz = cols.size();
+  myfile.write("SSTMSPY1", 8);
+  myfile.write((const char*) &dim, sizeof(int64_t));
+  myfile.write((const char*) &nnz, sizeof(int64_t));
+  myfile.write((const char*) offsets.data(), offsets.size()*sizeof(int64_t));
+  myfile.write((const char*) cols.data(), cols.size()*sizeof(int32_t));
+  myfile.write((const char*) vals.data(), vals.size()*sizeof(int64_t));
+  myfile.close();
+
+  if (png_){
+    dump_png(froot);
+  }
+}
+
+void
+stat_spyplot_dense::dump_png(const std::string& froot)
+{
+  //sum stride x stride squares of the matrix into each point
+  int stride = (dim_ + png_max_pixels_ - 1) / png_max_pixels_;
+  stride = std::max(stride, 1);
+  int npoints = (dim_ + stride - 1) / stride;
+  std::vector<long> points(npoints*npoints, 0);
+  int mask = block_size_ - 1;
+  for (int brow=0; brow < blocks_.size(); ++brow){
+    std::vector<long*>& row = blocks_[brow];
+    for (int bcol=0; bcol < row.size(); ++bcol){
+      long* blk = row[bcol];
+      if (!blk) continue;
+      for (int i=0; i < block_size_*block_size_; ++i){
+        if (blk[i]){
+          int src = brow*block_size_ + i / block_size_;
+          int dst = bcol*block_size_ + (i & mask);
+          points[(src/stride)*npoints + dst/stride] += blk[i];
+        }
+      }
+    }
+  }
+
+  long maxval = normalization_;
+  if (maxval <= 0){
+    maxval = 1;
+    for (long val : points) maxval = std::max(maxval, val);
+  }
+  cout0 << "PNG Spyplot " << froot << " normalized to " << maxval
+        << " with " << stride << "x" << stride << " ranks per point" << std::endl;
+
+  int pixels_per_point = std::max(1, std::min(10, png_max_pixels_ / std::max(npoints, 1)));
+  long width = (npoints + 2) * pixels_per_point;
+  long height = npoints * pixels_per_point;
+  std::vector<unsigned char> image(width * height * 4);
+  unsigned char* pixel = image.data();
+  for (int src=0; src < npoints; ++src){
+    for (int j=0; j < pixels_per_point; ++j){
+      for (int dst=0; dst < npoints; ++dst){
+        int datapoint = get_pixel((double) points[src*npoints + dst] / (double) maxval);
+        for (int i=0; i < pixels_per_point; ++i){
+          *pixel++ = datapoint & 0xFF;
+          *pixel++ = (datapoint >> 8) & 0xFF;
+          *pixel++ = (datapoint >> 16) & 0xFF;
+          *pixel++ = 255; //alpha
+        }
+      }
+
+      //a clear space
+      for (int i=0; i < 4*pixels_per_point; ++i){
+        *pixel++ = 0;
+      }
+
+      long heightcnt = height - (src*pixels_per_point + j);
+      int legend = get_pixel((double) heightcnt / (double) height);
+      for (int i=0; i < pixels_per_point; ++i){
+        *pixel++ = legend & 0xFF;
+        *pixel++ = (legend >> 8) & 0xFF;
+        *pixel++ = (legend >> 16) & 0xFF;
+        *pixel++ = 255; //alpha
+      }
+    }
+  }
+
+  std::string fullpath = froot + ".png";
+  unsigned error = lodepng::encode(fullpath, image, width, height);
+  if (error){
+    cerr0 << "stat_spyplot_dense: PNG encoder error " << error << ": "
+          << lodepng_error_text(error) << std::endl;
+  }
+}
+
+} //end namespace
@@ -17,6 +17,7 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <vector>
 #include <sprockit/unordered.h>
 
 namespace sstmac {
@@ -123,6 +124,85 @@ class stat_spyplot_png : public stat_spyplot
 
 };
 
+/**
+ * this stat_collector class keeps a spy plot in dense blocks instead of
+ * nested hash maps. A block of block_size x block_size counters is only
+ * allocated once a pair inside it communicates, so updates are an array
+ * index and the reductions only move blocks that were touched.
+ * A single collector is shared by every component on a thread.
+ * The matrix is written as a binary compressed sparse row file,
+ * and optionally as a downsampled PNG.
+ */
+class stat_spyplot_dense : public stat_spyplot
+{
+ public:
+  stat_spyplot_dense(sprockit::sim_parameters* params);
+
+  std::string
+  to_string() const override {
+    return "stat_spyplot_dense";
+  }
+
+  virtual
+  ~stat_spyplot_dense();
+
+  bool
+  thread_unique() const override {
+    return true;
+  }
+
+  virtual void
+  add(int source, int dest, long num) override;
+
+  /**
+   * @return The count for source to dest, zero if never added
+   */
+  long
+  get(int source, int dest) const;
+
+  /**
+   * @return One more than the largest source or dest added
+   */
+  int
+  dim() const {
+    return dim_;
+  }
+
+  virtual void
+  reduce(stat_collector *coll) override;
+
+  virtual void
+  global_reduce(parallel_runtime *rt) override;
+
+  virtual void
+  clear() override;
+
+  virtual void
+  dump_to_file(const std::string& froot) override;
+
+  stat_collector*
+  do_clone(sprockit::sim_parameters* params) const override {
+    return new stat_spyplot_dense(params);
+  }
+
+ private:
+  long*
+  block(int brow, int bcol);
+
+  void
+  dump_png(const std::string& froot);
+
+  /** blocks_[brow][bcol], null until touched */
+  std::vector<std::vector<long*> > blocks_;
+  int block_shift_;
+  int block_size_;
+  int dim_;
+  bool png_;
+  int png_max_pixels_;
+  long normalization_;
+
+};
+
 }
 
 #endif
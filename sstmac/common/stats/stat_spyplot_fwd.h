@@ -7,6 +7,8 @@ class stat_spyplot;
 
 class stat_spyplot_png;
 
+class stat_spyplot_dense;
+
 }
 
 #endif // STATS_COMMON_FWD_H
@@ -16,7 +16,7 @@ class thread_info {
 
   static inline int
   current_physical_thread_id(){
-#if SSTMAC_HAVE_UCONTEXT
+#if SSTMAC_HAVE_UCONTEXT || SSTMAC_HAVE_FCONTEXT
     return user_space_thread_id();
 #else
     return kernel_space_thread_id();
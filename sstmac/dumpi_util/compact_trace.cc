@@ -0,0 +1,370 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/dumpi_util/compact_trace.h>
+#include <sprockit/errors.h>
+#include <sprockit/fileio.h>
+#include <cstring>
+#include <errno.h>
+
+#define enumcase(x) case x: return #x;
+
+namespace sstmac {
+namespace sw {
+
+static const char compact_magic[] = "SSTMCTR1";
+static const int compact_magic_length = 8;
+
+/** The fields each call stores, beyond its op and compute time */
+enum compact_field {
+  peer_field = 1 << 0,
+  tag_field = 1 << 1,
+  comm_field = 1 << 2,
+  bytes_field = 1 << 3,
+  request_field = 1 << 4,
+  aux_field = 1 << 5
+};
+
+static const int p2p_fields = peer_field | tag_field | comm_field | bytes_field;
+static const int rooted_fields = peer_field | comm_field | bytes_field;
+
+static const int op_fields[compact_record::num_ops] = {
+  0, //init
+  0, //finalize
+  p2p_fields, //send
+  p2p_fields, //recv
+  p2p_fields | request_field, //isend
+  p2p_fields | request_field, //irecv
+  request_field, //wait
+  aux_field, //waitall
+  p2p_fields | aux_field, //sendrecv
+  comm_field, //barrier
+  rooted_fields, //bcast
+  rooted_fields, //reduce
+  comm_field | bytes_field, //allreduce
+  comm_field | bytes_field, //allgather
+  comm_field | bytes_field, //alltoall
+  rooted_fields, //gather
+  rooted_fields, //scatter
+  comm_field | request_field, //comm_dup
+  peer_field | tag_field | comm_field | request_field, //comm_split
+  comm_field //comm_free
+};
+
+enum compact_column {
+  op_column=0,
+  compute_column,
+  peer_column,
+  tag_column,
+  comm_column,
+  bytes_column,
+  request_column,
+  aux_column,
+  num_columns
+};
+
+const int64_t compact_record::any_source;
+const int64_t compact_record::any_tag;
+const int64_t compact_record::null_request;
+const int64_t compact_record::comm_world;
+const int64_t compact_record::comm_self;
+
+const char*
+compact_record::tostr(op_t op)
+{
+  switch(op){
+    enumcase(init);
+    enumcase(finalize);
+    enumcase(send);
+    enumcase(recv);
+    enumcase(isend);
+    enumcase(irecv);
+    enumcase(wait);
+    enumcase(waitall);
+    enumcase(sendrecv);
+    enumcase(barrier);
+    enumcase(bcast);
+    enumcase(reduce);
+    enumcase(allreduce);
+    enumcase(allgather);
+    enumcase(alltoall);
+    enumcase(gather);
+    enumcase(scatter);
+    enumcase(comm_dup);
+    enumcase(comm_split);
+    enumcase(comm_free);
+    case num_ops:
+      break;
+  }
+  spkt_throw_printf(sprockit::value_error,
+    "compact_record::tostr: unknown op %d", op);
+  return nullptr;
+}
+
+std::string
+compact_trace_file_name(int rank, const std::string& fileroot)
+{
+  char fname[256];
+  snprintf(fname, sizeof(fname), "%s-%04d.sct", fileroot.c_str(), rank);
+  return fname;
+}
+
+static void
+put_varint(std::vector<uint8_t>& buf, uint64_t val)
+{
+  while (val >= 0x80){
+    buf.push_back(uint8_t(val) | 0x80);
+    val >>= 7;
+  }
+  buf.push_back(uint8_t(val));
+}
+
+static void
+put_signed(std::vector<uint8_t>& buf, int64_t val)
+{
+  //zigzag so that small negative values also take one byte
+  put_varint(buf, (uint64_t(val) << 1) ^ uint64_t(val >> 63));
+}
+
+static bool
+get_varint(const uint8_t*& pos, const uint8_t* end, uint64_t& val)
+{
+  val = 0;
+  for (int shift=0; pos < end && shift < 64; shift += 7){
+    uint8_t byte = *pos++;
+    val |= uint64_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+static bool
+get_signed(const uint8_t*& pos, const uint8_t* end, int64_t& val)
+{
+  uint64_t raw;
+  if (!get_varint(pos, end, raw)) return false;
+  val = int64_t(raw >> 1) ^ -int64_t(raw & 1);
+  return true;
+}
+
+compact_trace_writer::compact_trace_writer(const std::string& fname, int block_size) :
+  block_size_(block_size),
+  bytes_written_(0)
+{
+  file_ = fopen(fname.c_str(), "wb");
+  if (!file_){
+    spkt_throw_printf(sprockit::io_error,
+      "compact_trace_writer: could not open %s: %s",
+      fname.c_str(), ::strerror(errno));
+  }
+  fwrite(compact_magic, 1, compact_magic_length, file_);
+  bytes_written_ = compact_magic_length;
+  block_.reserve(block_size_);
+}
+
+compact_trace_writer::~compact_trace_writer()
+{
+  close();
+}
+
+void
+compact_trace_writer::append(const compact_record& rec)
+{
+  block_.push_back(rec);
+  if (int(block_.size()) >= block_size_){
+    flush();
+  }
+}
+
+void
+compact_trace_writer::close()
+{
+  if (!file_) return;
+  flush();
+  fclose(file_);
+  file_ = nullptr;
+}
+
+void
+compact_trace_writer::flush()
+{
+  if (block_.empty()) return;
+
+  std::vector<uint8_t> columns[num_columns];
+  int64_t last_request = 0;
+  int64_t last_bytes = 0;
+  for (const compact_record& rec : block_){
+    int fields = op_fields[rec.op];
+    columns[op_column].push_back(uint8_t(rec.op));
+    put_varint(columns[compute_column], rec.compute > 0 ? rec.compute : 0);
+    if (fields & peer_field) put_signed(columns[peer_column], rec.peer);
+    if (fields & tag_field) put_signed(columns[tag_column], rec.tag);
+    if (fields & comm_field) put_signed(columns[comm_column], rec.comm);
+    if (fields & bytes_field){
+      put_signed(columns[bytes_column], rec.bytes - last_bytes);
+      last_bytes = rec.bytes;
+    }
+    if (fields & request_field){
+      put_signed(columns[request_column], rec.request - last_request);
+      last_request = rec.request;
+    }
+    if (fields & aux_field){
+      put_varint(columns[aux_column], rec.aux.size());
+      //lists are mostly requests started just before
+      int64_t last = last_request;
+      for (int64_t val : rec.aux){
+        put_signed(columns[aux_column], val - last);
+        last = val;
+      }
+    }
+  }
+
+  std::vector<uint8_t> header;
+  put_varint(header, block_.size());
+  for (int c=0; c < num_columns; ++c){
+    put_varint(header, columns[c].size());
+  }
+  fwrite(header.data(), 1, header.size(), file_);
+  bytes_written_ += header.size();
+  for (int c=0; c < num_columns; ++c){
+    fwrite(columns[c].data(), 1, columns[c].size(), file_);
+    bytes_written_ += columns[c].size();
+  }
+  block_.clear();
+}
+
+compact_trace_reader::compact_trace_reader(const std::string& fname) :
+  fname_(fname),
+  pos_(0)
+{
+  sprockit::SpktFileIO::open_file(in_, fname);
+  if (!in_.is_open()){
+    sprockit::SpktFileIO::not_found(fname);
+  }
+  char magic[compact_magic_length];
+  in_.read(magic, compact_magic_length);
+  if (!in_ || ::memcmp(magic, compact_magic, compact_magic_length) != 0){
+    spkt_throw_printf(sprockit::io_error,
+      "compact_trace_reader: %s is not a compact trace", fname.c_str());
+  }
+}
+
+bool
+compact_trace_reader::next(compact_record& rec)
+{
+  if (pos_ == block_.size()){
+    if (!read_block()) return false;
+  }
+  rec = block_[pos_++];
+  return true;
+}
+
+/** Reads a varint byte by byte from the file, false at the end of the file */
+static bool
+read_varint(std::istream& in, uint64_t& val)
+{
+  val = 0;
+  for (int shift=0; shift < 64; shift += 7){
+    int byte = in.get();
+    if (byte == EOF) return false;
+    val |= uint64_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return true;
+  }
+  return false;
+}
+
+bool
+compact_trace_reader::read_block()
+{
+  uint64_t nrec;
+  if (!read_varint(in_, nrec)) return false;
+
+  uint64_t lengths[num_columns];
+  uint64_t total = 0;
+  for (int c=0; c < num_columns; ++c){
+    if (!read_varint(in_, lengths[c])){
+      spkt_throw_printf(sprockit::io_error,
+        "compact_trace_reader: truncated block header in %s", fname_.c_str());
+    }
+    total += lengths[c];
+  }
+
+  std::vector<uint8_t> data(total);
+  in_.read(reinterpret_cast<char*>(data.data()), total);
+  if (uint64_t(in_.gcount()) != total){
+    spkt_throw_printf(sprockit::io_error,
+      "compact_trace_reader: truncated block in %s", fname_.c_str());
+  }
+
+  const uint8_t* pos[num_columns];
+  const uint8_t* end[num_columns];
+  const uint8_t* start = data.data();
+  for (int c=0; c < num_columns; ++c){
+    pos[c] = start;
+    start += lengths[c];
+    end[c] = start;
+  }
+
+  block_.resize(nrec);
+  pos_ = 0;
+  int64_t last_request = 0;
+  int64_t last_bytes = 0;
+  bool ok = lengths[op_column] == nrec;
+  for (uint64_t i=0; ok && i < nrec; ++i){
+    compact_record& rec = block_[i];
+    rec = compact_record();
+    uint8_t op = *pos[op_column]++;
+    if (op >= compact_record::num_ops){
+      ok = false;
+      break;
+    }
+    rec.op = compact_record::op_t(op);
+    int fields = op_fields[op];
+    uint64_t compute;
+    ok = get_varint(pos[compute_column], end[compute_column], compute);
+    rec.compute = compute;
+    if (ok && (fields & peer_field)) ok = get_signed(pos[peer_column], end[peer_column], rec.peer);
+    if (ok && (fields & tag_field)) ok = get_signed(pos[tag_column], end[tag_column], rec.tag);
+    if (ok && (fields & comm_field)) ok = get_signed(pos[comm_column], end[comm_column], rec.comm);
+    if (ok && (fields & bytes_field)){
+      int64_t delta;
+      ok = get_signed(pos[bytes_column], end[bytes_column], delta);
+      rec.bytes = last_bytes + delta;
+      last_bytes = rec.bytes;
+    }
+    if (ok && (fields & request_field)){
+      int64_t delta;
+      ok = get_signed(pos[request_column], end[request_column], delta);
+      rec.request = last_request + delta;
+      last_request = rec.request;
+    }
+    if (ok && (fields & aux_field)){
+      uint64_t count;
+      ok = get_varint(pos[aux_column], end[aux_column], count);
+      int64_t last = last_request;
+      for (uint64_t a=0; ok && a < count; ++a){
+        int64_t delta;
+        ok = get_signed(pos[aux_column], end[aux_column], delta);
+        last += delta;
+        rec.aux.push_back(last);
+      }
+    }
+  }
+
+  if (!ok){
+    spkt_throw_printf(sprockit::io_error,
+      "compact_trace_reader: corrupt block in %s", fname_.c_str());
+  }
+  return nrec > 0;
+}
+
+}
+}
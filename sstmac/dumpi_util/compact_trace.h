@@ -0,0 +1,163 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_DUMPI_UTIL_COMPACT_TRACE_H_INCLUDED
+#define SSTMAC_DUMPI_UTIL_COMPACT_TRACE_H_INCLUDED
+
+#include <cstdio>
+#include <fstream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * A replay trace that keeps only what the simulator consumes from a
+ * DUMPI trace: the MPI call, its peer, tag, communicator, message size,
+ * request and the computation since the previous call.
+ *
+ * Records are written in blocks. Within a block each field is stored as
+ * its own column of variable-length integers, and a column only holds
+ * the records of calls that use the field. Message sizes and requests
+ * are delta encoded since sizes repeat and requests are numbered
+ * consecutively.
+ */
+struct compact_record {
+  enum op_t {
+    init=0,
+    finalize,
+    send,
+    recv,
+    isend,
+    irecv,
+    wait,
+    waitall,
+    sendrecv,
+    barrier,
+    bcast,
+    reduce,
+    allreduce,
+    allgather,
+    alltoall,
+    gather,
+    scatter,
+    comm_dup,
+    comm_split,
+    comm_free,
+    num_ops
+  };
+
+  static const char*
+  tostr(op_t op);
+
+  static const int64_t any_source = -1;
+  static const int64_t any_tag = -1;
+  static const int64_t null_request = -1;
+  static const int64_t comm_world = 0;
+  static const int64_t comm_self = 1;
+
+  op_t op;
+  /** Nanoseconds of computation between the previous call and this one */
+  int64_t compute;
+  /** The destination, source or root, and the color for comm_split */
+  int64_t peer;
+  /** The tag, and the key for comm_split */
+  int64_t tag;
+  int64_t comm;
+  /** The bytes sent, or received for recv, irecv and scatter */
+  int64_t bytes;
+  /** The request started, waited on or the new communicator */
+  int64_t request;
+  /**
+   * The requests for waitall, and the source, tag and bytes of the
+   * receive for sendrecv
+   */
+  std::vector<int64_t> aux;
+
+  compact_record() :
+    op(init), compute(0), peer(0), tag(0), comm(comm_world),
+    bytes(0), request(null_request)
+  {
+  }
+};
+
+std::string
+compact_trace_file_name(int rank, const std::string& fileroot);
+
+class compact_trace_writer
+{
+ public:
+  /**
+   * @param fname The file to (over)write
+   * @param block_size The records buffered per block
+   */
+  compact_trace_writer(const std::string& fname, int block_size = 4096);
+
+  /** Flushes the last block if close was not called */
+  ~compact_trace_writer();
+
+  void
+  append(const compact_record& rec);
+
+  /** Flushes the last block and closes the file */
+  void
+  close();
+
+  /** @return The bytes written to the file so far */
+  long
+  bytes_written() const {
+    return bytes_written_;
+  }
+
+ private:
+  void
+  flush();
+
+  FILE* file_;
+  int block_size_;
+  long bytes_written_;
+  std::vector<compact_record> block_;
+
+};
+
+class compact_trace_reader
+{
+ public:
+  /**
+   * @param fname The trace file of one rank, looked up like other input files
+   * @throw sprockit::io_error if the file is missing or not a compact trace
+   */
+  compact_trace_reader(const std::string& fname);
+
+  /**
+   * @param rec Filled with the next record
+   * @return Whether there was another record
+   */
+  bool
+  next(compact_record& rec);
+
+ private:
+  bool
+  read_block();
+
+  std::string fname_;
+  std::ifstream in_;
+  std::vector<compact_record> block_;
+  size_t pos_;
+
+};
+
+}
+}
+
+#endif
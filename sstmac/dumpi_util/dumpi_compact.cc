@@ -0,0 +1,538 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/dumpi_util/dumpi_compact.h>
+#include <sstmac/dumpi_util/compact_trace.h>
+#include <sstmac/dumpi_util/dumpi_meta.h>
+#include <sstmac/dumpi_util/dumpi_util.h>
+#include <sprockit/errors.h>
+#include <dumpi/libundumpi/libundumpi.h>
+#include <map>
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * The state of converting one rank, passed to the undumpi callbacks
+ */
+class dumpi_compact_converter
+{
+ public:
+  dumpi_compact_converter(const std::string& compact_file,
+                          const dumpi_sizeof& sizes) :
+    writer_(compact_file),
+    sizes_(sizes),
+    initialized_(false),
+    next_comm_(compact_record::comm_self + 1)
+  {
+    comms_[DUMPI_COMM_WORLD] = compact_record::comm_world;
+    comms_[DUMPI_COMM_SELF] = compact_record::comm_self;
+  }
+
+  static dumpi_compact_converter*
+  get(void* uarg) {
+    return static_cast<dumpi_compact_converter*>(uarg);
+  }
+
+  /**
+   * Starts a record for a call, charging the time since the previous
+   * call as compute like parsedumpi does
+   */
+  compact_record&
+  start(compact_record::op_t op, const dumpi_time* wall) {
+    rec_ = compact_record();
+    rec_.op = op;
+    if (initialized_){
+      rec_.compute = 1000000000L*(wall->start.sec - last_stop_.sec)
+                     + (wall->start.nsec - last_stop_.nsec);
+    }
+    return rec_;
+  }
+
+  void
+  finish(const dumpi_time* wall) {
+    writer_.append(rec_);
+    last_stop_ = wall->stop;
+    initialized_ = true;
+  }
+
+  int64_t
+  bytes(int count, dumpi_datatype type) const {
+    //parsedumpi assumes double for unknown types
+    int64_t size = type < sizes_.count ? sizes_.size[type] : sizeof(double);
+    return int64_t(count) * size;
+  }
+
+  int64_t
+  peer(int id) const {
+    return id == DUMPI_ANY_SOURCE ? compact_record::any_source : id;
+  }
+
+  int64_t
+  tag(int id) const {
+    return id == DUMPI_ANY_TAG ? compact_record::any_tag : id;
+  }
+
+  int64_t
+  request(dumpi_request id) const {
+    return id == DUMPI_REQUEST_NULL ? compact_record::null_request : id;
+  }
+
+  int64_t
+  comm(dumpi_comm id) const {
+    auto it = comms_.find(id);
+    if (it == comms_.end()){
+      spkt_throw_printf(sprockit::value_error,
+        "dumpi_to_compact: no match for communicator index %d", int(id));
+    }
+    return it->second;
+  }
+
+  int64_t
+  add_comm(dumpi_comm id) {
+    int64_t newcomm = next_comm_++;
+    comms_[id] = newcomm;
+    return newcomm;
+  }
+
+  void
+  erase_comm(dumpi_comm id) {
+    if (id >= DUMPI_FIRST_USER_COMM) comms_.erase(id);
+  }
+
+  long
+  close() {
+    writer_.close();
+    return writer_.bytes_written();
+  }
+
+ private:
+  compact_trace_writer writer_;
+  dumpi_sizeof sizes_;
+  compact_record rec_;
+  dumpi_clock last_stop_;
+  bool initialized_;
+  std::map<dumpi_comm, int64_t> comms_;
+  int64_t next_comm_;
+
+};
+
+#define convert_args uint16_t thread, const dumpi_time* cpu, \
+  const dumpi_time* wall, const dumpi_perfinfo* perf, void* uarg
+
+static int
+on_init(const dumpi_init* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  cv->start(compact_record::init, wall);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_init_thread(const dumpi_init_thread* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  cv->start(compact_record::init, wall);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_finalize(const dumpi_finalize* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  cv->start(compact_record::finalize, wall);
+  cv->finish(wall);
+  return 1;
+}
+
+/** Send, bsend, ssend and rsend are all replayed as send */
+template <class T>
+static int
+on_send(const T* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::send, wall);
+  rec.peer = cv->peer(prm->dest);
+  rec.tag = cv->tag(prm->tag);
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->count, prm->datatype);
+  cv->finish(wall);
+  return 1;
+}
+
+template <class T>
+static int
+on_isend(const T* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::isend, wall);
+  rec.peer = cv->peer(prm->dest);
+  rec.tag = cv->tag(prm->tag);
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->count, prm->datatype);
+  rec.request = cv->request(prm->request);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_recv(const dumpi_recv* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::recv, wall);
+  rec.peer = cv->peer(prm->source);
+  rec.tag = cv->tag(prm->tag);
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->count, prm->datatype);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_irecv(const dumpi_irecv* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::irecv, wall);
+  rec.peer = cv->peer(prm->source);
+  rec.tag = cv->tag(prm->tag);
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->count, prm->datatype);
+  rec.request = cv->request(prm->request);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_sendrecv(const dumpi_sendrecv* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::sendrecv, wall);
+  rec.peer = cv->peer(prm->dest);
+  rec.tag = cv->tag(prm->sendtag);
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->sendcount, prm->sendtype);
+  rec.aux.push_back(cv->peer(prm->source));
+  rec.aux.push_back(cv->tag(prm->recvtag));
+  rec.aux.push_back(cv->bytes(prm->recvcount, prm->recvtype));
+  cv->finish(wall);
+  return 1;
+}
+
+static void
+wait_one(dumpi_compact_converter* cv, dumpi_request req, const dumpi_time* wall)
+{
+  compact_record& rec = cv->start(compact_record::wait, wall);
+  rec.request = cv->request(req);
+  cv->finish(wall);
+}
+
+static int
+on_wait(const dumpi_wait* prm, convert_args)
+{
+  wait_one(dumpi_compact_converter::get(uarg), prm->request, wall);
+  return 1;
+}
+
+static int
+on_test(const dumpi_test* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  //a test that did not complete is just time spent polling
+  if (prm->flag) wait_one(cv, prm->request, wall);
+  return 1;
+}
+
+static int
+on_waitany(const dumpi_waitany* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  if (prm->index >= 0 && prm->index < prm->count){
+    wait_one(cv, prm->requests[prm->index], wall);
+  }
+  return 1;
+}
+
+static void
+wait_all(dumpi_compact_converter* cv, int count, const dumpi_request* reqs,
+         const int* indices, const dumpi_time* wall)
+{
+  compact_record& rec = cv->start(compact_record::waitall, wall);
+  for (int i=0; i < count; ++i){
+    dumpi_request req = indices ? reqs[indices[i]] : reqs[i];
+    rec.aux.push_back(cv->request(req));
+  }
+  cv->finish(wall);
+}
+
+static int
+on_waitall(const dumpi_waitall* prm, convert_args)
+{
+  wait_all(dumpi_compact_converter::get(uarg), prm->count, prm->requests, NULL, wall);
+  return 1;
+}
+
+static int
+on_testall(const dumpi_testall* prm, convert_args)
+{
+  if (prm->flag){
+    wait_all(dumpi_compact_converter::get(uarg), prm->count, prm->requests, NULL, wall);
+  }
+  return 1;
+}
+
+static int
+on_waitsome(const dumpi_waitsome* prm, convert_args)
+{
+  wait_all(dumpi_compact_converter::get(uarg), prm->outcount, prm->requests,
+           prm->indices, wall);
+  return 1;
+}
+
+static int
+on_barrier(const dumpi_barrier* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::barrier, wall);
+  rec.comm = cv->comm(prm->comm);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_bcast(const dumpi_bcast* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::bcast, wall);
+  rec.peer = prm->root;
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->count, prm->datatype);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_reduce(const dumpi_reduce* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::reduce, wall);
+  rec.peer = prm->root;
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->count, prm->datatype);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_allreduce(const dumpi_allreduce* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::allreduce, wall);
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->count, prm->datatype);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_allgather(const dumpi_allgather* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::allgather, wall);
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->sendcount, prm->sendtype);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_alltoall(const dumpi_alltoall* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::alltoall, wall);
+  rec.comm = cv->comm(prm->comm);
+  rec.bytes = cv->bytes(prm->sendcount, prm->sendtype);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_gather(const dumpi_gather* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::gather, wall);
+  rec.peer = prm->root;
+  rec.comm = cv->comm(prm->comm);
+  //only the root's receive count is significant
+  rec.bytes = cv->bytes(prm->sendcount, prm->sendtype);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_scatter(const dumpi_scatter* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::scatter, wall);
+  rec.peer = prm->root;
+  rec.comm = cv->comm(prm->comm);
+  //only the root's send count is significant
+  rec.bytes = cv->bytes(prm->recvcount, prm->recvtype);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_comm_dup(const dumpi_comm_dup* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::comm_dup, wall);
+  rec.comm = cv->comm(prm->oldcomm);
+  rec.request = cv->add_comm(prm->newcomm);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_comm_split(const dumpi_comm_split* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::comm_split, wall);
+  rec.comm = cv->comm(prm->oldcomm);
+  rec.peer = prm->color;
+  rec.tag = prm->key;
+  rec.request = cv->add_comm(prm->newcomm);
+  cv->finish(wall);
+  return 1;
+}
+
+static int
+on_comm_free(const dumpi_comm_free* prm, convert_args)
+{
+  dumpi_compact_converter* cv = dumpi_compact_converter::get(uarg);
+  compact_record& rec = cv->start(compact_record::comm_free, wall);
+  rec.comm = cv->comm(prm->comm);
+  cv->erase_comm(prm->comm);
+  cv->finish(wall);
+  return 1;
+}
+
+#define unrepresentable(fxn) \
+  static int \
+  on_##fxn(const dumpi_##fxn* prm, convert_args) \
+  { \
+    spkt_throw(sprockit::unimplemented_error, \
+      "dumpi_to_compact: MPI_" #fxn " cannot be stored in a compact trace"); \
+    return 0; \
+  }
+
+unrepresentable(send_init)
+unrepresentable(recv_init)
+unrepresentable(start)
+unrepresentable(startall)
+unrepresentable(sendrecv_replace)
+unrepresentable(testany)
+unrepresentable(testsome)
+unrepresentable(gatherv)
+unrepresentable(scatterv)
+unrepresentable(allgatherv)
+unrepresentable(alltoallv)
+unrepresentable(reduce_scatter)
+unrepresentable(scan)
+unrepresentable(comm_create)
+
+static void
+set_callbacks(libundumpi_callbacks* cbacks)
+{
+  libundumpi_clear_callbacks(cbacks);
+  cbacks->on_init = on_init;
+  cbacks->on_init_thread = on_init_thread;
+  cbacks->on_finalize = on_finalize;
+  cbacks->on_send = on_send<dumpi_send>;
+  cbacks->on_bsend = on_send<dumpi_bsend>;
+  cbacks->on_ssend = on_send<dumpi_ssend>;
+  cbacks->on_rsend = on_send<dumpi_rsend>;
+  cbacks->on_isend = on_isend<dumpi_isend>;
+  cbacks->on_ibsend = on_isend<dumpi_ibsend>;
+  cbacks->on_issend = on_isend<dumpi_issend>;
+  cbacks->on_irsend = on_isend<dumpi_irsend>;
+  cbacks->on_recv = on_recv;
+  cbacks->on_irecv = on_irecv;
+  cbacks->on_sendrecv = on_sendrecv;
+  cbacks->on_wait = on_wait;
+  cbacks->on_test = on_test;
+  cbacks->on_waitany = on_waitany;
+  cbacks->on_waitall = on_waitall;
+  cbacks->on_testall = on_testall;
+  cbacks->on_waitsome = on_waitsome;
+  cbacks->on_barrier = on_barrier;
+  cbacks->on_bcast = on_bcast;
+  cbacks->on_reduce = on_reduce;
+  cbacks->on_allreduce = on_allreduce;
+  cbacks->on_allgather = on_allgather;
+  cbacks->on_alltoall = on_alltoall;
+  cbacks->on_gather = on_gather;
+  cbacks->on_scatter = on_scatter;
+  cbacks->on_comm_dup = on_comm_dup;
+  cbacks->on_comm_split = on_comm_split;
+  cbacks->on_comm_free = on_comm_free;
+  cbacks->on_send_init = on_send_init;
+  cbacks->on_recv_init = on_recv_init;
+  cbacks->on_start = on_start;
+  cbacks->on_startall = on_startall;
+  cbacks->on_sendrecv_replace = on_sendrecv_replace;
+  cbacks->on_testany = on_testany;
+  cbacks->on_testsome = on_testsome;
+  cbacks->on_gatherv = on_gatherv;
+  cbacks->on_scatterv = on_scatterv;
+  cbacks->on_allgatherv = on_allgatherv;
+  cbacks->on_alltoallv = on_alltoallv;
+  cbacks->on_reduce_scatter = on_reduce_scatter;
+  cbacks->on_scan = on_scan;
+  cbacks->on_comm_create = on_comm_create;
+}
+
+long
+dumpi_to_compact(const std::string& dumpi_file, const std::string& compact_file)
+{
+  dumpi_profile* profile = undumpi_open(dumpi_file.c_str());
+  if (profile == NULL){
+    spkt_throw_printf(sprockit::io_error,
+      "dumpi_to_compact: unable to open %s for reading", dumpi_file.c_str());
+  }
+
+  libundumpi_callbacks cbacks;
+  set_callbacks(&cbacks);
+  dumpi_compact_converter cv(compact_file, undumpi_read_datatype_sizes(profile));
+  if (undumpi_read_stream(profile, &cbacks, &cv) != 1){
+    spkt_throw_printf(sprockit::io_error,
+      "dumpi_to_compact: failed reading %s", dumpi_file.c_str());
+  }
+  undumpi_close(profile);
+  return cv.close();
+}
+
+long
+dumpi_meta_to_compact(const std::string& metafile, const std::string& fileroot)
+{
+  dumpi_meta meta(metafile);
+  int nproc = getnumprocs(&meta);
+  long total = 0;
+  for (int rank=0; rank < nproc; ++rank){
+    std::string dumpi_file = dumpi_file_name(rank, meta.dirplusfileprefix_);
+    total += dumpi_to_compact(dumpi_file, compact_trace_file_name(rank, fileroot));
+  }
+  return total;
+}
+
+}
+}
@@ -0,0 +1,44 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_DUMPI_UTIL_DUMPI_COMPACT_H_INCLUDED
+#define SSTMAC_DUMPI_UTIL_DUMPI_COMPACT_H_INCLUDED
+
+#include <string>
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * Converts one rank of a DUMPI trace into a compact trace.
+ * Tests, waitany and waitsome are stored as the waits that completed,
+ * and calls that do not communicate are folded into the compute time.
+ * @param dumpi_file The DUMPI trace file of the rank
+ * @param compact_file The compact trace file to write
+ * @return The size of the compact trace file in bytes
+ * @throw sprockit::unimplemented_error for calls a compact trace cannot store
+ */
+long
+dumpi_to_compact(const std::string& dumpi_file, const std::string& compact_file);
+
+/**
+ * Converts every rank of a DUMPI trace into a compact trace
+ * @param metafile The .meta file of the DUMPI trace
+ * @param fileroot The compact trace of each rank goes to fileroot-NNNN.sct
+ * @return The total size of the compact trace in bytes
+ */
+long
+dumpi_meta_to_compact(const std::string& metafile, const std::string& fileroot);
+
+}
+}
+
+#endif
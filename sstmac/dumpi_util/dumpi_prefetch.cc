@@ -0,0 +1,256 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/dumpi_util/dumpi_prefetch.h>
+#include <sprockit/errors.h>
+#include <sprockit/statics.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace sstmac {
+namespace sw {
+
+static sprockit::need_delete_statics<dumpi_prefetcher> del_statics;
+
+dumpi_prefetcher* dumpi_prefetcher::instance_ = nullptr;
+static pthread_mutex_t instance_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+dumpi_prefetcher::dumpi_prefetcher(long window, int max_files) :
+  max_files_(std::max(1, max_files)),
+  num_open_(0),
+  peak_open_(0),
+  bytes_read_(0),
+  started_(false),
+  stopped_(false),
+  busy_(false),
+  current_done_(false)
+{
+  long page = sysconf(_SC_PAGESIZE);
+  window_ = std::max(page, (window + page - 1) / page * page);
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&work_cond_, NULL);
+  pthread_cond_init(&idle_cond_, NULL);
+}
+
+dumpi_prefetcher::~dumpi_prefetcher()
+{
+  pthread_mutex_lock(&mutex_);
+  stopped_ = true;
+  pthread_cond_signal(&work_cond_);
+  pthread_mutex_unlock(&mutex_);
+  if (started_){
+    pthread_join(thread_, NULL);
+  }
+  for (trace_file& file : queue_){
+    if (file.fd >= 0) ::close(file.fd);
+  }
+  pthread_cond_destroy(&idle_cond_);
+  pthread_cond_destroy(&work_cond_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+dumpi_prefetcher*
+dumpi_prefetcher::instance(long window, int max_files)
+{
+  pthread_mutex_lock(&instance_mutex);
+  if (!instance_){
+    instance_ = new dumpi_prefetcher(window, max_files);
+  }
+  pthread_mutex_unlock(&instance_mutex);
+  return instance_;
+}
+
+void
+dumpi_prefetcher::delete_statics()
+{
+  delete instance_;
+  instance_ = nullptr;
+}
+
+void
+dumpi_prefetcher::add(const std::string& fname)
+{
+  pthread_mutex_lock(&mutex_);
+  if (!started_){
+    int status = pthread_create(&thread_, NULL, run, this);
+    if (status != 0){
+      pthread_mutex_unlock(&mutex_);
+      spkt_throw(sprockit::os_error,
+          "dumpi_prefetcher::add: failed creating pthread");
+    }
+    started_ = true;
+  }
+  trace_file file;
+  file.name = fname;
+  file.offset = 0;
+  file.size = -1;
+  file.fd = -1;
+  int in_rotation = queue_.size() + (busy_ ? 1 : 0);
+  if (in_rotation < max_files_){
+    queue_.push_back(file);
+  } else {
+    waiting_.push_back(file);
+  }
+  pthread_cond_signal(&work_cond_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+void
+dumpi_prefetcher::done(const std::string& fname)
+{
+  pthread_mutex_lock(&mutex_);
+  if (busy_ && current_ == fname){
+    //the I/O thread is reading from it right now and retires it when finished
+    current_done_ = true;
+  }
+  auto is_done = [&](const trace_file& f){ return f.name == fname; };
+  waiting_.erase(std::remove_if(waiting_.begin(), waiting_.end(), is_done), waiting_.end());
+  auto end = std::stable_partition(queue_.begin(), queue_.end(),
+    [&](const trace_file& f){ return !is_done(f); });
+  std::deque<trace_file> finished(end, queue_.end());
+  queue_.erase(end, queue_.end());
+  for (trace_file& file : finished){
+    retire(file);
+  }
+  pthread_mutex_unlock(&mutex_);
+}
+
+void
+dumpi_prefetcher::wait()
+{
+  pthread_mutex_lock(&mutex_);
+  while (!queue_.empty() || !waiting_.empty() || busy_){
+    pthread_cond_wait(&idle_cond_, &mutex_);
+  }
+  pthread_mutex_unlock(&mutex_);
+}
+
+int
+dumpi_prefetcher::peak_open_files()
+{
+  pthread_mutex_lock(&mutex_);
+  int peak = peak_open_;
+  pthread_mutex_unlock(&mutex_);
+  return peak;
+}
+
+void
+dumpi_prefetcher::retire(trace_file& file)
+{
+  if (file.fd >= 0){
+    ::close(file.fd);
+    file.fd = -1;
+    --num_open_;
+  }
+  int in_rotation = queue_.size() + (busy_ ? 1 : 0);
+  while (!waiting_.empty() && in_rotation < max_files_){
+    queue_.push_back(waiting_.front());
+    waiting_.pop_front();
+    ++in_rotation;
+  }
+}
+
+long
+dumpi_prefetcher::bytes_read()
+{
+  pthread_mutex_lock(&mutex_);
+  long bytes = bytes_read_;
+  pthread_mutex_unlock(&mutex_);
+  return bytes;
+}
+
+void*
+dumpi_prefetcher::run(void* args)
+{
+  static_cast<dumpi_prefetcher*>(args)->prefetch_loop();
+  return NULL;
+}
+
+void
+dumpi_prefetcher::prefetch_loop()
+{
+  pthread_mutex_lock(&mutex_);
+  while (true){
+    while (queue_.empty() && !stopped_){
+      pthread_cond_wait(&work_cond_, &mutex_);
+    }
+    if (stopped_) break;
+
+    trace_file file = queue_.front();
+    queue_.pop_front();
+    busy_ = true;
+    current_ = file.name;
+    current_done_ = false;
+    bool was_open = file.fd >= 0;
+    pthread_mutex_unlock(&mutex_);
+
+    long offset = file.offset;
+    bool more = warm(file);
+
+    pthread_mutex_lock(&mutex_);
+    busy_ = false;
+    bytes_read_ += file.offset - offset;
+    if (!was_open && file.fd >= 0){
+      ++num_open_;
+      peak_open_ = std::max(peak_open_, num_open_);
+    }
+    if (more && !current_done_){
+      queue_.push_back(file);
+    } else {
+      retire(file);
+    }
+    if (queue_.empty() && waiting_.empty()){
+      pthread_cond_broadcast(&idle_cond_);
+    }
+  }
+  busy_ = false;
+  pthread_cond_broadcast(&idle_cond_);
+  pthread_mutex_unlock(&mutex_);
+}
+
+bool
+dumpi_prefetcher::warm(trace_file& file)
+{
+  if (file.fd < 0){
+    //a missing file is reported by undumpi when the rank opens it
+    file.fd = ::open(file.name.c_str(), O_RDONLY);
+    if (file.fd < 0) return false;
+    struct stat st;
+    file.size = fstat(file.fd, &st) == 0 ? st.st_size : 0;
+  }
+  int fd = file.fd;
+
+  long length = std::min(window_, file.size - file.offset);
+  if (length > 0){
+    void* map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, file.offset);
+    if (map == MAP_FAILED){
+      return false;
+    }
+    madvise(map, length, MADV_WILLNEED);
+    //touch every page so the window is resident before we move on
+    long page = sysconf(_SC_PAGESIZE);
+    const volatile char* bytes = static_cast<const char*>(map);
+    char sum = 0;
+    for (long i=0; i < length; i += page){
+      sum += bytes[i];
+    }
+    (void) sum;
+    munmap(map, length);
+    file.offset += length;
+  }
+  return file.offset < file.size;
+}
+
+}
+}
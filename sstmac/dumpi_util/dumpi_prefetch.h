@@ -0,0 +1,145 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_DUMPI_UTIL_DUMPI_PREFETCH_H_INCLUDED
+#define SSTMAC_DUMPI_UTIL_DUMPI_PREFETCH_H_INCLUDED
+
+#include <pthread.h>
+#include <deque>
+#include <string>
+
+namespace sstmac {
+namespace sw {
+
+/**
+ * Reads dumpi trace files into the page cache on a background I/O thread
+ * so the ranks replaying a trace do not stall the simulation on the disk.
+ * All ranks move through their traces at roughly the same pace in
+ * simulated time, so the files are warmed one window at a time in round
+ * robin over the order they were added in (rank order) rather than one
+ * whole file after another. At most max_files files are in the rotation,
+ * each kept open until it is warmed or done; later files wait their turn.
+ * Only one window is mapped at a time, no matter how many ranks the trace has.
+ */
+class dumpi_prefetcher
+{
+ public:
+  /**
+   * @param window The bytes mapped and read per step of the round robin,
+   *               rounded up to a whole number of pages
+   * @param max_files The most files open and warmed in round robin at once
+   */
+  dumpi_prefetcher(long window, int max_files);
+
+  /** Stops the I/O thread, abandoning any files not yet warmed */
+  ~dumpi_prefetcher();
+
+  /**
+   * Queues a file to be warmed, starting the I/O thread on first use
+   * @param fname The trace file of a rank
+   */
+  void
+  add(const std::string& fname);
+
+  /**
+   * Stops warming a file the rank has finished replaying
+   * @param fname The trace file of a rank
+   */
+  void
+  done(const std::string& fname);
+
+  /** Blocks until every queued file is warmed or done */
+  void
+  wait();
+
+  /** @return The total bytes read ahead so far */
+  long
+  bytes_read();
+
+  long
+  window() const {
+    return window_;
+  }
+
+  /** @return The most files the I/O thread has had open at once */
+  int
+  peak_open_files();
+
+  /**
+   * The prefetcher shared by all parsedumpi ranks in this process
+   * @param window The window to create it with if it does not exist yet
+   * @param max_files The file limit to create it with if it does not exist yet
+   */
+  static dumpi_prefetcher*
+  instance(long window, int max_files);
+
+  static void
+  delete_statics();
+
+ private:
+  struct trace_file {
+    std::string name;
+    long offset;
+    long size;
+    /** Open while the file is in the rotation, -1 before its first window */
+    int fd;
+  };
+
+  static void*
+  run(void* args);
+
+  void
+  prefetch_loop();
+
+  /**
+   * Maps and touches the next window of the file
+   * @return Whether the file has more left to read
+   */
+  bool
+  warm(trace_file& file);
+
+  /**
+   * Takes the file out of the rotation and lets the next waiting file in.
+   * Must be called with the mutex held.
+   */
+  void
+  retire(trace_file& file);
+
+  long window_;
+  int max_files_;
+  int num_open_;
+  int peak_open_;
+  long bytes_read_;
+  bool started_;
+  bool stopped_;
+  /** Whether the I/O thread is working on a file popped from the queue */
+  bool busy_;
+  /** The file the I/O thread is working on, if busy */
+  std::string current_;
+  /** Whether the current file was marked done while being read */
+  bool current_done_;
+  /** Files in the rotation */
+  std::deque<trace_file> queue_;
+  /** Files waiting for a slot in the rotation */
+  std::deque<trace_file> waiting_;
+  pthread_t thread_;
+  pthread_mutex_t mutex_;
+  pthread_cond_t work_cond_;
+  pthread_cond_t idle_cond_;
+
+  static dumpi_prefetcher* instance_;
+
+};
+
+}
+}
+
+#endif
@@ -13,7 +13,8 @@ namespace hw {
 
 packetizer::packetizer(sprockit::sim_parameters* params, event_scheduler* parent) :
   event_subcomponent(parent), //no self events
-  notifier_(nullptr)
+  notifier_(nullptr),
+  train_length_(1)
 {
   packet_size_ = params->get_byte_length_param("mtu");
   double bw = params->get_bandwidth_param("bandwidth");
@@ -68,7 +69,15 @@ packetizer::sendWhatYouCan(int vn)
         pkt_debug("no space to send %d bytes on vn %d", num_bytes, vn);
         return;
       }
-      pkt_debug("injecting %d bytes on vn %d", num_bytes, vn);
+      //coalesce following packets into a train while there is space
+      int num_packets = 1;
+      while (num_packets < train_length_ && num_bytes < next.bytes_left){
+        long train_bytes = std::min(next.bytes_left, num_bytes + packet_size_);
+        if (!spaceToSend(vn, train_bytes*8)) break;
+        num_bytes = train_bytes;
+        ++num_packets;
+      }
+      pkt_debug("injecting %d bytes in %d packets on vn %d", num_bytes, num_packets, vn);
       inject(vn, num_bytes, next.offset, next.msg);
 
       next.offset += num_bytes;
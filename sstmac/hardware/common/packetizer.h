@@ -83,6 +83,9 @@ class packetizer :
   packetizer(sprockit::sim_parameters* params,
              event_scheduler* parent);
 
+  /** The most packets that can be coalesced into a single injection */
+  int train_length_;
+
   void bytesArrived(int vn, uint64_t unique_id, int bytes, message* parent);
 
 };
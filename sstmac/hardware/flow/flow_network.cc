@@ -0,0 +1,181 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/hardware/flow/flow_network.h>
+#include <sprockit/errors.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+
+namespace sstmac {
+namespace hw {
+
+int
+flow_network::add_link(double bandwidth)
+{
+  if (bandwidth <= 0){
+    spkt_throw_printf(sprockit::value_error,
+      "flow_network: link bandwidth must be positive, got %f", bandwidth);
+  }
+  link l;
+  l.bandwidth = bandwidth;
+  l.residual = 0;
+  l.num_unfixed = 0;
+  l.mark = 0;
+  links_.push_back(l);
+  return links_.size() - 1;
+}
+
+int
+flow_network::add_flow(const std::vector<int>& links, double bytes, double now)
+{
+  if (links.empty()){
+    spkt_throw(sprockit::value_error,
+      "flow_network: a flow must cross at least one link");
+  }
+
+  int id;
+  if (free_flows_.empty()){
+    id = flows_.size();
+    flows_.emplace_back();
+  } else {
+    id = free_flows_.back();
+    free_flows_.pop_back();
+  }
+
+  flow& f = flows_[id];
+  f.links = links;
+  f.remaining = bytes;
+  f.rate = 0;
+  f.last_update = now;
+  f.mark = 0;
+  f.fixed = false;
+  for (int l : links){
+    links_[l].flows.push_back(id);
+    dirty_links_.push_back(l);
+  }
+  return id;
+}
+
+void
+flow_network::remove_flow(int id)
+{
+  flow& f = flows_[id];
+  for (int l : f.links){
+    std::vector<int>& on_link = links_[l].flows;
+    auto it = std::find(on_link.begin(), on_link.end(), id);
+    *it = on_link.back();
+    on_link.pop_back();
+    //only flows that shared a link with this one can speed up
+    dirty_links_.push_back(l);
+  }
+  f.links.clear();
+  free_flows_.push_back(id);
+}
+
+void
+flow_network::update_rates(double now, std::vector<int>& changed)
+{
+  if (dirty_links_.empty()) return;
+
+  collect_component();
+  dirty_links_.clear();
+  fill(now, changed);
+}
+
+void
+flow_network::collect_component()
+{
+  ++mark_;
+  comp_links_.clear();
+  comp_flows_.clear();
+  for (int l : dirty_links_){
+    if (links_[l].mark != mark_){
+      links_[l].mark = mark_;
+      comp_links_.push_back(l);
+    }
+  }
+
+  //comp_links_ doubles as the BFS queue
+  for (int next=0; next < comp_links_.size(); ++next){
+    const link& l = links_[comp_links_[next]];
+    for (int fid : l.flows){
+      flow& f = flows_[fid];
+      if (f.mark == mark_) continue;
+      f.mark = mark_;
+      comp_flows_.push_back(fid);
+      for (int l2 : f.links){
+        if (links_[l2].mark != mark_){
+          links_[l2].mark = mark_;
+          comp_links_.push_back(l2);
+        }
+      }
+    }
+  }
+}
+
+void
+flow_network::fill(double now, std::vector<int>& changed)
+{
+  //progress so far was made at the old rates
+  for (int fid : comp_flows_){
+    flow& f = flows_[fid];
+    f.remaining = std::max(0.0, f.remaining - f.rate * (now - f.last_update));
+    f.last_update = now;
+    f.fixed = false;
+  }
+
+  typedef std::pair<double,int> share_t;
+  std::priority_queue<share_t, std::vector<share_t>, std::greater<share_t> > shares;
+  for (int lid : comp_links_){
+    link& l = links_[lid];
+    l.residual = l.bandwidth;
+    l.num_unfixed = l.flows.size();
+    if (l.num_unfixed > 0){
+      shares.push(share_t(l.residual / l.num_unfixed, lid));
+    }
+  }
+
+  //the most contended link fixes the rate of every flow crossing it
+  //fixing flows at the smallest share only raises the share of other links,
+  //so an entry below a link's current share is pushed back rather than updated
+  while (!shares.empty()){
+    share_t top = shares.top();
+    shares.pop();
+    link& l = links_[top.second];
+    if (l.num_unfixed == 0) continue;
+
+    double share = l.residual / l.num_unfixed;
+    if (share != top.first){
+      shares.push(share_t(share, top.second));
+      continue;
+    }
+
+    for (int fid : l.flows){
+      flow& f = flows_[fid];
+      if (f.fixed) continue;
+      f.fixed = true;
+      if (f.rate != share){
+        f.rate = share;
+        changed.push_back(fid);
+      }
+      for (int lid : f.links){
+        link& other = links_[lid];
+        other.residual -= share;
+        --other.num_unfixed;
+      }
+    }
+  }
+}
+
+}
+}
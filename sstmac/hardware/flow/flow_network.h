@@ -0,0 +1,135 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef FLOW_NETWORK_H
+#define FLOW_NETWORK_H
+
+#include <vector>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief Tracks the flows active on a set of links and shares link
+ *        bandwidth between them max-min fairly.
+ * Rates are only recomputed when a flow arrives or departs, and then
+ * only for the flows that (transitively) share a link with it.
+ * Time is in seconds and sizes in bytes.
+ */
+class flow_network
+{
+ public:
+  flow_network() : mark_(0) {}
+
+  int
+  add_link(double bandwidth);
+
+  int
+  num_links() const {
+    return links_.size();
+  }
+
+  /**
+   * Start a new flow. Its rate is zero until the next #update_rates.
+   * @param links The links the flow crosses
+   * @param bytes The number of bytes still to send
+   * @param now   The current time
+   * @return The id of the new flow
+   */
+  int
+  add_flow(const std::vector<int>& links, double bytes, double now);
+
+  /**
+   * Finish a flow. The flows it competed with keep their rates
+   * until the next #update_rates.
+   */
+  void
+  remove_flow(int id);
+
+  /**
+   * Recompute the rates of every flow that shares a link, directly or through
+   * other flows, with a flow added or removed since the last update.
+   * Many arrivals and departures at the same time only cost one update.
+   * @param changed [out] The flows whose rate changed
+   */
+  void
+  update_rates(double now, std::vector<int>& changed);
+
+  double
+  rate(int id) const {
+    return flows_[id].rate;
+  }
+
+  /**
+   * @return The time the flow completes at its current rate
+   */
+  double
+  completion_time(int id) const {
+    const flow& f = flows_[id];
+    return f.last_update + f.remaining / f.rate;
+  }
+
+  int
+  num_active_flows() const {
+    return flows_.size() - free_flows_.size();
+  }
+
+ private:
+  struct link {
+    double bandwidth;
+    /** The active flows crossing the link */
+    std::vector<int> flows;
+    /** Scratch space for the water filling */
+    double residual;
+    int num_unfixed;
+    int mark;
+  };
+
+  struct flow {
+    std::vector<int> links;
+    double remaining;
+    double rate;
+    /** The time remaining was last brought up to date */
+    double last_update;
+    int mark;
+    bool fixed;
+  };
+
+  /**
+   * Collect every flow reachable through shared links from the dirty links
+   */
+  void
+  collect_component();
+
+  /**
+   * Max-min fair rates for the flows in comp_flows_
+   * via progressive filling of the links in comp_links_
+   */
+  void
+  fill(double now, std::vector<int>& changed);
+
+  std::vector<link> links_;
+  std::vector<flow> flows_;
+  std::vector<int> free_flows_;
+
+  /** Links whose set of flows changed since the last update */
+  std::vector<int> dirty_links_;
+
+  std::vector<int> comp_links_;
+  std::vector<int> comp_flows_;
+  int mark_;
+
+};
+
+}
+}
+
+#endif // FLOW_NETWORK_H
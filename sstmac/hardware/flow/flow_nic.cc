@@ -0,0 +1,89 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/hardware/flow/flow_nic.h>
+#include <sstmac/hardware/network/network_message.h>
+#include <sprockit/util.h>
+#include <sprockit/sim_parameters.h>
+
+namespace sstmac {
+namespace hw {
+
+SpktRegister("flow", nic, flow_nic,
+            "implements a nic that sends every message as a flow through the flow switch");
+
+flow_nic::flow_nic(sprockit::sim_parameters* params, node* parent) :
+  nic(params, parent)
+{
+  //no message is too small to share bandwidth - this also keeps small messages
+  //from being acked here and again by the switch when their flow completes
+  negligible_size_ = -1;
+}
+
+flow_nic::~flow_nic()
+{
+}
+
+void
+flow_nic::do_send(network_message* msg)
+{
+  nic_debug("flow injection at %8.4e for message %s",
+            now().sec(), msg->to_string().c_str());
+  //the switch acks the message once its flow completes
+  send_to_link(logp_switch_, msg);
+}
+
+void
+flow_nic::send_to_logp_switch(network_message* netmsg)
+{
+  netmsg->set_needs_ack(false);
+  nic::send_to_logp_switch(netmsg);
+}
+
+void
+flow_nic::connect_output(
+  sprockit::sim_parameters* params,
+  int src_outport,
+  int dst_inport,
+  event_handler* mod)
+{
+  if (src_outport == Injection){
+    //ignore
+  } else if (src_outport == LogP){
+    nic_debug("connecting to flow switch");
+    logp_switch_ = mod;
+  } else {
+    spkt_abort_printf("Invalid switch port %d in flow_nic::connect_output", src_outport);
+  }
+}
+
+void
+flow_nic::connect_input(
+  sprockit::sim_parameters* params,
+  int src_outport,
+  int dst_inport,
+  event_handler* mod)
+{
+  //nothing needed
+}
+
+link_handler*
+flow_nic::payload_handler(int port) const
+{
+#if SSTMAC_INTEGRATED_SST_CORE
+  return new SST::Event::Handler<nic>(const_cast<flow_nic*>(this), &nic::mtl_handle);
+#else
+  return mtl_handler();
+#endif
+}
+
+}
+}
@@ -0,0 +1,81 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef FLOW_NIC_H
+#define FLOW_NIC_H
+
+#include <sstmac/hardware/nic/nic.h>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief Implements a NIC that hands every message to the flow switch.
+ * Injection bandwidth is shared by the flow switch along with the
+ * rest of the route, so the NIC itself adds no delay.
+ */
+class flow_nic :
+  public nic
+{
+ public:
+  flow_nic(sprockit::sim_parameters* params, node* parent);
+
+  virtual ~flow_nic();
+
+  virtual void
+  connect_output(
+    sprockit::sim_parameters* params,
+    int src_outport,
+    int dst_inport,
+    event_handler* handler) override;
+
+  virtual void
+  connect_input(
+    sprockit::sim_parameters* params,
+    int src_outport,
+    int dst_inport,
+    event_handler* handler) override;
+
+  virtual std::string
+  to_string() const override {
+    return "flow nic";
+  }
+
+  link_handler*
+  credit_handler(int port) const override {
+    return nullptr; //should never handle credits
+  }
+
+  link_handler*
+  payload_handler(int port) const override;
+
+  /**
+   * The flow switch acks every message it is given that asks for one,
+   * but nothing waits on acks for messages sent outside the NIC's queues
+   * @param netmsg The message to send without an injection ack
+   */
+  void
+  send_to_logp_switch(network_message* netmsg) override;
+
+ protected:
+  /**
+    Start the message sending and inject it into the network
+    @param payload The network message to send
+  */
+  virtual void
+  do_send(network_message* msg) override;
+
+};
+
+}
+} // end of namespace sstmac.
+
+#endif // FLOW_NIC_H
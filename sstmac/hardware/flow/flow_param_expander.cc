@@ -0,0 +1,33 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/hardware/flow/flow_param_expander.h>
+#include <sprockit/sim_parameters.h>
+
+namespace sstmac {
+namespace hw {
+
+SpktRegister("flow", sstmac::param_expander, flow_param_expander);
+
+void
+flow_param_expander::expand(sprockit::sim_parameters* params)
+{
+  logp_param_expander::expand(params);
+
+  sprockit::sim_parameters* node_params = params->get_optional_namespace("node");
+  sprockit::sim_parameters* nic_params = node_params->get_optional_namespace("nic");
+  sprockit::sim_parameters* switch_params = params->get_optional_namespace("switch");
+  nic_params->add_param_override("model", "flow");
+  switch_params->add_param_override("model", "flow");
+}
+
+}
+}
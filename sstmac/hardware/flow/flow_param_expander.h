@@ -0,0 +1,35 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef FLOW_PARAM_EXPANDER_H
+#define FLOW_PARAM_EXPANDER_H
+
+#include <sstmac/hardware/logp/logp_param_expander.h>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * The flow model reads the same link and injection parameters as LogP,
+ * so only the component models differ
+ */
+class flow_param_expander :
+  public logp_param_expander
+{
+  public:
+    virtual void
+    expand(sprockit::sim_parameters* params);
+};
+
+}
+}
+
+#endif // FLOW_PARAM_EXPANDER_H
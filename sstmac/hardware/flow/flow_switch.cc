@@ -0,0 +1,337 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/hardware/flow/flow_switch.h>
+#include <sstmac/hardware/network/network_message.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <sstmac/hardware/router/routable.h>
+#include <sstmac/common/event_callback.h>
+#include <sprockit/util.h>
+#include <sprockit/sim_parameters.h>
+#include <algorithm>
+#include <functional>
+
+namespace sstmac {
+namespace hw {
+
+SpktRegister("flow", network_switch, flow_switch,
+  "A switch that models messages as flows sharing link bandwidth max-min fairly");
+
+flow_switch::flow_switch(sprockit::sim_parameters *params, uint64_t id, event_manager *mgr) :
+  update_pending_(false),
+  check_pending_(false),
+  check_version_(0),
+  network_switch(params, id, mgr, device_id::logp_overlay)
+{
+  sprockit::sim_parameters* link_params = params->get_namespace("link");
+  sprockit::sim_parameters* ej_params = params->get_namespace("ejection");
+
+  link_bw_ = link_params->get_bandwidth_param("bandwidth");
+  if (link_params->has_param("send_latency")){
+    hop_latency_ = link_params->get_time_param("send_latency");
+  } else {
+    hop_latency_ = link_params->get_time_param("latency");
+  }
+
+  inj_bw_ = ej_params->get_optional_bandwidth_param("bandwidth", link_bw_);
+  timestamp inj_lat;
+  if (ej_params->has_param("send_latency")){
+    inj_lat = ej_params->get_time_param("send_latency");
+  } else {
+    inj_lat = ej_params->get_time_param("latency");
+  }
+  dbl_inj_lat_ = 2*inj_lat;
+
+  //same default as the nic - small messages are not worth a rate update
+  negligible_size_ = params->get_optional_byte_length_param("negligible_size", 256);
+
+  nics_.resize(top_->max_node_id());
+  build_links();
+
+#if !SSTMAC_INTEGRATED_SST_CORE
+  mtl_handler_ = new_handler(this, &flow_switch::handle);
+#endif
+}
+
+flow_switch::~flow_switch()
+{
+#if !SSTMAC_INTEGRATED_SST_CORE
+  delete mtl_handler_;
+#endif
+}
+
+void
+flow_switch::build_links()
+{
+  max_num_ports_ = top_->max_num_ports();
+  int num_switch_ids = top_->max_switch_id();
+  port_link_.assign(num_switch_ids * max_num_ports_, -1);
+  port_dst_.assign(num_switch_ids * max_num_ports_, 0);
+
+  std::vector<topology::connection> conns;
+  for (int i=0; i < num_switch_ids; ++i){
+    switch_id sid(i);
+    if (!top_->switch_id_slot_filled(sid)) continue;
+    top_->connected_outports(sid, conns);
+    for (topology::connection& conn : conns){
+      int idx = sid * max_num_ports_ + conn.src_outport;
+      port_link_[idx] = network_.add_link(link_bw_);
+      port_dst_[idx] = conn.dst;
+    }
+  }
+
+  //every node has its own injection and ejection link
+  int num_node_ids = top_->max_node_id();
+  injection_link_.assign(num_node_ids, -1);
+  ejection_link_.assign(num_node_ids, -1);
+  for (int i=0; i < num_node_ids; ++i){
+    node_id nid(i);
+    if (!top_->node_id_slot_filled(nid)) continue;
+    injection_link_[i] = network_.add_link(inj_bw_);
+    ejection_link_[i] = network_.add_link(inj_bw_);
+  }
+  switch_debug("flow switch built %d links", network_.num_links());
+}
+
+link_handler*
+flow_switch::payload_handler(int port) const
+{
+#if SSTMAC_INTEGRATED_SST_CORE
+  return new SST::Event::Handler<flow_switch>(
+        const_cast<flow_switch*>(this), &flow_switch::handle);
+#else
+  return mtl_handler_;
+#endif
+}
+
+void
+flow_switch::connect_output(sprockit::sim_parameters *params,
+                            int src_outport, int dst_inport,
+                            event_handler *mod)
+{
+  if (dst_inport == Node){
+    node_id nid = src_outport;
+    switch_debug("Connecting flow switch to NIC %d", nid);
+    nics_[nid] = mod;
+  } else if (dst_inport == Switch){
+    spkt_abort_printf("flow_switch: the flow model can only run on a single rank");
+  } else {
+    spkt_abort_printf("Invalid inport %d in flow_switch::connect_output", dst_inport);
+  }
+}
+
+void
+flow_switch::connect_input(sprockit::sim_parameters *params,
+                           int src_outport, int dst_inport,
+                           event_handler *mod)
+{
+  //no-op
+}
+
+int
+flow_switch::route(node_id src, node_id dst, std::vector<int>& links)
+{
+  int port;
+  switch_id cur = top_->node_to_injection_switch(src, port);
+  switch_id ej = top_->node_to_ejection_switch(dst, port);
+  links.clear();
+  links.push_back(injection_link_[src]);
+
+  routable::path path;
+  int num_hops = 0;
+  int max_hops = top_->max_switch_id();
+  while (cur != ej){
+    top_->minimal_route_to_switch(cur, ej, path);
+    int idx = cur * max_num_ports_ + path.outport;
+    if (num_hops == max_hops || path.outport < 0 || path.outport >= max_num_ports_
+        || port_link_[idx] < 0){
+      spkt_abort_printf("flow_switch: no minimal route from switch %d to %d for %d->%d",
+                        int(cur), int(ej), int(src), int(dst));
+    }
+    links.push_back(port_link_[idx]);
+    cur = port_dst_[idx];
+    ++num_hops;
+  }
+
+  links.push_back(ejection_link_[dst]);
+  return num_hops;
+}
+
+void
+flow_switch::handle(event* ev)
+{
+  //this should only handle messages from local nics
+  network_message* msg = safe_cast(network_message, ev);
+  node_id src = msg->fromaddr();
+  node_id dst = msg->toaddr();
+
+  int num_hops = route(src, dst, path_);
+  long num_bytes = msg->byte_length();
+  switch_debug("starting flow %d->%d over %d hops for %ld bytes: %s",
+               int(src), int(dst), num_hops, num_bytes, msg->to_string().c_str());
+  if (num_bytes <= negligible_size_){
+    //too small to matter to other flows - only pays latency like the LogP overlay
+    if (msg->needs_ack()){
+      send_to_link(nics_[src], msg->clone_injection_ack());
+    }
+    deliver(msg, num_hops, timestamp(num_bytes / inj_bw_));
+    return;
+  }
+
+  int id = network_.add_flow(path_, num_bytes, now().sec());
+  if (id >= flows_.size()){
+    flows_.resize(id+1);
+  }
+  active_flow& f = flows_[id];
+  f.msg = msg;
+  f.num_hops = num_hops;
+  schedule_update();
+}
+
+void
+flow_switch::schedule_update()
+{
+  if (!update_pending_){
+    update_pending_ = true;
+    send_now_self_event_queue(new_callback(this, &flow_switch::update_rates));
+  }
+}
+
+void
+flow_switch::update_rates()
+{
+  update_pending_ = false;
+  changed_.clear();
+  network_.update_rates(now().sec(), changed_);
+
+  timestamp t_now = now();
+  for (int id : changed_){
+    active_flow& f = flows_[id];
+    f.due = timestamp(network_.completion_time(id));
+    //rounding to ticks must never put the completion in the past
+    if (f.due < t_now) f.due = t_now;
+    //a flow that slowed down keeps its early entry and is pushed back when it pops
+    if (!f.queued || f.due < f.queued_time){
+      ++f.version;
+      push_completion(id, f.due);
+    }
+  }
+  compact_completions();
+  schedule_check();
+}
+
+void
+flow_switch::push_completion(int id, timestamp time)
+{
+  active_flow& f = flows_[id];
+  f.queued = true;
+  f.queued_time = time;
+  completion c;
+  c.time = time;
+  c.id = id;
+  c.version = f.version;
+  completions_.push_back(c);
+  std::push_heap(completions_.begin(), completions_.end(), std::greater<completion>());
+}
+
+void
+flow_switch::compact_completions()
+{
+  //every speedup leaves an old entry behind in the heap
+  if (completions_.size() < 2*network_.num_active_flows() + 1024){
+    return;
+  }
+
+  auto stale = [this](const completion& c){
+    return c.version != flows_[c.id].version;
+  };
+  completions_.erase(std::remove_if(completions_.begin(), completions_.end(), stale),
+                     completions_.end());
+  std::make_heap(completions_.begin(), completions_.end(), std::greater<completion>());
+}
+
+void
+flow_switch::schedule_check()
+{
+  //drop completions superseded by a later rate change
+  while (!completions_.empty()){
+    const completion& c = completions_.front();
+    if (c.version == flows_[c.id].version) break;
+    std::pop_heap(completions_.begin(), completions_.end(), std::greater<completion>());
+    completions_.pop_back();
+  }
+  if (completions_.empty()) return;
+
+  timestamp next = completions_.front().time;
+  if (!check_pending_ || next < next_check_){
+    //any check already scheduled for later will see a stale version
+    ++check_version_;
+    check_pending_ = true;
+    next_check_ = next;
+    send_self_event_queue(next,
+      new_callback(this, &flow_switch::check_completions, check_version_));
+  }
+}
+
+void
+flow_switch::check_completions(uint32_t check_version)
+{
+  if (check_version != check_version_){
+    return;
+  }
+  check_pending_ = false;
+
+  timestamp t_now = now();
+  bool any_done = false;
+  while (!completions_.empty() && completions_.front().time <= t_now){
+    completion c = completions_.front();
+    std::pop_heap(completions_.begin(), completions_.end(), std::greater<completion>());
+    completions_.pop_back();
+    active_flow& f = flows_[c.id];
+    if (c.version != f.version) continue;
+    if (f.due > c.time){
+      push_completion(c.id, f.due);
+      continue;
+    }
+
+    network_message* msg = f.msg;
+    f.msg = nullptr;
+    f.queued = false;
+    ++f.version;
+    network_.remove_flow(c.id);
+    any_done = true;
+
+    switch_debug("finished flow %d->%d: %s",
+                 int(msg->fromaddr()), int(msg->toaddr()), msg->to_string().c_str());
+    if (msg->needs_ack()){
+      //the last byte has left the source
+      send_to_link(nics_[msg->fromaddr()], msg->clone_injection_ack());
+    }
+    deliver(msg, f.num_hops, timestamp(0));
+  }
+
+  if (any_done){
+    //flows finishing together only cost one update
+    schedule_update();
+  } else {
+    schedule_check();
+  }
+}
+
+void
+flow_switch::deliver(network_message* msg, int num_hops, timestamp extra_delay)
+{
+  timestamp delay = extra_delay + num_hops * hop_latency_ + dbl_inj_lat_;
+  send_delayed_to_link(delay, nics_[msg->toaddr()], msg);
+}
+
+}
+}
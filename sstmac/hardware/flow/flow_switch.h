@@ -0,0 +1,188 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef FLOW_SWITCH_H
+#define FLOW_SWITCH_H
+
+#include <sstmac/hardware/switch/network_switch.h>
+#include <sstmac/hardware/flow/flow_network.h>
+#include <sstmac/hardware/network/network_message_fwd.h>
+#include <sstmac/common/event_handler.h>
+#include <vector>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief Implements a switch that models each message as a single flow
+ *        along its minimal route. Flows sharing a link split its bandwidth
+ *        max-min fairly, and rates only change when a flow starts or ends.
+ * Like the LogP switch, a single flow switch stands in for the whole network.
+ */
+class flow_switch :
+  public network_switch
+{
+ public:
+  typedef enum {
+    Node,
+    Switch
+  } Port;
+
+  flow_switch(sprockit::sim_parameters* params, uint64_t id, event_manager* mgr);
+
+  virtual ~flow_switch();
+
+  void
+  handle(event* ev);
+
+  std::string
+  to_string() const override {
+    return "flow switch";
+  }
+
+  int queue_length(int port) const override {
+    return 0;
+  }
+
+  void connect_output(sprockit::sim_parameters *params,
+                      int src_outport, int dst_inport,
+                      event_handler* handler) override;
+
+  void connect_input(sprockit::sim_parameters *params,
+                     int src_outport, int dst_inport,
+                     event_handler* handler) override;
+
+  link_handler*
+  payload_handler(int port) const override;
+
+  link_handler*
+  credit_handler(int port) const override {
+    return nullptr;
+  }
+
+ private:
+  struct active_flow {
+    active_flow() : msg(nullptr), num_hops(0), version(0), queued(false) {}
+    network_message* msg;
+    int num_hops;
+    /** Bumped whenever an earlier completion is queued so the old entry can be skipped */
+    uint32_t version;
+    /** Whether an entry with the current version is in the completion heap */
+    bool queued;
+    /** The time of the queued entry */
+    timestamp queued_time;
+    /** The time the flow completes at its current rate */
+    timestamp due;
+  };
+
+  struct completion {
+    timestamp time;
+    int id;
+    uint32_t version;
+
+    bool
+    operator>(const completion& other) const {
+      return time > other.time || (time == other.time && id > other.id);
+    }
+  };
+
+  void
+  build_links();
+
+  /**
+   * @return The number of switch hops on the route
+   */
+  int
+  route(node_id src, node_id dst, std::vector<int>& links);
+
+  /**
+   * Recompute rates once all the arrivals at this time have been seen
+   */
+  void
+  schedule_update();
+
+  void
+  update_rates();
+
+  /**
+   * Drop completions superseded by a later rate change
+   * once they outnumber the active flows
+   */
+  void
+  compact_completions();
+
+  void
+  push_completion(int id, timestamp time);
+
+  /**
+   * Make sure an event is pending for the earliest completion
+   */
+  void
+  schedule_check();
+
+  void
+  check_completions(uint32_t check_version);
+
+  void
+  deliver(network_message* msg, int num_hops, timestamp extra_delay);
+
+  flow_network network_;
+
+  std::vector<active_flow> flows_;
+
+  /** A min-heap on completion time, including stale entries */
+  std::vector<completion> completions_;
+
+  bool update_pending_;
+
+  bool check_pending_;
+
+  timestamp next_check_;
+
+  uint32_t check_version_;
+
+  std::vector<int> changed_;
+
+  std::vector<int> path_;
+
+  /** Indexed by switch*max_num_ports + outport, -1 if unconnected */
+  std::vector<int> port_link_;
+
+  std::vector<switch_id> port_dst_;
+
+  std::vector<int> injection_link_;
+
+  std::vector<int> ejection_link_;
+
+  int max_num_ports_;
+
+  double link_bw_;
+
+  double inj_bw_;
+
+  long negligible_size_;
+
+  timestamp hop_latency_;
+
+  timestamp dbl_inj_lat_;
+
+  std::vector<event_handler*> nics_;
+
+#if !SSTMAC_INTEGRATED_SST_CORE
+  link_handler* mtl_handler_;
+#endif
+
+};
+
+}
+}
+
+#endif // FLOW_SWITCH_H
@@ -20,21 +20,27 @@
 #include <sstmac/hardware/switch/network_switch.h>
 #include <sstmac/hardware/switch/dist_dummyswitch.h>
 #include <sstmac/hardware/logp/logp_switch.h>
+#include <sstmac/hardware/flow/flow_switch.h>
 #include <sstmac/backends/common/parallel_runtime.h>
 #include <sstmac/backends/common/sim_partition.h>
 #include <sstmac/common/runtime.h>
 #include <sstmac/common/event_manager.h>
+#include <sstmac/software/process/time.h>
 #include <sprockit/keyword_registration.h>
 #include <sprockit/statics.h>
 #include <sprockit/delete.h>
 #include <sprockit/output.h>
 #include <sprockit/sim_parameters.h>
 #include <sprockit/util.h>
+#include <pthread.h>
+#include <algorithm>
 
 ImplementFactory(sstmac::hw::interconnect)
 RegisterDebugSlot(interconnect);
+RegisterDebugSlot(interconnect_startup,
+    "print a breakdown of the wall time spent building the interconnect");
 RegisterNamespaces("interconnect");
-RegisterKeywords("network_name", "interconnect");
+RegisterKeywords("network_name", "interconnect", "build_threads");
 
 namespace sstmac {
 namespace hw {
@@ -80,6 +86,7 @@ interconnect::~interconnect()
   for (network_switch* sw : switches_){
     delete sw;
   }
+  sprockit::delete_vector(param_copies_);
 }
 #endif
 
@@ -87,6 +94,7 @@ interconnect::interconnect(sprockit::sim_parameters *params, event_manager *mgr,
                            partition *part, parallel_runtime *rt)
 {
   if (!static_interconnect_) static_interconnect_ = this;
+  double t_start = sstmac_wall_time();
   topology_ = topology::static_topology(params);
   num_nodes_ = topology_->num_nodes();
   num_switches_ = topology_->num_switches();
@@ -97,6 +105,7 @@ interconnect::interconnect(sprockit::sim_parameters *params, event_manager *mgr,
   rt_ = rt;
   int my_rank = rt_->me();
   int nproc = rt_->nproc();
+  build_threads_ = params->get_optional_int_param("build_threads", rt_->nthread());
   sprockit::sim_parameters* netlink_params = params->get_optional_namespace("netlink");
   sprockit::sim_parameters* nlink_inj_params =
       netlink_params->get_optional_namespace("injection");
@@ -112,35 +121,34 @@ interconnect::interconnect(sprockit::sim_parameters *params, event_manager *mgr,
   sprockit::sim_parameters* ej_params = switch_params->get_namespace("ejection");
   topology* top = topology_;
 
-  bool logp_model = switch_params->get_param("model") == "logP";
+  std::string switch_model = switch_params->get_param("model");
+  bool logp_model = switch_model == "logP";
+  //the flow switch replaces the LogP overlay as the whole network
+  bool flow_model = switch_model == "flow";
+  if (flow_model && (nproc > 1 || rt_->nthread() > 1)){
+    spkt_throw_printf(sprockit::input_error,
+      "interconnect: flow congestion model only runs serially, got %d ranks and %d threads",
+      nproc, rt_->nthread());
+  }
 
   switches_.resize(top->max_switch_id());
   nodes_.resize(top->max_node_id());
   netlinks_.resize(top->max_netlink_id());
 
   local_logp_switch_ = my_rank;
-  logp_switch* local_logp_switch;
   for (int i=0; i < nproc; ++i){
     switch_id sid(i);
     switch_params->add_param_override("id", int(sid));
-    if (i == my_rank){
-      logp_overlay_switches_[sid] = local_logp_switch = new logp_switch(switch_params, sid, mgr);
+    if (i == my_rank && flow_model){
+      logp_overlay_switches_[sid] = new flow_switch(switch_params, sid, mgr);
+    } else if (i == my_rank){
+      logp_overlay_switches_[sid] = new logp_switch(switch_params, sid, mgr);
     } else {
       logp_overlay_switches_[sid] = new dist_dummy_switch(switch_params, sid, mgr, device_id::logp_overlay);
     }
   }
 
-  build_endpoints(node_params, nic_params,netlink_params, mgr);
-  if (!logp_model){
-    build_switches(switch_params, mgr);
-    connect_switches(switch_params);
-    if (netlinks_.empty()){
-      connect_endpoints(inj_params, ej_params);
-    } else {
-      connect_endpoints(nlink_inj_params, ej_params);
-    }
-  }
-
+  //needed before building anything for the per-LP lookahead
   sprockit::sim_parameters* link_params = switch_params->get_namespace("link");
   if (link_params->has_param("send_latency")){
     hop_latency_ = link_params->get_time_param("send_latency");
@@ -150,6 +158,31 @@ interconnect::interconnect(sprockit::sim_parameters *params, event_manager *mgr,
   hop_bw_ = link_params->get_bandwidth_param("bandwidth");
   lookahead_ = hop_latency_;
   injection_latency_ = inj_params->get_time_param("latency");
+
+  double t_overlay = sstmac_wall_time();
+  build_endpoints(node_params, nic_params,netlink_params, mgr);
+  double t_endpoints = sstmac_wall_time();
+  double t_switches = t_endpoints;
+  double t_links = t_endpoints;
+  if (!logp_model && !flow_model){
+    build_switches(switch_params, mgr);
+    t_switches = sstmac_wall_time();
+    connect_switches(switch_params, mgr);
+    t_links = sstmac_wall_time();
+    if (netlinks_.empty()){
+      connect_endpoints(inj_params, ej_params);
+    } else {
+      connect_endpoints(nlink_inj_params, ej_params);
+    }
+  }
+  double t_done = sstmac_wall_time();
+
+  debug_printf(sprockit::dbg::interconnect_startup,
+    "rank %d built interconnect in %8.4fs: topology %8.4fs, endpoints %8.4fs, "
+    "switches %8.4fs, switch links %8.4fs, endpoint links %8.4fs",
+    my_rank, t_done - t_start, t_overlay - t_start, t_endpoints - t_overlay,
+    t_switches - t_endpoints, t_links - t_switches, t_done - t_links);
+
 #endif
 }
 
@@ -177,6 +210,7 @@ void
 interconnect::connect_endpoints(sprockit::sim_parameters* inj_params,
                                 sprockit::sim_parameters* ej_params)
 {
+  int my_rank = rt_->me();
   int num_nodes = topology_->num_nodes();
   for (int nodeaddr=0; nodeaddr < num_nodes; ++nodeaddr){
     node_id netlink_id;
@@ -193,16 +227,22 @@ interconnect::connect_endpoints(sprockit::sim_parameters* inj_params,
     bool has_netlink = topology_->node_to_netlink(nodeaddr, netlink_id, netlink_offset);
     if (has_netlink) {
       if (netlink_offset == 0){
-        ep = netlinks_[netlink_id];
         injaddr = topology_->netlink_to_injection_switch(netlink_id, inj_ports, num_inj_ports);
+        if (partition_->lpid_for_switch(injaddr) != my_rank){
+          continue; //built and connected by another rank
+        }
+        ep = netlinks_[netlink_id];
         ejaddr = topology_->netlink_to_injection_switch(netlink_id, ej_ports, num_ej_ports);
         ep_id = netlink_id;
       } else {
         continue; //no connection required
       }
     } else {
-      ep = nodes_[nodeaddr]->get_nic();
       injaddr = topology_->node_to_injection_switch(nodeaddr, inj_ports, num_inj_ports);
+      if (partition_->lpid_for_switch(injaddr) != my_rank){
+        continue; //built and connected by another rank
+      }
+      ep = nodes_[nodeaddr]->get_nic();
       ejaddr = topology_->node_to_injection_switch(nodeaddr, ej_ports, num_ej_ports);
       ep_id = nodeaddr;
     }
@@ -245,12 +285,16 @@ interconnect::build_endpoints(sprockit::sim_parameters* node_params,
   sprockit::sim_parameters* inj_params = nic_params->get_namespace("injection");
 
   int my_rank = rt_->me();
-  logp_switch* local_logp_switch = safe_cast(logp_switch,
-                                         logp_overlay_switches_[my_rank]);
+  network_switch* local_logp_switch = logp_overlay_switches_[my_rank];
+  //the overlay only needs one link to each remote rank
+  std::vector<bool> remote_rank_connected(rt_->nproc(), false);
 
   for (int i=0; i < num_switches_; ++i){
     switch_id sid(i);
     int target_rank = partition_->lpid_for_switch(sid);
+    if (target_rank != my_rank && remote_rank_connected[target_rank]){
+      continue;
+    }
     std::vector<topology::injection_port> nodes;
     topology_->nodes_connected_to_injection_switch(sid, nodes);
     interconn_debug("switch %d maps to target rank %d", i, target_rank);
@@ -316,11 +360,80 @@ interconnect::build_endpoints(sprockit::sim_parameters* node_params,
           target_rank,
           logp_switch::Switch,
           logp_overlay_switches_[target_rank]->payload_handler(port));
+        //remote overlay messages always cross at least one hop
+        add_lp_lookahead(target_rank, hop_latency_);
+        remote_rank_connected[target_rank] = true;
+        break;
       }
     }
   }
 }
 
+/**
+ * Run fxn on every set of args, the first on the calling thread
+ * and each of the others on its own pthread
+ */
+template <class Args>
+static void
+run_build_threads(void* (*fxn)(void*), std::vector<Args>& args)
+{
+  int nthread = args.size();
+  std::vector<pthread_t> threads(nthread);
+  std::vector<bool> started(nthread, false);
+  for (int i=1; i < nthread; ++i){
+    started[i] = pthread_create(&threads[i], NULL, fxn, &args[i]) == 0;
+  }
+  fxn(&args[0]);
+  for (int i=1; i < nthread; ++i){
+    if (started[i]){
+      pthread_join(threads[i], NULL);
+    } else {
+      //could not get a thread - just do the work here
+      fxn(&args[i]);
+    }
+  }
+  for (Args& a : args){
+    if (!a.error.empty()){
+      spkt_throw_printf(sprockit::illformed_error,
+        "interconnect: startup thread failed: %s", a.error.c_str());
+    }
+  }
+}
+
+struct interconnect::switch_build_range {
+  interconnect* ic;
+  sprockit::sim_parameters* params;
+  event_manager* mgr;
+  const switch_id* ids;
+  int num_ids;
+  std::string error;
+};
+
+void*
+interconnect::build_switch_range(void* args)
+{
+  switch_build_range* range = (switch_build_range*) args;
+  try {
+    for (int i=0; i < range->num_ids; ++i){
+      range->ic->build_switch(range->ids[i], range->params, range->mgr);
+    }
+  } catch (const std::exception& e){
+    range->error = e.what();
+  }
+  return nullptr;
+}
+
+void
+interconnect::build_switch(switch_id sid, sprockit::sim_parameters* switch_params,
+                           event_manager* mgr)
+{
+  switch_params->add_param_override("id", int(sid));
+  if (!topology_->uniform_switches())
+    topology_->configure_nonuniform_switch_params(sid, switch_params);
+  switches_[sid] = network_switch_factory::get_param("model",
+                      switch_params, sid, mgr);
+}
+
 void
 interconnect::build_switches(sprockit::sim_parameters* switch_params,
                              event_manager* mgr)
@@ -329,35 +442,148 @@ interconnect::build_switches(sprockit::sim_parameters* switch_params,
   if (simple_model) return; //nothing to do
 
   int my_rank = rt_->me();
-  bool all_switches_same = topology_->uniform_switches();
   switch_id num_switch_ids = topology_->max_switch_id();
+  //switches on other ranks only get placeholders if linked to this rank
+  std::vector<switch_id> local_ids;
   for (switch_id i=0; i < num_switch_ids; ++i){
-    if (!topology_->switch_id_slot_filled(i))
-      continue; //don't build
-
-    switch_params->add_param_override("id", int(i));
-    if (partition_->lpid_for_switch(i) == my_rank){
-      if (!all_switches_same)
-        topology_->configure_nonuniform_switch_params(i, switch_params);
-      switches_[i] = network_switch_factory::get_param("model",
-                      switch_params, i, mgr);
+    if (topology_->switch_id_slot_filled(i) && partition_->lpid_for_switch(i) == my_rank){
+      local_ids.push_back(i);
+    }
+  }
+
+  int num_local = local_ids.size();
+  int nthread = std::max(1, std::min(build_threads_, num_local - 1));
+  if (num_local > 0){
+    //the first switch fills in defaults (e.g. ejection credits) that links
+    //read later from the shared parameters, so build it before copying them
+    build_switch(local_ids[0], switch_params, mgr);
+  }
+
+  //constructors write overrides into their parameters, so every
+  //thread but this one builds from a private copy of the whole tree
+  std::vector<switch_build_range> ranges(nthread);
+  int num_left = std::max(0, num_local - 1);
+  int offset = 1;
+  for (int t=0; t < nthread; ++t){
+    switch_build_range& range = ranges[t];
+    range.ic = this;
+    range.mgr = mgr;
+    if (t == 0){
+      range.params = switch_params;
     } else {
-      switches_[i] = new dist_dummy_switch(switch_params, i, mgr, device_id::router);
+      sprockit::sim_parameters* root;
+      range.params = switch_params->copy_scope(root);
+      param_copies_.push_back(root);
     }
+    range.num_ids = num_left / nthread + (t < num_left % nthread ? 1 : 0);
+    range.ids = local_ids.data() + offset;
+    offset += range.num_ids;
   }
+  run_build_threads(&interconnect::build_switch_range, ranges);
 
   for (network_switch* netsw : switches_){
-    netsw->compatibility_check();
+    if (netsw) netsw->compatibility_check();
   }
+
+  debug_printf(sprockit::dbg::interconnect_startup,
+    "rank %d built %d of %d switches on %d threads",
+    my_rank, num_local, int(num_switch_ids), nthread);
+}
+
+network_switch*
+interconnect::remote_switch(switch_id sid, sprockit::sim_parameters* switch_params,
+                            event_manager* mgr)
+{
+  network_switch*& sw = switches_[sid];
+  if (!sw){
+    switch_params->add_param_override("id", int(sid));
+    sw = new dist_dummy_switch(switch_params, sid, mgr, device_id::router);
+  }
+  return sw;
+}
+
+struct interconnect::switch_link {
+  topology::connection conn;
+  int src_lp;
+  int dst_lp;
+};
+
+struct interconnect::link_gather_range {
+  interconnect* ic;
+  switch_id first;
+  switch_id last;
+  std::vector<switch_link> links;
+  int num_skipped;
+  std::string error;
+};
+
+void*
+interconnect::gather_link_range(void* args)
+{
+  link_gather_range* range = (link_gather_range*) args;
+  topology* top = range->ic->topology_;
+  partition* part = range->ic->partition_;
+  int my_rank = range->ic->rt_->me();
+  std::vector<topology::connection> outports(64); //allocate 64 spaces optimistically
+  range->num_skipped = 0;
+  try {
+    for (switch_id src=range->first; src < range->last; ++src){
+      int src_lp = part->lpid_for_switch(src);
+      top->connected_outports(src, outports);
+      for (topology::connection& conn : outports){
+        int dst_lp = part->lpid_for_switch(conn.dst);
+        if (src_lp != my_rank && dst_lp != my_rank){
+          //neither end lives here - another rank connects it
+          ++range->num_skipped;
+        } else {
+          switch_link link;
+          link.conn = conn;
+          link.src_lp = src_lp;
+          link.dst_lp = dst_lp;
+          range->links.push_back(link);
+        }
+      }
+    }
+  } catch (const std::exception& e){
+    range->error = e.what();
+  }
+  return nullptr;
+}
+
+int
+interconnect::gather_switch_links(std::vector<switch_link>& links)
+{
+  int nthread = std::max(1, std::min(build_threads_, num_switches_));
+  std::vector<link_gather_range> ranges(nthread);
+  int first = 0;
+  for (int t=0; t < nthread; ++t){
+    link_gather_range& range = ranges[t];
+    range.ic = this;
+    range.first = first;
+    range.last = first + num_switches_ / nthread + (t < num_switches_ % nthread ? 1 : 0);
+    first = range.last;
+  }
+  run_build_threads(&interconnect::gather_link_range, ranges);
+
+  int num_skipped = 0;
+  for (link_gather_range& range : ranges){
+    links.insert(links.end(), range.links.begin(), range.links.end());
+    num_skipped += range.num_skipped;
+  }
+  return num_skipped;
 }
 
 void
-interconnect::connect_switches(sprockit::sim_parameters* switch_params)
+interconnect::connect_switches(sprockit::sim_parameters* switch_params,
+                               event_manager* mgr)
 {
   bool simple_model = switch_params->get_param("model") == "simple";
   if (simple_model) return; //nothing to do
 
-  std::vector<topology::connection> outports(64); //allocate 64 spaces optimistically
+  int my_rank = rt_->me();
+  int num_connected = 0;
+  std::vector<switch_link> links;
+  int num_skipped = gather_switch_links(links);
 
   //might be super uniform in which all ports are the same
   bool all_ports_same = topology_->uniform_network_ports();
@@ -371,35 +597,66 @@ interconnect::connect_switches(sprockit::sim_parameters* switch_params)
   } else if (all_switches_same){
     topology_->configure_individual_port_params(switch_id(0), switch_params);
   }
+  //look up each port namespace once rather than once per link
+  std::vector<sprockit::sim_parameters*> port_params_cache;
+
+  //the links come grouped by source switch
+  bool configured = false;
+  switch_id configured_src;
+  for (switch_link& link : links){
+    topology::connection& conn = link.conn;
+    switch_id src = conn.src;
+    int src_lp = link.src_lp;
+    int dst_lp = link.dst_lp;
+    if (!all_switches_same && (!configured || src != configured_src)){
+      topology_->configure_individual_port_params(src, switch_params);
+      configured = true;
+      configured_src = src;
+    }
 
-  for (int i=0; i < num_switches_; ++i){
-    switch_id src(i);
-    topology_->connected_outports(src, outports);
-    network_switch* src_sw = switches_[src];
-    if (!all_switches_same) topology_->configure_individual_port_params(src, switch_params);
-    for (topology::connection& conn : outports){
-      if (!all_ports_same){
-        port_params = topology::get_port_params(switch_params, conn.src_outport);
+    if (!all_ports_same){
+      if (conn.src_outport >= int(port_params_cache.size())){
+        port_params_cache.resize(conn.src_outport + 1, nullptr);
+      }
+      sprockit::sim_parameters*& cached = port_params_cache[conn.src_outport];
+      if (!cached){
+        cached = topology::get_port_params(switch_params, conn.src_outport);
       }
+      port_params = cached;
+    }
 
-      network_switch* dst_sw = switches_[conn.dst];
-
-      interconn_debug("%s connecting to %s on ports %d:%d",
-                topology_->switch_label(src).c_str(),
-                topology_->switch_label(conn.dst).c_str(),
-                conn.src_outport, conn.dst_inport);
-
-      src_sw->connect_output(port_params,
-                             conn.src_outport,
-                             conn.dst_inport,
-                             dst_sw->payload_handler(conn.dst_inport));
-      dst_sw->connect_input(port_params,
-                            conn.src_outport,
-                            conn.dst_inport,
-                            src_sw->credit_handler(conn.src_outport));
+    network_switch* src_sw = src_lp == my_rank ? switches_[src]
+                               : remote_switch(src, switch_params, mgr);
+    network_switch* dst_sw = dst_lp == my_rank ? switches_[conn.dst]
+                               : remote_switch(conn.dst, switch_params, mgr);
+
+    if (src_lp != dst_lp){
+      //payloads flow one way, credits the other - both bounded by the send latency
+      timestamp link_lat = port_params->has_param("send_latency") ?
+            port_params->get_time_param("send_latency") :
+            port_params->get_time_param("latency");
+      add_lp_lookahead(src_lp == my_rank ? dst_lp : src_lp, link_lat);
     }
+
+    interconn_debug("%s connecting to %s on ports %d:%d",
+              topology_->switch_label(src).c_str(),
+              topology_->switch_label(conn.dst).c_str(),
+              conn.src_outport, conn.dst_inport);
+
+    src_sw->connect_output(port_params,
+                           conn.src_outport,
+                           conn.dst_inport,
+                           dst_sw->payload_handler(conn.dst_inport));
+    dst_sw->connect_input(port_params,
+                          conn.src_outport,
+                          conn.dst_inport,
+                          src_sw->credit_handler(conn.src_outport));
+    ++num_connected;
   }
 
+  debug_printf(sprockit::dbg::interconnect_startup,
+    "rank %d connected %d switch links, left %d to other ranks",
+    my_rank, num_connected, num_skipped);
 }
 
 void
@@ -417,11 +674,33 @@ interconnect::deadlock_check()
   }
 }
 
+network_switch*
+interconnect::local_switch_at(switch_id sid) const
+{
+  network_switch* sw = switches_[sid];
+  if (!sw || partition_->lpid_for_switch(sid) != rt_->me()){
+    spkt_throw_printf(sprockit::value_error,
+      "interconnect: switch %d is not owned by rank %d",
+      int(sid), rt_->me());
+  }
+  return sw;
+}
+
 int
 interconnect::thread_for_switch(switch_id sid) const
 {
-  network_switch* sw = this->switch_at(sid);
-  return sw->thread_id();
+  return local_switch_at(sid)->thread_id();
+}
+
+void
+interconnect::add_lp_lookahead(int lp, timestamp latency)
+{
+  std::map<int,timestamp>::iterator it = lp_lookahead_.find(lp);
+  if (it == lp_lookahead_.end()){
+    lp_lookahead_[lp] = latency;
+  } else if (latency < it->second){
+    it->second = latency;
+  }
 }
 #endif
 
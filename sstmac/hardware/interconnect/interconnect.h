@@ -29,8 +29,11 @@
 #include <sprockit/unordered.h>
 
 #include <set>
+#include <map>
+#include <vector>
 
 DeclareDebugSlot(interconnect)
+DeclareDebugSlot(interconnect_startup)
 
 #define interconn_debug(...) \
   debug_printf(sprockit::dbg::interconnect, __VA_ARGS__)
@@ -118,11 +121,27 @@ class interconnect
     return logp_overlay_switches_[sid];
   }
 
+  /**
+   * @brief Return the switch corresponding to given ID.
+   *        In parallel simulation, switches owned by another process
+   *        are either a dist_dummy_switch placeholder (if a local switch
+   *        links to them) or NULL
+   * @param id The ID of the switch object to get
+   * @return The switch object, a placeholder, or NULL
+   */
   network_switch*
   switch_at(switch_id id) const {
     return switches_[id];
   }
 
+  /**
+   * @brief Return the switch corresponding to given ID, which must
+   *        be owned by this process
+   * @throw sprockit::value_error if the switch is remote
+   */
+  network_switch*
+  local_switch_at(switch_id id) const;
+
   const node_map&
   nodes() const {
     return nodes_;
@@ -144,6 +163,11 @@ class interconnect
     return switches_;
   }
 
+  /**
+   * @param sid A switch owned by this process
+   * @throw sprockit::value_error if the switch is remote
+   * @return The thread the switch runs on
+   */
   int
   thread_for_switch(switch_id sid) const;
 
@@ -157,8 +181,30 @@ class interconnect
     return lookahead_;
   }
 
+  /**
+   * @brief For every remote LP that has a link into this LP, the minimum latency
+   *        across all such links. Only these LPs can ever send events to this LP,
+   *        and never with less delay than the latency recorded here.
+   * @return Map from remote LP to per-link lookahead
+   */
+  const std::map<int,timestamp>&
+  lp_lookahead() const {
+    return lp_lookahead_;
+  }
+
  private:
-  void connect_switches(sprockit::sim_parameters* switch_params);
+  void add_lp_lookahead(int lp, timestamp latency);
+
+  void connect_switches(sprockit::sim_parameters* switch_params,
+                        event_manager* mgr);
+
+  /**
+   * @return The placeholder for a switch on another rank,
+   *         built the first time a local link needs it
+   */
+  network_switch* remote_switch(switch_id sid,
+                                sprockit::sim_parameters* switch_params,
+                                event_manager* mgr);
 
   void build_endpoints(sprockit::sim_parameters* node_params,
                     sprockit::sim_parameters* nic_params,
@@ -168,6 +214,25 @@ class interconnect
   void build_switches(sprockit::sim_parameters* switch_params,
                       event_manager* mgr);
 
+  void build_switch(switch_id sid,
+                    sprockit::sim_parameters* switch_params,
+                    event_manager* mgr);
+
+  struct switch_build_range;
+  static void* build_switch_range(void* args);
+
+  struct switch_link;
+  struct link_gather_range;
+  static void* gather_link_range(void* args);
+
+  /**
+   * @brief Walk the topology once for every switch link with at least
+   *        one end on this rank, splitting the switches across build threads
+   * @param links [out] The links in order of source switch
+   * @return The number of links skipped because neither end is local
+   */
+  int gather_switch_links(std::vector<switch_link>& links);
+
   void connect_endpoints(sprockit::sim_parameters* inj_params,
                   sprockit::sim_parameters* ej_params);
 
@@ -187,12 +252,21 @@ class interconnect
 
   timestamp lookahead_;
 
+  std::map<int,timestamp> lp_lookahead_;
+
   int num_speedy_switches_with_extra_node_;
   int num_nodes_per_speedy_switch_;
 
   partition* partition_;
   parallel_runtime* rt_;
 
+  /** The number of threads that build switches and gather links at startup */
+  int build_threads_;
+
+  /** Parameter trees copied for build threads, kept alive since
+   *  components may hold on to their parameters */
+  std::vector<sprockit::sim_parameters*> param_copies_;
+
   typedef std::vector<netlink*> netlink_map;
   netlink_map netlinks_;
 #endif
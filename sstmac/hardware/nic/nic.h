@@ -106,7 +106,7 @@ class nic :
   void
   intranode_send(network_message* payload);
 
-  void
+  virtual void
   send_to_logp_switch(network_message* netmsg);
 
  protected:
@@ -22,10 +22,30 @@ pisces_payload::pisces_payload(
   bool is_tail) :
   packet(msg, num_bytes, is_tail),
   bw_(uninitialized_bw),
-  max_in_bw_(1.0)
+  max_in_bw_(1.0),
+  train_length_(1),
+  train_packet_size_(num_bytes)
 {
 }
 
+void
+pisces_payload::split_train(std::vector<pisces_payload*>& pkts)
+{
+  for (int i=1; i < train_length_; ++i){
+    pisces_payload* pkt = clone_payload();
+    pkt->num_bytes_ = train_packet_size_;
+    pkt->is_tail_ = false;
+    //only the tail packet carries the message
+    pkt->orig_ = nullptr;
+    pkt->train_length_ = 1;
+    pkts.push_back(pkt);
+  }
+  num_bytes_ -= (train_length_ - 1) * train_packet_size_;
+  train_length_ = 1;
+  train_packet_size_ = num_bytes_;
+  pkts.push_back(this);
+}
+
 void
 pisces_payload::serialize_order(serializer& ser)
 {
@@ -36,6 +56,8 @@ pisces_payload::serialize_order(serializer& ser)
   ser & max_in_bw_;
   ser & arrival_;
   ser & vc_;
+  ser & train_length_;
+  ser & train_packet_size_;
 }
 
 void
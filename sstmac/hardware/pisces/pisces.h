@@ -5,8 +5,10 @@
 #include <sstmac/common/messages/sst_message.h>
 #include <sstmac/hardware/router/routing_enum.h>
 #include <sstmac/hardware/router/routable.h>
+#include <sstmac/common/slab_allocator.h>
 #include <sprockit/factories/factory.h>
 #include <sprockit/debug.h>
+#include <vector>
 
 DeclareDebugSlot(pisces)
 DeclareDebugSlot(pisces_queue)
@@ -24,6 +26,7 @@ namespace hw {
 class pisces_payload :
   public packet
 {
+  SlabAllocated()
  public:
   static const double uninitialized_bw;
 
@@ -121,6 +124,33 @@ class pisces_payload :
     return num_bytes_ / bw_;
   }
 
+  /**
+   @return The number of packets coalesced into this payload.
+   Greater than 1 only for a packet train.
+   */
+  int
+  train_length() const {
+    return train_length_;
+  }
+
+  /**
+   @param num_packets The number of packets coalesced into this payload
+   @param packet_size The size of each packet, the last can be smaller
+   */
+  void
+  set_train(int num_packets, int packet_size) {
+    train_length_ = num_packets;
+    train_packet_size_ = packet_size;
+  }
+
+  /**
+   @brief split_train Break a packet train back into its individual packets.
+   The train itself is reused as the last packet.
+   @param pkts [out] The packets in the order they were injected
+   */
+  void
+  split_train(std::vector<pisces_payload*>& pkts);
+
   void
   set_inport(int port) {
     inport_ = port;
@@ -137,6 +167,12 @@ class pisces_payload :
  protected:
   pisces_payload(){} //for serialization
 
+  /**
+   @return A copy of this packet with the same routing state
+   */
+  virtual pisces_payload*
+  clone_payload() const = 0;
+
   int inport_;
 
   double bw_;
@@ -147,6 +183,10 @@ class pisces_payload :
 
   int vc_;
 
+  int train_length_;
+
+  int train_packet_size_;
+
 };
 
 /**
@@ -228,6 +268,12 @@ class pisces_default_packet :
   std::string
   to_string() const override;
 
+ protected:
+  pisces_payload*
+  clone_payload() const override {
+    return new pisces_default_packet(*this);
+  }
+
  private:
   uint64_t flow_id_;
 
@@ -268,6 +314,12 @@ class pisces_delay_stats_packet : public pisces_default_packet
    congestion_delay_ += sec;
   }
 
+ protected:
+  pisces_payload*
+  clone_payload() const override {
+    return new pisces_delay_stats_packet(*this);
+  }
+
  private:
   double congestion_delay_;
 
@@ -277,7 +329,7 @@ class pisces_credit :
   public event,
   public sprockit::printable
 {
-
+  SlabAllocated()
  public:
   ImplementSerializable(pisces_credit)
 
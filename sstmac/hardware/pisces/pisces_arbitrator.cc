@@ -149,7 +149,8 @@ pisces_null_arbitrator::bytes_sending(timestamp now) const
 
 pisces_cut_through_arbitrator::
 pisces_cut_through_arbitrator(sprockit::sim_parameters* params)
-  : head_(nullptr),
+  : head_(0),
+    size_(0),
     pisces_bandwidth_arbitrator(params)
 {
   timestamp sec(1.0);
@@ -157,13 +158,21 @@ pisces_cut_through_arbitrator(sprockit::sim_parameters* params)
   bw_sec_to_tick_conversion_ = tick.sec();
   bw_tick_to_sec_conversion_ = sec.ticks_int64();
 
-  head_ = new bandwidth_epoch;
-  head_->bw_available = out_bw_ * bw_sec_to_tick_conversion_;
-  head_->start = 0;
+  //a link under load rarely has more than a handful of epochs
+  epochs_.resize(16);
+  mask_ = epochs_.size() - 1;
+
+  size_ = 1;
+  bandwidth_epoch& first = epoch(0);
+  first.bw_available = out_bw_ * bw_sec_to_tick_conversion_;
+  first.start = 0;
   //just set to super long
-  head_->length = std::numeric_limits<uint64_t>::max();
+  first.length = std::numeric_limits<uint64_t>::max();
 }
 
+pisces_cut_through_arbitrator::~pisces_cut_through_arbitrator()
+{
+}
 
 timestamp
 pisces_cut_through_arbitrator::head_tail_delay(pisces_payload *pkt)
@@ -172,21 +181,11 @@ pisces_cut_through_arbitrator::head_tail_delay(pisces_payload *pkt)
   return ser_delay;
 }
 
-pisces_cut_through_arbitrator::~pisces_cut_through_arbitrator()
-{
-  bandwidth_epoch* next = head_;
-  while (next){
-    bandwidth_epoch* e = next;
-    next = next->next;
-    delete e;
-  }
-}
-
 int
 pisces_cut_through_arbitrator::bytes_sending(timestamp now) const
 {
   double next_free =
-    head_->start; //just assume that at head_->start link is fully available
+    epoch(0).start; //just assume that at the first epoch link is fully available
   double now_ = now.sec();
   double send_delay = next_free > now_ ? (next_free - now_) : 0;
   int bytes_sending = send_delay * out_bw_;
@@ -196,73 +195,72 @@ pisces_cut_through_arbitrator::bytes_sending(timestamp now) const
 void
 pisces_cut_through_arbitrator::partition(noise_model* noise, int num_intervals)
 {
-  //find the tail
-  bandwidth_epoch* tail = head_;
-  while (tail->next) //while true, not the tail
-    tail = tail->next;
-
   for (int i=0; i < num_intervals; ++i){
-    tail->split(noise->value());
-    tail = tail->next;
+    split(size_ - 1, noise->value());
   }
-
 }
 
 void
 pisces_cut_through_arbitrator::init_noise_model(noise_model* noise)
 {
-  bandwidth_epoch* next = head_;
-  while (next){
-    next->bw_available = noise->value();
-    next = next->next;
+  for (uint32_t i=0; i < size_; ++i){
+    epoch(i).bw_available = noise->value();
   }
 }
 
 void
-pisces_cut_through_arbitrator::bandwidth_epoch::split(ticks_t delta_t)
+pisces_cut_through_arbitrator::grow()
 {
-  bandwidth_epoch* new_epoch = new bandwidth_epoch;
-  new_epoch->bw_available = this->bw_available;
-  new_epoch->start = this->start + delta_t;
-  new_epoch->length = this->length - delta_t;
-  new_epoch->next = this->next;
-  this->next = new_epoch;
-  this->length = delta_t;
+  std::vector<bandwidth_epoch> bigger(2*epochs_.size());
+  for (uint32_t i=0; i < size_; ++i){
+    bigger[i] = epoch(i);
+  }
+  epochs_.swap(bigger);
+  head_ = 0;
+  mask_ = epochs_.size() - 1;
 }
 
 void
-pisces_cut_through_arbitrator::bandwidth_epoch::truncate_after(ticks_t delta_t)
+pisces_cut_through_arbitrator::split(uint32_t i, ticks_t delta_t)
 {
-  ticks_t finish = start + length;
-  start += delta_t;
+  if (size_ == epochs_.size()){
+    grow();
+  }
 
-  length -= delta_t;
+  //splits mostly land near the front, but the tail is usually short
+  for (uint32_t j=size_; j > i+1; --j){
+    epoch(j) = epoch(j-1);
+  }
+  ++size_;
+
+  bandwidth_epoch& old_epoch = epoch(i);
+  bandwidth_epoch& new_epoch = epoch(i+1);
+  new_epoch.bw_available = old_epoch.bw_available;
+  new_epoch.start = old_epoch.start + delta_t;
+  new_epoch.length = old_epoch.length - delta_t;
+  old_epoch.length = delta_t;
 }
 
 void
 pisces_cut_through_arbitrator::clean_up(ticks_t now)
 {
-  bandwidth_epoch* epoch = head_;
   while (1) {
-
-    if (epoch->start >= now) {
+    bandwidth_epoch& first = epoch(0);
+    if (first.start >= now) {
       return; // we are done
     }
 
-    ticks_t delta_t = now - epoch->start;
-    if (delta_t >= epoch->length) { //this epoch has expired
-      //delete and move on
-      head_ = epoch->next;
-      delete epoch;
-      epoch = head_;
+    ticks_t delta_t = now - first.start;
+    if (delta_t >= first.length) { //this epoch has expired
+      pop_front(1);
     }
     else { //we are in the middle of this epoch
-      epoch->truncate_after(delta_t);
+      first.truncate_after(delta_t);
       return; //we are done
     }
 
-    if (!head_) {
-      spkt_throw_printf(sprockit::illformed_error, "head is null");
+    if (size_ == 0) {
+      spkt_throw_printf(sprockit::illformed_error, "no bandwidth epochs left");
     }
   }
 }
@@ -292,7 +290,7 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
   ticks_t now = st.now.ticks_int64();
   clean_up(now);
 
-  ticks_t send_start = head_->start;
+  ticks_t send_start = epoch(0).start;
 
   long bytes_queued = payload_bw * (send_start - payload->arrival().ticks_int64());
 #if SSTMAC_SANITY_CHECK
@@ -308,16 +306,19 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
   pflow_arb_debug_printf_l0("cut_through arbitrator handling %s at time %10.5e that started arriving at %10.5e",
                             payload->to_string().c_str(), st.now.sec(), payload->arrival().sec());
 
-  bandwidth_epoch* epoch = head_;
+  //the epoch being filled, relative to the first epoch
+  //using up the epoch at cur also drops every epoch before it
+  uint32_t cur = 0;
   while (1) {
+    bandwidth_epoch& ep = epoch(cur);
     pflow_arb_debug_printf_l1("epoch BW=%9.5e start=%9.5e length=%9.5e: bytes_to_send=%d bytes_queued=%d",
-                           epoch->bw_available,
-                           epoch->start,
-                           epoch->length,
+                           ep.bw_available,
+                           ep.start,
+                           ep.length,
                            bytes_to_send,
                            bytes_queued);
 
-    double delta_bw = payload_bw - epoch->bw_available;
+    double delta_bw = payload_bw - ep.bw_available;
 
     /**
         This is basically assuming payload->bw >= bw_available
@@ -326,29 +327,28 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
     */
     if (delta_bw > -1e-6) {
       //see if we can send all the bytes in this epoch
-      ticks_t time_to_send = bytes_to_send / epoch->bw_available;
+      ticks_t time_to_send = bytes_to_send / ep.bw_available;
       pflow_arb_debug_printf_l2("delta=%8.4e, send_time=%lu using all available bandwidth in epoch",
                              delta_bw, time_to_send);
-      if (time_to_send < epoch->length) {
-        ticks_t payload_stop = epoch->start + time_to_send;
+      if (time_to_send < ep.length) {
+        ticks_t payload_stop = ep.start + time_to_send;
         ticks_t total_send_time = payload_stop - send_start;
         double new_bw = payload->num_bytes() * bw_tick_to_sec_conversion_ / total_send_time;
 
         payload->set_bw(new_bw);
-        epoch->truncate_after(time_to_send);
+        ep.truncate_after(time_to_send);
         pflow_arb_debug_printf_l1("truncate epoch: start=%llu stop=%llu send_time=%llu new_bw=%12.8e",
                                 send_start, payload_stop, total_send_time, payload->bw());
         st.head_leaves = timestamp(send_start, timestamp::exact);
         st.tail_leaves = timestamp(payload_stop, timestamp::exact);
         return;
       }
-      else if (time_to_send == epoch->length) {
-        ticks_t payload_stop = epoch->start + time_to_send;
+      else if (time_to_send == ep.length) {
+        ticks_t payload_stop = ep.start + time_to_send;
         ticks_t total_send_time = payload_stop - send_start;
         double new_bw = payload->num_bytes()*bw_tick_to_sec_conversion_ / total_send_time;
         payload->set_bw(new_bw);
-        head_ = epoch->next;
-        delete epoch;
+        pop_front(cur + 1);
         pflow_arb_debug_printf_l2("exact fit: start=%llu stop=%llu send_time=%llu new_bw=%12.8e\n",
                                    send_start, payload_stop, total_send_time, payload->bw());
         st.head_leaves = timestamp(send_start, timestamp::exact);
@@ -357,10 +357,9 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
       }
       else {
         //this epoch is exhausted
-        bytes_to_send -= epoch->bw_available * epoch->length;
-        head_ = epoch->next;
-        delete epoch;
-        epoch = head_;
+        bytes_to_send -= ep.bw_available * ep.length;
+        pop_front(cur + 1);
+        cur = 0;
         pflow_arb_debug_print_l2("epoch used up");
       }
     }
@@ -375,12 +374,14 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
       pflow_arb_debug_printf_l2("underutilized, No Queue: time_to_send=%llu",
                                 time_to_send);
 
-      if (time_to_send <= epoch->length) {
-        epoch->split(time_to_send);
-        epoch->bw_available -= payload_bw;
+      if (time_to_send <= ep.length) {
+        split(cur, time_to_send);
+        //the split may have moved the epochs
+        bandwidth_epoch& sending = epoch(cur);
+        sending.bw_available -= payload_bw;
 
         //configure bandwidth
-        ticks_t send_done = epoch->start + time_to_send;
+        ticks_t send_done = sending.start + time_to_send;
         double new_bw = payload->num_bytes() * bw_tick_to_sec_conversion_ / (send_done - send_start);
         payload->set_bw(new_bw);
         pflow_arb_debug_printf_l2("send finishes: start=%llu stop=%llu new_bw=%12.8e",
@@ -391,8 +392,7 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
       }
       else {
 #if SSTMAC_SANITY_CHECK
-        if (epoch->next ==
-            0) { //we should never be subtracting from the big long epoch at the end
+        if (cur + 1 == size_) { //we should never be subtracting from the big long epoch at the end
           spkt_throw_printf(sprockit::illformed_error,
                            "Subtracting bandwidth from the final epoch:\n"
                            "bytes_to_send=%d\n"
@@ -402,12 +402,12 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
                            bytes_to_send,
                            payload->bw(),
                            time_to_send,
-                           epoch->length);
+                           ep.length);
         }
 #endif
-        epoch->bw_available -= payload_bw;
-        bytes_to_send -= payload_bw * epoch->length;
-        epoch = epoch->next;
+        ep.bw_available -= payload_bw;
+        bytes_to_send -= payload_bw * ep.length;
+        ++cur;
         pflow_arb_debug_print_l2("send not done yet");
       }
     }
@@ -427,9 +427,9 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
       //subject to t >= 0
 
       //the intersection might come after whole message is sent
-      ticks_t send_all_time = bytes_to_send / epoch->bw_available;
+      ticks_t send_all_time = bytes_to_send / ep.bw_available;
       ticks_t time_to_intersect = bytes_queued / (-delta_bw);
-      ticks_t time_to_send = std::min(epoch->length, std::min(send_all_time,
+      ticks_t time_to_send = std::min(ep.length, std::min(send_all_time,
                                      time_to_intersect));
 
       pflow_arb_debug_printf_l2("underutilized, but %d bytes queued: delta=%12.8e "
@@ -438,19 +438,19 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
 
       if (time_to_send == send_all_time) {
         //and the message completely finishes
-        ticks_t send_done = epoch->start + time_to_send;
+        ticks_t send_done = ep.start + time_to_send;
         double new_bw = payload->num_bytes() * bw_tick_to_sec_conversion_ / (send_done - send_start);
         payload->set_bw(new_bw);
         pflow_arb_debug_printf_l2("send finishes: start=%llu stop=%llu new_bw=%12.8e",
                                send_start, send_done, payload->bw());
-        epoch->truncate_after(time_to_send);
+        ep.truncate_after(time_to_send);
         st.head_leaves = timestamp(send_start, timestamp::exact);
         st.tail_leaves = timestamp(send_done, timestamp::exact);
         return;
       }
-      else if (time_to_send == epoch->length) {
+      else if (time_to_send == ep.length) {
 #if SSTMAC_SANITY_CHECK
-        if (epoch->next == 0) {
+        if (cur + 1 == size_) {
           //something freaked out numerically
           //time_to_send should never equal the length of the big long, last epoch
           spkt_throw_printf(sprockit::illformed_error,
@@ -466,40 +466,39 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
                            "delta_bw=%20.16e\n",
                            send_all_time,
                            time_to_intersect,
-                           epoch->length,
+                           ep.length,
                            time_to_send,
                            bytes_to_send,
                            bytes_queued,
-                           epoch->bw_available,
+                           ep.bw_available,
                            payload->bw(),
                            delta_bw);
         }
 #endif
         //add in the contributions
-        bytes_to_send -= ceil(epoch->bw_available * time_to_send);
+        bytes_to_send -= ceil(ep.bw_available * time_to_send);
         //we are also draining the queue
         //delta < 0 so this is really a subtraction
-        bytes_queued += ceil(delta_bw * epoch->length);
+        bytes_queued += ceil(delta_bw * ep.length);
         //this epoch is exhausted
-        head_ = epoch->next;
-        delete epoch;
-        epoch = head_;
+        pop_front(cur + 1);
+        cur = 0;
         pflow_arb_debug_print_l2("send not done yet");
       }
 
       else { //time_to_send = time_to_intersect
         //the queue is completely drained during the epoch
-        epoch->truncate_after(time_to_send);
+        ep.truncate_after(time_to_send);
         //but we are not done yet - add the contributions
-        bytes_to_send -= ceil(epoch->bw_available * time_to_send);
+        bytes_to_send -= ceil(ep.bw_available * time_to_send);
         bytes_queued = 0;
         pflow_arb_debug_print_l2("queue emptied");
       }
 
     }
 
-    if (!head_) {
-      spkt_throw_printf(sprockit::illformed_error, "head is null");
+    if (cur >= size_) {
+      spkt_throw_printf(sprockit::illformed_error, "ran past the last bandwidth epoch");
     }
 
   }
@@ -507,4 +506,3 @@ pisces_cut_through_arbitrator::do_arbitrate(pkt_arbitration_t &st)
 
 }
 }
-
@@ -7,6 +7,7 @@
 #include <sprockit/factories/factory.h>
 #include <sstmac/hardware/noise/noise.h>
 #include <sstmac/hardware/pisces/pisces_stats.h>
+#include <vector>
 
 namespace sstmac {
 namespace hw {
@@ -130,10 +131,12 @@ class pisces_simple_arbitrator :
 };
 
 /**
- * @brief The pisces_simple_arbitrator class Implements a store-and-forward arbitration scheme.
- * The entire packet has to arrive before it can be arbitrated.  Links/crossbars never interleave
- * flits from different packets in this scheme.  For larger packet sizes, this can lead to
- * unrealistic delays since packets cannot pipeline across network stages.
+ * @brief The pisces_cut_through_arbitrator class Implements cut-through arbitration.
+ * Packets are forwarded as soon as they start arriving. The future availability of the link
+ * is tracked as a sequence of bandwidth epochs. Each packet consumes bandwidth from the
+ * epochs it overlaps, splitting an epoch if it only needs part of the bandwidth.
+ * The epochs are stored contiguously in a ring buffer that only grows,
+ * so arbitration never allocates once the buffer is large enough.
  */
 class pisces_cut_through_arbitrator :
   public pisces_bandwidth_arbitrator
@@ -167,31 +170,68 @@ class pisces_cut_through_arbitrator :
   timestamp
   head_tail_delay(pisces_payload *pkt) override;
 
- private:
-  void clean_up(ticks_t now);
-
-  void
-  do_arbitrate(pkt_arbitration_t& st);
+  int
+  num_epochs() const {
+    return size_;
+  }
 
+ private:
   struct bandwidth_epoch {
     bw_t bw_available; //bandwidth is bytes per timestamp tick
     ticks_t start;
     ticks_t length;
-    bandwidth_epoch* next;
 
-    bandwidth_epoch() :
-      next(nullptr) {
-    }
-    
-    ~bandwidth_epoch(){
+    void truncate_after(ticks_t delta_t){
+      start += delta_t;
+      length -= delta_t;
     }
+  };
 
-    void truncate_after(ticks_t delta_t);
+  /**
+   * @param i The position relative to the first (current) epoch
+   */
+  bandwidth_epoch&
+  epoch(uint32_t i){
+    return epochs_[(head_ + i) & mask_];
+  }
 
-    void split(ticks_t delta_t);
-  };
+  const bandwidth_epoch&
+  epoch(uint32_t i) const {
+    return epochs_[(head_ + i) & mask_];
+  }
+
+  /**
+   * @brief pop_front Drop the first n epochs
+   */
+  void
+  pop_front(uint32_t n){
+    head_ = (head_ + n) & mask_;
+    size_ -= n;
+  }
+
+  /**
+   * @brief split End epoch i after delta_t ticks, inserting a new epoch
+   *        with the same bandwidth for the remainder
+   */
+  void
+  split(uint32_t i, ticks_t delta_t);
+
+  void
+  grow();
+
+  void clean_up(ticks_t now);
+
+  void
+  do_arbitrate(pkt_arbitration_t& st);
+
+  std::vector<bandwidth_epoch> epochs_;
+
+  uint32_t head_;
+
+  uint32_t size_;
 
-  bandwidth_epoch* head_;
+  /** The capacity is always a power of 2 */
+  uint32_t mask_;
 
   /** Convert from bytes/sec to bytes/tick */
   double bw_tick_to_sec_conversion_;
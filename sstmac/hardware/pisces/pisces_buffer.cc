@@ -144,6 +144,11 @@ pisces_network_buffer::handle_payload(event* ev)
     pkt->to_string().c_str(),
     dst_vc);
 
+  if (pkt->train_length() > 1 && train_contended(pkt, num_credits, output_)){
+    split_train(pkt);
+    return;
+  }
+
   // it either gets queued or gets sent
   // either way there's a delay accumulating for other messages
   bytes_delayed_ += pkt->num_bytes();
@@ -243,6 +243,11 @@ pisces_NtoM_queue::handle_payload(event* ev)
         to_string().c_str(), pkt->to_string().c_str(), dst_port, dst_vc);
   }
 
+  if (pkt->train_length() > 1 && train_contended(pkt, num_credits, outputs_[local_port(dst_port)])){
+    split_train(pkt);
+    return;
+  }
+
   if (num_credits >= pkt->num_bytes()) {
     num_credits -= pkt->num_bytes();
     send_payload(pkt);
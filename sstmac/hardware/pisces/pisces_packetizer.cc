@@ -26,6 +26,10 @@
 
 RegisterNamespaces("congestion_delays", "congestion_matrix");
 
+RegisterKeywords(
+"train_length",
+);
+
 namespace sstmac {
 namespace hw {
 
@@ -67,7 +71,10 @@ pisces_packetizer::init(sprockit::sim_parameters* params, event_scheduler* paren
   pkt_allocator_ = packet_allocator_factory
       ::get_optional_param("packet_allocator", "pisces", params);
 
-
+  //a train can never need more credits than the injection buffer has
+  long max_train = inj_params->get_byte_length_param("credits") / packetSize();
+  train_length_ = params->get_optional_int_param("train_length", 1);
+  train_length_ = std::max(1L, std::min(long(train_length_), max_train));
 
   payload_handler_ = new_handler(this, &pisces_packetizer::recv_packet);
 }
@@ -148,6 +155,10 @@ pisces_packetizer::inject(int vn, long bytes, long byte_offset, message* msg)
   pisces_payload* payload = pkt_allocator_->new_packet(bytes, msg->flow_id(), is_tail,
                                                        msg->toaddr(), msg->fromaddr(),
                                                        is_tail ? msg : nullptr);
+  if (bytes > packetSize()){
+    int num_packets = (bytes + packetSize() - 1) / packetSize();
+    payload->set_train(num_packets, packetSize());
+  }
   inj_buffer_->handle_payload(payload);
 }
 
@@ -122,7 +122,7 @@ pisces_sender::send(
   pisces_bandwidth_arbitrator* arb,
   pisces_payload* pkt,
   const pisces_input& src,
-  const pisces_output& dest)
+  pisces_output& dest)
 {
   pkt_arbitration_t st;
   st.incoming_bw = pkt->bw();
@@ -139,6 +139,10 @@ pisces_sender::send(
 
   if (stat_collector_) stat_collector_->collect_single_event(st);
 
+  dest.busy_until = st.tail_leaves;
+  dest.busy_with_train = pkt->train_length() > 1;
+  if (dest.busy_with_train) dest.busy_flow = pkt->flow_id();
+
 #if SSTMAC_SANITY_CHECK
   if (pkt->bw() <= 0 && pkt->bw() != pisces_payload::uninitialized_bw) {
     spkt_throw_printf(sprockit::value_error,
@@ -171,6 +175,19 @@ pisces_sender::send(
   send_to_link(st.head_leaves, send_lat_, dest.handler, pkt);
 }
 
+void
+pisces_sender::split_train(pisces_payload* pkt)
+{
+  pisces_debug("On %s:%p, splitting %d packet train {%s}",
+    to_string().c_str(), this, pkt->train_length(),
+    pkt->to_string().c_str());
+  std::vector<pisces_payload*> pkts;
+  pkt->split_train(pkts);
+  for (pisces_payload* next : pkts){
+    handle_payload(next);
+  }
+}
+
 std::string
 pisces_sender::to_string() const
 {
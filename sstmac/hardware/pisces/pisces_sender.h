@@ -49,9 +49,16 @@ struct pisces_input {
 struct pisces_output {
   int dst_inport;
   event_handler* handler;
+  /** When the last packet sent to this output finishes arbitrating */
+  timestamp busy_until;
+  /** Whether the last packet sent was a packet train */
+  bool busy_with_train;
+  uint64_t busy_flow;
   pisces_output() :
     dst_inport(-1),
-    handler(0)
+    handler(0),
+    busy_with_train(false),
+    busy_flow(0)
   {
   }
 };
@@ -111,7 +118,32 @@ class pisces_sender :
   send(pisces_bandwidth_arbitrator* arb,
        pisces_payload* pkt,
        const pisces_input& src,
-       const pisces_output& dest);
+       pisces_output& dest);
+
+  /**
+   * @brief train_contended A packet train only stays together while it has
+   *  credits for all of its packets and no other flow is still being sent
+   *  to the same output
+   * @param pkt         The packet train
+   * @param num_credits The credits available for the train
+   * @param dest        The output the train is going to
+   * @return Whether the train must be split into its individual packets
+   */
+  bool
+  train_contended(pisces_payload* pkt, int num_credits,
+                  const pisces_output& dest) const {
+    if (num_credits < pkt->num_bytes()) return true;
+    if (now() >= dest.busy_until) return false;
+    return !dest.busy_with_train || dest.busy_flow != pkt->flow_id();
+  }
+
+  /**
+   * @brief split_train Break up a contended packet train
+   *  and handle each of its packets individually
+   * @param pkt The packet train
+   */
+  void
+  split_train(pisces_payload* pkt);
 
  protected:
   packet_stats_callback* stat_collector_;
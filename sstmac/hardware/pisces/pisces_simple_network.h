@@ -51,6 +51,12 @@ class simple_network_packet : public pisces_routable_packet
     return vn_;
   }
 
+ protected:
+  pisces_payload*
+  clone_payload() const override {
+    return new simple_network_packet(*this);
+  }
+
  private:
   int vn_;
 
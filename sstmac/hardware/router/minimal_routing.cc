@@ -13,19 +13,34 @@ SpktRegister("minimal", router, minimal_router,
 
 minimal_router::minimal_router(sprockit::sim_parameters* params, topology* top,
                                network_switch* netsw, routing::algorithm_t algo) :
-  router(params, top, netsw, algo)
+  router(params, top, netsw, algo),
+  table_(nullptr)
 {
   fat_tree* ft = test_cast(fat_tree, top);
   if (ft){
     spkt_throw(sprockit::value_error,
                "minimal_router should not be used with fat tree - set router=fattree in params");
   }
+
+  if (params->get_optional_bool_param("route_table", false)){
+    //filling every destination up front costs num_switches^2 routes over the whole system
+    int eager_limit = params->get_optional_int_param("route_table_eager_limit", 1024);
+    bool eager = top_->num_switches() <= eager_limit;
+    table_ = new routing_table(top_, my_addr_, eager);
+    rter_debug("built %s routing table using %lu bytes",
+               eager ? "eager" : "lazy", table_->num_bytes());
+  }
+}
+
+minimal_router::~minimal_router()
+{
+  if (table_) delete table_;
 }
 
 void
 minimal_router::route_to_switch(switch_id sid, routable::path& path)
 {
-  top_->minimal_route_to_switch(my_addr_, sid, path);
+  minimal_route(sid, path);
 }
 
 }
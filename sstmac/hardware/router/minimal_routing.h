@@ -2,6 +2,7 @@
 #define sstmac_hardware_network_topology_routing_BASIC_ROUTING_H
 
 #include <sstmac/hardware/router/router.h>
+#include <sstmac/hardware/router/routing_table.h>
 
 namespace sstmac {
 namespace hw {
@@ -18,7 +19,7 @@ class minimal_router :
   minimal_router(sprockit::sim_parameters* params, topology* top,
                  network_switch* netsw, routing::algorithm_t algo = routing::minimal);
 
-  virtual ~minimal_router() {}
+  virtual ~minimal_router();
 
   std::string
   to_string() const override {
@@ -28,6 +29,22 @@ class minimal_router :
  protected:
   void route_to_switch(switch_id sid, routable::path &path) override;
 
+  /**
+   * @brief minimal_route Compute the minimal route from this switch,
+   *        looking it up in the routing table if one was built
+   */
+  void
+  minimal_route(switch_id dst, routable::path& path){
+    if (table_){
+      table_->route(dst, path);
+    } else {
+      top_->minimal_route_to_switch(my_addr_, dst, path);
+    }
+  }
+
+  /** Null unless route_table is set */
+  routing_table* table_;
+
 };
 
 }
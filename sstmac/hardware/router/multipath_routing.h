@@ -43,11 +43,65 @@ class multipath_router :
     }
   };
 
+  /**
+   * @brief The redundant_ports struct The redundant set of an outport
+   * as a bitset over ports, ascending in the order the topology lists them
+   */
+  struct redundant_ports {
+    int geometric_id;
+    /** Zero if the set has not been cached */
+    uint64_t ports;
+
+    redundant_ports() : geometric_id(0), ports(0) {}
+  };
+
   virtual void
   compatibility_check(){
     //do nothing
   }
 
+  /**
+   * @brief cached_redundant_path
+   * @param path [inout] Switched to the next redundant port, if the set was cached
+   * @return Whether the redundant set for the outport was cached
+   */
+  bool
+  cached_redundant_path(routable::path& path){
+    if (path.outport < 0 || path.outport >= redundant_.size()) return false;
+
+    const redundant_ports& red = redundant_[path.outport];
+    if (red.ports == 0) return false;
+
+    int next_index = geom_paths_[red.geometric_id].next_index();
+    uint64_t ports = red.ports;
+    for (int i=0; i < next_index; ++i){
+      ports &= ports - 1; //drop the lowest port
+    }
+    path.geometric_id = red.geometric_id;
+    path.outport = __builtin_ctzll(ports);
+    return true;
+  }
+
+  void
+  cache_redundant_paths(int outport, routable::path_set& paths){
+    if (outport < 0 || outport >= redundant_.size() || paths.size() == 0) return;
+
+    //only sets that a bitset can reproduce in order
+    uint64_t ports = 0;
+    int geometric_id = paths[0].geometric_id;
+    int last_port = -1;
+    for (int i=0; i < paths.size(); ++i){
+      int port = paths[i].outport;
+      if (port <= last_port || port >= 64 || paths[i].geometric_id != geometric_id){
+        return;
+      }
+      ports |= uint64_t(1) << port;
+      last_port = port;
+    }
+    redundant_[outport].geometric_id = geometric_id;
+    redundant_[outport].ports = ports;
+  }
+
  public:
   multipath_router(sprockit::sim_parameters* params, topology* top, network_switch* netsw) :
     ParentRouter(params, top, netsw),
@@ -61,14 +115,26 @@ class multipath_router :
     for (int i=0; i < npaths; ++i){
       geom_paths_[i].redundancy = reds[i];
     }
+
+    if (params->get_optional_bool_param("route_table", false)){
+      //redundant paths only depend on the structural outport
+      redundant_.resize(top->max_num_ports());
+    }
   }
 
   virtual void
   route(packet* pkt){
-    routable::path_set paths;
     ParentRouter::route(pkt);
     routable::path& path = pkt->interface<routable>()->current_path();
+    if (cached_redundant_path(path)){
+      debug_printf(sprockit::dbg::router,
+        "multipath routing: using cached port %d", path.outport);
+      return;
+    }
+
+    routable::path_set paths;
     top_->get_redundant_paths(path, paths);
+    cache_redundant_paths(path.outport, paths);
 
     int path_id = paths[0].geometric_id;
     int next_index = geom_paths_[path_id].next_index();
@@ -79,6 +145,8 @@ class multipath_router :
 
  private:
   std::vector<multipath> geom_paths_;
+  /** Indexed by structural outport, empty unless route_table is set */
+  std::vector<redundant_ports> redundant_;
   multipath_topology* top_;
 
 };
@@ -25,6 +25,8 @@ RegisterNamespaces("router");
 RegisterKeywords(
 "router",
 "ugal_threshold",
+"route_table",
+"route_table_eager_limit",
 );
 
 namespace sstmac {
@@ -0,0 +1,163 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/hardware/router/routing_table.h>
+#include <sstmac/common/thread_lock.h>
+#include <sprockit/spkt_string.h>
+#include <algorithm>
+
+namespace sstmac {
+namespace hw {
+
+/** Totals of tables that have already been destroyed */
+struct routing_table_totals {
+  int num_tables;
+  uint64_t bytes;
+  uint64_t hits;
+  uint64_t fills;
+  uint64_t live;
+};
+
+static routing_table_totals retired_ = { 0, 0, 0, 0, 0 };
+static std::vector<routing_table*>* all_tables_ = 0;
+static thread_lock tables_lock_;
+
+routing_table::routing_table(topology* top, switch_id addr, bool eager) :
+  top_(top),
+  addr_(addr),
+  num_pages_allocated_(0),
+  hits_(0),
+  fills_(0),
+  live_(0)
+{
+  int max_sid = top_->max_switch_id();
+  num_pages_ = (max_sid + page_size - 1) / page_size;
+  pages_.assign(num_states * num_pages_, nullptr);
+
+  tables_lock_.lock();
+  if (!all_tables_) all_tables_ = new std::vector<routing_table*>;
+  all_tables_->push_back(this);
+  tables_lock_.unlock();
+
+  if (eager){
+    for (int i=0; i < max_sid; ++i){
+      switch_id dst(i);
+      if (dst == addr_ || !top_->switch_id_slot_filled(dst)) continue;
+      if (top_->minimal_route_cacheable(addr_, dst)){
+        routable::path path;
+        fill(dst, path);
+      } else {
+        //computing the route here would draw from the topology random stream
+        get_entry(dst, 0).outport = live;
+      }
+    }
+  }
+}
+
+routing_table::~routing_table()
+{
+  tables_lock_.lock();
+  retired_.num_tables++;
+  retired_.bytes += num_bytes();
+  retired_.hits += hits_;
+  retired_.fills += fills_;
+  retired_.live += live_;
+  auto iter = std::find(all_tables_->begin(), all_tables_->end(), this);
+  all_tables_->erase(iter);
+  tables_lock_.unlock();
+
+  for (entry* page : pages_){
+    delete[] page;
+  }
+}
+
+uint64_t
+routing_table::num_bytes() const
+{
+  return uint64_t(num_pages_allocated_) * page_size * sizeof(entry)
+      + pages_.size() * sizeof(entry*);
+}
+
+routing_table::entry&
+routing_table::get_entry(switch_id dst, uint32_t state)
+{
+  entry*& page = pages_[state*num_pages_ + dst / page_size];
+  if (!page){
+    page = new entry[page_size];
+    for (int i=0; i < page_size; ++i){
+      page[i].outport = empty;
+    }
+    ++num_pages_allocated_;
+  }
+  return page[dst % page_size];
+}
+
+void
+routing_table::fill(switch_id dst, routable::path& path)
+{
+  uint32_t state = path.metadata.bit_integer();
+  bool cacheable = top_->minimal_route_cacheable(addr_, dst);
+  top_->minimal_route_to_switch(addr_, dst, path);
+  if (state >= num_states){
+    //metadata this table does not know about
+    ++live_;
+    return;
+  }
+
+  ++fills_;
+  entry& e = get_entry(dst, state);
+  uint32_t metadata = path.metadata.bit_integer();
+  if (cacheable && path.outport >= 0 && path.outport <= INT16_MAX
+      && path.vc >= 0 && path.vc <= UINT8_MAX && metadata <= UINT8_MAX){
+    e.outport = path.outport;
+    e.vc = path.vc;
+    e.metadata = metadata;
+  } else {
+    e.outport = live;
+  }
+}
+
+int
+routing_table::num_tables()
+{
+  tables_lock_.lock();
+  int ntables = retired_.num_tables + (all_tables_ ? all_tables_->size() : 0);
+  tables_lock_.unlock();
+  return ntables;
+}
+
+void
+routing_table::print_stats(std::ostream& os)
+{
+  tables_lock_.lock();
+  routing_table_totals totals = retired_;
+  if (all_tables_){
+    for (routing_table* table : *all_tables_){
+      totals.num_tables++;
+      totals.bytes += table->num_bytes();
+      totals.hits += table->hits_;
+      totals.fills += table->fills_;
+      totals.live += table->live_;
+    }
+  }
+  tables_lock_.unlock();
+
+  uint64_t lookups = totals.hits + totals.fills + totals.live;
+  double hit_rate = lookups ? 100.0*double(totals.hits)/double(lookups) : 0;
+  os << sprockit::printf("Routing tables: %d switches, %lu bytes (%lu bytes/switch)\n",
+                         totals.num_tables, totals.bytes,
+                         totals.num_tables ? totals.bytes / totals.num_tables : 0);
+  os << sprockit::printf("  %lu hits, %lu fills, %lu computed live (%6.2f%% hit rate)\n",
+                         totals.hits, totals.fills, totals.live, hit_rate);
+}
+
+}
+}
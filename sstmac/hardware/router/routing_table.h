@@ -0,0 +1,149 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_HARDWARE_ROUTER_ROUTING_TABLE_H_INCLUDED
+#define SSTMAC_HARDWARE_ROUTER_ROUTING_TABLE_H_INCLUDED
+
+#include <sstmac/common/node_address.h>
+#include <sstmac/hardware/router/routable.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <stdint.h>
+#include <iostream>
+#include <vector>
+
+namespace sstmac {
+namespace hw {
+
+/**
+ * @brief The routing_table class
+ * Forwarding table for a single switch mapping a destination switch
+ * to the outport, vc, and metadata computed by topology::minimal_route_to_switch.
+ * Since the topology may read the path metadata (e.g. to track dateline crossings),
+ * entries are kept separately for each value of the incoming metadata bits.
+ * Entries are stored in fixed-size pages that are only allocated once a destination
+ * in the page is used. An eager table fills the entries for fresh packets
+ * (no metadata bits set) of every destination at construction.
+ * Routes the topology marks as not cacheable are recomputed on every call.
+ */
+class routing_table
+{
+ public:
+  routing_table(topology* top, switch_id addr, bool eager);
+
+  ~routing_table();
+
+  /**
+   * @brief route Equivalent to top->minimal_route_to_switch(addr, dst, path)
+   * @param dst   The destination switch
+   * @param path  [inout] Metadata is read, outport/vc/metadata are written
+   */
+  void
+  route(switch_id dst, routable::path& path){
+    uint32_t state = path.metadata.bit_integer();
+    if (state < num_states){
+      entry* page = pages_[state*num_pages_ + dst / page_size];
+      if (page){
+        const entry& e = page[dst % page_size];
+        if (e.outport >= 0){
+          ++hits_;
+          path.outport = e.outport;
+          path.vc = e.vc;
+          path.metadata.set_bit_integer(e.metadata);
+          return;
+        } else if (e.outport == live){
+          ++live_;
+          top_->minimal_route_to_switch(addr_, dst, path);
+          return;
+        }
+      }
+    }
+    fill(dst, path);
+  }
+
+  /**
+   * @return The bytes currently allocated for entries and the page index
+   */
+  uint64_t
+  num_bytes() const;
+
+  uint64_t
+  num_hits() const {
+    return hits_;
+  }
+
+  uint64_t
+  num_fills() const {
+    return fills_;
+  }
+
+  uint64_t
+  num_live() const {
+    return live_;
+  }
+
+  /**
+   * @brief print_stats Print table memory and lookups aggregated over all tables
+   * @param os The stream to print to
+   */
+  static void
+  print_stats(std::ostream& os);
+
+  /**
+   * @return The number of tables ever created
+   */
+  static int
+  num_tables();
+
+ private:
+  struct entry {
+    int16_t outport;
+    uint8_t vc;
+    uint8_t metadata;
+  };
+
+  /** The routable metadata slots give 8 possible incoming states */
+  static const uint32_t num_states = 8;
+
+  static const int page_size = 64;
+
+  static const int16_t empty = -1;
+
+  static const int16_t live = -2;
+
+  void
+  fill(switch_id dst, routable::path& path);
+
+  entry&
+  get_entry(switch_id dst, uint32_t state);
+
+  topology* top_;
+
+  switch_id addr_;
+
+  int num_pages_;
+
+  int num_pages_allocated_;
+
+  /** Indexed by state*num_pages + dst/page_size, null until used */
+  std::vector<entry*> pages_;
+
+  uint64_t hits_;
+
+  uint64_t fills_;
+
+  uint64_t live_;
+
+};
+
+}
+}
+
+#endif
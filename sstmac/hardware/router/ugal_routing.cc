@@ -36,7 +36,7 @@ ugal_router::initial_step(
   int min_dst = top_->minimal_distance(src, dst);
   if (min_dst <= val_threshold_) {
     // Too close - ignore valiant.
-    top_->minimal_route_to_switch(my_addr_, ej_addr, path);
+    minimal_route(ej_addr, path);
     // Still need to set vc - might need to use valiant at some point.
     path.vc = zero_stage_vc(path.vc);
     return minimal;
@@ -98,7 +98,7 @@ valiant_router::route_valiant(packet* pkt)
   switch (ac){
     case intermediate_switch:
     {
-      top_->minimal_route_to_switch(my_addr_, rtbl->dest_switch(), path);
+      minimal_route(rtbl->dest_switch(), path);
       configure_intermediate_path(path);
       break;
     }
@@ -108,7 +108,7 @@ valiant_router::route_valiant(packet* pkt)
       if (sid == my_addr_){
         configure_ejection_path(path);
       } else {
-        top_->minimal_route_to_switch(my_addr_, sid, path);
+        minimal_route(sid, path);
         configure_final_path(path);
       }
     }
@@ -49,6 +49,19 @@ dist_dummy_switch::to_string() const
   return sprockit::printf("dummy switch %d", int(my_addr_));
 }
 
+void
+dist_dummy_switch::credit_stub::handle(event* ev)
+{
+  spkt_throw(sprockit::illformed_error,
+    "dist_dummy_switch::credit_stub::handle: should never actually handle a message");
+}
+
+std::string
+dist_dummy_switch::credit_stub::to_string() const
+{
+  return sprockit::printf("dummy switch %d credits", int(event_location().id()));
+}
+
   }
 }
 
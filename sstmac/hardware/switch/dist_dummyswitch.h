@@ -35,7 +35,8 @@ class dist_dummy_switch :
   dist_dummy_switch(sprockit::sim_parameters* params, uint64_t sid, event_manager* mgr,
                     device_id::type_t ty)
     : network_switch(params, sid, mgr),
-      event_handler(device_id(sid, ty))
+      event_handler(device_id(sid, ty)),
+      credit_handler_(sid)
   {
   }
 
@@ -49,7 +50,7 @@ class dist_dummy_switch :
 
   link_handler*
   credit_handler(int port) const override {
-    return const_cast<dist_dummy_switch*>(this);
+    return const_cast<credit_stub*>(&credit_handler_);
   }
 
   void compatibility_check() const override {}
@@ -84,6 +85,31 @@ class dist_dummy_switch :
     return 0;
   }
 
+ private:
+  /**
+   * Credits and payloads for the same remote switch must land on
+   * different handlers on the owning rank, so credits are sent
+   * to a separate stub tagged as router_credit
+   */
+  class credit_stub : public event_handler {
+   public:
+    credit_stub(uint64_t sid) :
+      event_handler(device_id(sid, device_id::router_credit))
+    {
+    }
+
+    std::string
+    to_string() const override;
+
+    bool
+    ipc_handler() const override {
+      return true;
+    }
+
+    void handle(event *ev) override;
+  };
+
+  credit_stub credit_handler_;
 
 };
 
@@ -214,6 +214,15 @@ dragonfly::minimal_route_to_switch(
   }
 }
 
+bool
+dragonfly::minimal_route_cacheable(switch_id src, switch_id dst) const
+{
+  int srcX, srcY, srcG; get_coords(src, srcX, srcY, srcG);
+  int dstG = computeG(dst);
+  //gateways to groups not directly connected are picked at random
+  return srcG == dstG || xy_connected_to_group(srcX, srcY, srcG, dstG);
+}
+
 int
 dragonfly::minimal_distance(switch_id src, switch_id dst) const
 {
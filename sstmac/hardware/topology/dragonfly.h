@@ -140,6 +140,11 @@ class dragonfly : public cartesian_topology
     return (sid / (x_*y_));
   }
 
+  int
+  switch_group(switch_id sid) const override {
+    return computeG(sid);
+  }
+
   virtual int
   num_switches() const override {
     return x_ * y_ * g_;
@@ -155,6 +160,9 @@ class dragonfly : public cartesian_topology
       switch_id dest_sw_addr,
       routable::path &path) const override;
 
+  bool
+  minimal_route_cacheable(switch_id src, switch_id dst) const override;
+
   int
   minimal_distance(switch_id src, switch_id dst) const override;
 
@@ -160,6 +160,16 @@ class fat_tree :
     col = sid % numleafswitches_;
   }
 
+  /**
+   * Leaf switches sharing their first level of up switches form a group
+   */
+  int
+  switch_group(switch_id sid) const override {
+    int row, col;
+    compute_row_col(sid, row, col);
+    return col / k_;
+  }
+
   static int
   upColumnConnection(int k, int myColumn, int upPort, int columnSize);
 
@@ -245,6 +255,11 @@ class tapered_fat_tree : public abstract_fat_tree
   int
   level(switch_id sid) const;
 
+  int
+  switch_group(switch_id sid) const override {
+    return sub_tree(sid);
+  }
+
   inline int inj_sub_tree(switch_id sid) const {
     return sid / num_inj_switches_per_subtree_;
   }
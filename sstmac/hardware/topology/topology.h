@@ -218,6 +218,18 @@ class topology : public sprockit::printable
   virtual switch_id
   node_to_injection_switch(node_id addr, int& port) const = 0;
 
+  /**
+   * @brief switch_group Switches in the same group reach each other
+   *        without crossing the global links of the network.
+   *        Topology-aware collectives combine data within a group first.
+   * @param sid
+   * @return The group the switch belongs to. By default each switch is its own group.
+   */
+  virtual int
+  switch_group(switch_id sid) const {
+    return sid;
+  }
+
   /**
     This gives the minimal distance counting the number of hops between switches.
     @param src. The source switch.
@@ -280,6 +292,20 @@ class topology : public sprockit::printable
     switch_id dest_sw_addr,
     routable::path& path) const = 0;
 
+  /**
+   * @brief minimal_route_cacheable
+   * Whether minimal_route_to_switch always returns the same outport, vc,
+   * and metadata for this pair of switches given the same input metadata.
+   * Routes that make random choices must not be stored in a routing table.
+   * @param src The current switch
+   * @param dst The destination switch
+   * @return Whether the route can be computed once and reused
+   */
+  virtual bool
+  minimal_route_cacheable(switch_id src, switch_id dst) const {
+    return true;
+  }
+
   virtual bool
   node_to_netlink(node_id nid, node_id& net_id, int& offset) const = 0;
 
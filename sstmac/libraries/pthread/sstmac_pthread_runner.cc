@@ -36,6 +36,7 @@ void
 pthread_runner::run()
 {
   p_txt_ = parent_app_->get_process_context();
+  share_globals(parent_app_);
   start_routine_(arg_);
 }
 
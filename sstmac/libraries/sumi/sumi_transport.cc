@@ -11,6 +11,19 @@
 #include <sumi/message.h>
 #include <sprockit/output.h>
 #include <sstmac/common/runtime.h>
+#include <sstmac/hardware/topology/structured_topology.h>
+#include <sumi/collective_model.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+
+RegisterNamespaces("collective_model");
+RegisterKeywords(
+"collectives",
+"latency",
+"overhead",
+"bandwidth",
+"diameter",
+);
 
 using namespace sprockit::dbg;
 
@@ -90,6 +103,46 @@ class sumi_server :
 
 RegisterAPI("sumi_transport", sumi_transport);
 
+//shared by all ranks, the first transport configures it
+static sumi::collective_model* collective_model = nullptr;
+
+/**
+ * Fill in the message latency and bandwidth of the collective model
+ * from the machine if they are not given. A message is charged the
+ * injection latency at both ends and one hop per link of the longest
+ * minimal path, at the bandwidth of a network link.
+ */
+static void
+add_collective_model_defaults(sprockit::sim_parameters* model_params,
+                              sprockit::sim_parameters* node_params)
+{
+  sprockit::sim_parameters* link_params =
+      node_params->get_namespace("switch")->get_namespace("link");
+  if (!model_params->has_param("bandwidth")){
+    model_params->add_param_override("bandwidth", link_params->get_param("bandwidth"));
+  }
+
+  if (!model_params->has_param("latency")){
+    double hop_latency = link_params->has_param("send_latency")
+        ? link_params->get_time_param("send_latency")
+        : link_params->get_time_param("latency");
+    double inj_latency = node_params->get_namespace("nic")
+        ->get_namespace("injection")->get_time_param("latency");
+    int diameter = model_params->get_optional_int_param("diameter", -1);
+    if (diameter < 0){
+      hw::structured_topology* top =
+          dynamic_cast<hw::structured_topology*>(hw::topology::global());
+      if (!top){
+        spkt_abort_printf("collective_model: topology has no diameter - "
+                          "specify collective_model.diameter or latency");
+      }
+      diameter = top->diameter();
+    }
+    double latency = 2*inj_latency + diameter*hop_latency;
+    model_params->add_param_override("latency", latency*1e9, "ns");
+  }
+}
+
 sumi_transport::sumi_transport(sprockit::sim_parameters* params,
                const char* prefix,
                sstmac::sw::software_id sid,
@@ -130,6 +183,15 @@ sumi_transport::sumi_transport(sprockit::sim_parameters* params,
   nproc_ = rank_mapper_->nproc();
   loc_ = os_->event_location();
 
+  if (params->has_namespace("collective_model")){
+    if (!collective_model){
+      sprockit::sim_parameters* model_params = params->get_namespace("collective_model");
+      add_collective_model_defaults(model_params, os_->params());
+      collective_model = new sumi::collective_model(model_params);
+    }
+    set_collective_cost_model(collective_model);
+  }
+
   server->register_proc(rank_, this);
 }
 
@@ -344,6 +406,19 @@ sumi_transport::wall_time() const
   return now().sec();
 }
 
+bool
+sumi_transport::rank_location(int global_rank, int& node, int& group) const
+{
+  hw::topology* top = hw::topology::global();
+  if (!top) return false;
+
+  node = rank_mapper_->node_assignment(global_rank);
+  int port;
+  switch_id sid = top->node_to_injection_switch(node, port);
+  group = top->switch_group(sid);
+  return true;
+}
+
 void
 sumi_transport::do_send_ping_request(int dst)
 {
@@ -510,6 +585,15 @@ sumi_transport::delayed_transport_handle(const sumi::message::ptr &msg)
   schedule_delay(sstmac::timestamp(1e-9), done_ev);
 }
 
+void
+sumi_transport::schedule_collective_done(const sumi::collective_done_message::ptr& msg,
+                                         double delay)
+{
+  sstmac::callback* done_ev = sstmac::new_callback(
+        loc_, this, &transport::handle, sumi::message::ptr(msg));
+  schedule_delay(sstmac::timestamp(delay), done_ev);
+}
+
 void
 sumi_transport::schedule_ping_timeout(sumi::pinger* pnger, double to)
 {
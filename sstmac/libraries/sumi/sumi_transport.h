@@ -82,6 +82,9 @@ class sumi_transport :
   double
   wall_time() const override;
 
+  bool
+  rank_location(int global_rank, int& node, int& group) const override;
+
   sumi::message::ptr
   poll_pending_messages(bool blocking, double timeout = -1) override;
 
@@ -135,6 +138,10 @@ class sumi_transport :
   void
   delayed_transport_handle(const sumi::message::ptr& msg) override;
 
+  void
+  schedule_collective_done(const sumi::collective_done_message::ptr& msg,
+                           double delay) override;
+
   void
   schedule_ping_timeout(sumi::pinger* pnger, double to) override;
 
@@ -140,7 +140,7 @@ static void
 wait_sims(Simulation** sims, int nsims, double** results, int nresults, uq_spawn_type_t spawn_ty)
 {
   for (int i=0; i < nsims; ++i){
-    if (spawn_ty == Fork) sims[i]->waitFork();
+    if (spawn_ty != MPIScan) sims[i]->waitFork();
     else                  sims[i]->waitMPIScan();
     results[i] = sims[i]->results();
     if (sims[i]->numResults() != nresults){
@@ -271,6 +271,7 @@ sstmac_uq_run(void* queue,
   q->buildUp();
 
   sprockit::sim_parameters params;
+  std::vector<sprockit::sim_parameters*> sweep_points;
 
 
   for (int j=0; j < njobs; ++j){
@@ -282,6 +283,13 @@ sstmac_uq_run(void* queue,
     if (spawn_ty == Fork){
       sims[num_running++] = q->fork(params, nresults, results[j]);
     }
+    else if (spawn_ty == ForkAtDivergence){
+      //the batch forks together once it is full
+      sprockit::sim_parameters* point = new sprockit::sim_parameters;
+      params.combine_into(point);
+      sweep_points.push_back(point);
+      ++num_running;
+    }
     else if (spawn_ty == MPIScan){
       sims[num_running++] = send_scan_point(q, params, bufferPtr,
                                 nparams, results[j], nresults, param_names, param_values[j]);
@@ -292,7 +300,18 @@ sstmac_uq_run(void* queue,
     }
 
     if (num_running == max_nthread || j == last_job){
+      if (spawn_ty == ForkAtDivergence){
+        std::vector<Simulation*> batch = q->forkSweep(sweep_points,
+                                            nresults, results + result_offset);
+        for (int i=0; i < num_running; ++i){
+          sims[i] = batch[i];
+        }
+      }
       wait_sims(sims, num_running, results+result_offset, nresults, spawn_ty);
+      for (sprockit::sim_parameters* point : sweep_points){
+        delete point;
+      }
+      sweep_points.clear();
       debug_printf(sprockit::dbg::uq,
                    "Finished through simulation point %d", j);
       result_offset += num_running;
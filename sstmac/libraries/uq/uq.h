@@ -17,7 +17,10 @@ typedef enum {
 
 typedef enum {
   Fork,
-  MPIScan
+  MPIScan,
+  /** Simulate the startup shared by a batch of jobs once, then fork
+      at the divergence point, see SimulationQueue::forkSweep */
+  ForkAtDivergence
 } uq_spawn_type_t;
 
 typedef struct 
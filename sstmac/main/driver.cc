@@ -2,6 +2,8 @@
 #include <sstmac/common/sstmac_config.h>
 #include <sstmac/common/sstmac_env.h>
 #include <sstmac/backends/native/manager.h>
+#include <sstmac/common/runtime.h>
+#include <sstmac/common/event_manager.h>
 #include <sprockit/errors.h>
 #include <sprockit/fileio.h>
 #include <sprockit/statics.h>
@@ -10,6 +12,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -343,6 +346,126 @@ SimulationQueue::fork(sprockit::sim_parameters* params, int nresults, double* re
 }
 
 
+/**
+ * Forks the sweep leader into one process per point at the divergence point.
+ * The leader itself only ever simulates the shared prefix.
+ */
+class sweep_diverger : public divergence_handler
+{
+ public:
+  sweep_diverger(const std::vector<sprockit::sim_parameters*>& points,
+                 const std::vector<int>& fds) :
+    points_(points), fds_(fds), point_(-1)
+  {
+  }
+
+  void diverge() override {
+    if (event_manager::global && event_manager::global->nthread() > 1){
+      spkt_throw(sprockit::unimplemented_error,
+        "warm-start sweeps cannot fork a multithreaded simulation");
+    }
+
+    //don't repeat buffered output from the prefix in every point
+    std::cout.flush();
+    std::cerr.flush();
+    fflush(stdout);
+    fflush(stderr);
+
+    std::vector<pid_t> children;
+    for (int i=0; i < points_.size(); ++i){
+      pid_t pid = ::fork();
+      if (pid == 0){
+        point_ = i;
+        for (int j=0; j < points_.size(); ++j){
+          if (j != i) close(fds_[2*j+WRITE]);
+        }
+        points_[i]->combine_into(sstmac::env::params, false, true, true);
+        driver_debug("sweep point %d diverged at t=%8.4es",
+          i, event_manager::global ? event_manager::global->now().sec() : 0.);
+        return;
+      }
+      children.push_back(pid);
+    }
+
+    for (pid_t pid : children){
+      int status;
+      waitpid(pid, &status, 0);
+    }
+    _exit(0);
+  }
+
+  /** The point this process continues as, negative in the leader */
+  int
+  point() const {
+    return point_;
+  }
+
+ private:
+  const std::vector<sprockit::sim_parameters*>& points_;
+  const std::vector<int>& fds_;
+  int point_;
+
+};
+
+std::vector<Simulation*>
+SimulationQueue::forkSweep(const std::vector<sprockit::sim_parameters*>& points,
+                           int nresults, double** resultPtrs)
+{
+  if (nproc_ > 1){
+    spkt_throw(sprockit::unimplemented_error,
+      "SimulationQueue::forkSweep: warm-start sweeps only run on one process");
+  }
+
+  int npoints = points.size();
+  std::vector<int> fds(2*npoints);
+  for (int i=0; i < npoints; ++i){
+    if (pipe(&fds[2*i]) == -1){
+      fprintf(stderr, "failed opening pipe\n");
+      abort();
+    }
+  }
+
+  pid_t pid = ::fork();
+
+  if (pid == 0){
+    for (int i=0; i < npoints; ++i){
+      close(fds[2*i+READ]);
+    }
+    sweep_diverger diverger(points, fds);
+    runtime::set_divergence_handler(&diverger);
+    sprockit::sim_parameters params;
+    sim_stats stats;
+    run(&params, stats);
+    runtime::set_divergence_handler(nullptr);
+
+    int point = diverger.point();
+    if (point < 0){
+      fprintf(stderr, "sweep simulation finished before reaching its divergence point\n");
+      exit(1);
+    }
+    stats.numResults = num_results_;
+    write(fds[2*point+WRITE], &stats, sizeof(sim_stats));
+    if (results_)
+      write(fds[2*point+WRITE], results_, num_results_*sizeof(double));
+    close(fds[2*point+WRITE]);
+    exit(0);
+  }
+
+  driver_debug("forked sweep leader %d for %d points", pid, npoints);
+  std::vector<Simulation*> sims(npoints);
+  for (int i=0; i < npoints; ++i){
+    close(fds[2*i+WRITE]);
+    Simulation* sim = new Simulation;
+    sim->setResults(resultPtrs ? resultPtrs[i] : nullptr, nresults);
+    sim->setPid(pid);
+    sim->setParameters(points[i]);
+    sim->setPipe(&fds[2*i]);
+    pending_.push_back(sim);
+    sims[i] = sim;
+  }
+  return sims;
+}
+
 Simulation*
 SimulationQueue::waitForForked()
 {
@@ -352,7 +475,8 @@ SimulationQueue::waitForForked()
       Simulation* sim = *it;
       int status;
       pid_t result = waitpid(sim->pid(), &status, WNOHANG);
-      if (result > 0){
+      //points of a sweep share a process that may already be reaped
+      if (result > 0 || (result < 0 && errno == ECHILD)){
         driver_debug("waited on process %d", sim->pid());
         pending_.erase(it);
         sim->finalize();
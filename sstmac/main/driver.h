@@ -6,6 +6,7 @@
 #include <sstmac/main/sstmac.h>
 #include <sstmac/common/sstmac_config.h>
 #include <list>
+#include <vector>
 #include <iostream>
 #include <sstmac/libraries/uq/uq.h>
 
@@ -221,6 +222,22 @@ class SimulationQueue
     int nresults = 0, 
     double* resultPtr = nullptr);
 
+  /**
+   * Warm-start sweep: run the template parameters once up to the divergence
+   * point, then fork a process per point that merges the point's parameters
+   * into the live parameters and finishes the run from there.
+   * The divergence point is the first call to runtime::diverge by an app,
+   * or sweep_divergence_time. Only parameters read after it can differ
+   * between points. Requires a serial run.
+   * @param points The parameters of each point
+   * @param resultPtrs Optional array of result buffers, one per point
+   * @return A simulation per point, waited on like those from fork
+   */
+  std::vector<Simulation*>
+  forkSweep(const std::vector<sprockit::sim_parameters*>& points,
+    int nresults = 0,
+    double** resultPtrs = nullptr);
+
   Simulation*
   waitForForked();
 
@@ -0,0 +1,213 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sstmac/skeletons/sumi_undumpi/compact_replay.h>
+#include <sstmac/common/runtime.h>
+#include <sumi-mpi/mpi_api.h>
+#include <sumi-mpi/mpi_types.h>
+#include <sprockit/errors.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/keyword_registration.h>
+#include <iostream>
+#include <vector>
+
+RegisterKeywords(
+"compact_trace_fileroot",
+"compact_replay_timescale",
+);
+
+namespace sumi {
+
+using sstmac::sw::compact_record;
+
+SpktRegister("compact_replay", sstmac::sw::app, compact_replay,
+            "application for replaying compact traces converted from dumpi");
+
+compact_replay::compact_replay(sprockit::sim_parameters* params,
+                               sstmac::sw::software_id sid,
+                               sstmac::sw::operating_system* os) :
+  app(params, sid, os)
+{
+  fileroot_ = params->get_param("compact_trace_fileroot");
+  timescaling_ = params->get_optional_double_param("compact_replay_timescale", 1);
+}
+
+void
+compact_replay::skeleton_main()
+{
+  int rank = this->tid();
+  mpi_api* mpi = get_api<mpi_api>();
+
+  comms_[compact_record::comm_world] = MPI_COMM_WORLD;
+  comms_[compact_record::comm_self] = MPI_COMM_SELF;
+
+  sstmac::sw::compact_trace_reader reader(
+    sstmac::sw::compact_trace_file_name(rank, fileroot_));
+
+  sstmac::runtime::add_deadlock_check(
+    sstmac::new_deadlock_check(mpi, &sumi::transport::deadlock_check));
+  sstmac::runtime::enter_deadlock_region();
+
+  compact_record rec;
+  while (reader.next(rec)){
+    if (rec.compute > 0){
+      compute(timescaling_ * sstmac::timestamp::exact_nsec(rec.compute));
+    }
+    replay(mpi, rec);
+  }
+
+  if (rank == 0) {
+    std::cout << "Compact replay finalized on rank 0 - trace "
+      << fileroot_ << " successful!" << std::endl;
+  }
+
+  sstmac::runtime::exit_deadlock_region();
+}
+
+void
+compact_replay::replay(mpi_api* mpi, const compact_record& rec)
+{
+  switch (rec.op){
+    case compact_record::init:
+      mpi->do_init(nullptr, nullptr);
+      break;
+    case compact_record::finalize:
+      mpi->do_finalize();
+      break;
+    case compact_record::send:
+      mpi->send(NULL, rec.bytes, MPI_BYTE, get_peer(rec.peer),
+                get_tag(rec.tag), get_comm(rec.comm));
+      break;
+    case compact_record::recv:
+      mpi->recv(NULL, rec.bytes, MPI_BYTE, get_peer(rec.peer),
+                get_tag(rec.tag), get_comm(rec.comm), MPI_STATUS_IGNORE);
+      break;
+    case compact_record::isend: {
+      MPI_Request req;
+      mpi->isend(NULL, rec.bytes, MPI_BYTE, get_peer(rec.peer),
+                 get_tag(rec.tag), get_comm(rec.comm), &req);
+      requests_[rec.request] = req;
+      break;
+    }
+    case compact_record::irecv: {
+      MPI_Request req;
+      mpi->irecv(NULL, rec.bytes, MPI_BYTE, get_peer(rec.peer),
+                 get_tag(rec.tag), get_comm(rec.comm), &req);
+      requests_[rec.request] = req;
+      break;
+    }
+    case compact_record::wait:
+      mpi->wait(get_request(rec.request), MPI_STATUS_IGNORE);
+      requests_.erase(rec.request);
+      break;
+    case compact_record::waitall: {
+      std::vector<MPI_Request> reqs;
+      reqs.reserve(rec.aux.size());
+      for (int64_t id : rec.aux){
+        reqs.push_back(*get_request(id));
+      }
+      mpi->waitall(reqs.size(), reqs.data(), MPI_STATUSES_IGNORE);
+      for (int64_t id : rec.aux){
+        requests_.erase(id);
+      }
+      break;
+    }
+    case compact_record::sendrecv:
+      mpi->sendrecv(NULL, rec.bytes, MPI_BYTE, get_peer(rec.peer), get_tag(rec.tag),
+                    NULL, rec.aux[2], MPI_BYTE, get_peer(rec.aux[0]), get_tag(rec.aux[1]),
+                    get_comm(rec.comm), MPI_STATUS_IGNORE);
+      break;
+    case compact_record::barrier:
+      mpi->barrier(get_comm(rec.comm));
+      break;
+    case compact_record::bcast:
+      mpi->bcast(rec.bytes, MPI_BYTE, rec.peer, get_comm(rec.comm));
+      break;
+    case compact_record::reduce:
+      mpi->reduce(rec.bytes, MPI_BYTE, MPI_SUM, rec.peer, get_comm(rec.comm));
+      break;
+    case compact_record::allreduce:
+      mpi->allreduce(rec.bytes, MPI_BYTE, MPI_SUM, get_comm(rec.comm));
+      break;
+    case compact_record::allgather:
+      mpi->allgather(rec.bytes, MPI_BYTE, rec.bytes, MPI_BYTE, get_comm(rec.comm));
+      break;
+    case compact_record::alltoall:
+      mpi->alltoall(rec.bytes, MPI_BYTE, rec.bytes, MPI_BYTE, get_comm(rec.comm));
+      break;
+    case compact_record::gather:
+      mpi->gather(rec.bytes, MPI_BYTE, rec.bytes, MPI_BYTE, rec.peer, get_comm(rec.comm));
+      break;
+    case compact_record::scatter:
+      mpi->scatter(rec.bytes, MPI_BYTE, rec.bytes, MPI_BYTE, rec.peer, get_comm(rec.comm));
+      break;
+    case compact_record::comm_dup: {
+      MPI_Comm newcomm;
+      mpi->comm_dup(get_comm(rec.comm), &newcomm);
+      comms_[rec.request] = newcomm;
+      break;
+    }
+    case compact_record::comm_split: {
+      MPI_Comm newcomm;
+      mpi->comm_split(get_comm(rec.comm), rec.peer, rec.tag, &newcomm);
+      comms_[rec.request] = newcomm;
+      break;
+    }
+    case compact_record::comm_free: {
+      MPI_Comm comm = get_comm(rec.comm);
+      mpi->comm_free(&comm);
+      comms_.erase(rec.comm);
+      break;
+    }
+    case compact_record::num_ops:
+      spkt_throw_printf(sprockit::value_error,
+        "compact_replay: invalid op in trace %s", fileroot_.c_str());
+  }
+}
+
+MPI_Comm
+compact_replay::get_comm(int64_t id)
+{
+  auto it = comms_.find(id);
+  if (it == comms_.end()){
+    spkt_throw_printf(sprockit::value_error,
+      "compact_replay: no match for communicator %ld", id);
+  }
+  return it->second;
+}
+
+MPI_Request*
+compact_replay::get_request(int64_t id)
+{
+  if (id == compact_record::null_request){
+    requests_[id] = MPI_REQUEST_NULL;
+  }
+  auto it = requests_.find(id);
+  if (it == requests_.end()){
+    spkt_throw_printf(sprockit::value_error,
+      "compact_replay: no match for request %ld", id);
+  }
+  return &it->second;
+}
+
+int
+compact_replay::get_peer(int64_t peer) const
+{
+  return peer == compact_record::any_source ? MPI_ANY_SOURCE : int(peer);
+}
+
+int
+compact_replay::get_tag(int64_t tag) const
+{
+  return tag == compact_record::any_tag ? MPI_ANY_TAG : int(tag);
+}
+
+}
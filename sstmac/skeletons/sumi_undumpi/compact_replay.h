@@ -0,0 +1,68 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_SOFTWARE_SKELETONS_UNDUMPI_COMPACT_REPLAY_H_INCLUDED
+#define SSTMAC_SOFTWARE_SKELETONS_UNDUMPI_COMPACT_REPLAY_H_INCLUDED
+
+#include <sstmac/software/process/app.h>
+#include <sstmac/dumpi_util/compact_trace.h>
+#include <sumi-mpi/mpi_api_fwd.h>
+#include <sumi-mpi/sstmac_mpi_integers.h>
+#include <map>
+
+namespace sumi {
+
+/**
+ * Replays a compact trace converted from a DUMPI trace.
+ * Each rank reads fileroot-NNNN.sct and issues the same MPI calls
+ * parsedumpi would for the original trace.
+ */
+class compact_replay : public sstmac::sw::app
+{
+ public:
+  compact_replay(sprockit::sim_parameters* params, sstmac::sw::software_id sid,
+                 sstmac::sw::operating_system* os);
+
+  virtual
+  ~compact_replay() throw () {}
+
+  virtual void
+  skeleton_main();
+
+ private:
+  void
+  replay(mpi_api* mpi, const sstmac::sw::compact_record& rec);
+
+  MPI_Comm
+  get_comm(int64_t id);
+
+  MPI_Request*
+  get_request(int64_t id);
+
+  int
+  get_peer(int64_t peer) const;
+
+  int
+  get_tag(int64_t tag) const;
+
+  std::string fileroot_;
+
+  double timescaling_;
+
+  std::map<int64_t, MPI_Comm> comms_;
+
+  std::map<int64_t, MPI_Request> requests_;
+
+};
+
+}
+
+#endif
@@ -16,6 +16,7 @@
 #include <sstmac/skeletons/sumi_undumpi/parsedumpi.h>
 #include <sstmac/skeletons/sumi_undumpi/parsedumpi_callbacks.h>
 #include <sstmac/dumpi_util/dumpi_meta.h>
+#include <sstmac/dumpi_util/dumpi_prefetch.h>
 #include <sstmac/dumpi_util/dumpi_util.h>
 #include <sumi-mpi/mpi_api.h>
 #include <sprockit/errors.h>
@@ -31,6 +32,9 @@ RegisterKeywords(
 "parsedumpi_timescale",
 "parsedumpi_terminate_percent",
 "parsedumpi_print_progress",
+"parsedumpi_prefetch",
+"parsedumpi_prefetch_window",
+"parsedumpi_prefetch_files",
 "launch_dumpi_metaname",
 "dumpi_metaname",
 );
@@ -55,6 +59,11 @@ parsedumpi::parsedumpi(sprockit::sim_parameters* params, software_id sid,
   print_progress_ = params->get_optional_bool_param("parsedumpi_print_progress", true);
 
   percent_terminate_ = params->get_optional_double_param("parsedumpi_terminate_percent", -1);
+
+  bool prefetch = params->get_optional_bool_param("parsedumpi_prefetch", true);
+  prefetch_window_ = prefetch ?
+    params->get_optional_byte_length_param("parsedumpi_prefetch_window", 4*1024*1024) : 0;
+  prefetch_files_ = params->get_optional_int_param("parsedumpi_prefetch_files", 64);
 }
 
 mpi_api* 
@@ -96,8 +105,19 @@ void parsedumpi::skeleton_main()
     sstmac::new_deadlock_check(mpi(), &sumi::transport::deadlock_check));
   sstmac::runtime::enter_deadlock_region();
 
+  //ranks are started in order, so the files are queued in the order they are read
+  sstmac::sw::dumpi_prefetcher* prefetcher = nullptr;
+  if (prefetch_window_ > 0){
+    prefetcher = sstmac::sw::dumpi_prefetcher::instance(prefetch_window_, prefetch_files_);
+    prefetcher->add(fname);
+  }
+
   cbacks.parse_stream(fname.c_str(), print_my_progress, my_percent_terminate);
 
+  if (prefetcher){
+    prefetcher->done(fname);
+  }
+
   if (rank == 0) {
     std::cout << "Parsedumpi finalized on rank 0 - trace "
       << fileroot_ << " successful!" << std::endl;
@@ -63,6 +63,12 @@ class parsedumpi : public sstmac::sw::app
 
   std::string metafilename_;
 
+  /// The bytes read ahead per step, zero if trace files are not prefetched.
+  long prefetch_window_;
+
+  /// The most trace files held open for prefetching at once.
+  int prefetch_files_;
+
 
 };
 
@@ -0,0 +1,127 @@
+#include <sstmac/util.h>
+#include <sstmac/replacements/mpi.h>
+#include <sstmac/software/process/backtrace.h>
+#include <sumi-mpi/mpi_api.h>
+#include <sumi/collective_model.h>
+#include <sstmac/skeleton.h>
+#include <sprockit/keyword_registration.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/units.h>
+#include <cstdio>
+
+RegisterKeywords("sizes");
+
+#define sstmac_app_name mpi_collective_model
+
+/**
+ * Validates the collective model against the collectives it replaces.
+ * Every collective is timed over a sweep of sizes once simulated
+ * message by message and once resolved by the model. The time of a call
+ * is the longest time any rank spends in it.
+ */
+
+static const sumi::collective::type_t validated[] = {
+  sumi::collective::barrier,
+  sumi::collective::bcast,
+  sumi::collective::allreduce,
+  sumi::collective::allgather,
+  sumi::collective::alltoall
+};
+
+static void
+run_collective(sumi::collective::type_t ty, int count)
+{
+  switch (ty){
+    case sumi::collective::barrier:
+      MPI_Barrier(MPI_COMM_WORLD);
+      break;
+    case sumi::collective::bcast:
+      MPI_Bcast(NULL, count, MPI_BYTE, 0, MPI_COMM_WORLD);
+      break;
+    case sumi::collective::allreduce:
+      MPI_Allreduce(NULL, NULL, count, MPI_BYTE, MPI_SUM, MPI_COMM_WORLD);
+      break;
+    case sumi::collective::allgather:
+      MPI_Allgather(NULL, count, MPI_BYTE, NULL, count, MPI_BYTE, MPI_COMM_WORLD);
+      break;
+    case sumi::collective::alltoall:
+      MPI_Alltoall(NULL, count, MPI_BYTE, NULL, count, MPI_BYTE, MPI_COMM_WORLD);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @param model The model to resolve the collective with, null to simulate it
+ * @return The longest time any rank spent in the collective, on rank 0 only
+ */
+static double
+time_collective(sumi::transport* tport, sumi::collective_model* model,
+                sumi::collective::type_t ty, int count)
+{
+  //synchronizing calls are always simulated
+  tport->set_collective_cost_model(nullptr);
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  tport->set_collective_cost_model(model);
+  double start = MPI_Wtime();
+  run_collective(ty, count);
+  double elapsed = MPI_Wtime() - start;
+
+  tport->set_collective_cost_model(nullptr);
+  double max_elapsed = 0;
+  MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  return max_elapsed;
+}
+
+int USER_MAIN(int argc, char** argv)
+{
+  SSTMACBacktrace("main");
+  MPI_Init(&argc, &argv);
+
+  int me, nproc;
+  MPI_Comm_rank(MPI_COMM_WORLD, &me);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  sumi::transport* tport = current_mpi();
+  sumi::collective_model* model = tport->collective_cost_model();
+  if (!model){
+    spkt_abort_printf("mpi_collective_model: no collective_model namespace given to mpi");
+  }
+
+  std::vector<std::string> sizes;
+  get_params()->get_optional_vector_param("sizes", sizes);
+  if (sizes.empty()){
+    sizes = { "64B", "4KB", "256KB" };
+  }
+
+  if (me == 0){
+    printf("Collective model on %d ranks: latency=%8.4fus bandwidth=%8.4fGB/s\n",
+           nproc, model->latency()*1e6, model->bandwidth()/1e9);
+    printf("%12s %10s %14s %14s %8s\n",
+           "collective", "bytes", "simulated(us)", "model(us)", "ratio");
+  }
+
+  for (sumi::collective::type_t ty : validated){
+    for (const std::string& size : sizes){
+      bool error;
+      int count = sprockit::byte_length(size.c_str(), error);
+      if (error){
+        spkt_abort_printf("mpi_collective_model: invalid size %s", size.c_str());
+      }
+      if (ty == sumi::collective::barrier) count = 0;
+      double simulated = time_collective(tport, nullptr, ty, count);
+      double modeled = time_collective(tport, model, ty, count);
+      if (me == 0){
+        printf("%12s %10d %14.4f %14.4f %8.3f\n",
+               sumi::collective::tostr(ty), count,
+               simulated*1e6, modeled*1e6, modeled / simulated);
+      }
+      if (ty == sumi::collective::barrier) break;
+    }
+  }
+
+  MPI_Finalize();
+  return 0;
+}
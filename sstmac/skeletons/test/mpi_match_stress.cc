@@ -0,0 +1,156 @@
+#include <sstmac/util.h>
+#include <sstmac/replacements/mpi.h>
+#include <sstmac/software/process/backtrace.h>
+#include <sstmac/skeleton.h>
+#include <sprockit/keyword_registration.h>
+#include <sprockit/sim_parameters.h>
+#include <cstdio>
+#include <vector>
+
+RegisterKeywords("messages_per_rank");
+
+#define sstmac_app_name mpi_match_stress
+
+/**
+ * Stresses MPI receive matching with deep queues. Every rank sends
+ * messages_per_rank messages with tags 0..n-1 to rank 0, which matches them
+ * against many posted receives, against many unexpected messages and
+ * with wildcards. Receives are posted in the reverse order of the sends
+ * so every match is as deep in the queue as it can be. The envelope of
+ * every match is checked against MPI ordering rules.
+ */
+
+static int
+check(const MPI_Status& stat, int source, int tag)
+{
+  bool source_ok = source == MPI_ANY_SOURCE || stat.MPI_SOURCE == source;
+  bool tag_ok = tag == MPI_ANY_TAG || stat.MPI_TAG == tag;
+  return source_ok && tag_ok ? 0 : 1;
+}
+
+static void
+send_all(int nmsgs)
+{
+  for (int tag=0; tag < nmsgs; ++tag){
+    MPI_Send(NULL, 0, MPI_INT, 0, tag, MPI_COMM_WORLD);
+  }
+}
+
+/** Receives are all posted before any message is sent */
+static int
+posted_phase(int me, int nproc, int nmsgs)
+{
+  if (me != 0){
+    MPI_Barrier(MPI_COMM_WORLD);
+    send_all(nmsgs);
+    return 0;
+  }
+
+  int nrecvs = (nproc-1)*nmsgs;
+  std::vector<MPI_Request> reqs(nrecvs);
+  std::vector<MPI_Status> stats(nrecvs);
+  int idx = 0;
+  for (int tag=nmsgs-1; tag >= 0; --tag){
+    for (int src=nproc-1; src > 0; --src, ++idx){
+      MPI_Irecv(NULL, 0, MPI_INT, src, tag, MPI_COMM_WORLD, &reqs[idx]);
+    }
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Waitall(nrecvs, reqs.data(), stats.data());
+
+  int errors = 0;
+  idx = 0;
+  for (int tag=nmsgs-1; tag >= 0; --tag){
+    for (int src=nproc-1; src > 0; --src, ++idx){
+      errors += check(stats[idx], src, tag);
+    }
+  }
+  return errors;
+}
+
+/** Every message has arrived before any receive is posted */
+static int
+unexpected_phase(int me, int nproc, int nmsgs)
+{
+  if (me != 0){
+    send_all(nmsgs);
+    MPI_Barrier(MPI_COMM_WORLD);
+    return 0;
+  }
+
+  MPI_Barrier(MPI_COMM_WORLD);
+  int errors = 0;
+  for (int tag=nmsgs-1; tag >= 0; --tag){
+    for (int src=nproc-1; src > 0; --src){
+      MPI_Status stat;
+      MPI_Recv(NULL, 0, MPI_INT, src, tag, MPI_COMM_WORLD, &stat);
+      errors += check(stat, src, tag);
+    }
+  }
+  return errors;
+}
+
+/**
+ * Wildcard receives against a mix of posted and unexpected messages.
+ * Messages from one source must match in the order they were sent.
+ */
+static int
+wildcard_phase(int me, int nproc, int nmsgs)
+{
+  if (me != 0){
+    send_all(nmsgs);
+    return 0;
+  }
+
+  int errors = 0;
+  //any source with a given tag, in the reverse order of the sends
+  for (int tag=nmsgs-1; tag >= nmsgs/2; --tag){
+    for (int src=1; src < nproc; ++src){
+      MPI_Status stat;
+      MPI_Recv(NULL, 0, MPI_INT, MPI_ANY_SOURCE, tag, MPI_COMM_WORLD, &stat);
+      errors += check(stat, MPI_ANY_SOURCE, tag);
+    }
+  }
+  //any tag from a given source gets the rest in send order
+  for (int src=nproc-1; src > 0; --src){
+    for (int tag=0; tag < nmsgs/2; ++tag){
+      MPI_Status stat;
+      MPI_Recv(NULL, 0, MPI_INT, src, MPI_ANY_TAG, MPI_COMM_WORLD, &stat);
+      errors += check(stat, src, tag);
+    }
+  }
+  return errors;
+}
+
+int USER_MAIN(int argc, char** argv)
+{
+  SSTMACBacktrace("main");
+  MPI_Init(&argc, &argv);
+
+  int me, nproc;
+  MPI_Comm_rank(MPI_COMM_WORLD, &me);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  int nmsgs = get_params()->get_optional_int_param("messages_per_rank", 1000);
+
+  int errors = posted_phase(me, nproc, nmsgs);
+  if (me == 0){
+    printf("Matched %d messages to posted receives: %d errors\n",
+           (nproc-1)*nmsgs, errors);
+  }
+
+  errors = unexpected_phase(me, nproc, nmsgs);
+  if (me == 0){
+    printf("Matched %d unexpected messages: %d errors\n",
+           (nproc-1)*nmsgs, errors);
+  }
+
+  errors = wildcard_phase(me, nproc, nmsgs);
+  if (me == 0){
+    printf("Matched %d messages to wildcard receives: %d errors\n",
+           (nproc-1)*nmsgs, errors);
+  }
+
+  MPI_Finalize();
+  return 0;
+}
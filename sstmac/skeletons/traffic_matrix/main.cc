@@ -1,6 +1,7 @@
 #include <sprockit/sim_parameters.h>
 #include <sprockit/debug.h>
 #include <sstmac/common/sstmac_env.h>
+#include <sstmac/common/runtime.h>
 #include <sstmac/main/driver.h>
 #include <sstmac/software/process/app.h>
 #include <sstmac/software/process/operating_system.h>
@@ -231,20 +232,12 @@ int USER_MAIN(int argc, char** argv)
 
   sprockit::sim_parameters* params = sstmac::sw::app::get_params();
 
-  /** This configures the compute intensity as a function of baseline bandwidth
-   *  Messages are sent in windows of size 100 us
-   *  The default chunk size is 256 KB for an intensity of 1.0
-   *  This means an intensity of 1.0 requires 2.56GB/s to keep up */
-  double intensity = params->get_double_param("intensity");
-
   /** This configures the number of partners each rank sends to
    *  For mixing=4 and intensity=1.0, every 100 us
    *  Each rank would send 256/4 = 64KB to every partner
    */
   int mixing = params->get_int_param("mixing");
 
-  int num_iterations = params->get_int_param("niterations");
-
   /** This configures how local the traffic pattern is
    *  For scatter=1, rank N sends to N+1,N+2,etc
    *  For scatter=2, rank N sends to N+2,N+4,etc
@@ -257,8 +250,8 @@ int USER_MAIN(int argc, char** argv)
   std::vector<sumi::public_buffer> send_chunks(npartners);
 
   debug_printf(sprockit::dbg::traffic_matrix,
-    "Rank %d starting run with mixing=%d, niter=%d, scatter=%d",
-    tport->rank(), mixing, num_iterations, scatter);
+    "Rank %d starting setup with mixing=%d, scatter=%d",
+    tport->rank(), mixing, scatter);
 
   //because of weirdness with page boundaries,
   //only allow certain mixing numbers
@@ -324,6 +317,17 @@ int USER_MAIN(int argc, char** argv)
   tport->barrier(tag);
   tport->collective_block(sumi::collective::barrier, tag);
 
+  //setup is done - warm-start sweeps over the parameters below fork here
+  sstmac::runtime::diverge();
+
+  /** This configures the compute intensity as a function of baseline bandwidth
+   *  Messages are sent in windows of size 100 us
+   *  The default chunk size is 256 KB for an intensity of 1.0
+   *  This means an intensity of 1.0 requires 2.56GB/s to keep up */
+  double intensity = params->get_double_param("intensity");
+
+  int num_iterations = params->get_int_param("niterations");
+
   std::list<rdma_message::ptr> done;
 
   static double timeout = 100e-6 / intensity; //100 us per send iteration, modified by intensity
@@ -1,10 +1,63 @@
 #include <sstmac/software/process/global.h>
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/thread.h>
+#include <sstmac/common/thread_lock.h>
+#include <cstdlib>
+#include <algorithm>
 
 namespace sstmac {
 namespace sw {
 
+struct global_page {
+  size_t size;
+  size_t used;
+  /** Once a process has allocated the page, new globals go on a new page */
+  bool sealed;
+  std::vector<std::pair<int,const sstmac_global*>> globals;
+};
+
+//function statics since globals register during static initialization
+static std::vector<global_page>&
+global_pages()
+{
+  static std::vector<global_page> pages;
+  return pages;
+}
+
+static thread_lock&
+global_pages_lock()
+{
+  static thread_lock lock;
+  return lock;
+}
+
+sstmac_global::sstmac_global(size_t size, size_t align)
+{
+  std::vector<global_page>& pages = global_pages();
+  global_pages_lock().lock();
+  size_t offset = 0;
+  if (!pages.empty()){
+    global_page& last = pages.back();
+    offset = (last.used + align - 1) / align * align;
+    if (last.sealed || (offset + size) > last.size){
+      offset = 0;
+    }
+  }
+  if (offset == 0){
+    global_page page;
+    page.size = std::max(size, size_t(page_size));
+    page.used = 0;
+    page.sealed = false;
+    pages.push_back(page);
+  }
+  global_page& page = pages.back();
+  page.used = offset + size;
+  page.globals.emplace_back(offset, this);
+  page_ = pages.size() - 1;
+  offset_ = offset;
+  global_pages_lock().unlock();
+}
+
 process_context
 sstmac_global::current_context() const {
   thread* t = operating_system::current_thread();
@@ -16,5 +69,51 @@ sstmac_global::current_context() const {
   }
 }
 
+void*
+sstmac_global::current_slot() const {
+  thread* t = operating_system::current_thread();
+  if (t) {
+    return t->globals()->slot(page_, offset_);
+  }
+  else {
+    return nullptr;
+  }
+}
+
+char*
+global_segment::alloc_page(int page)
+{
+  global_pages_lock().lock();
+  global_page& info = global_pages()[page];
+  info.sealed = true;
+  //malloc alignment suffices for any builtin type
+  char* storage = (char*) ::malloc(info.size);
+  for (auto& pair : info.globals){
+    pair.second->init_slot(storage + pair.first);
+  }
+  global_pages_lock().unlock();
+
+  if (page >= pages_.size()){
+    pages_.resize(page + 1, nullptr);
+  }
+  pages_[page] = storage;
+  return storage;
+}
+
+global_segment::~global_segment()
+{
+  global_pages_lock().lock();
+  for (int page=0; page < pages_.size(); ++page){
+    char* storage = pages_[page];
+    if (storage){
+      for (auto& pair : global_pages()[page].globals){
+        pair.second->destroy_slot(storage + pair.first);
+      }
+      ::free(storage);
+    }
+  }
+  global_pages_lock().unlock();
+}
+
 }
 }
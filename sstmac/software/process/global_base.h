@@ -13,16 +13,98 @@
 #define SSTMAC_SOFTWARE_PROCESS_GLOBAL_BASE_H_INCLUDED
 
 #include <sstmac/software/process/process_context.h>
+#include <cstddef>
+#include <vector>
 
 namespace sstmac {
 namespace sw {
 
+/**
+ * Storage for every global variable of a single process.
+ * Each global gets a fixed (page, offset) when it is constructed.
+ * Pages are allocated the first time a process touches one of their globals,
+ * so a lookup is just an index into the page table.
+ * The segment is shared by all threads of the process and
+ * reclaimed when the last of them exits.
+ */
+class global_segment
+{
+ public:
+  global_segment() : refcount_(1) {}
+
+  /** Destroys the values held by the process and frees the pages */
+  ~global_segment();
+
+  void*
+  slot(int page, int offset) {
+    if (page < pages_.size() && pages_[page]){
+      return pages_[page] + offset;
+    }
+    return alloc_page(page) + offset;
+  }
+
+  void
+  incref() {
+    ++refcount_;
+  }
+
+  /** @return Whether this was the last reference */
+  bool
+  decref() {
+    return --refcount_ == 0;
+  }
+
+ private:
+  char*
+  alloc_page(int page);
+
+  std::vector<char*> pages_;
+
+  int refcount_;
+
+};
+
 class sstmac_global
 {
+ public:
+  /** Globals are packed into pages of this many bytes, larger globals get their own page */
+  static const int page_size = 4096;
+
+  virtual ~sstmac_global(){}
+
+  /**
+   * Construct a new per-process value from the current initial value
+   * @param slot Uninitialized storage of the size given at registration
+   */
+  virtual void
+  init_slot(void* slot) const = 0;
+
+  /** Destroy a per-process value when its process exits */
+  virtual void
+  destroy_slot(void* slot) const = 0;
+
  protected:
+  /**
+   * Reserve storage in every process segment
+   * @param size  The bytes needed per process
+   * @param align The required alignment of the storage
+   */
+  sstmac_global(size_t size, size_t align);
+
   process_context
   current_context() const;
 
+  /**
+   * @return The storage of the current process, nullptr if
+   *         not running inside a process
+   */
+  void*
+  current_slot() const;
+
+ private:
+  int page_;
+  int offset_;
+
 };
 
 
@@ -15,6 +15,7 @@
 #include <sstmac/software/process/global_base.h>
 #include <sprockit/errors.h>
 #include <iostream>
+#include <new>
 
 namespace sstmac {
 namespace sw {
@@ -24,40 +25,22 @@ class sstmac_global_builtin : public sstmac_global
 {
 
  private:
-  typedef spkt_unordered_map<long, T> val_map;
-  val_map vals_;
   mutable T init_;
-  mutable bool isinit_;
-
-  bool
-  check_init(process_context ptxt) const {
-
-    val_map& vals = const_cast<val_map&> (vals_);
-    if (ptxt != process_context::none) {
-      typename val_map::iterator it = vals.find(ptxt);
-      if (it == vals.end()) {
-        vals[ptxt] = init_;
-      }
-      return true;
-    }
-    else {
-      return false;
-    }
-  }
 
  public:
   explicit
-  sstmac_global_builtin() {
-    isinit_ = false;
+  sstmac_global_builtin() :
+    sstmac_global(sizeof(T), alignof(T)), init_() {
   }
 
   explicit
   sstmac_global_builtin(T init) :
-    init_(init), isinit_(true) {
+    sstmac_global(sizeof(T), alignof(T)), init_(init) {
   }
 
   explicit
-  sstmac_global_builtin(const sstmac_global_builtin<T>& other) {
+  sstmac_global_builtin(const sstmac_global_builtin<T>& other) :
+    sstmac_global(sizeof(T), alignof(T)) {
     spkt_throw_printf(sprockit::illformed_error,
                      "copy constructor should never be called for primitive global");
   }
@@ -66,32 +49,19 @@ class sstmac_global_builtin : public sstmac_global
   }
 
   void
-  print_all() const {
-    for (auto& pair : vals_) {
-      std::cout << pair.second << std::endl;
-    }
+  init_slot(void* slot) const override {
+    new (slot) T(init_);
+  }
+
+  void
+  destroy_slot(void* slot) const override {
+    ((T*)slot)->~T();
   }
 
   T&
   get_val() const {
-    process_context ptxt = current_context();
-    val_map& vals = const_cast<val_map&> (vals_);
-    if (ptxt != process_context::none) {
-      typename val_map::iterator it = vals.find(ptxt);
-      if (it == vals.end()) {
-        if(!isinit_) {
-          init_ = 0;
-          isinit_ = true;
-        }
-        T& ret = vals[ptxt];
-        ret = init_;
-        return ret;
-      }
-      else {
-        return it->second;
-      }
-    }
-    return const_cast<T&> (init_);
+    T* slot = (T*) current_slot();
+    return slot ? *slot : init_;
   }
 
   std::string
@@ -278,31 +248,6 @@ class sstmac_global_builtin : public sstmac_global
     return myval < otherval;
   }
 
-  void
-  delete_vals() {
-    if (init_) {
-      delete init_;
-      init_ = 0;
-    }
-    typedef typename spkt_unordered_map<long, T>::iterator myiter;
-    myiter it;
-    for (it = vals_.begin(); it != vals_.end(); ++it)
-      if (it->second) {
-        delete it->second;
-      }
-    vals_.clear();
-  }
-
-  typename val_map::const_iterator
-  begin() const {
-    return vals_.begin();
-  }
-
-  typename val_map::const_iterator
-  end() const {
-    return vals_.end();
-  }
-
 };
 
 template<typename T, typename U>
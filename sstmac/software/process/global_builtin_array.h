@@ -23,8 +23,6 @@ class sstmac_global_builtin_arr : public sstmac_global
 {
 
  private:
-  typedef spkt_unordered_map<long, T*> val_map;
-  val_map vals_;
   T* init_;
 
  public:
@@ -32,53 +30,45 @@ class sstmac_global_builtin_arr : public sstmac_global
 
   explicit
   sstmac_global_builtin_arr() :
-    init_(nullptr) {
+    sstmac_global(N * sizeof(T), alignof(T)), init_(nullptr) {
   }
 
   explicit
-  sstmac_global_builtin_arr(static_arr init) {
+  sstmac_global_builtin_arr(static_arr init) :
+    sstmac_global(N * sizeof(T), alignof(T)) {
     init_ = new T[N];
     ::memcpy(init_, init, N * sizeof(T));
   }
 
-  sstmac_global_builtin_arr(const sstmac_global_builtin_arr<T, N>& other) {
+  sstmac_global_builtin_arr(const sstmac_global_builtin_arr<T, N>& other) :
+    sstmac_global(N * sizeof(T), alignof(T)) {
     spkt_throw_printf(sprockit::illformed_error,
                      "copy constructor should never be called for primitive global");
   }
 
   ~sstmac_global_builtin_arr() {
-    for (auto& pair : vals_){
-      T* t = pair.second;
-      delete t;
-    }
     if (init_) delete[] init_;
   }
 
   void
-  print_all() const {
-    for (auto& pair : vals_){
-      std::cout << pair.second << std::endl;
+  init_slot(void* slot) const override {
+    if (init_) {
+      ::memcpy(slot, init_, N * sizeof(T));
+    }
+    else {
+      ::memset(slot, 0, N * sizeof(T));
     }
   }
 
+  void
+  destroy_slot(void* slot) const override {
+  }
+
   T*
   get_val() const {
-    process_context ptxt = current_context();
-    val_map& vals = const_cast<val_map&> (vals_);
-    if (ptxt != process_context::none) {
-      typename val_map::iterator it = vals.find(ptxt);
-      if (it == vals.end()) {
-        T* ret = new T[N];
-        vals[ptxt] = ret;
-        if (init_) {
-          ::memcpy(ret, init_, N * sizeof(T));
-        }
-        return ret;
-      }
-      else {
-        T* r = it->second;
-        return r;
-      }
+    T* slot = (T*) current_slot();
+    if (slot) {
+      return slot;
     }
     spkt_throw_printf(sprockit::illformed_error,
                      "getting static array value with no process context");
@@ -225,16 +215,6 @@ class sstmac_global_builtin_arr : public sstmac_global
     return myval < otherval;
   }
 
-  typename val_map::const_iterator
-  begin() const {
-    return vals_[0].begin();
-  }
-
-  typename val_map::const_iterator
-  end() const {
-    return vals_[0].end();
-  }
-
 };
 
 
@@ -22,55 +22,36 @@ class sstmac_global_builtin<T*> : public sstmac_global
 {
 
  protected:
-  typedef spkt_unordered_map<long, T*> val_map;
   typedef T* Tptr;
-  val_map vals_;
   T* init_;
 
-  bool
-  check_init(process_context ptxt) {
-
-    if (ptxt != process_context::none) {
-      if (vals_.find(ptxt) == vals_.end()) {
-        vals_[ptxt] = init_;
-      }
-      return true;
-    }
-    else {
-      return false;
-    }
-  }
-
  public:
   explicit
   sstmac_global_builtin() :
-    init_(NULL) {
+    sstmac_global(sizeof(T*), alignof(T*)), init_(NULL) {
   }
 
   explicit
   sstmac_global_builtin(T* init) :
-    init_(init) {
+    sstmac_global(sizeof(T*), alignof(T*)), init_(init) {
   }
 
   ~sstmac_global_builtin() {
   }
 
+  void
+  init_slot(void* slot) const override {
+    *((T**)slot) = init_;
+  }
+
+  void
+  destroy_slot(void* slot) const override {
+  }
+
   T*&
   get_val(int n = 0) const {
-
-    process_context ptxt = current_context();
-    val_map& vals = const_cast<val_map&> (vals_);
-    if (ptxt != process_context::none) {
-      auto it = vals.find(ptxt);
-      if (it == vals.end()) {
-        T*& ret = vals[ptxt] = init_;
-        return ret;
-      }
-      else {
-        return it->second;
-      }
-    }
-    return const_cast<T*&> (init_);
+    T** slot = (T**) current_slot();
+    return slot ? *slot : const_cast<T*&> (init_);
   }
 
   std::string
@@ -196,16 +177,6 @@ class sstmac_global_builtin<T*> : public sstmac_global
     return arr[idx];
   }
 
-  typename val_map::const_iterator
-  begin() const {
-    return vals_.begin();
-  }
-
-  typename val_map::const_iterator
-  end() const {
-    return vals_.end();
-  }
-
 };
 
 }
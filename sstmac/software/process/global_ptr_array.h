@@ -22,45 +22,36 @@ class sstmac_global_builtin_arr<T*, N> : public sstmac_global
 {
 
  protected:
-  typedef spkt_unordered_map<long, T*> val_map;
   typedef T* Tptr;
-  val_map vals_[N];
   T* init_;
 
-  bool
-  check_init(process_context ptxt, int n = 0) {
-    if (n >= N) {
-      spkt_throw_printf(
-        sprockit::value_error,
-        "sstmac_global*::check_init: trying to access index %d outside of array size %d",
-        n, N);
-    }
-    if (ptxt != process_context::none) {
-      if (vals_[n].find(ptxt) == vals_[n].end()) {
-        vals_[n][ptxt] = init_;
-      }
-      return true;
-    }
-    else {
-      return false;
-    }
-  }
-
  public:
   explicit
   sstmac_global_builtin_arr() :
-    init_(NULL) {
+    sstmac_global(N * sizeof(T*), alignof(T*)), init_(NULL) {
   }
 
   explicit
   sstmac_global_builtin_arr(T* init) :
-    init_(init) {
+    sstmac_global(N * sizeof(T*), alignof(T*)), init_(init) {
   }
 
   virtual
   ~sstmac_global_builtin_arr() {
   }
 
+  void
+  init_slot(void* slot) const override {
+    T** arr = (T**) slot;
+    for (int i=0; i < N; ++i) {
+      arr[i] = init_;
+    }
+  }
+
+  void
+  destroy_slot(void* slot) const override {
+  }
+
   T*&
   get_val(int n = 0) const {
     if (n >= N) {
@@ -69,19 +60,8 @@ class sstmac_global_builtin_arr<T*, N> : public sstmac_global
         "sstmac_global*::get_val: trying to access index %d outside of array size %d",
         n, N);
     }
-    process_context ptxt = current_context();
-    val_map& vals = const_cast<val_map&> (vals_[n]);
-    if (ptxt != process_context::none) {
-      typename val_map::iterator it = vals.find(ptxt);
-      if (it == vals.end()) {
-        T*& ret = vals[ptxt] = init_;
-        return ret;
-      }
-      else {
-        return it->second;
-      }
-    }
-    return const_cast<T*&> (init_);
+    T** slot = (T**) current_slot();
+    return slot ? slot[n] : const_cast<T*&> (init_);
   }
 
   std::string
@@ -43,6 +43,9 @@
 #if SSTMAC_HAVE_UCONTEXT
 #include <sstmac/software/threading/threading_ucontext.h>
 #endif
+#if SSTMAC_HAVE_FCONTEXT
+#include <sstmac/software/threading/threading_fcontext.h>
+#endif
 
 #include <sstmac/hardware/node/node.h>
 #include <sstmac/hardware/processor/processor.h>
@@ -76,6 +79,8 @@ RegisterKeywords(
 "call_graph",
 "event_trace",
 "stack_protect",
+"stack_lazy_commit",
+"stack_report",
 "event_trace_start",
 "event_trace_stop",
 "compute_scheduler",
@@ -86,6 +91,7 @@ namespace sw {
 
 static sprockit::need_delete_statics<operating_system> del_statics;
 size_t operating_system::stacksize_ = 0;
+bool operating_system::stack_report_ = false;
 
 #if SSTMAC_USE_MULTITHREAD
 std::vector<operating_system::os_thread_context> operating_system::os_thread_contexts_;
@@ -123,7 +129,9 @@ operating_system::operating_system(sprockit::sim_parameters* params, hw::node* p
 
   stacksize_ = params->get_optional_byte_length_param("stack_size", 1 << 17);
   bool mprot = params->get_optional_bool_param("stack_protect", false);
-  long suggested_chunk_size = 1<22;
+  bool lazy_commit = params->get_optional_bool_param("stack_lazy_commit", false);
+  stack_report_ = params->get_optional_bool_param("stack_report", false);
+  long suggested_chunk_size = 1<<22;
   long min_chunk_size = 8*stacksize_;
   long default_chunk_size = std::max(suggested_chunk_size, min_chunk_size);
   long chunksize = params->get_optional_byte_length_param("stack_chunk_size", default_chunk_size);
@@ -136,10 +144,10 @@ operating_system::operating_system(sprockit::sim_parameters* params, hw::node* p
   if (os_thread_contexts_.size() == 0){
     os_thread_contexts_.resize(1);
     stack_alloc& salloc = os_thread_contexts_[0].stackalloc;
-    salloc.init(stacksize_, chunksize, mprot);
+    salloc.init(stacksize_, chunksize, mprot, lazy_commit);
   }
 #else
-  os_thread_context_.stackalloc.init(stacksize_, chunksize, mprot);
+  os_thread_context_.stackalloc.init(stacksize_, chunksize, mprot, lazy_commit);
 #endif
 
   //we automatically initialize the first context
@@ -153,7 +161,8 @@ operating_system::operating_system(sprockit::sim_parameters* params, hw::node* p
       ctxt.stackalloc.init(
         main_ctxt.stackalloc.stacksize(),
         main_ctxt.stackalloc.chunksize(),
-        main_ctxt.stackalloc.use_mprot());
+        main_ctxt.stackalloc.use_mprot(),
+        main_ctxt.stackalloc.lazy_commit());
     }
   }
 #endif
@@ -171,7 +180,7 @@ operating_system::~operating_system()
   /** JJW 01/28/2016 This should already be cleared out
    *  It not, leave it. It's a leak */
   //sprockit::delete_vals(libs_);
-  current_os_thread_context().stackalloc.clear();
+  //the stack pool is kept for the next job, other nodes may still hold stacks
 
 #if SSTMAC_HAVE_GRAPHVIZ
   if (call_graph_) delete call_graph_;
@@ -203,6 +212,12 @@ operating_system::os_thread_context operating_system::cxa_finalize_context_;
 #define ucontext_available ""
 #endif
 
+#if SSTMAC_HAVE_FCONTEXT
+#define fcontext_available "fcontext,"
+#else
+#define fcontext_available ""
+#endif
+
 void
 operating_system::init_threading()
 {
@@ -216,6 +231,8 @@ operating_system::init_threading()
   } else { 
 #if defined(SSTMAC_USE_UCONTEXT) //explicitly specified default via configure, different from HAVE_UCONTEXT
     threading_string = "ucontext";
+#elif defined(SSTMAC_USE_FCONTEXT)
+    threading_string = "fcontext";
 #elif defined(SSTMAC_USE_PTHREAD)
     threading_string = "pthread";
 #elif defined(SSTMAC_USE_PTH)
@@ -224,6 +241,7 @@ operating_system::init_threading()
     //if none of the above set, we have no explicitly specified default
     //go ahead and pick a sensible one
 #elif SSTMAC_USE_MULTITHREAD //set priorities differently depending on whether we are in multithreading mode
+    //fcontext is never picked here, it must be asked for
     #if defined(SSTMAC_HAVE_UCONTEXT)
     threading_string = "ucontext";
     #elif defined(SSTMAC_HAVE_PTHREAD)
@@ -240,7 +258,7 @@ operating_system::init_threading()
     #elif defined(SSTMAC_HAVE_PTHREAD)
     threading_string = "pthread";
     #else
-    #error no valid thread interfaces available (pth, pthread, ucontext supported)
+    #error no valid thread interfaces available (pth, pthread, ucontext, fcontext supported)
     #error ucontext is not available on MAC
     #error pthread is not compatible with integrated SST core
     #error pth must be downloaded and installed from GNU site
@@ -291,12 +309,20 @@ operating_system::init_threading()
 #else
     spkt_throw(sprockit::value_error,
       "operating_system: SSTMAC_THREADING=ucontext is not supported");
+#endif
+  }
+  else if (threading_string == "fcontext") {
+#if defined(SSTMAC_HAVE_FCONTEXT)
+    des_context_ = new threading_fcontext();
+#else
+    spkt_throw(sprockit::value_error,
+      "operating_system: SSTMAC_THREADING=fcontext is not supported");
 #endif
   }
   else {
     spkt_throw_printf(sprockit::value_error,
        "operating_system: invalid value %s for SSTMAC_THREADING environmental variable\n"
-       "choose one of " pth_available pthread_available ucontext_available,
+       "choose one of " pth_available pthread_available ucontext_available fcontext_available,
        threading_string.c_str());
   }
 
@@ -318,6 +344,22 @@ operating_system::local_shutdown()
 void
 operating_system::delete_statics()
 {
+  if (!stack_report_) return;
+
+  size_t reserved = 0;
+  size_t peak = 0;
+#if SSTMAC_USE_MULTITHREAD
+  //each worker thread has its own pool, the peaks may not coincide
+  for (os_thread_context& ctxt : os_thread_contexts_){
+    reserved += ctxt.stackalloc.reserved_bytes();
+    peak += ctxt.stackalloc.peak_committed_bytes();
+  }
+#else
+  reserved = os_thread_context_.stackalloc.reserved_bytes();
+  peak = os_thread_context_.stackalloc.peak_committed_bytes();
+#endif
+  cout0 << sprockit::printf("Peak committed stack memory of %12.3f MB, %12.3f MB reserved\n",
+                            peak / 1e6, reserved / 1e6);
 }
 
 void
@@ -466,11 +508,26 @@ operating_system::current_node_id()
   return addr;
 }
 
+int
+operating_system::event_thread_id() const
+{
+#if SSTMAC_USE_MULTITHREAD && !SSTMAC_INTEGRATED_SST_CORE
+  //not necessarily the thread the node was built on if threads rebalance
+  if (event_manager::components_migrate()){
+    event_manager* mgr = event_manager::active();
+    return mgr ? mgr->thread_id() : thread_id();
+  }
+  return thread_id();
+#else
+  return thread_id();
+#endif
+}
+
 operating_system::os_thread_context&
 operating_system::current_os_thread_context()
 {
 #if SSTMAC_USE_MULTITHREAD
-  int thr = thread_id();
+  int thr = event_thread_id();
   return os_thread_contexts_[thr];
 #else
   return os_thread_context_;
@@ -518,6 +575,14 @@ operating_system::switch_to_thread(thread_data_t tothread)
   ctxt.current_aid = ctxt.current_thread->aid();
   ctxt.current_tid = ctxt.current_thread->tid(  );
 
+#if SSTMAC_USE_MULTITHREAD
+  if (next_thread->stack()){
+    //the stack may have been started on a different worker thread
+    thread_info::register_user_space_virtual_thread(event_thread_id(),
+      next_thread->stack(), next_thread->stacksize());
+  }
+#endif
+
   from.first->swap_context(tothread.first);
 
   /** back to main thread */
@@ -800,11 +865,16 @@ operating_system::stack_check()
 }
 
 void
-operating_system::free_thread_stack(void *stack)
+operating_system::free_thread_stack(void *stack, stack_alloc* pool)
 {
   os_thread_context& ctxt = current_os_thread_context();
-  stack_alloc& stackalloc_ = ctxt.stackalloc;
-  stackalloc_.free(stack);
+  if (pool == &ctxt.stackalloc){
+    pool->free(stack);
+  } else {
+    //the thread was created on another worker thread before its
+    //switch group was moved here - give the stack back to its owner
+    pool->free_remote(stack);
+  }
 }
 
 void
@@ -814,11 +884,12 @@ operating_system::add_thread(thread* t)
   stack_alloc& stackalloc_ = ctxt.stackalloc;
 
   t->init_thread(
-    thread_id(),
+    event_thread_id(),
     des_context_,
     stackalloc_.alloc(),
     stackalloc_.stacksize(),
     NULL);
+  t->stack_pool_ = &stackalloc_;
 
   threads_.push_back(t);
 }
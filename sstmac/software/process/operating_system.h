@@ -249,7 +249,7 @@ class operating_system :
   schedule_timeout(timestamp delay, key* k);
 
   void
-  free_thread_stack(void* stack);
+  free_thread_stack(void* stack, stack_alloc* pool);
 
   static size_t
   stacksize(){
@@ -297,6 +297,12 @@ class operating_system :
   os_thread_context&
   current_os_thread_context();
 
+  /**
+   * @return The worker thread running this node's events right now
+   */
+  int
+  event_thread_id() const;
+
 
   friend class library;
 
@@ -356,6 +362,8 @@ class operating_system :
 
  private:
   static size_t stacksize_;
+  /// Whether to print peak committed stack memory at the end
+  static bool stack_report_;
   static bool cxa_finalizing_;
   static os_thread_context cxa_finalize_context_;
 
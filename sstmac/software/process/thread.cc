@@ -14,6 +14,7 @@
 #include <sstmac/software/process/operating_system.h>
 #include <sstmac/software/process/key.h>
 #include <sstmac/software/process/app.h>
+#include <sstmac/software/process/global_base.h>
 #include <sstmac/software/libraries/library.h>
 #include <sstmac/software/libraries/compute/compute_event.h>
 #include <sstmac/software/api/api.h>
@@ -253,7 +254,9 @@ thread::thread(sprockit::sim_parameters* params, software_id sid, operating_syst
   schedule_key_(key::construct(schedule_delay)),
   p_txt_(process_context::none),
   stack_(nullptr),
+  stack_pool_(nullptr),
   context_(nullptr),
+  globals_(nullptr),
   cpumask_(0),
   pthread_map_(nullptr),
   parent_app_(nullptr),
@@ -331,13 +334,30 @@ thread::now()
 thread::~thread()
 {
   if (backtrace_) graph_viz::delete_trace(backtrace_);
-  if (stack_) os_->free_thread_stack(stack_);
+  if (stack_) os_->free_thread_stack(stack_, stack_pool_);
   if (context_) {
     context_->destroy_context();
     delete context_;
   }
   if (schedule_key_) delete schedule_key_;
   if (perf_model_) delete perf_model_;
+  if (globals_ && globals_->decref()) delete globals_;
+}
+
+global_segment*
+thread::init_globals()
+{
+  globals_ = new global_segment;
+  return globals_;
+}
+
+void
+thread::share_globals(thread* thr)
+{
+  global_segment* segment = thr->globals();
+  segment->incref();
+  if (globals_ && globals_->decref()) delete globals_;
+  globals_ = segment;
 }
 
 
@@ -345,6 +365,7 @@ void
 thread::start_thread(thread* thr)
 {
   thr->p_txt_ = p_txt_;
+  thr->share_globals(this);
   os_->start_thread(thr);
 }
 
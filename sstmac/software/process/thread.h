@@ -28,6 +28,7 @@
 #include <sstmac/software/libraries/compute/lib_sleep_fwd.h>
 #include <sstmac/software/api/api_fwd.h>
 #include <sstmac/software/threading/threading_interface_fwd.h>
+#include <sstmac/software/threading/stack_alloc_fwd.h>
 #include <sstmac/software/process/perf_counter.h>
 #include <queue>
 #include <map>
@@ -39,6 +40,8 @@
 namespace sstmac {
 namespace sw {
 
+class global_segment;
+
 class thread
 {
  public:
@@ -214,6 +217,15 @@ class thread
     return p_txt_;
   }
 
+  /**
+   * @return The storage for global variables of this thread's process,
+   *         created on first use if the thread does not share one
+   */
+  global_segment*
+  globals() {
+    return globals_ ? globals_ : init_globals();
+  }
+
   /**
    * @brief key used 
    * @return 
@@ -339,7 +351,17 @@ class thread
 
   software_id sid_;
 
+  /**
+   * Use the same global variables as another thread in the process
+   * @param thr The thread whose segment gets shared
+   */
+  void
+  share_globals(thread* thr);
+
  private:
+  global_segment*
+  init_globals();
+
   bool isInit;
 
   void** backtrace_;
@@ -356,6 +378,9 @@ class thread
   void* stack_;
   /// The stacksize.
   size_t stacksize_;
+  /// The pool the stack came from, which may belong to another worker thread
+  /// by the time this thread is deleted
+  stack_alloc* stack_pool_;
   
   long thread_id_;
 
@@ -363,6 +388,8 @@ class thread
 
   threading_interface* context_;
 
+  global_segment* globals_;
+
   /// This key gets used by the compute scheduler to delay this thread
   /// 
   key* schedule_key_;
@@ -12,7 +12,10 @@
 #include <sstmac/software/threading/stack_alloc.h>
 #include <sstmac/software/threading/stack_alloc_chunk.h>
 #include <sprockit/errors.h>
+#include <sprockit/output.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <errno.h>
 
 
 namespace sstmac {
@@ -21,21 +24,48 @@ namespace sw {
 // Build.
 //
 stack_alloc::stack_alloc() :
-  suggested_chunk_(0), stacksize_(0), use_mprot_(false)
+  suggested_chunk_(0), stacksize_(0), use_mprot_(false), lazy_commit_(false),
+  reserved_bytes_(0), committed_bytes_(0), peak_committed_bytes_(0),
+  num_remote_frees_(0)
 {
+  remote_lock_.clear();
+}
 
+stack_alloc::stack_alloc(const stack_alloc& other) :
+  suggested_chunk_(other.suggested_chunk_), stacksize_(other.stacksize_),
+  use_mprot_(other.use_mprot_), lazy_commit_(other.lazy_commit_),
+  reserved_bytes_(0), committed_bytes_(0), peak_committed_bytes_(0),
+  num_remote_frees_(0)
+{
+  remote_lock_.clear();
+  if (!other.chunks_.empty()) {
+    spkt_throw_printf(sprockit::illformed_error,
+        "stackalloc: cannot copy an allocator that holds stacks");
+  }
 }
 
 void
-stack_alloc::init(size_t stacksize, size_t alloc_unit, bool use_mprot)
+stack_alloc::init(size_t stacksize, size_t alloc_unit, bool use_mprot, bool lazy_commit)
 {
+  size_t rem = stacksize % sysconf(_SC_PAGESIZE);
+  if(rem) {
+    stacksize += (sysconf(_SC_PAGESIZE) - rem);
+  }
+  drain_remote_frees();
+  //pooled stacks are kept across jobs as long as they still fit
+  bool changed = stacksize != stacksize_ || use_mprot != use_mprot_
+              || lazy_commit != lazy_commit_;
+  if (changed && committed_bytes_) {
+    spkt_throw_printf(sprockit::value_error,
+        "stackalloc: cannot change stack size or mode while stacks are in use");
+  }
+  else if (changed) {
+    clear();
+  }
   suggested_chunk_ = alloc_unit;
   stacksize_ = stacksize;
   use_mprot_ = use_mprot;
-  size_t rem = stacksize_ % sysconf(_SC_PAGESIZE);
-  if(rem) {
-    stacksize_ += (sysconf(_SC_PAGESIZE) - rem);
-  }
+  lazy_commit_ = lazy_commit;
 }
 
 //
@@ -55,6 +85,12 @@ stack_alloc::clear()
   }
   chunks_.clear();
   chunks_.resize(0);
+  available_.clear();
+  remote_frees_.clear();
+  num_remote_frees_ = 0;
+  reserved_bytes_ = 0;
+  committed_bytes_ = 0;
+  peak_committed_bytes_ = 0;
 }
 
 //
@@ -67,9 +103,12 @@ stack_alloc::alloc()
     spkt_throw_printf(sprockit::value_error, "stackalloc::stacksize was not initialized");
   }
 
+  drain_remote_frees();
   if(available_.empty()){
     // grab a new chunk.
-    chunk* new_chunk = new chunk(stacksize_, suggested_chunk_, use_mprot_);
+    chunk* new_chunk = new chunk(stacksize_, suggested_chunk_, use_mprot_, lazy_commit_);
+    chunks_.push_back(new_chunk);
+    reserved_bytes_ += new_chunk->size();
     void* buf = new_chunk->get_next_stack();
     while (buf){
       available_.push_back(buf);
@@ -78,6 +117,16 @@ stack_alloc::alloc()
   }
   void *buf = available_.back();
   available_.pop_back();
+  if (lazy_commit_) {
+    //pages are still only backed by memory once they are touched
+    if (mprotect(buf, stacksize_, PROT_READ | PROT_WRITE | PROT_EXEC) != 0){
+      cerrn << "Failed to commit a stack of size " << stacksize_ << ": "
+            << strerror(errno) << "\n";
+      spkt_throw(sprockit::memory_error, "stackalloc: failed to commit stack.");
+    }
+  }
+  committed_bytes_ += stacksize_;
+  peak_committed_bytes_ = std::max(peak_committed_bytes_, committed_bytes_);
   return buf;
 }
 
@@ -86,9 +135,56 @@ stack_alloc::alloc()
 //
 void stack_alloc::free(void* buf)
 {
+  if (lazy_commit_) {
+    //give the pages back, the next allocation of this stack gets zero pages
+    madvise(buf, stacksize_, MADV_DONTNEED);
+    mprotect(buf, stacksize_, PROT_NONE);
+  }
+  committed_bytes_ -= stacksize_;
   available_.push_back(buf);
 }
 
+void
+stack_alloc::free_remote(void* buf)
+{
+  if (lazy_commit_) {
+    madvise(buf, stacksize_, MADV_DONTNEED);
+    mprotect(buf, stacksize_, PROT_NONE);
+  }
+  //the counters and available list belong to the owning thread
+  lock_remote();
+  remote_frees_.push_back(buf);
+  ++num_remote_frees_;
+  unlock_remote();
+}
+
+void
+stack_alloc::lock_remote()
+{
+  while (remote_lock_.test_and_set(std::memory_order_acquire)) ;
+}
+
+void
+stack_alloc::unlock_remote()
+{
+  remote_lock_.clear(std::memory_order_release);
+}
+
+void
+stack_alloc::drain_remote_frees()
+{
+  if (num_remote_frees_ == 0) return;
+
+  lock_remote();
+  for (void* buf : remote_frees_){
+    committed_bytes_ -= stacksize_;
+    available_.push_back(buf);
+  }
+  remote_frees_.clear();
+  num_remote_frees_ = 0;
+  unlock_remote();
+}
+
 
 
 }
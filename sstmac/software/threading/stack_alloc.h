@@ -12,6 +12,7 @@
 #ifndef SSTMAC_SOFTWARE_THREADING_STACKALLOC_H_INCLUDED
 #define SSTMAC_SOFTWARE_THREADING_STACKALLOC_H_INCLUDED
 
+#include <atomic>
 #include <cstring>
 #include <vector>
 
@@ -26,6 +27,10 @@ namespace sw {
  *
  * This allocator does not return memory to the system until it is
  * deleted, but regions can be allocated and free-d repeatedly.
+ *
+ * Each worker thread owns its own allocator. A stack freed by a thread
+ * other than the owner must go through free_remote, which hands it back
+ * to the owner the next time the owner allocates.
  */
 class stack_alloc
 {
@@ -41,15 +46,41 @@ class stack_alloc
   size_t stacksize_;
   /// Do we want stacks separated by an mprot region?
   bool use_mprot_;
+  /// Do we only commit memory for stacks that are in use?
+  bool lazy_commit_;
+  /// Address space mapped for all chunks
+  size_t reserved_bytes_;
+  /// Bytes in stacks that are currently allocated
+  size_t committed_bytes_;
+  size_t peak_committed_bytes_;
 
   /// This is our list of un-allocated chunks:
   typedef std::vector<void*> available_vec_t;
   available_vec_t available_;
 
+  /// Stacks returned by other threads, not yet taken back by the owner
+  available_vec_t remote_frees_;
+  std::atomic<int> num_remote_frees_;
+  /// Remote frees are rare, a spin lock suffices. This header is included
+  /// by skeletons that replace pthreads, so thread_lock cannot be used.
+  std::atomic_flag remote_lock_;
+
+  void lock_remote();
+
+  void unlock_remote();
+
+  void drain_remote_frees();
+
  public:
   /// Build.
   stack_alloc();
 
+  /**
+   * Copies only the configuration. Used while the per-thread contexts
+   * are being set up, before any stacks have been allocated.
+   */
+  stack_alloc(const stack_alloc& other);
+
   size_t
   stacksize() const {
     return stacksize_;
@@ -65,6 +96,26 @@ class stack_alloc
     return suggested_chunk_;
   }
 
+  bool
+  lazy_commit() const {
+    return lazy_commit_;
+  }
+
+  size_t
+  reserved_bytes() const {
+    return reserved_bytes_;
+  }
+
+  size_t
+  committed_bytes() const {
+    return committed_bytes_;
+  }
+
+  size_t
+  peak_committed_bytes() const {
+    return peak_committed_bytes_;
+  }
+
   /// Goodbye.
   virtual ~stack_alloc();
 
@@ -74,7 +125,22 @@ class stack_alloc
   /// Return the given memory region.
   void free(void*);
 
-  void init(size_t stacksize, size_t alloc_unit, bool use_mprot);
+  /**
+   * Return a memory region allocated by this allocator from a thread
+   * other than the one that owns it. The region stays counted as committed
+   * until the owner next calls alloc or init.
+   */
+  void free_remote(void*);
+
+  /**
+   * @param stacksize   The size of each stack
+   * @param alloc_unit  The suggested size of each chunk of stacks
+   * @param use_mprot   Whether to put guard pages between stacks
+   * @param lazy_commit Whether to only reserve address space for chunks,
+   *                    committing memory when a stack is allocated and
+   *                    releasing it back to the system when the stack is freed
+   */
+  void init(size_t stacksize, size_t alloc_unit, bool use_mprot, bool lazy_commit);
 
   bool
   initialized() const {
@@ -26,7 +26,7 @@ namespace sw {
 // Make a new chunk.
 //
 stack_alloc::chunk::chunk(size_t stacksize, size_t suggested_chunk_size,
-                          bool use_mprot) :
+                          bool use_mprot, bool lazy_commit) :
   addr_(nullptr),
   size_(suggested_chunk_size),
   stacksize_(stacksize), 
@@ -45,9 +45,15 @@ stack_alloc::chunk::chunk(size_t stacksize, size_t suggested_chunk_size,
     size_ += guard - rem;
   }
   // Now allocate our chunk.
+  // A lazy chunk is inaccessible address space that does not count against
+  // the commit limit until the stack allocator makes a stack writable
   int mmap_flags = MAP_PRIVATE | MAP_ANON;
-  addr_ = (char*)mmap(0, size_, PROT_READ | PROT_WRITE | PROT_EXEC,
-                      mmap_flags, -1, 0);
+  int prot = PROT_READ | PROT_WRITE | PROT_EXEC;
+  if (lazy_commit) {
+    mmap_flags |= MAP_NORESERVE;
+    prot = PROT_NONE;
+  }
+  addr_ = (char*)mmap(0, size_, prot, mmap_flags, -1, 0);
   if(addr_ == MAP_FAILED) {
     cerrn << "Failed to mmap a region of size " << size_ << ": "
               << strerror(errno) << "\n";
@@ -55,7 +61,7 @@ stack_alloc::chunk::chunk(size_t stacksize, size_t suggested_chunk_size,
   }
   // and set protections on the pages between the stack chunks.
   const size_t stride = stacksize_ + guard;
-  if(use_mprot_) {
+  if(use_mprot_ && !lazy_commit) {
     for(size_t offset = 0; offset < size_; offset += stride) {
       mprotect(addr_+offset, guard, PROT_NONE);
     }
@@ -39,7 +39,10 @@ class stack_alloc::chunk
 
  public:
   /// Make a new chunk.
-  chunk(size_t stacksize, size_t suggested_chunk_size, bool use_mprot);
+  /// With lazy_commit, the region is only reserved and every stack
+  /// must be committed before use.
+  chunk(size_t stacksize, size_t suggested_chunk_size, bool use_mprot,
+        bool lazy_commit);
 
   /// Goodbye.
   ~chunk();
@@ -47,6 +50,11 @@ class stack_alloc::chunk
   void* 
   get_next_stack();
 
+  size_t
+  size() const {
+    return size_;
+  }
+
 };
 
 }
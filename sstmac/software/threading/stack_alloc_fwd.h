@@ -0,0 +1,12 @@
+#ifndef STACK_ALLOC_FWD_H
+#define STACK_ALLOC_FWD_H
+
+namespace sstmac {
+namespace sw {
+
+class stack_alloc;
+
+}
+}
+
+#endif // STACK_ALLOC_FWD_H
@@ -0,0 +1,166 @@
+#include <sstmac/software/threading/threading_fcontext.h>
+#include <sstmac/common/thread_info.h>
+#include <sprockit/errors.h>
+#include <stdint.h>
+#include <cstring>
+
+#ifdef SSTMAC_HAVE_FCONTEXT
+
+#if defined(__APPLE__)
+#define FCONTEXT_SYMBOL(name) "_" #name
+#define FCONTEXT_FUNCTION(name) \
+  ".globl " FCONTEXT_SYMBOL(name) "\n" \
+  ".p2align 4\n" \
+  FCONTEXT_SYMBOL(name) ":\n"
+#define FCONTEXT_END(name)
+#else
+#define FCONTEXT_SYMBOL(name) #name
+#define FCONTEXT_FUNCTION(name) \
+  ".globl " FCONTEXT_SYMBOL(name) "\n" \
+  ".type " FCONTEXT_SYMBOL(name) ",%function\n" \
+  ".p2align 4\n" \
+  FCONTEXT_SYMBOL(name) ":\n"
+#define FCONTEXT_END(name) \
+  ".size " FCONTEXT_SYMBOL(name) ",.-" FCONTEXT_SYMBOL(name) "\n"
+#endif
+
+extern "C" {
+/**
+ * Save the callee-saved registers on the current stack, store the stack pointer
+ * in from_sp, then switch to to_sp and restore the registers saved there.
+ */
+void sstmac_fcontext_swap(void** from_sp, void* to_sp);
+
+/**
+ * The first swap into a new context returns here with the thread function
+ * and its argument in callee-saved registers
+ */
+void sstmac_fcontext_start();
+}
+
+#if defined(__x86_64__)
+/** mxcsr and x87 control word, fnstcw and fldcw only touch the low 2 bytes */
+static const uint64_t default_fp_control = (uint64_t(0x037F) << 32) | 0x1F80;
+/** Words saved by sstmac_fcontext_swap below the return address */
+static const int num_saved_words = 7;
+
+__asm__ (
+".text\n"
+FCONTEXT_FUNCTION(sstmac_fcontext_swap)
+"  pushq %rbp\n"
+"  pushq %rbx\n"
+"  pushq %r12\n"
+"  pushq %r13\n"
+"  pushq %r14\n"
+"  pushq %r15\n"
+"  subq $8, %rsp\n"
+"  stmxcsr (%rsp)\n"
+"  fnstcw 4(%rsp)\n"
+"  movq %rsp, (%rdi)\n"
+"  movq %rsi, %rsp\n"
+"  ldmxcsr (%rsp)\n"
+"  fldcw 4(%rsp)\n"
+"  addq $8, %rsp\n"
+"  popq %r15\n"
+"  popq %r14\n"
+"  popq %r13\n"
+"  popq %r12\n"
+"  popq %rbx\n"
+"  popq %rbp\n"
+"  ret\n"
+FCONTEXT_END(sstmac_fcontext_swap)
+FCONTEXT_FUNCTION(sstmac_fcontext_start)
+"  movq %r13, %rdi\n"
+"  callq *%r12\n"
+//threads complete by swapping out, they never return here
+"  ud2\n"
+FCONTEXT_END(sstmac_fcontext_start)
+);
+#elif defined(__aarch64__)
+/** x19-x30 and d8-d15 */
+static const int num_saved_words = 20;
+
+__asm__ (
+".text\n"
+FCONTEXT_FUNCTION(sstmac_fcontext_swap)
+"  sub sp, sp, #160\n"
+"  stp x19, x20, [sp, #0]\n"
+"  stp x21, x22, [sp, #16]\n"
+"  stp x23, x24, [sp, #32]\n"
+"  stp x25, x26, [sp, #48]\n"
+"  stp x27, x28, [sp, #64]\n"
+"  stp x29, x30, [sp, #80]\n"
+"  stp d8, d9, [sp, #96]\n"
+"  stp d10, d11, [sp, #112]\n"
+"  stp d12, d13, [sp, #128]\n"
+"  stp d14, d15, [sp, #144]\n"
+"  mov x9, sp\n"
+"  str x9, [x0]\n"
+"  mov sp, x1\n"
+"  ldp x19, x20, [sp, #0]\n"
+"  ldp x21, x22, [sp, #16]\n"
+"  ldp x23, x24, [sp, #32]\n"
+"  ldp x25, x26, [sp, #48]\n"
+"  ldp x27, x28, [sp, #64]\n"
+"  ldp x29, x30, [sp, #80]\n"
+"  ldp d8, d9, [sp, #96]\n"
+"  ldp d10, d11, [sp, #112]\n"
+"  ldp d12, d13, [sp, #128]\n"
+"  ldp d14, d15, [sp, #144]\n"
+"  add sp, sp, #160\n"
+"  ret\n"
+FCONTEXT_END(sstmac_fcontext_swap)
+FCONTEXT_FUNCTION(sstmac_fcontext_start)
+"  mov x0, x20\n"
+"  blr x19\n"
+//threads complete by swapping out, they never return here
+"  brk #0\n"
+FCONTEXT_END(sstmac_fcontext_start)
+);
+#else
+#error fcontext threading is only implemented for x86-64 and aarch64
+#endif
+
+namespace sstmac {
+namespace sw {
+
+void
+threading_fcontext::start_context(int physical_thread_id,
+   void *stack, size_t stacksize, void
+   (*func)(void*), void *args, threading_interface *yield_to)
+{
+  thread_info::register_user_space_virtual_thread(physical_thread_id, stack, stacksize);
+
+  //build the frame the first swap into this context will restore
+  uintptr_t top = ((uintptr_t) stack + stacksize) & ~uintptr_t(15);
+#if defined(__x86_64__)
+  //after returning into sstmac_fcontext_start the stack must be 16-byte aligned
+  uintptr_t* frame = (uintptr_t*) top - 1 - num_saved_words;
+  frame[0] = default_fp_control;
+  frame[1] = 0; //r15
+  frame[2] = 0; //r14
+  frame[3] = (uintptr_t) args; //r13
+  frame[4] = (uintptr_t) func; //r12
+  frame[5] = 0; //rbx
+  frame[6] = 0; //rbp, ends backtraces
+  frame[7] = (uintptr_t) &sstmac_fcontext_start;
+#elif defined(__aarch64__)
+  uintptr_t* frame = (uintptr_t*) top - num_saved_words;
+  ::memset(frame, 0, num_saved_words * sizeof(uintptr_t));
+  frame[0] = (uintptr_t) func; //x19
+  frame[1] = (uintptr_t) args; //x20
+  frame[11] = (uintptr_t) &sstmac_fcontext_start; //x30
+#endif
+  sp_ = frame;
+}
+
+void
+threading_fcontext::swap_context(threading_interface *to)
+{
+  threading_fcontext* casted = static_cast<threading_fcontext*>(to);
+  sstmac_fcontext_swap(&sp_, casted->sp_);
+}
+
+} }
+
+#endif
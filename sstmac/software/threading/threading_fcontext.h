@@ -0,0 +1,73 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_SOFTWARE_THREADING_THREADING_FCONTEXT_H_INCLUDED
+#define SSTMAC_SOFTWARE_THREADING_THREADING_FCONTEXT_H_INCLUDED
+
+#include <sstmac/software/threading/threading_interface.h>
+
+namespace sstmac {
+namespace sw {
+
+#ifdef SSTMAC_HAVE_FCONTEXT
+
+/**
+ * Virtual thread contexts switched by a few lines of assembly (x86-64 or aarch64)
+ * that only save the callee-saved registers and swap stack pointers.
+ * Unlike swapcontext, the signal mask is never saved or restored,
+ * so a context switch never enters the kernel.
+ */
+class threading_fcontext : public threading_interface
+{
+ private:
+  /// The saved stack pointer, registers are saved on top of the stack
+  void* sp_;
+
+ public:
+  threading_fcontext() : sp_(nullptr) {}
+
+  virtual
+  threading_interface* copy() {
+    return new threading_fcontext();
+  }
+
+  /// The running context is saved on its first swap
+  virtual void
+  init_context() {
+  }
+
+  virtual void
+  destroy_context() {
+  }
+
+  /// Start a new context.
+  virtual void
+  start_context(int physical_thread_id, void *stack, size_t stacksize, void
+                (*func)(void*), void *args, threading_interface *yield_to);
+
+  /// Swap context.
+  virtual void
+  swap_context(threading_interface *to);
+
+  /// This is called when we have completed running the thread. It is
+  /// called in the from context.
+  virtual void
+  complete_context(threading_interface *to) {
+    swap_context(to);
+  }
+
+};
+
+#endif
+
+}
+} // end of namespace sstmac
+#endif
@@ -447,6 +447,14 @@ class mpi_api :
       int count, MPI_Datatype type, MPI_Op op,
        MPI_Comm comm);
 
+  int
+  exscan(int count, MPI_Datatype type, MPI_Op op, MPI_Comm comm);
+
+  int
+  exscan(const void* src, void* dst,
+      int count, MPI_Datatype type, MPI_Op op,
+       MPI_Comm comm);
+
   int
   ibarrier(MPI_Comm comm, MPI_Request* req);
 
@@ -586,6 +594,14 @@ class mpi_api :
       int count, MPI_Datatype type, MPI_Op op,
        MPI_Comm comm, MPI_Request* req);
 
+  int
+  iexscan(int count, MPI_Datatype type, MPI_Op op, MPI_Comm comm, MPI_Request* req);
+
+  int
+  iexscan(const void* src, void* dst,
+      int count, MPI_Datatype type, MPI_Op op,
+       MPI_Comm comm, MPI_Request* req);
+
 
   int
   type_get_name(MPI_Datatype type, char* type_name, int* resultlen);
@@ -790,12 +806,12 @@ class mpi_api :
 
   void start_reduce(collective_op* op);
 
-  void start_reduce_scatter(collective_op* op);
-
-  void start_reduce_scatter_block(collective_op* op);
+  void start_reduce_scatter(collective_op* op, int* recvcnts);
 
   void start_scan(collective_op* op);
 
+  void start_exscan(collective_op* op);
+
   void start_scatter(collective_op* op);
 
   void start_allgatherv(collectivev_op* op);
@@ -885,6 +901,11 @@ class mpi_api :
       int count, MPI_Datatype type, MPI_Op op,
        MPI_Comm comm);
 
+  collective_op_base*
+  start_exscan(const char* name, const void* src, void* dst,
+      int count, MPI_Datatype type, MPI_Op op,
+       MPI_Comm comm);
+
   void do_start(MPI_Request req);
 
   void
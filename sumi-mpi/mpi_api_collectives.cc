@@ -683,17 +683,12 @@ mpi_api::ireduce(int count, MPI_Datatype type, MPI_Op op, int root, MPI_Comm com
 }
 
 void
-mpi_api::start_reduce_scatter(collective_op* op)
+mpi_api::start_reduce_scatter(collective_op* op, int* recvcnts)
 {
-  spkt_throw(sprockit::unimplemented_error,
-    "sumi::reduce_scatter");
-
   reduce_fxn fxn = get_collective_function(op);
-
-  //transport::allreduce(op->tmp_recvbuf, op->tmp_sendbuf, op->sendcnt,
-  //                     op->sendtype->packed_size(), op->tag,
-  //                     fxn, false, options::initial_context, op->comm);
-
+  transport::reduce_scatter(op->tmp_recvbuf, op->tmp_sendbuf, recvcnts,
+                            op->sendtype->packed_size(), op->tag,
+                            fxn, false, options::initial_context, op->comm);
 }
 
 collective_op_base*
@@ -705,14 +700,23 @@ mpi_api::start_reduce_scatter(const char *name, const void *src, void *dst,
     "%s(<...>,%s,%s,%s)", name,
     type_str(type).c_str(), op_str(mop), comm_str(comm).c_str());
 
-  spkt_throw(sprockit::unimplemented_error,
-    "sumi::reduce_scatter");
+  mpi_comm* cm = get_comm(comm);
+  int total = 0;
+  for (int i=0; i < cm->size(); ++i){
+    total += recvcnts[i];
+  }
 
-  collective_op* op = 0;
-  start_mpi_collective(collective::reduce_scatter, src, dst, type, type, op);
-  start_reduce_scatter(op);
+  //in place, the whole vector comes in through the result buffer
+  if (src == MPI_IN_PLACE){
+    src = dst;
+  }
+
+  collective_op* op = new collective_op(total, recvcnts[cm->rank()], cm);
   op->op = mop;
 
+  start_mpi_collective(collective::reduce_scatter, src, dst, type, type, op);
+  start_reduce_scatter(op, recvcnts);
+
   return op;
 }
 
@@ -760,15 +764,10 @@ mpi_api::start_reduce_scatter_block(const char *name, const void *src, void *dst
     "%s(<...>,%s,%s,%s)", name,
     type_str(type).c_str(), op_str(mop), comm_str(comm).c_str());
 
-  spkt_throw(sprockit::unimplemented_error,
-    "sumi::reduce_scatter");
-
-  collective_op* op = 0;
-  start_mpi_collective(collective::reduce_scatter, src, dst, type, type, op);
-  start_reduce_scatter(op);
-  op->op = mop;
-
-  return op;
+  mpi_comm* cm = get_comm(comm);
+  //the counts are copied by the collective before this returns
+  std::vector<int> recvcnts(cm->size(), recvcnt);
+  return start_reduce_scatter(name, src, dst, recvcnts.data(), type, mop, comm);
 }
 
 int
@@ -812,11 +811,10 @@ mpi_api::ireduce_scatter_block(int recvcnt, MPI_Datatype type,
 void
 mpi_api::start_scan(collective_op* op)
 {
-  spkt_throw(sprockit::unimplemented_error, "sumi::scan");
   reduce_fxn fxn = get_collective_function(op);
-  //transport::reduce(op->tmp_recvbuf, op->tmp_sendbuf, op->sendcnt,
-  //                     op->sendtype->packed_size(), op->tag,
-  //                     fxn, false, options::initial_context, op->comm);
+  transport::scan(op->tmp_recvbuf, op->tmp_sendbuf, op->sendcnt,
+                  op->sendtype->packed_size(), op->tag,
+                  fxn, false, options::initial_context, op->comm);
 }
 
 collective_op_base*
@@ -866,6 +864,63 @@ mpi_api::iscan(int count, MPI_Datatype type, MPI_Op op,
   return iscan(NULL, NULL, count, type, op, comm, req);
 }
 
+void
+mpi_api::start_exscan(collective_op* op)
+{
+  reduce_fxn fxn = get_collective_function(op);
+  transport::exscan(op->tmp_recvbuf, op->tmp_sendbuf, op->sendcnt,
+                    op->sendtype->packed_size(), op->tag,
+                    fxn, false, options::initial_context, op->comm);
+}
+
+collective_op_base*
+mpi_api::start_exscan(const char* name, const void *src, void *dst,
+                      int count, MPI_Datatype type, MPI_Op mop, MPI_Comm comm)
+{
+  mpi_api_debug(sprockit::dbg::mpi | sprockit::dbg::mpi_collective,
+    "%s(%d,%s,%s,%s)", name,
+    count, type_str(type).c_str(), op_str(mop), comm_str(comm).c_str());
+
+  collective_op* op = new collective_op(count, get_comm(comm));
+  op->op = mop;
+
+  //completes as a scan, only the result differs
+  start_mpi_collective(collective::scan, src, dst, type, type, op);
+  start_exscan(op);
+  return op;
+}
+
+int
+mpi_api::exscan(const void *src, void *dst, int count, MPI_Datatype type, MPI_Op mop, MPI_Comm comm)
+{
+  collective_op_base* op = start(exscan, "MPI_Exscan", src, dst, count, type, mop, comm);
+  wait_collective(op);
+  delete op;
+  return MPI_SUCCESS;
+}
+
+int
+mpi_api::exscan(int count, MPI_Datatype type, MPI_Op op, MPI_Comm comm)
+{
+  return exscan(NULL, NULL, count, type, op, comm);
+}
+
+int
+mpi_api::iexscan(const void *src, void *dst, int count, MPI_Datatype type,
+                 MPI_Op mop, MPI_Comm comm, MPI_Request* req)
+{
+  collective_op_base* op = start(exscan, "MPI_Iexscan", src, dst, count, type, mop, comm);
+  add_immediate_collective(op, req);
+  return MPI_SUCCESS;
+}
+
+int
+mpi_api::iexscan(int count, MPI_Datatype type, MPI_Op op,
+                 MPI_Comm comm, MPI_Request* req)
+{
+  return iexscan(NULL, NULL, count, type, op, comm, req);
+}
+
 void
 mpi_api::start_scatter(collective_op* op)
 {
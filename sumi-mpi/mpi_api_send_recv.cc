@@ -172,6 +172,9 @@ mpi_api::recv(void *buf, int count, MPI_Datatype datatype, int source,
   queue_->recv(req, count, datatype, source, tag, commPtr, buf);
 
   queue_->progress_loop(req);
+  if (status != MPI_STATUS_IGNORE){
+    *status = req->status();
+  }
   delete req;
 
   return MPI_SUCCESS;
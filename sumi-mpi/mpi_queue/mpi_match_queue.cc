@@ -0,0 +1,137 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#include <sumi-mpi/mpi_queue/mpi_match_queue.h>
+#include <sumi-mpi/mpi_queue/mpi_queue_recv_request.h>
+
+namespace sumi {
+
+void
+mpi_recv_match_queue::push_back(mpi_queue_recv_request* req)
+{
+  mpi_match_key key = { req->comm_, req->source_, req->tag_ };
+  entry e = { next_seqnum_++, req };
+  buckets_[key].push_back(e);
+  ++size_;
+}
+
+mpi_queue_recv_request*
+mpi_recv_match_queue::pop_match(const mpi_message::ptr& msg)
+{
+  mpi_match_key keys[4] = {
+    { msg->comm(), msg->src_rank(), msg->tag() },
+    { msg->comm(), MPI_ANY_SOURCE, msg->tag() },
+    { msg->comm(), msg->src_rank(), MPI_ANY_TAG },
+    { msg->comm(), MPI_ANY_SOURCE, MPI_ANY_TAG }
+  };
+
+  bucket_map::iterator earliest = buckets_.end();
+  for (const mpi_match_key& key : keys){
+    auto it = buckets_.find(key);
+    if (it == buckets_.end()) continue;
+
+    bucket& b = it->second;
+    while (!b.empty() && b.front().req->is_cancelled()){
+      b.pop_front();
+      --size_;
+    }
+    if (b.empty()){
+      buckets_.erase(it);
+    } else if (earliest == buckets_.end()
+      || b.front().seqnum < earliest->second.front().seqnum){
+      earliest = it;
+    }
+  }
+
+  if (earliest == buckets_.end()){
+    return nullptr;
+  }
+
+  mpi_queue_recv_request* req = earliest->second.front().req;
+  earliest->second.pop_front();
+  if (earliest->second.empty()){
+    buckets_.erase(earliest);
+  }
+  --size_;
+  //the match is known, but this also checks the buffer is big enough
+  req->matches(msg);
+  return req;
+}
+
+mpi_unexpected_queue::~mpi_unexpected_queue()
+{
+  for (entry* e : all_){
+    delete e;
+  }
+}
+
+void
+mpi_unexpected_queue::match_keys(const mpi_message::ptr& msg, mpi_match_key keys[4])
+{
+  keys[0] = { msg->comm(), msg->src_rank(), msg->tag() };
+  keys[1] = { msg->comm(), MPI_ANY_SOURCE, msg->tag() };
+  keys[2] = { msg->comm(), msg->src_rank(), MPI_ANY_TAG };
+  keys[3] = { msg->comm(), MPI_ANY_SOURCE, MPI_ANY_TAG };
+}
+
+void
+mpi_unexpected_queue::push_back(const mpi_message::ptr& msg)
+{
+  mpi_match_key keys[4];
+  match_keys(msg, keys);
+
+  entry* e = new entry;
+  e->msg = msg;
+  e->all_pos = all_.insert(all_.end(), e);
+  for (int i=0; i < 4; ++i){
+    bucket& b = buckets_[keys[i]];
+    e->pos[i] = b.insert(b.end(), e);
+  }
+}
+
+mpi_message::ptr
+mpi_unexpected_queue::find_match(MPI_Comm comm, int source, int tag) const
+{
+  mpi_match_key key = { comm, source, tag };
+  auto it = buckets_.find(key);
+  if (it == buckets_.end()){
+    return mpi_message::ptr();
+  }
+  return it->second.front()->msg;
+}
+
+mpi_message::ptr
+mpi_unexpected_queue::pop_match(MPI_Comm comm, int source, int tag)
+{
+  mpi_match_key key = { comm, source, tag };
+  auto it = buckets_.find(key);
+  if (it == buckets_.end()){
+    return mpi_message::ptr();
+  }
+
+  entry* e = it->second.front();
+  mpi_match_key keys[4];
+  match_keys(e->msg, keys);
+  for (int i=0; i < 4; ++i){
+    auto bit = buckets_.find(keys[i]);
+    bit->second.erase(e->pos[i]);
+    if (bit->second.empty()){
+      buckets_.erase(bit);
+    }
+  }
+  all_.erase(e->all_pos);
+
+  mpi_message::ptr msg = e->msg;
+  delete e;
+  return msg;
+}
+
+}
@@ -0,0 +1,159 @@
+/*
+ *  This file is part of SST/macroscale:
+ *               The macroscale architecture simulator from the SST suite.
+ *  Copyright (c) 2009 Sandia Corporation.
+ *  This software is distributed under the BSD License.
+ *  Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,
+ *  the U.S. Government retains certain rights in this software.
+ *  For more information, see the LICENSE file in the top
+ *  SST/macroscale directory.
+ */
+
+#ifndef SSTMAC_SOFTWARE_LIBRARIES_MPI_MPI_QUEUE_MPIMATCHQUEUE_H_INCLUDED
+#define SSTMAC_SOFTWARE_LIBRARIES_MPI_MPI_QUEUE_MPIMATCHQUEUE_H_INCLUDED
+
+#include <sumi-mpi/mpi_message.h>
+#include <sumi-mpi/mpi_queue/mpi_queue_recv_request_fwd.h>
+#include <sprockit/unordered.h>
+#include <deque>
+#include <list>
+#include <stdint.h>
+
+namespace sumi {
+
+/**
+ * The envelope matched on. Posted receives can have MPI_ANY_SOURCE
+ * and MPI_ANY_TAG in their key, messages never do.
+ */
+struct mpi_match_key {
+  MPI_Comm comm;
+  int source;
+  int tag;
+
+  bool
+  operator==(const mpi_match_key& other) const {
+    return comm == other.comm && source == other.source && tag == other.tag;
+  }
+
+  struct hash {
+    size_t
+    operator()(const mpi_match_key& key) const {
+      uint64_t h = uint32_t(key.comm);
+      h = h*1000003 ^ uint32_t(key.source);
+      h = h*1000003 ^ uint32_t(key.tag);
+      return size_t(h);
+    }
+  };
+};
+
+/**
+ * Posted receives, bucketed by their envelope including wildcards.
+ * All receives in a bucket match exactly the same messages, so each bucket
+ * is in posting order and an incoming message only has to compare
+ * the first receive in each of the 4 buckets it can match.
+ */
+class mpi_recv_match_queue
+{
+ public:
+  mpi_recv_match_queue() : next_seqnum_(0), size_(0) {}
+
+  void
+  push_back(mpi_queue_recv_request* req);
+
+  /**
+   * Cancelled receives found along the way are dropped
+   * @return The earliest posted receive matching the message, null if none
+   */
+  mpi_queue_recv_request*
+  pop_match(const mpi_message::ptr& msg);
+
+  size_t
+  size() const {
+    return size_;
+  }
+
+  template <class Fn>
+  void
+  for_each(Fn fn) const {
+    for (auto& pair : buckets_){
+      for (const entry& e : pair.second){
+        fn(e.req);
+      }
+    }
+  }
+
+ private:
+  struct entry {
+    uint64_t seqnum;
+    mpi_queue_recv_request* req;
+  };
+
+  typedef std::deque<entry> bucket;
+
+  typedef spkt_unordered_map<mpi_match_key, bucket, mpi_match_key::hash> bucket_map;
+
+  bucket_map buckets_;
+
+  uint64_t next_seqnum_;
+
+  size_t size_;
+
+};
+
+/**
+ * Messages that arrived before a receive was posted for them. Every message
+ * is linked into the buckets of all 4 envelopes that can match it,
+ * so any receive finds the earliest matching message in a single bucket.
+ */
+class mpi_unexpected_queue
+{
+ public:
+  ~mpi_unexpected_queue();
+
+  void
+  push_back(const mpi_message::ptr& msg);
+
+  /**
+   * @return The earliest message matching the envelope, null if none
+   */
+  mpi_message::ptr
+  find_match(MPI_Comm comm, int source, int tag) const;
+
+  /**
+   * @return The earliest message matching the envelope removed from the queue,
+   *         null if none
+   */
+  mpi_message::ptr
+  pop_match(MPI_Comm comm, int source, int tag);
+
+  size_t
+  size() const {
+    return all_.size();
+  }
+
+ private:
+  struct entry;
+
+  typedef std::list<entry*> bucket;
+
+  struct entry {
+    mpi_message::ptr msg;
+    std::list<entry*>::iterator all_pos;
+    bucket::iterator pos[4];
+  };
+
+  typedef spkt_unordered_map<mpi_match_key, bucket, mpi_match_key::hash> bucket_map;
+
+  static void
+  match_keys(const mpi_message::ptr& msg, mpi_match_key keys[4]);
+
+  bucket_map buckets_;
+
+  /** Everything in arrival order, only needed for cleanup */
+  std::list<entry*> all_;
+
+};
+
+}
+
+#endif
@@ -119,9 +119,7 @@ mpi_queue::~mpi_queue() throw ()
 {
   //receives can be posted, but not resolved
   //clean up stuff
-  for (mpi_queue_recv_request* req : pending_message_){
-    delete req;
-  }
+  pending_message_.for_each([](mpi_queue_recv_request* req){ delete req; });
   for (mpi_queue_recv_request* req : waiting_message_){
     delete req;
   }
@@ -229,18 +227,14 @@ mpi_queue::protocol(long bytes) const
 mpi_message::ptr
 mpi_queue::find_matching_recv(mpi_queue_recv_request* req)
 {
-  need_recv_t::iterator it, end = need_recv_.end();
-  for (it = need_recv_.begin(); it != end; ++it) {
-    mpi_message::ptr mess = *it;
-    if (req->matches(mess)) {
-      mpi_queue_debug("matched recv tag=%s,src=%s to send tag=%d,src=%d on comm=%s",
-        api_->tag_str(req->tag_).c_str(), api_->src_str(req->source_).c_str(),
-        mess->tag(), mess->src_rank(), api_->comm_str(req->comm_).c_str());
-
-      need_recv_.erase(it);
-      return mess;
-
-    }
+  mpi_message::ptr mess = need_recv_.pop_match(req->comm_, req->source_, req->tag_);
+  if (mess) {
+    mpi_queue_debug("matched recv tag=%s,src=%s to send tag=%d,src=%d on comm=%s",
+      api_->tag_str(req->tag_).c_str(), api_->src_str(req->source_).c_str(),
+      mess->tag(), mess->src_rank(), api_->comm_str(req->comm_).c_str());
+    //checks the buffer is big enough
+    req->matches(mess);
+    return mess;
   }
   mpi_queue_debug("could not match recv tag=%s, src=%s to any sends on comm=%s",
     api_->tag_str(req->tag_).c_str(), api_->src_str(req->source_).c_str(),
@@ -312,14 +306,12 @@ mpi_queue::probe(mpi_request* key, mpi_comm* comm,
 
   mpi_queue_probe_request* req = new mpi_queue_probe_request(key, comm->id(), source, tag);
   // Figure out whether we already have a matching message.
-  need_recv_t::iterator it, end = need_recv_.end();
-  for (it = need_recv_.begin(); it != end; ++it) {
-    mpi_message::ptr mess = *it;
-    if (req->matches(mess)){
-      // We're good to go.
-      req->complete(mess);
-      return;
-    }
+  mpi_message::ptr mess = need_recv_.find_match(comm->id(), source, tag);
+  if (mess){
+    // We're good to go.
+    req->complete(mess);
+    delete req;
+    return;
   }
   // If we get here, we still need to wait for the message.
   probelist_.push_back(req);
@@ -338,19 +330,13 @@ mpi_queue::iprobe(mpi_comm* comm,
     api_->src_str(source).c_str(), api_->tag_str(tag).c_str(),
     api_->comm_str(comm).c_str());
 
-  mpi_queue_probe_request* req = new mpi_queue_probe_request(NULL, comm->id(), source, tag);
-  need_recv_t::iterator it, end = need_recv_.end();
-  for (it = need_recv_.begin(); it != end; ++it) {
-    mpi_message::ptr mess = *it;
-    if (req->matches(mess)) {
-      // This is it
-      delete req;
-      if (stat != MPI_STATUS_IGNORE) mess->build_status(stat);
-      return true;
-    }
+  mpi_message::ptr mess = need_recv_.find_match(comm->id(), source, tag);
+  if (mess) {
+    // This is it
+    if (stat != MPI_STATUS_IGNORE) mess->build_status(stat);
+    return true;
   }
   // If we got here, there was no match
-  delete req;
   return false;
 }
 
@@ -551,7 +537,7 @@ mpi_queue_recv_request*
 mpi_queue::pop_pending_request(const mpi_message::ptr& message,
                                 bool set_need_recv)
 {
-  mpi_queue_recv_request* req = pop_matching_request(pending_message_, message);
+  mpi_queue_recv_request* req = pending_message_.pop_match(message);
   if (!req) {
     // We get here if no match was found.
     // Messages that don't have a respondent are added to the list
@@ -36,6 +36,7 @@
 #include <sumi-mpi/mpi_queue/mpi_queue_recv_request_fwd.h>
 #include <sumi-mpi/mpi_queue/mpi_queue_send_request_fwd.h>
 #include <sumi-mpi/mpi_queue/mpi_queue_probe_request_fwd.h>
+#include <sumi-mpi/mpi_queue/mpi_match_queue.h>
 
 #include <queue>
 
@@ -150,8 +151,6 @@ class mpi_queue
 
   typedef std::list<mpi_queue_recv_request*> pending_message_t;
 
-  typedef std::list<mpi_message::ptr> need_recv_t;
-
   typedef std::list<mpi_queue_send_request*> send_needs_ack_t;
 
   typedef spkt_unordered_map<int, mpi_message::ptr> reorderlist_t;
@@ -227,14 +226,15 @@ class mpi_queue
   /// The (locally unique) id that will be given to the next message.
   mpi_message::id next_id_;
 
-  pending_message_t pending_message_;
+  /// Posted receives waiting for a matching message.
+  mpi_recv_match_queue pending_message_;
 
   pending_message_t waiting_message_;
 
   pending_message_t in_flight_messages_;
 
   /// Inbound messages waiting for a matching receive request.
-  need_recv_t need_recv_;
+  mpi_unexpected_queue need_recv_;
 
   /// Save all sends so we can match up the nic acks that come back
   send_needs_ack_t send_needs_nic_ack_;
@@ -25,6 +25,7 @@ namespace sumi {
  */
 class mpi_queue_recv_request  {
   friend class mpi_queue;
+  friend class mpi_recv_match_queue;
   friend class rendezvous_get;
   friend class eager1;
   friend class eager1_doublecpy;
@@ -119,6 +119,9 @@ extern "C" int sstmac_reduce_scatter_block(const void* src, void* dst,
 extern "C" int sstmac_scan(const void* src, void* dst,
       int count, MPI_Datatype type, MPI_Op op,
        MPI_Comm comm){ return sumi::sstmac_mpi()->scan(src,dst,count,type,op,comm); }
+extern "C" int sstmac_exscan(const void* src, void* dst,
+       int count, MPI_Datatype type, MPI_Op op,
+       MPI_Comm comm){ return sumi::sstmac_mpi()->exscan(src,dst,count,type,op,comm); }
 extern "C" int sstmac_ibarrier(MPI_Comm comm, MPI_Request* req){ return sumi::sstmac_mpi()->ibarrier(comm,req); }
 extern "C" int sstmac_ibcast(void *buffer, int count, MPI_Datatype datatype, int root,
         MPI_Comm comm, MPI_Request* req){ return sumi::sstmac_mpi()->ibcast(buffer,count,datatype,root,comm,req); }
@@ -164,6 +167,9 @@ extern "C" int sstmac_ireduce_scatter_block(const void* src, void* dst,
 extern "C" int sstmac_iscan(const void* src, void* dst,
       int count, MPI_Datatype type, MPI_Op op,
        MPI_Comm comm, MPI_Request* req){ return sumi::sstmac_mpi()->iscan(src,dst,count,type,op,comm,req); }
+extern "C" int sstmac_iexscan(const void* src, void* dst,
+       int count, MPI_Datatype type, MPI_Op op,
+       MPI_Comm comm, MPI_Request* req){ return sumi::sstmac_mpi()->iexscan(src,dst,count,type,op,comm,req); }
 extern "C" int sstmac_type_get_name(MPI_Datatype type, char* type_name, int* resultlen){ return sumi::sstmac_mpi()->type_get_name(type,type_name,resultlen); }
 extern "C" int sstmac_type_set_name(MPI_Datatype type, const char* type_name){ return sumi::sstmac_mpi()->type_set_name(type,type_name); }
 extern "C" int sstmac_type_extent(MPI_Datatype type, MPI_Aint* extent){ return sumi::sstmac_mpi()->type_extent(type,extent); }
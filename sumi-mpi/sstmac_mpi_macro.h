@@ -63,6 +63,7 @@
 #define MPI_Ibarrier current_mpi()->ibarrier
 #define MPI_Ibcast current_mpi()->ibcast
 #define MPI_Iscan current_mpi()->iscan
+#define MPI_Iexscan current_mpi()->iexscan
 #define MPI_Igather current_mpi()->igather
 #define MPI_Igatherv current_mpi()->igatherv
 #define MPI_Iallgather current_mpi()->iallgather
@@ -147,6 +148,7 @@
 #define MPI_Op_free current_mpi()->op_free
 #define MPI_Reduce_scatter_block   current_mpi()->reduce_scatter_block
 #define MPI_Ireduce_scatter_block   current_mpi()->ireduce_scatter_block
+#define MPI_Ireduce_scatter   current_mpi()->ireduce_scatter
 #define MPI_Send_init current_mpi()->send_init
 #define MPI_Bsend_init current_mpi()->send_init
 #define MPI_Rsend_init current_mpi()->send_init
@@ -211,6 +213,7 @@
 #define MPI_Ibarrier sstmac_ibarrier
 #define MPI_Ibcast sstmac_ibcast
 #define MPI_Iscan sstmac_iscan
+#define MPI_Iexscan sstmac_iexscan
 #define MPI_Igather sstmac_igather
 #define MPI_Igatherv sstmac_igatherv
 #define MPI_Iallgather sstmac_iallgather
@@ -295,6 +298,7 @@
 #define MPI_Op_free sstmac_op_free
 #define MPI_Reduce_scatter_block sstmac_reduce_scatter_block
 #define MPI_Ireduce_scatter_block sstmac_ireduce_scatter_block
+#define MPI_Ireduce_scatter sstmac_ireduce_scatter
 #define MPI_Send_init sstmac_send_init
 #define MPI_Bsend_init sstmac_send_init
 #define MPI_Rsend_init sstmac_send_init
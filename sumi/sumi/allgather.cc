@@ -18,6 +18,9 @@ namespace sumi
 {
 
 SpktRegister("bruck_allgather", dag_collective, bruck_allgather_collective);
+SpktRegister("ring_allgather", dag_collective, ring_allgather_collective);
+SpktRegister("recursive_doubling_allgather", dag_collective,
+             recursive_doubling_allgather_collective);
 
 void
 bruck_allgather_actor::init_buffers(void* dst, void* src)
@@ -155,6 +158,187 @@ bruck_allgather_actor::finalize()
   delete[] tmp;
 }
 
+/**
+ * Put my block where it belongs in the result buffer,
+ * unlike bruck there is no reordering at the end
+ */
+static void
+place_allgather_block(void* dst, void* src, int me, int block_size)
+{
+  //in place means my block is already there
+  if (dst != src){
+    std::memcpy((char*)dst + me*block_size, src, block_size);
+  }
+}
 
+void
+ring_allgather_actor::init_buffers(void* dst, void* src)
+{
+  if (src){
+    place_allgather_block(dst, src, dense_me_, nelems_ * type_size_);
+    long buffer_size = nelems_ * type_size_ * comm_->nproc();
+    result_buffer_ = my_api_->make_public_buffer(dst, buffer_size);
+    send_buffer_ = result_buffer_;
+    recv_buffer_ = result_buffer_;
+  }
 }
 
+void
+ring_allgather_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    long buffer_size = nelems_ * type_size_ * comm_->nproc();
+    my_api_->unmake_public_buffer(result_buffer_, buffer_size);
+  }
+}
+
+void
+ring_allgather_actor::init_dag()
+{
+  int nproc = dense_nproc_;
+  int me = dense_me_;
+  int right = (me + 1) % nproc;
+  int left = (me + nproc - 1) % nproc;
+
+  debug_printf(sumi_collective,
+    "Ring allgather %s: configured for %d rounds on tag=%d",
+    rank_str().c_str(), nproc - 1, tag_);
+
+  //rounds can exceed action::max_round for big rings, but message ids stay
+  //unique since every send goes to the right and every recv comes from the left
+  action *prev_send = 0, *prev_recv = 0;
+  for (int i=0; i < nproc - 1; ++i){
+    int send_block = (me + nproc - i) % nproc;
+    int recv_block = (send_block + nproc - 1) % nproc;
+    action* send_ac = new send_action(i, right, send_action::in_place);
+    action* recv_ac = new recv_action(i, left, recv_action::in_place);
+    send_ac->offset = send_block * nelems_;
+    recv_ac->offset = recv_block * nelems_;
+    send_ac->nelems = nelems_;
+    recv_ac->nelems = nelems_;
+
+    add_dependency(prev_send, send_ac);
+    add_dependency(prev_recv, send_ac);
+    add_dependency(prev_send, recv_ac);
+    add_dependency(prev_recv, recv_ac);
+
+    prev_send = send_ac;
+    prev_recv = recv_ac;
+  }
+}
+
+void
+ring_allgather_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  std::memcpy(dst_buffer, msg_buffer, ac->nelems * type_size_);
+}
+
+void
+recursive_doubling_allgather_actor::init_buffers(void* dst, void* src)
+{
+  if (src){
+    place_allgather_block(dst, src, dense_me_, nelems_ * type_size_);
+    long buffer_size = nelems_ * type_size_ * comm_->nproc();
+    result_buffer_ = my_api_->make_public_buffer(dst, buffer_size);
+    send_buffer_ = result_buffer_;
+    recv_buffer_ = result_buffer_;
+  }
+}
+
+void
+recursive_doubling_allgather_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    long buffer_size = nelems_ * type_size_ * comm_->nproc();
+    my_api_->unmake_public_buffer(result_buffer_, buffer_size);
+  }
+}
+
+/**
+ * @return The first block held by a folded rank. Folded ranks
+ *         below num_folded hold 2 blocks, the rest hold 1.
+ */
+static int
+first_block(int folded, int num_folded)
+{
+  return folded < num_folded ? 2*folded : folded + num_folded;
+}
+
+void
+recursive_doubling_allgather_actor::init_dag()
+{
+  int log2nproc;
+  int num_folded = compute_fold(log2nproc);
+  int me = dense_me_;
+  int folded_me = folded_rank(me, num_folded);
+  int final_round = log2nproc + 1;
+  int total_nelems = nelems_ * dense_nproc_;
+
+  debug_printf(sumi_collective,
+    "Recursive doubling allgather %s: configured for %d rounds with %d folded ranks on tag=%d",
+    rank_str().c_str(), log2nproc, num_folded, tag_);
+
+  if (folded_me < 0){
+    //hand my block to my neighbor and wait for everything
+    action* send_ac = new send_action(0, me + 1, send_action::in_place);
+    send_ac->offset = me * nelems_;
+    send_ac->nelems = nelems_;
+    action* recv_ac = new recv_action(final_round, me + 1, recv_action::in_place);
+    recv_ac->offset = 0;
+    recv_ac->nelems = total_nelems;
+    add_action(send_ac);
+    add_dependency(send_ac, recv_ac);
+    return;
+  }
+
+  action *prev_send = 0, *prev_recv = 0;
+  if (me < 2*num_folded){
+    action* recv_ac = new recv_action(0, me - 1, recv_action::in_place);
+    recv_ac->offset = (me - 1) * nelems_;
+    recv_ac->nelems = nelems_;
+    add_action(recv_ac);
+    prev_recv = recv_ac;
+  }
+
+  int partner_gap = 1;
+  for (int i=0; i < log2nproc; ++i){
+    int folded_partner = folded_me ^ partner_gap;
+    int partner = unfolded_rank(folded_partner, num_folded);
+    //the group of partner_gap folded ranks whose blocks I have gathered so far
+    int my_group = folded_me & ~(partner_gap - 1);
+    int partner_group = folded_partner & ~(partner_gap - 1);
+    int my_first = first_block(my_group, num_folded);
+    int partner_first = first_block(partner_group, num_folded);
+    action* send_ac = new send_action(i + 1, partner, send_action::in_place);
+    send_ac->offset = my_first * nelems_;
+    send_ac->nelems = (first_block(my_group + partner_gap, num_folded) - my_first) * nelems_;
+    action* recv_ac = new recv_action(i + 1, partner, recv_action::in_place);
+    recv_ac->offset = partner_first * nelems_;
+    recv_ac->nelems = (first_block(partner_group + partner_gap, num_folded) - partner_first) * nelems_;
+
+    add_dependency(prev_send, send_ac);
+    add_dependency(prev_recv, send_ac);
+    add_dependency(prev_send, recv_ac);
+    add_dependency(prev_recv, recv_ac);
+
+    prev_send = send_ac;
+    prev_recv = recv_ac;
+    partner_gap *= 2;
+  }
+
+  if (me < 2*num_folded){
+    action* send_ac = new send_action(final_round, me - 1, send_action::in_place);
+    send_ac->offset = 0;
+    send_ac->nelems = total_nelems;
+    add_dependency(prev_send, send_ac);
+    add_dependency(prev_recv, send_ac);
+  }
+}
+
+void
+recursive_doubling_allgather_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  std::memcpy(dst_buffer, msg_buffer, ac->nelems * type_size_);
+}
+
+}
@@ -53,6 +53,98 @@ class bruck_allgather_collective :
 
 };
 
+/**
+ * Every rank forwards the block it received last to its right neighbor.
+ * Takes p-1 rounds, but there is no reordering at the end
+ * and each link only ever carries one block at a time.
+ */
+class ring_allgather_actor :
+  public dag_collective_actor
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "ring allgather actor";
+  }
+
+ protected:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+
+  void buffer_action(void *dst_buffer, void *msg_buffer, action* ac) override;
+
+};
+
+class ring_allgather_collective :
+  public dag_collective
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "ring allgather";
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new ring_allgather_actor;
+  }
+
+  dag_collective*
+  clone() const override {
+    return new ring_allgather_collective;
+  }
+
+};
+
+/**
+ * Partners at doubling distance swap everything they have gathered so far.
+ * Non-power-of-2 process counts fold the extra ranks into their neighbors,
+ * which keeps the blocks held by any group of partners contiguous.
+ */
+class recursive_doubling_allgather_actor :
+  public dag_collective_actor
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "recursive doubling allgather actor";
+  }
+
+ protected:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+
+  void buffer_action(void *dst_buffer, void *msg_buffer, action* ac) override;
+
+};
+
+class recursive_doubling_allgather_collective :
+  public dag_collective
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "recursive doubling allgather";
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new recursive_doubling_allgather_actor;
+  }
+
+  dag_collective*
+  clone() const override {
+    return new recursive_doubling_allgather_collective;
+  }
+
+};
+
 }
 
 #endif // ALLGATHER_H
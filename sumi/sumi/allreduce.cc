@@ -16,7 +16,9 @@ using namespace sprockit::dbg;
 namespace sumi
 {
 
-SpktRegister("wilke", dag_collective, wilke_halving_allreduce);
+SpktRegister("wilke_allreduce | rabenseifner_allreduce", dag_collective, wilke_halving_allreduce);
+SpktRegister("ring_allreduce", dag_collective, ring_allreduce);
+SpktRegister("recursive_doubling_allreduce", dag_collective, recursive_doubling_allreduce);
 
 void
 wilke_allreduce_actor::finalize_buffers()
@@ -210,4 +212,202 @@ wilke_allreduce_actor::buffer_action(void *dst_buffer, void *msg_buffer, action*
   }
 }
 
+void
+ring_allreduce_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    long buffer_size = nelems_ * type_size_;
+    my_api_->unmake_public_buffer(result_buffer_, buffer_size);
+    my_api_->free_public_buffer(recv_buffer_, buffer_size);
+  }
+}
+
+void
+ring_allreduce_actor::init_buffers(void* dst, void* src)
+{
+  int size = nelems_ * type_size_;
+  if (src){
+    if (src != dst)
+      std::memcpy(dst, src, size);
+    result_buffer_ = my_api_->make_public_buffer(dst, size);
+    //each chunk lands in its own section of the temp buffer before being reduced
+    recv_buffer_ = my_api_->allocate_public_buffer(size);
+  }
+  send_buffer_ = result_buffer_;
+}
+
+int
+ring_allreduce_actor::chunk_offset(int chunk) const
+{
+  return (long(chunk) * nelems_) / dense_nproc_;
+}
+
+void
+ring_allreduce_actor::init_dag()
+{
+  slicer_->fxn = fxn_;
+
+  int nproc = dense_nproc_;
+  int me = dense_me_;
+  int right = (me + 1) % nproc;
+  int left = (me + nproc - 1) % nproc;
+  int num_steps = nproc - 1;
+
+  debug_printf(sumi_collective,
+    "Rank %s configured ring allreduce for tag=%d for nproc=%d over %d rounds",
+    rank_str().c_str(), tag_, nproc, 2*num_steps);
+
+  recv_action::buf_type_t gather_recv_type = slicer_->contiguous() ?
+        recv_action::in_place : recv_action::unpack_temp_buf;
+
+  //rounds can exceed action::max_round for big rings, but message ids stay
+  //unique since every send goes to the right and every recv comes from the left
+  action *prev_send = 0, *prev_recv = 0;
+  for (int step=0; step < 2*num_steps; ++step){
+    bool reducing = step < num_steps;
+    int gather_step = reducing ? step : step - num_steps;
+    //during the allgather I forward the chunk I finished reducing or received last
+    int send_chunk = (me + nproc - gather_step + (reducing ? 0 : 1)) % nproc;
+    int recv_chunk = (send_chunk + nproc - 1) % nproc;
+
+    action* send_ac = new send_action(step, right, send_action::in_place);
+    send_ac->offset = chunk_offset(send_chunk);
+    send_ac->nelems = chunk_offset(send_chunk + 1) - send_ac->offset;
+    action* recv_ac = new recv_action(step, left,
+                          reducing ? recv_action::reduce : gather_recv_type);
+    recv_ac->offset = chunk_offset(recv_chunk);
+    recv_ac->nelems = chunk_offset(recv_chunk + 1) - recv_ac->offset;
+
+    add_dependency(prev_send, send_ac);
+    add_dependency(prev_send, recv_ac);
+    add_dependency(prev_recv, send_ac);
+    add_dependency(prev_recv, recv_ac);
+
+    prev_send = send_ac;
+    prev_recv = recv_ac;
+  }
+}
+
+void
+ring_allreduce_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  if (ac->round < dense_nproc_ - 1){
+    (fxn_)(dst_buffer, msg_buffer, ac->nelems);
+  }
+  else {
+    std::memcpy(dst_buffer, msg_buffer, ac->nelems * type_size_);
+  }
+}
+
+void
+recursive_doubling_allreduce_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    long buffer_size = nelems_ * type_size_;
+    my_api_->unmake_public_buffer(result_buffer_, buffer_size);
+    my_api_->free_public_buffer(recv_buffer_, buffer_size);
+    my_api_->free_public_buffer(send_buffer_, buffer_size);
+  }
+}
+
+void
+recursive_doubling_allreduce_actor::init_buffers(void* dst, void* src)
+{
+  int size = nelems_ * type_size_;
+  if (src){
+    if (src != dst)
+      std::memcpy(dst, src, size);
+    result_buffer_ = my_api_->make_public_buffer(dst, size);
+    recv_buffer_ = my_api_->allocate_public_buffer(size);
+    //the full vector is reduced into while it is being sent
+    //so each round sends from a snapshot of the result
+    send_buffer_ = my_api_->allocate_public_buffer(size);
+  }
+}
+
+void
+recursive_doubling_allreduce_actor::start_shuffle(action* ac)
+{
+  if (result_buffer_.ptr == 0) return;
+
+  std::memcpy(send_buffer_, result_buffer_, nelems_ * type_size_);
+}
+
+void
+recursive_doubling_allreduce_actor::init_dag()
+{
+  slicer_->fxn = fxn_;
+
+  int log2nproc;
+  int num_folded = compute_fold(log2nproc);
+  int me = dense_me_;
+  int folded_me = folded_rank(me, num_folded);
+  int final_round = log2nproc + 1;
+
+  debug_printf(sumi_collective,
+    "Rank %s configured recursive doubling allreduce for tag=%d for nproc=%d over %d rounds",
+    rank_str().c_str(), tag_, dense_nproc_, log2nproc);
+
+  recv_action::buf_type_t result_recv_type = slicer_->contiguous() ?
+        recv_action::in_place : recv_action::unpack_temp_buf;
+
+  if (folded_me < 0){
+    //hand my vector to my neighbor and wait for the answer
+    action* send_ac = new send_action(0, me + 1, send_action::in_place);
+    send_ac->offset = 0;
+    send_ac->nelems = nelems_;
+    action* recv_ac = new recv_action(final_round, me + 1, result_recv_type);
+    recv_ac->offset = 0;
+    recv_ac->nelems = nelems_;
+    add_action(send_ac);
+    add_dependency(send_ac, recv_ac);
+    return;
+  }
+
+  action *prev_send = 0, *prev_recv = 0;
+  if (me < 2*num_folded){
+    action* recv_ac = new recv_action(0, me - 1, recv_action::reduce);
+    recv_ac->offset = 0;
+    recv_ac->nelems = nelems_;
+    add_action(recv_ac);
+    prev_recv = recv_ac;
+  }
+
+  int partner_gap = 1;
+  for (int i=0; i < log2nproc; ++i){
+    int rnd = i + 1;
+    int partner = unfolded_rank(folded_me ^ partner_gap, num_folded);
+    action* shuffle_ac = new shuffle_action(rnd, partner);
+    //the snapshot has to wait until the last send out of it is done
+    add_dependency(prev_send, shuffle_ac);
+    add_dependency(prev_recv, shuffle_ac);
+
+    action* send_ac = new send_action(rnd, partner, send_action::temp_send);
+    send_ac->offset = 0;
+    send_ac->nelems = nelems_;
+    action* recv_ac = new recv_action(rnd, partner, recv_action::reduce);
+    recv_ac->offset = 0;
+    recv_ac->nelems = nelems_;
+    add_dependency(shuffle_ac, send_ac);
+    add_dependency(shuffle_ac, recv_ac);
+
+    prev_send = send_ac;
+    prev_recv = recv_ac;
+    partner_gap *= 2;
+  }
+
+  if (me < 2*num_folded){
+    action* send_ac = new send_action(final_round, me - 1, send_action::in_place);
+    send_ac->offset = 0;
+    send_ac->nelems = nelems_;
+    add_dependency(prev_recv, send_ac);
+  }
+}
+
+void
+recursive_doubling_allreduce_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  (fxn_)(dst_buffer, msg_buffer, ac->nelems);
+}
+
 }
@@ -39,6 +39,10 @@ class wilke_allreduce_actor :
 
 };
 
+/**
+ * Recursive-halving reduce-scatter followed by a recursive-doubling allgather,
+ * i.e. Rabenseifner's algorithm
+ */
 class wilke_halving_allreduce :
   public dag_collective
 {
@@ -72,6 +76,138 @@ class wilke_halving_allreduce :
 
 };
 
+/**
+ * Reduce-scatter around a ring followed by an allgather around the ring.
+ * Takes 2(p-1) rounds but every rank only ever sends nelems/p elements
+ * per round, which is what MPI libraries pick for very large vectors.
+ */
+class ring_allreduce_actor :
+  public dag_collective_actor
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "ring all reduce actor";
+  }
+
+  void
+  buffer_action(void *dst_buffer,
+                void *msg_buffer, action* ac) override;
+
+  ring_allreduce_actor(reduce_fxn fxn) : fxn_(fxn) {}
+
+ private:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+
+  int chunk_offset(int chunk) const;
+
+ private:
+  reduce_fxn fxn_;
+
+};
+
+class ring_allreduce :
+  public dag_collective
+{
+ public:
+  std::string
+  to_string() const override {
+    return "sumi ring allreduce";
+  }
+
+  ring_allreduce(reduce_fxn fxn) : fxn_(fxn) {}
+
+  ring_allreduce(){}
+
+  virtual void
+  init_reduce(reduce_fxn fxn) override {
+    fxn_ = fxn;
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new ring_allreduce_actor(fxn_);
+  }
+
+  dag_collective*
+  clone() const override {
+    return new ring_allreduce(fxn_);
+  }
+
+ private:
+  reduce_fxn fxn_;
+
+};
+
+/**
+ * Every round exchanges and reduces the full vector with a partner
+ * at doubling distance, so only log2(p) rounds are needed.
+ * Non-power-of-2 process counts fold the extra ranks into
+ * their neighbors before the exchange and get the result back after.
+ */
+class recursive_doubling_allreduce_actor :
+  public dag_collective_actor
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "recursive doubling all reduce actor";
+  }
+
+  void
+  buffer_action(void *dst_buffer,
+                void *msg_buffer, action* ac) override;
+
+  recursive_doubling_allreduce_actor(reduce_fxn fxn) : fxn_(fxn) {}
+
+ private:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+  void start_shuffle(action* ac) override;
+
+ private:
+  reduce_fxn fxn_;
+
+};
+
+class recursive_doubling_allreduce :
+  public dag_collective
+{
+ public:
+  std::string
+  to_string() const override {
+    return "sumi recursive doubling allreduce";
+  }
+
+  recursive_doubling_allreduce(reduce_fxn fxn) : fxn_(fxn) {}
+
+  recursive_doubling_allreduce(){}
+
+  virtual void
+  init_reduce(reduce_fxn fxn) override {
+    fxn_ = fxn;
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new recursive_doubling_allreduce_actor(fxn_);
+  }
+
+  dag_collective*
+  clone() const override {
+    return new recursive_doubling_allreduce(fxn_);
+  }
+
+ private:
+  reduce_fxn fxn_;
+
+};
+
 }
 
 #endif // ALLREDUCE_H
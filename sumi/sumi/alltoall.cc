@@ -20,6 +20,7 @@ namespace sumi
 {
 
 SpktRegister("bruck_alltoall", dag_collective, bruck_alltoall_collective);
+SpktRegister("pairwise_alltoall", dag_collective, pairwise_alltoall_collective);
 
 void
 bruck_alltoall_actor::init_buffers(void* dst, void* src)
@@ -193,6 +194,81 @@ bruck_alltoall_actor::finalize()
   delete[] tmp;
 }
 
+void
+pairwise_alltoall_actor::init_buffers(void* dst, void* src)
+{
+  copied_send_ = false;
+  if (src){
+    int block_size = nelems_ * type_size_;
+    int total_size = dense_nproc_ * block_size;
+    result_buffer_ = my_api_->make_public_buffer(dst, total_size);
+    if (src == dst){
+      //blocks would be overwritten before they are sent
+      copied_send_ = true;
+      send_buffer_ = my_api_->allocate_public_buffer(total_size);
+      std::memcpy(send_buffer_, src, total_size);
+    } else {
+      send_buffer_ = my_api_->make_public_buffer(src, total_size);
+      int my_offset = dense_me_ * block_size;
+      std::memcpy((char*)dst + my_offset, (char*)src + my_offset, block_size);
+    }
+    recv_buffer_ = result_buffer_;
+  }
+}
+
+void
+pairwise_alltoall_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    int total_size = dense_nproc_ * nelems_ * type_size_;
+    my_api_->unmake_public_buffer(result_buffer_, total_size);
+    if (copied_send_){
+      my_api_->free_public_buffer(send_buffer_, total_size);
+    } else {
+      my_api_->unmake_public_buffer(send_buffer_, total_size);
+    }
+  }
+}
+
+void
+pairwise_alltoall_actor::init_dag()
+{
+  int nproc = dense_nproc_;
+  int me = dense_me_;
 
+  debug_printf(sumi_collective,
+    "Pairwise all-to-all %s: configured for %d rounds on tag=%d",
+    rank_str().c_str(), nproc - 1, tag_);
+
+  //message ids overflow into the partner once a round reaches action::max_round,
+  //so every message goes out on round 0 - ids stay unique since I never
+  //send to or receive from the same partner twice
+  action *prev_send = 0, *prev_recv = 0;
+  for (int round=1; round < nproc; ++round){
+    int send_partner = (me + round) % nproc;
+    int recv_partner = (me + nproc - round) % nproc;
+    action* send_ac = new send_action(0, send_partner, send_action::temp_send);
+    send_ac->offset = send_partner * nelems_;
+    send_ac->nelems = nelems_;
+    action* recv_ac = new recv_action(0, recv_partner, recv_action::in_place);
+    recv_ac->offset = recv_partner * nelems_;
+    recv_ac->nelems = nelems_;
+
+    //one exchange at a time keeps the network from being flooded
+    add_dependency(prev_send, send_ac);
+    add_dependency(prev_recv, send_ac);
+    add_dependency(prev_send, recv_ac);
+    add_dependency(prev_recv, recv_ac);
+
+    prev_send = send_ac;
+    prev_recv = recv_ac;
+  }
 }
 
+void
+pairwise_alltoall_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  std::memcpy(dst_buffer, msg_buffer, ac->nelems * type_size_);
+}
+
+}
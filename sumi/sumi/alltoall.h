@@ -56,6 +56,54 @@ class bruck_alltoall_collective :
 
 };
 
+/**
+ * In round k every rank sends straight to me+k and receives from me-k.
+ * Takes p-1 rounds, but blocks are never forwarded or shuffled,
+ * which is what MPI libraries use for large messages.
+ */
+class pairwise_alltoall_actor :
+  public dag_collective_actor
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "pairwise all-to-all actor";
+  }
+
+ protected:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+
+  void buffer_action(void *dst_buffer, void *msg_buffer, action* ac) override;
+
+ private:
+  bool copied_send_;
+};
+
+class pairwise_alltoall_collective :
+  public dag_collective
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "pairwise all-to-all";
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new pairwise_alltoall_actor;
+  }
+
+  dag_collective*
+  clone() const override {
+    return new pairwise_alltoall_collective;
+  }
+
+};
+
 }
 
 #endif // ALLGATHER_H
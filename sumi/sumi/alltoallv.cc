@@ -21,7 +21,7 @@ using namespace sprockit::dbg;
 namespace sumi
 {
 
-SpktRegister("bruck_alltoall", dag_collective, direct_alltoallv_collective);
+SpktRegister("direct_alltoallv", dag_collective, direct_alltoallv_collective);
 
 void
 direct_alltoallv_actor::init_buffers(void* dst, void* src)
@@ -206,8 +206,10 @@ class dag_collective :
 class collective_algorithm_selector
 {
  public:
-  virtual dag_collective* select(int nproc, int nelems) = 0;
-  virtual dag_collective* select(int nproc, int* counts) = 0;
+  virtual ~collective_algorithm_selector(){}
+
+  virtual dag_collective* select(int nproc, int nelems, int type_size) = 0;
+  virtual dag_collective* select(int nproc, int* counts, int type_size) = 0;
 };
 
 DeclareFactory(dag_collective);
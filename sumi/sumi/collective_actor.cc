@@ -1262,6 +1262,18 @@ dag_collective_actor::compute_tree(int &log2nproc, int &midpoint, int &nproc) co
   midpoint = nproc / 2;
 }
 
+int
+dag_collective_actor::compute_fold(int &log2nproc) const
+{
+  int pow2 = 1;
+  log2nproc = 0;
+  while (pow2*2 <= dense_nproc_){
+    ++log2nproc;
+    pow2 *= 2;
+  }
+  return dense_nproc_ - pow2;
+}
+
 void
 bruck_actor::compute_tree(int &log2nproc, int &midpoint, int &num_rounds, int &nprocs_extra_round) const
 {
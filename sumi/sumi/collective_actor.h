@@ -468,6 +468,28 @@ class dag_collective_actor :
   void
   compute_tree(int& log2nproc, int& midpoint, int& nproc) const;
 
+  /**
+   * Fold the ranks onto the largest power of 2 not greater than nproc.
+   * The first 2*num_folded ranks pair up and only the odd rank
+   * of each pair takes part in the power-of-2 exchange.
+   * @param log2nproc [out] The number of rounds in the power-of-2 exchange
+   * @return The number of ranks folded into a neighbor
+   */
+  int
+  compute_fold(int& log2nproc) const;
+
+  /** @return The rank in the folded group, -1 if the rank was folded away */
+  static int
+  folded_rank(int rank, int num_folded){
+    if (rank >= 2*num_folded) return rank - num_folded;
+    return rank % 2 ? rank / 2 : -1;
+  }
+
+  static int
+  unfolded_rank(int folded, int num_folded){
+    return folded < num_folded ? 2*folded + 1 : folded + num_folded;
+  }
+
   static bool
   is_shared_role(int role, int num_roles, int* my_roles){
     for (int r=0; r < num_roles; ++r){
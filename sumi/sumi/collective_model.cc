@@ -0,0 +1,125 @@
+#include <sumi/collective_model.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/errors.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace sumi {
+
+static const collective::type_t modeled_types[] = {
+  collective::alltoall, collective::alltoallv,
+  collective::allreduce,
+  collective::allgather, collective::allgatherv,
+  collective::bcast, collective::barrier,
+  collective::gather, collective::gatherv,
+  collective::reduce, collective::reduce_scatter, collective::scan,
+  collective::scatter, collective::scatterv
+};
+
+collective_model::collective_model(double latency, double overhead, double bandwidth) :
+  latency_(latency),
+  overhead_(overhead),
+  byte_time_(1.0/bandwidth)
+{
+}
+
+collective_model::collective_model(sprockit::sim_parameters* params)
+{
+  latency_ = params->get_time_param("latency");
+  overhead_ = params->get_optional_time_param("overhead", 0);
+  byte_time_ = 1.0 / params->get_bandwidth_param("bandwidth");
+
+  std::vector<std::string> names;
+  params->get_optional_vector_param("collectives", names);
+  if (names.empty()){
+    for (collective::type_t ty : modeled_types){
+      cover(ty);
+    }
+  }
+
+  for (const std::string& entry : names){
+    size_t pos = entry.find(':');
+    std::string name = entry.substr(0, pos);
+    double scale = pos == std::string::npos ? 1.0 : std::stod(entry.substr(pos+1));
+    bool found = false;
+    for (collective::type_t ty : modeled_types){
+      if (name == collective::tostr(ty)){
+        cover(ty, scale);
+        found = true;
+      }
+    }
+    if (!found){
+      spkt_throw_printf(sprockit::value_error,
+        "collective_model: cannot model collective %s", name.c_str());
+    }
+  }
+}
+
+void
+collective_model::cover(collective::type_t ty, double scale)
+{
+  covered_[ty] = scale;
+}
+
+double
+collective_model::time(collective::type_t ty, int nproc, long nbytes) const
+{
+  auto it = covered_.find(ty);
+  double scale = it == covered_.end() ? 1.0 : it->second;
+  return scale * closed_form(ty, nproc, nbytes);
+}
+
+double
+collective_model::closed_form(collective::type_t ty, int nproc, long nbytes) const
+{
+  if (nproc <= 1) return 0;
+
+  int lg = 0;
+  while ((1 << lg) < nproc) ++lg;
+
+  double p = nproc;
+  double n = nbytes;
+  double startup = latency_ + 2*overhead_;
+  //the volume every rank moves when a vector is split into nproc pieces
+  double split = 2*(p-1)/p*n*byte_time_;
+
+  switch (ty){
+    case collective::barrier:
+      return lg*startup;
+    case collective::bcast:
+    case collective::reduce:
+      //binomial tree, or scatter followed by allgather
+      return std::min(lg*message(n), (lg + p - 1)*startup + split);
+    case collective::allreduce:
+      //recursive doubling, or Rabenseifner's reduce-scatter then allgather
+      return std::min(lg*message(n), 2*lg*startup + split);
+    case collective::allgather:
+    case collective::allgatherv:
+    case collective::gather:
+    case collective::gatherv:
+    case collective::scatter:
+    case collective::scatterv:
+      //lg rounds in which the busiest rank moves p-1 blocks in total
+      return lg*startup + (p-1)*n*byte_time_;
+    case collective::alltoall:
+    case collective::alltoallv:
+      //Bruck moves half the blocks each round, pairwise moves each block once
+      return std::min(lg*message(p/2*n), (p-1)*message(n));
+    case collective::reduce_scatter:
+      //pairwise exchange of the blocks of everybody else
+      return (p-1)*message(n);
+    case collective::scan:
+      //recursive doubling on the full vector
+      return lg*message(n);
+    case collective::dynamic_tree_vote:
+    case collective::heartbeat:
+      break;
+  }
+  spkt_throw_printf(sprockit::value_error,
+    "collective_model: cannot model collective %s",
+    collective::tostr(ty));
+  return 0;
+}
+
+}
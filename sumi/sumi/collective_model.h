@@ -0,0 +1,98 @@
+#ifndef sumi_api_COLLECTIVE_MODEL_H
+#define sumi_api_COLLECTIVE_MODEL_H
+
+#include <sumi/collective.h>
+#include <sprockit/sim_parameters_fwd.h>
+#include <map>
+
+namespace sumi {
+
+/**
+ * A LogGP-style closed form for the time a collective takes, used in place
+ * of simulating every message of the collective. Each message costs
+ * latency + 2*overhead + bytes/bandwidth and each collective is charged
+ * the cheapest of the textbook algorithms MPI libraries switch between.
+ *
+ * Collectives are listed as name or name:scale, where the time of the
+ * collective is multiplied by scale to calibrate it against runs of the
+ * full simulation, e.g. to account for contention in an alltoall.
+ *
+ * The model assumes all ranks enter the collective together. Each rank
+ * finishes a fixed time after it enters, so skew between ranks is not
+ * propagated through the collective, not even through a barrier.
+ */
+class collective_model
+{
+ public:
+  /**
+   * @param latency The end-to-end latency of one message
+   * @param overhead The time a rank is busy sending or receiving one message
+   * @param bandwidth The bandwidth of one message in bytes/s
+   */
+  collective_model(double latency, double overhead, double bandwidth);
+
+  /**
+   * Reads latency, overhead, bandwidth and the list of modeled collectives
+   * @param params The collective_model namespace
+   */
+  collective_model(sprockit::sim_parameters* params);
+
+  /** @return Whether calls to the collective are resolved by the model */
+  bool
+  covers(collective::type_t ty) const {
+    return covered_.count(ty);
+  }
+
+  /**
+   * @param scale The factor applied to the closed form for the collective
+   */
+  void
+  cover(collective::type_t ty, double scale = 1.0);
+
+  /**
+   * @param nproc The number of ranks in the communicator
+   * @param nbytes The size of the vector for bcast, reduce, allreduce
+   *               and scan, and the size of the block exchanged with
+   *               (or left on) each rank for the other collectives
+   * @return The time in seconds from entering to leaving the collective
+   */
+  double
+  time(collective::type_t ty, int nproc, long nbytes) const;
+
+  /** @return The closed form time before calibration */
+  double
+  closed_form(collective::type_t ty, int nproc, long nbytes) const;
+
+  double
+  latency() const {
+    return latency_;
+  }
+
+  double
+  overhead() const {
+    return overhead_;
+  }
+
+  double
+  bandwidth() const {
+    return 1.0 / byte_time_;
+  }
+
+ private:
+  /** The time to send nbytes in one message */
+  double
+  message(double nbytes) const {
+    return latency_ + 2*overhead_ + nbytes*byte_time_;
+  }
+
+  double latency_;
+  double overhead_;
+  double byte_time_;
+  /** The calibration factor of each modeled collective */
+  std::map<collective::type_t,double> covered_;
+
+};
+
+}
+
+#endif // COLLECTIVE_MODEL_H
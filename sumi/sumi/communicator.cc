@@ -1,9 +1,15 @@
 #include <sumi/communicator.h>
 #include <sumi/transport.h>
+#include <sumi/hierarchical.h>
 #include <sprockit/errors.h>
 
 namespace sumi {
 
+communicator::~communicator()
+{
+  if (hierarchy_) delete hierarchy_;
+}
+
 void
 communicator::rank_resolved(int global_rank, int comm_rank)
 {
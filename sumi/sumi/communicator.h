@@ -6,6 +6,8 @@
 
 namespace sumi {
 
+class rank_hierarchy;
+
 class communicator {
  public:
   class rank_callback {
@@ -22,7 +24,7 @@ class communicator {
     return my_comm_rank_;
   }
 
-  virtual ~communicator(){}
+  virtual ~communicator();
 
   /**
    * @brief comm_to_global_rank
@@ -40,6 +42,20 @@ class communicator {
 
   static const int unresolved_rank = -1;
 
+  /**
+   * @return The node and group structure of the ranks, built by the
+   *         first topology-aware collective on the communicator
+   */
+  rank_hierarchy*
+  hierarchy() const {
+    return hierarchy_;
+  }
+
+  void
+  set_hierarchy(rank_hierarchy* hier){
+    hierarchy_ = hier;
+  }
+
   void
   register_rank_callback(rank_callback* cback){
     rank_callbacks_.insert(cback);
@@ -51,7 +67,11 @@ class communicator {
   }
 
  protected:
-  communicator(int comm_rank) : my_comm_rank_(comm_rank){}
+  communicator(int comm_rank) :
+    my_comm_rank_(comm_rank),
+    hierarchy_(nullptr)
+  {
+  }
 
   void
   rank_resolved(int global_rank, int comm_rank);
@@ -65,6 +85,8 @@ class communicator {
   */
   std::set<rank_callback*> rank_callbacks_;
 
+  rank_hierarchy* hierarchy_;
+
 };
 
 class global_communicator :
@@ -159,8 +181,9 @@ class rotate_communicator :
    * @param me
    */
   rotate_communicator(int my_global_rank, int nproc, int shift) :
-    nproc_(nproc), shift_(shift),
-    communicator(global_to_comm_rank(my_global_rank))
+    //the base is built before nproc_ and shift_ are set, compute the rank directly
+    communicator((my_global_rank + nproc - shift) % nproc),
+    nproc_(nproc), shift_(shift)
   {
   }
 
@@ -187,8 +210,9 @@ class subrange_communicator :
 {
  public:
   subrange_communicator(int my_global_rank, int start, int nproc) :
-    nproc_(nproc), start_(start),
-    communicator(global_to_comm_rank(my_global_rank))
+    //the base is built before start_ is set, compute the rank directly
+    communicator(my_global_rank - start),
+    nproc_(nproc), start_(start)
   {
   }
 
@@ -0,0 +1,132 @@
+#include <sumi/cost_table_selector.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/errors.h>
+#include <sprockit/units.h>
+#include <climits>
+
+namespace sumi {
+
+/**
+ * The decisions MPICH makes for the collectives with more than one algorithm.
+ * Alltoall uses the scattered isend/irecv algorithm between bruck and pairwise,
+ * which pairwise stands in for here.
+ */
+static const char*
+mpich_table(collective::type_t ty)
+{
+  switch (ty){
+    case collective::allreduce:
+      return "recursive_doubling:2048 rabenseifner";
+    case collective::allgather:
+      return "bruck:81920 recursive_doubling:524288 ring";
+    case collective::alltoall:
+      return "pairwise:256:7 bruck:256 pairwise";
+    default:
+      spkt_throw_printf(sprockit::value_error,
+        "cost_table_selector: no mpich table for collective %s",
+        collective::tostr(ty));
+  }
+  return nullptr;
+}
+
+static long
+parse_bytes(const std::string& str, const std::string& row)
+{
+  bool error;
+  long bytes = sprockit::byte_length(str.c_str(), error);
+  if (error){
+    spkt_throw_printf(sprockit::value_error,
+      "cost_table_selector: invalid size %s in rule %s",
+      str.c_str(), row.c_str());
+  }
+  return bytes;
+}
+
+cost_table_selector::cost_table_selector(sprockit::sim_parameters* params,
+                                         collective::type_t ty,
+                                         const std::string& default_algorithm) :
+  type_(ty),
+  params_(params)
+{
+  fallback_ = params->get_optional_param("algorithm", default_algorithm);
+  validate(fallback_);
+
+  std::vector<std::string> rows;
+  params->get_optional_vector_param("cost_table", rows);
+  if (rows.size() == 1 && rows[0] == "mpich"){
+    rows.clear();
+    std::string table = mpich_table(ty);
+    size_t pos = 0;
+    while (pos < table.size()){
+      size_t end = table.find(' ', pos);
+      if (end == std::string::npos) end = table.size();
+      rows.push_back(table.substr(pos, end - pos));
+      pos = end + 1;
+    }
+  }
+  add_rules(rows);
+}
+
+void
+cost_table_selector::add_rules(const std::vector<std::string>& rows)
+{
+  for (const std::string& row : rows){
+    rule r;
+    r.max_bytes = LONG_MAX;
+    r.max_nproc = INT_MAX;
+    size_t size_pos = row.find(':');
+    r.algorithm = row.substr(0, size_pos);
+    if (size_pos != std::string::npos){
+      size_t nproc_pos = row.find(':', size_pos + 1);
+      r.max_bytes = parse_bytes(row.substr(size_pos + 1, nproc_pos - size_pos - 1), row);
+      if (nproc_pos != std::string::npos){
+        r.max_nproc = std::stoi(row.substr(nproc_pos + 1));
+      }
+    }
+    validate(r.algorithm);
+    rules_.push_back(r);
+  }
+}
+
+void
+cost_table_selector::validate(const std::string& name)
+{
+  std::string factory_name = name + "_" + collective::tostr(type_);
+  delete dag_collective_factory::get_value(factory_name, params_);
+}
+
+const std::string&
+cost_table_selector::algorithm(int nproc, long nbytes) const
+{
+  for (const rule& r : rules_){
+    if (nbytes <= r.max_bytes && nproc <= r.max_nproc){
+      return r.algorithm;
+    }
+  }
+  return fallback_;
+}
+
+dag_collective*
+cost_table_selector::select(int nproc, int nelems, int type_size)
+{
+  long nbytes = long(nelems) * type_size;
+  if (type_ == collective::allgather){
+    nbytes *= nproc;
+  }
+  std::string factory_name = algorithm(nproc, nbytes) + "_" + collective::tostr(type_);
+  return dag_collective_factory::get_value(factory_name, params_);
+}
+
+dag_collective*
+cost_table_selector::select(int nproc, int* counts, int type_size)
+{
+  long nbytes = 0;
+  for (int i=0; i < nproc; ++i){
+    nbytes += counts[i];
+  }
+  nbytes *= type_size;
+  std::string factory_name = algorithm(nproc, nbytes) + "_" + collective::tostr(type_);
+  return dag_collective_factory::get_value(factory_name, params_);
+}
+
+}
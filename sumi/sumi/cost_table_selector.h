@@ -0,0 +1,75 @@
+#ifndef sumi_api_COST_TABLE_SELECTOR_H
+#define sumi_api_COST_TABLE_SELECTOR_H
+
+#include <sumi/collective.h>
+#include <sprockit/sim_parameters_fwd.h>
+#include <string>
+#include <vector>
+
+namespace sumi {
+
+/**
+ * Picks the algorithm for one collective from an ordered table of rules,
+ * the way production MPI libraries switch algorithms on message and
+ * communicator size. Each rule is written as name:max_size[:max_nproc]
+ * and the first rule covering the call wins. Calls no rule covers
+ * use the fallback algorithm.
+ *
+ * The size compared against the table is the size of the result buffer
+ * for allreduce and allgather and the size of one block for alltoall,
+ * matching the cutoffs MPI libraries publish.
+ */
+class cost_table_selector :
+  public collective_algorithm_selector
+{
+ public:
+  /**
+   * @param params The namespace of the collective, e.g. allreduce
+   * @param ty The collective algorithms are selected for
+   * @param default_algorithm The fallback if no algorithm is given
+   */
+  cost_table_selector(sprockit::sim_parameters* params,
+                      collective::type_t ty,
+                      const std::string& default_algorithm);
+
+  dag_collective*
+  select(int nproc, int nelems, int type_size) override;
+
+  dag_collective*
+  select(int nproc, int* counts, int type_size) override;
+
+  /**
+   * @param nproc The number of ranks in the communicator
+   * @param nbytes The size compared against the table
+   * @return The name of the algorithm to run
+   */
+  const std::string&
+  algorithm(int nproc, long nbytes) const;
+
+ private:
+  struct rule {
+    std::string algorithm;
+    long max_bytes;
+    int max_nproc;
+  };
+
+  void
+  add_rules(const std::vector<std::string>& rows);
+
+  /** Check that the algorithm is implemented for this collective */
+  void
+  validate(const std::string& name);
+
+  std::vector<rule> rules_;
+
+  std::string fallback_;
+
+  collective::type_t type_;
+
+  sprockit::sim_parameters* params_;
+
+};
+
+}
+
+#endif // COST_TABLE_SELECTOR_H
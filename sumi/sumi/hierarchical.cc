@@ -0,0 +1,579 @@
+#include <sumi/hierarchical.h>
+#include <sumi/transport.h>
+#include <sumi/communicator.h>
+#include <sprockit/output.h>
+#include <algorithm>
+#include <cstring>
+
+using namespace sprockit::dbg;
+
+namespace sumi {
+
+SpktRegister("hierarchical_allreduce", dag_collective, hierarchical_allreduce);
+SpktRegister("hierarchical_bcast", dag_collective, hierarchical_bcast);
+SpktRegister("hierarchical_allgather", dag_collective,
+             hierarchical_allgather_collective);
+
+struct rank_location {
+  int group;
+  int node;
+  int rank;
+
+  bool
+  operator<(const rank_location& other) const {
+    if (group != other.group) return group < other.group;
+    if (node != other.node) return node < other.node;
+    return rank < other.rank;
+  }
+};
+
+rank_hierarchy::rank_hierarchy(transport* api, communicator* comm)
+{
+  int nproc = comm->nproc();
+  std::vector<rank_location> locs(nproc);
+  for (int r=0; r < nproc; ++r){
+    rank_location& loc = locs[r];
+    loc.rank = r;
+    int global = comm->comm_to_global_rank(r);
+    if (global == communicator::unresolved_rank
+        || !api->rank_location(global, loc.node, loc.group)){
+      //real nodes and groups are never negative
+      loc.node = loc.group = -1 - r;
+    }
+  }
+  std::sort(locs.begin(), locs.end());
+
+  order_.resize(nproc);
+  position_.resize(nproc);
+  node_begin_.resize(nproc);
+  node_end_.resize(nproc);
+  group_begin_.resize(nproc);
+  group_end_.resize(nproc);
+  for (int p=0; p < nproc; ++p){
+    order_[p] = locs[p].rank;
+    position_[locs[p].rank] = p;
+    bool new_group = p == 0 || locs[p].group != locs[p-1].group;
+    bool new_node = new_group || locs[p].node != locs[p-1].node;
+    node_begin_[p] = new_node ? p : node_begin_[p-1];
+    group_begin_[p] = new_group ? p : group_begin_[p-1];
+    if (new_group) group_starts_.push_back(p);
+  }
+  group_starts_.push_back(nproc);
+
+  for (int p=nproc-1; p >= 0; --p){
+    bool last_in_node = p == nproc - 1 || node_begin_[p+1] != node_begin_[p];
+    bool last_in_group = p == nproc - 1 || group_begin_[p+1] != group_begin_[p];
+    node_end_[p] = last_in_node ? p + 1 : node_end_[p+1];
+    group_end_[p] = last_in_group ? p + 1 : group_end_[p+1];
+  }
+}
+
+int
+rank_hierarchy::stage::index(int rank) const
+{
+  auto it = std::find(ranks.begin(), ranks.end(), rank);
+  return it == ranks.end() ? -1 : it - ranks.begin();
+}
+
+void
+rank_hierarchy::node_stage(int rank, stage& st) const
+{
+  int pos = position_[rank];
+  int end = node_end_[pos];
+  for (int p=node_begin_[pos]; p < end; ++p){
+    st.ranks.push_back(order_[p]);
+    st.offsets.push_back(p);
+  }
+  st.offsets.push_back(end);
+}
+
+void
+rank_hierarchy::group_stage(int rank, stage& st) const
+{
+  int pos = position_[rank];
+  int end = group_end_[pos];
+  for (int p=group_begin_[pos]; p < end; p = node_end_[p]){
+    st.ranks.push_back(order_[p]);
+    st.offsets.push_back(p);
+  }
+  st.offsets.push_back(end);
+}
+
+void
+rank_hierarchy::global_stage(stage& st) const
+{
+  int ngroups = num_groups();
+  for (int g=0; g < ngroups; ++g){
+    st.ranks.push_back(order_[group_starts_[g]]);
+    st.offsets.push_back(group_starts_[g]);
+  }
+  st.offsets.push_back(group_starts_[ngroups]);
+}
+
+const rank_hierarchy*
+hierarchical_actor::hierarchy()
+{
+  if (!hier_){
+    rank_hierarchy* hier = comm_->hierarchy();
+    if (!hier){
+      hier = new rank_hierarchy(my_api_, comm_);
+      comm_->set_hierarchy(hier);
+    }
+    hier_ = hier;
+  }
+  return hier_;
+}
+
+void
+hierarchical_actor::set_fan_in_block(action* ac, const rank_hierarchy::stage& st,
+                                     int first, int last)
+{
+  ac->offset = 0;
+  ac->nelems = nelems_;
+}
+
+void
+hierarchical_actor::set_result_block(action* ac)
+{
+  ac->offset = 0;
+  ac->nelems = nelems_;
+}
+
+recv_action::buf_type_t
+hierarchical_actor::result_recv_type() const
+{
+  return slicer_->contiguous() ? recv_action::in_place : recv_action::unpack_temp_buf;
+}
+
+action*
+hierarchical_actor::fan_in(const rank_hierarchy::stage& st, int round, action* prev)
+{
+  int size = st.size();
+  int me = st.index(dense_me_);
+  if (me < 0) return prev;
+
+  //binomial tree - at each level the ranks with the level bit set
+  //hand everything their subtree gathered to the rank below them
+  action* last = prev;
+  for (int mask=1; mask < size; mask *= 2, ++round){
+    if (me & mask){
+      action* send_ac = new send_action(round, st.ranks[me - mask], send_action::in_place);
+      set_fan_in_block(send_ac, st, me, std::min(me + mask, size));
+      add_dependency(last, send_ac);
+      return send_ac;
+    } else if (me + mask < size){
+      int child = me + mask;
+      action* recv_ac = new recv_action(round, st.ranks[child], fan_in_recv_type());
+      set_fan_in_block(recv_ac, st, child, std::min(child + mask, size));
+      //recvs share the receive buffer so they run one at a time
+      add_dependency(last, recv_ac);
+      last = recv_ac;
+    }
+  }
+  return last;
+}
+
+action*
+hierarchical_actor::fan_out(const rank_hierarchy::stage& st, int root, int round, action* prev)
+{
+  int size = st.size();
+  int idx = st.index(dense_me_);
+  if (idx < 0) return prev;
+
+  //number the stage relative to the rank that has the result
+  int me = (idx - root + size) % size;
+  action* have = prev;
+  for (int mask=1; mask < size; mask *= 2, ++round){
+    if (me < mask){
+      if (me + mask < size){
+        int partner = st.ranks[(me + mask + root) % size];
+        action* send_ac = new send_action(round, partner, send_action::in_place);
+        set_result_block(send_ac);
+        add_dependency(have, send_ac);
+      }
+    } else if (me < 2*mask){
+      int partner = st.ranks[(me - mask + root) % size];
+      action* recv_ac = new recv_action(round, partner, result_recv_type());
+      set_result_block(recv_ac);
+      add_dependency(prev, recv_ac);
+      have = recv_ac;
+    }
+  }
+  return have;
+}
+
+void
+hierarchical_allreduce_actor::init_buffers(void* dst, void* src)
+{
+  int size = nelems_ * type_size_;
+  if (src){
+    if (src != dst)
+      std::memcpy(dst, src, size);
+    result_buffer_ = my_api_->make_public_buffer(dst, size);
+    recv_buffer_ = my_api_->allocate_public_buffer(size);
+    //group leaders reduce into the vector while sending it
+    send_buffer_ = my_api_->allocate_public_buffer(size);
+  }
+}
+
+void
+hierarchical_allreduce_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    long buffer_size = nelems_ * type_size_;
+    my_api_->unmake_public_buffer(result_buffer_, buffer_size);
+    my_api_->free_public_buffer(recv_buffer_, buffer_size);
+    my_api_->free_public_buffer(send_buffer_, buffer_size);
+  }
+}
+
+void
+hierarchical_allreduce_actor::start_shuffle(action* ac)
+{
+  if (result_buffer_.ptr == 0) return;
+
+  std::memcpy(send_buffer_, result_buffer_, nelems_ * type_size_);
+}
+
+void
+hierarchical_allreduce_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  (fxn_)(dst_buffer, msg_buffer, ac->nelems);
+}
+
+action*
+hierarchical_allreduce_actor::global_exchange(const rank_hierarchy::stage& st, action* prev)
+{
+  int size = st.size();
+  if (size == 1) return prev;
+
+  int log2size = 0;
+  int pow2 = 1;
+  while (pow2*2 <= size){
+    pow2 *= 2;
+    ++log2size;
+  }
+  int num_folded = size - pow2;
+  int me = st.index(dense_me_);
+  int folded_me = folded_rank(me, num_folded);
+  int final_round = global_round + log2size + 1;
+
+  if (folded_me < 0){
+    //hand my vector to my neighbor and wait for the answer
+    action* send_ac = new send_action(global_round, st.ranks[me + 1], send_action::in_place);
+    set_result_block(send_ac);
+    add_dependency(prev, send_ac);
+    action* recv_ac = new recv_action(final_round, st.ranks[me + 1], result_recv_type());
+    set_result_block(recv_ac);
+    add_dependency(send_ac, recv_ac);
+    return recv_ac;
+  }
+
+  action *prev_send = 0, *prev_recv = prev;
+  if (me < 2*num_folded){
+    action* recv_ac = new recv_action(global_round, st.ranks[me - 1], recv_action::reduce);
+    set_result_block(recv_ac);
+    add_dependency(prev, recv_ac);
+    prev_recv = recv_ac;
+  }
+
+  int partner_gap = 1;
+  for (int i=0; i < log2size; ++i){
+    int rnd = global_round + i + 1;
+    int partner = st.ranks[unfolded_rank(folded_me ^ partner_gap, num_folded)];
+    action* shuffle_ac = new shuffle_action(rnd, partner);
+    //the snapshot has to wait until the last send out of it is done
+    add_dependency(prev_send, shuffle_ac);
+    add_dependency(prev_recv, shuffle_ac);
+
+    action* send_ac = new send_action(rnd, partner, send_action::temp_send);
+    set_result_block(send_ac);
+    action* recv_ac = new recv_action(rnd, partner, recv_action::reduce);
+    set_result_block(recv_ac);
+    add_dependency(shuffle_ac, send_ac);
+    add_dependency(shuffle_ac, recv_ac);
+
+    prev_send = send_ac;
+    prev_recv = recv_ac;
+    partner_gap *= 2;
+  }
+
+  if (me < 2*num_folded){
+    action* send_ac = new send_action(final_round, st.ranks[me - 1], send_action::in_place);
+    set_result_block(send_ac);
+    add_dependency(prev_recv, send_ac);
+  }
+  return prev_recv;
+}
+
+void
+hierarchical_allreduce_actor::init_dag()
+{
+  slicer_->fxn = fxn_;
+  const rank_hierarchy* hier = hierarchy();
+  int me = dense_me_;
+
+  debug_printf(sumi_collective,
+    "Rank %s configured hierarchical allreduce for tag=%d over %d groups",
+    rank_str().c_str(), tag_, hier->num_groups());
+
+  rank_hierarchy::stage node;
+  hier->node_stage(me, node);
+  action* ac = fan_in(node, node_up_round, nullptr);
+  if (hier->node_leader(me) == me){
+    rank_hierarchy::stage group;
+    hier->group_stage(me, group);
+    ac = fan_in(group, group_up_round, ac);
+    if (hier->group_leader(me) == me){
+      rank_hierarchy::stage global;
+      hier->global_stage(global);
+      ac = global_exchange(global, ac);
+    }
+    ac = fan_out(group, 0, group_down_round, ac);
+  }
+  fan_out(node, 0, node_down_round, ac);
+}
+
+void
+hierarchical_bcast_actor::init_buffers(void* dst, void* src)
+{
+  void* buffer = dense_me_ == root_ ? src : dst;
+  if (buffer){
+    long byte_length = nelems_ * type_size_;
+    send_buffer_ = my_api_->make_public_buffer(buffer, byte_length);
+    recv_buffer_ = send_buffer_;
+    result_buffer_ = send_buffer_;
+  }
+}
+
+void
+hierarchical_bcast_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    long buffer_size = nelems_ * type_size_;
+    my_api_->unmake_public_buffer(send_buffer_, buffer_size);
+    //recv and result alias send buffer
+  }
+}
+
+void
+hierarchical_bcast_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  std::memcpy(dst_buffer, msg_buffer, ac->nelems * type_size_);
+}
+
+action*
+hierarchical_bcast_actor::hop(int src, int dst, int round, action* prev)
+{
+  if (src == dst) return prev;
+
+  if (dense_me_ == src){
+    action* send_ac = new send_action(round, dst, send_action::in_place);
+    set_result_block(send_ac);
+    add_dependency(prev, send_ac);
+  } else if (dense_me_ == dst){
+    action* recv_ac = new recv_action(round, src, result_recv_type());
+    set_result_block(recv_ac);
+    add_dependency(prev, recv_ac);
+    return recv_ac;
+  }
+  return prev;
+}
+
+void
+hierarchical_bcast_actor::init_dag()
+{
+  const rank_hierarchy* hier = hierarchy();
+  int me = dense_me_;
+  int root_node_leader = hier->node_leader(root_);
+  int root_group_leader = hier->group_leader(root_);
+
+  debug_printf(sumi_collective,
+    "Rank %s configured hierarchical bcast from root %d for tag=%d over %d groups",
+    rank_str().c_str(), root_, tag_, hier->num_groups());
+
+  action* ac = hop(root_, root_node_leader, node_up_round, nullptr);
+  ac = hop(root_node_leader, root_group_leader, group_up_round, ac);
+
+  //ranks that already have the data on the way up sit out the way down
+  if (hier->group_leader(me) == me){
+    rank_hierarchy::stage global;
+    hier->global_stage(global);
+    ac = fan_out(global, global.index(root_group_leader), global_round, ac);
+  }
+  if (hier->node_leader(me) == me){
+    rank_hierarchy::stage group;
+    hier->group_stage(me, group);
+    if (root_node_leader != root_group_leader && hier->group_leader(me) == root_group_leader){
+      group.ranks.erase(group.ranks.begin() + group.index(root_node_leader));
+    }
+    ac = fan_out(group, 0, group_down_round, ac);
+  }
+  rank_hierarchy::stage node;
+  hier->node_stage(me, node);
+  if (root_ != root_node_leader && hier->node_leader(me) == root_node_leader){
+    node.ranks.erase(node.ranks.begin() + node.index(root_));
+  }
+  fan_out(node, 0, node_down_round, ac);
+}
+
+void
+hierarchical_allgather_actor::init_buffers(void* dst, void* src)
+{
+  if (src){
+    const rank_hierarchy* hier = hierarchy();
+    long block_size = nelems_ * type_size_;
+    long buffer_size = block_size * comm_->nproc();
+    void* my_block = dst == src ? (char*)src + dense_me_ * block_size : src;
+    result_dst_ = dst;
+    result_buffer_ = my_api_->allocate_public_buffer(buffer_size);
+    std::memcpy((char*)result_buffer_.ptr + hier->position(dense_me_) * block_size,
+                my_block, block_size);
+    send_buffer_ = result_buffer_;
+    recv_buffer_ = result_buffer_;
+  }
+}
+
+void
+hierarchical_allgather_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    long block_size = nelems_ * type_size_;
+    int nproc = comm_->nproc();
+    for (int p=0; p < nproc; ++p){
+      std::memcpy((char*)result_dst_ + hier_->rank_at(p) * block_size,
+                  (char*)result_buffer_.ptr + p * block_size, block_size);
+    }
+    my_api_->free_public_buffer(result_buffer_, block_size * nproc);
+  }
+}
+
+void
+hierarchical_allgather_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  std::memcpy(dst_buffer, msg_buffer, ac->nelems * type_size_);
+}
+
+void
+hierarchical_allgather_actor::set_fan_in_block(action* ac, const rank_hierarchy::stage& st,
+                                               int first, int last)
+{
+  ac->offset = st.offsets[first] * nelems_;
+  ac->nelems = (st.offsets[last] - st.offsets[first]) * nelems_;
+}
+
+void
+hierarchical_allgather_actor::set_result_block(action* ac)
+{
+  ac->offset = 0;
+  ac->nelems = nelems_ * dense_nproc_;
+}
+
+/**
+ * @return The first stage member whose blocks a folded rank holds.
+ *         Folded ranks below num_folded hold 2 members, the rest hold 1.
+ */
+static int
+first_member(int folded, int num_folded)
+{
+  return folded < num_folded ? 2*folded : folded + num_folded;
+}
+
+action*
+hierarchical_allgather_actor::global_exchange(const rank_hierarchy::stage& st, action* prev)
+{
+  int size = st.size();
+  if (size == 1) return prev;
+
+  int log2size = 0;
+  int pow2 = 1;
+  while (pow2*2 <= size){
+    pow2 *= 2;
+    ++log2size;
+  }
+  int num_folded = size - pow2;
+  int me = st.index(dense_me_);
+  int folded_me = folded_rank(me, num_folded);
+  int final_round = global_round + log2size + 1;
+
+  if (folded_me < 0){
+    //hand my group's blocks to my neighbor and wait for everything
+    action* send_ac = new send_action(global_round, st.ranks[me + 1], send_action::in_place);
+    set_fan_in_block(send_ac, st, me, me + 1);
+    add_dependency(prev, send_ac);
+    action* recv_ac = new recv_action(final_round, st.ranks[me + 1], recv_action::in_place);
+    set_result_block(recv_ac);
+    add_dependency(send_ac, recv_ac);
+    return recv_ac;
+  }
+
+  action *prev_send = 0, *prev_recv = prev;
+  if (me < 2*num_folded){
+    action* recv_ac = new recv_action(global_round, st.ranks[me - 1], recv_action::in_place);
+    set_fan_in_block(recv_ac, st, me - 1, me);
+    add_dependency(prev, recv_ac);
+    prev_recv = recv_ac;
+  }
+
+  int partner_gap = 1;
+  for (int i=0; i < log2size; ++i){
+    int rnd = global_round + i + 1;
+    int folded_partner = folded_me ^ partner_gap;
+    int partner = unfolded_rank(folded_partner, num_folded);
+    //the folded ranks whose blocks each side has gathered so far
+    int my_first = folded_me & ~(partner_gap - 1);
+    int partner_first = folded_partner & ~(partner_gap - 1);
+    action* send_ac = new send_action(rnd, st.ranks[partner], send_action::in_place);
+    set_fan_in_block(send_ac, st, first_member(my_first, num_folded),
+                     first_member(my_first + partner_gap, num_folded));
+    action* recv_ac = new recv_action(rnd, st.ranks[partner], recv_action::in_place);
+    set_fan_in_block(recv_ac, st, first_member(partner_first, num_folded),
+                     first_member(partner_first + partner_gap, num_folded));
+
+    add_dependency(prev_send, send_ac);
+    add_dependency(prev_recv, send_ac);
+    add_dependency(prev_send, recv_ac);
+    add_dependency(prev_recv, recv_ac);
+
+    prev_send = send_ac;
+    prev_recv = recv_ac;
+    partner_gap *= 2;
+  }
+
+  if (me < 2*num_folded){
+    action* send_ac = new send_action(final_round, st.ranks[me - 1], send_action::in_place);
+    set_result_block(send_ac);
+    add_dependency(prev_send, send_ac);
+    add_dependency(prev_recv, send_ac);
+  }
+  return prev_recv;
+}
+
+void
+hierarchical_allgather_actor::init_dag()
+{
+  const rank_hierarchy* hier = hierarchy();
+  int me = dense_me_;
+
+  debug_printf(sumi_collective,
+    "Rank %s configured hierarchical allgather for tag=%d over %d groups",
+    rank_str().c_str(), tag_, hier->num_groups());
+
+  rank_hierarchy::stage node;
+  hier->node_stage(me, node);
+  action* ac = fan_in(node, node_up_round, nullptr);
+  if (hier->node_leader(me) == me){
+    rank_hierarchy::stage group;
+    hier->group_stage(me, group);
+    ac = fan_in(group, group_up_round, ac);
+    if (hier->group_leader(me) == me){
+      rank_hierarchy::stage global;
+      hier->global_stage(global);
+      ac = global_exchange(global, ac);
+    }
+    ac = fan_out(group, 0, group_down_round, ac);
+  }
+  fan_out(node, 0, node_down_round, ac);
+}
+
+}
@@ -0,0 +1,359 @@
+#ifndef sumi_api_HIERARCHICAL_H
+#define sumi_api_HIERARCHICAL_H
+
+#include <sumi/collective.h>
+#include <sumi/collective_actor.h>
+#include <sumi/comm_functions.h>
+#include <vector>
+
+namespace sumi {
+
+/**
+ * The ranks of a communicator sorted so that ranks sharing a node are
+ * contiguous and nodes sharing a group of switches are contiguous.
+ * The first rank of a node or group in this order is its leader.
+ * Ranks whose location the transport does not know are placed alone
+ * on their own node in their own group.
+ */
+class rank_hierarchy
+{
+ public:
+  rank_hierarchy(transport* api, communicator* comm);
+
+  /**
+   * The ranks exchanging data at one level of the hierarchy,
+   * leader first, and the blocks each of them owns in sorted order
+   */
+  struct stage {
+    std::vector<int> ranks;
+    /** The first sorted position owned by each rank, plus the end position */
+    std::vector<int> offsets;
+
+    int
+    size() const {
+      return ranks.size();
+    }
+
+    int
+    index(int rank) const;
+  };
+
+  int
+  nproc() const {
+    return order_.size();
+  }
+
+  /** @return Where the rank appears in sorted order */
+  int
+  position(int rank) const {
+    return position_[rank];
+  }
+
+  /** @return The rank at a position in sorted order */
+  int
+  rank_at(int pos) const {
+    return order_[pos];
+  }
+
+  int
+  node_leader(int rank) const {
+    return order_[node_begin_[position_[rank]]];
+  }
+
+  int
+  group_leader(int rank) const {
+    return order_[group_begin_[position_[rank]]];
+  }
+
+  int
+  num_groups() const {
+    return group_starts_.size() - 1;
+  }
+
+  /** The ranks on the same node as rank */
+  void
+  node_stage(int rank, stage& st) const;
+
+  /** The node leaders in the same group as rank */
+  void
+  group_stage(int rank, stage& st) const;
+
+  /** The group leaders */
+  void
+  global_stage(stage& st) const;
+
+ private:
+  std::vector<int> order_;
+  std::vector<int> position_;
+  /** Indexed by sorted position */
+  std::vector<int> node_begin_;
+  std::vector<int> node_end_;
+  std::vector<int> group_begin_;
+  std::vector<int> group_end_;
+  /** The first sorted position of each group, plus the end position */
+  std::vector<int> group_starts_;
+
+};
+
+/**
+ * Common machinery for collectives that run node-local, then group-local,
+ * then global phases. Phases within a node or group are binomial trees
+ * rooted at the leader so no leader is flooded by its members.
+ */
+class hierarchical_actor :
+  public dag_collective_actor
+{
+ protected:
+  hierarchical_actor() : hier_(nullptr) {}
+
+  /** Rounds are split into disjoint ranges, one per phase */
+  static const int node_up_round = 0;
+  static const int group_up_round = 32;
+  static const int global_round = 64;
+  static const int group_down_round = 128;
+  static const int node_down_round = 160;
+
+  const rank_hierarchy*
+  hierarchy();
+
+  /**
+   * Combine the data of a stage at its leader
+   * @param prev The action my data depends on, null if available now
+   * @return The last action I take in the stage
+   */
+  action*
+  fan_in(const rank_hierarchy::stage& st, int round, action* prev);
+
+  /**
+   * Spread the result from one rank of a stage to the others
+   * @param root The index in the stage that has the result
+   * @param prev The action after which I have the result, or after which
+   *             my buffer can be overwritten if I do not have it
+   * @return The action after which I have the result
+   */
+  action*
+  fan_out(const rank_hierarchy::stage& st, int root, int round, action* prev);
+
+  /**
+   * Set the data moved for members [first,last) of a stage during fan in.
+   * By default the whole vector moves.
+   */
+  virtual void
+  set_fan_in_block(action* ac, const rank_hierarchy::stage& st,
+                   int first, int last);
+
+  virtual recv_action::buf_type_t
+  fan_in_recv_type() const {
+    return recv_action::in_place;
+  }
+
+  /** Set the data moved during fan out. By default the whole vector moves. */
+  virtual void
+  set_result_block(action* ac);
+
+  recv_action::buf_type_t
+  result_recv_type() const;
+
+  const rank_hierarchy* hier_;
+
+};
+
+class hierarchical_allreduce_actor :
+  public hierarchical_actor
+{
+ public:
+  std::string
+  to_string() const override {
+    return "hierarchical allreduce actor";
+  }
+
+  hierarchical_allreduce_actor(reduce_fxn fxn) : fxn_(fxn) {}
+
+  void
+  buffer_action(void *dst_buffer, void *msg_buffer, action* ac) override;
+
+ private:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+  void start_shuffle(action* ac) override;
+
+  recv_action::buf_type_t
+  fan_in_recv_type() const override {
+    return recv_action::reduce;
+  }
+
+  /** Recursive doubling among the group leaders */
+  action*
+  global_exchange(const rank_hierarchy::stage& st, action* prev);
+
+  reduce_fxn fxn_;
+
+};
+
+/**
+ * Reduces within each node, then within each group, then exchanges
+ * across groups and sends the result back down. Only group leaders
+ * put data on the global links.
+ */
+class hierarchical_allreduce :
+  public dag_collective
+{
+ public:
+  std::string
+  to_string() const override {
+    return "sumi hierarchical allreduce";
+  }
+
+  hierarchical_allreduce(reduce_fxn fxn) : fxn_(fxn) {}
+
+  hierarchical_allreduce(){}
+
+  void
+  init_reduce(reduce_fxn fxn) override {
+    fxn_ = fxn;
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new hierarchical_allreduce_actor(fxn_);
+  }
+
+  dag_collective*
+  clone() const override {
+    return new hierarchical_allreduce(fxn_);
+  }
+
+ private:
+  reduce_fxn fxn_;
+
+};
+
+class hierarchical_bcast_actor :
+  public hierarchical_actor
+{
+ public:
+  std::string
+  to_string() const override {
+    return "hierarchical bcast actor";
+  }
+
+  hierarchical_bcast_actor(int root) : root_(root) {}
+
+  void
+  buffer_action(void *dst_buffer, void *msg_buffer, action* ac) override;
+
+ private:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+
+  /** Carry the data from one rank up to its leader */
+  action*
+  hop(int src, int dst, int round, action* prev);
+
+  int root_;
+
+};
+
+/**
+ * Carries the data from the root to its group leader, broadcasts
+ * among group leaders, then within each group and each node.
+ */
+class hierarchical_bcast :
+  public dag_collective
+{
+ public:
+  std::string
+  to_string() const override {
+    return "sumi hierarchical bcast";
+  }
+
+  hierarchical_bcast() : root_(-1) {}
+
+  void
+  init_root(int root) override {
+    root_ = root;
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new hierarchical_bcast_actor(root_);
+  }
+
+  dag_collective*
+  clone() const override {
+    return new hierarchical_bcast(root_);
+  }
+
+ private:
+  hierarchical_bcast(int root) : root_(root) {}
+
+  int root_;
+
+};
+
+class hierarchical_allgather_actor :
+  public hierarchical_actor
+{
+ public:
+  std::string
+  to_string() const override {
+    return "hierarchical allgather actor";
+  }
+
+  hierarchical_allgather_actor() : result_dst_(nullptr) {}
+
+  void
+  buffer_action(void *dst_buffer, void *msg_buffer, action* ac) override;
+
+ private:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+
+  void
+  set_fan_in_block(action* ac, const rank_hierarchy::stage& st,
+                   int first, int last) override;
+
+  void
+  set_result_block(action* ac) override;
+
+  /** Recursive doubling among the group leaders */
+  action*
+  global_exchange(const rank_hierarchy::stage& st, action* prev);
+
+  /** The blocks are gathered in sorted order, then moved here */
+  void* result_dst_;
+
+};
+
+/**
+ * Gathers within each node, then within each group, then exchanges
+ * across groups and sends the result back down. Blocks are gathered
+ * in hierarchy order so that every exchange is one contiguous range.
+ */
+class hierarchical_allgather_collective :
+  public dag_collective
+{
+ public:
+  std::string
+  to_string() const override {
+    return "hierarchical allgather";
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new hierarchical_allgather_actor;
+  }
+
+  dag_collective*
+  clone() const override {
+    return new hierarchical_allgather_collective;
+  }
+
+};
+
+}
+
+#endif // HIERARCHICAL_H
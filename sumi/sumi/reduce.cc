@@ -16,7 +16,7 @@ using namespace sprockit::dbg;
 namespace sumi
 {
 
-SpktRegister("wilke", dag_collective, wilke_halving_reduce);
+SpktRegister("wilke_reduce", dag_collective, wilke_halving_reduce);
 
 wilke_halving_reduce::wilke_halving_reduce(int root, reduce_fxn fxn) :
  root_(root), fxn_(fxn)
@@ -0,0 +1,92 @@
+#include <sumi/reduce_scatter.h>
+#include <sumi/transport.h>
+#include <sumi/communicator.h>
+#include <sprockit/output.h>
+#include <cstring>
+
+using namespace sprockit::dbg;
+
+namespace sumi
+{
+
+SpktRegister("pairwise_reduce_scatter", dag_collective, pairwise_reduce_scatter);
+
+void
+pairwise_reduce_scatter_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    my_api_->unmake_public_buffer(result_buffer_, nelems_ * type_size_);
+    my_api_->free_public_buffer(recv_buffer_, nelems_ * type_size_);
+    my_api_->free_public_buffer(send_buffer_, total_nelems_ * type_size_);
+  }
+}
+
+void
+pairwise_reduce_scatter_actor::init_buffers(void* dst, void* src)
+{
+  total_nelems_ = 0;
+  displs_.resize(dense_nproc_);
+  for (int i=0; i < dense_nproc_; ++i){
+    displs_[i] = total_nelems_;
+    total_nelems_ += recv_counts_[i];
+  }
+
+  if (src){
+    //the blocks for the other ranks are sent from a copy of the input
+    //since my block of the result may overwrite the input in place
+    send_buffer_ = my_api_->allocate_public_buffer(total_nelems_ * type_size_);
+    std::memcpy(send_buffer_, src, total_nelems_ * type_size_);
+    std::memcpy(dst, (char*) src + displs_[dense_me_] * type_size_, nelems_ * type_size_);
+    result_buffer_ = my_api_->make_public_buffer(dst, nelems_ * type_size_);
+    recv_buffer_ = my_api_->allocate_public_buffer(nelems_ * type_size_);
+  }
+}
+
+void
+pairwise_reduce_scatter_actor::init_dag()
+{
+  slicer_->fxn = fxn_;
+
+  int me = dense_me_;
+  int nproc = dense_nproc_;
+
+  debug_printf(sumi_collective,
+    "Rank %s configured pairwise reduce scatter for tag=%d for nproc=%d over %d rounds",
+    rank_str().c_str(), tag_, nproc, nproc - 1);
+
+  //every partner is sent to and received from exactly once, so all messages
+  //can go out on round 0 and stay unique even past action::max_round
+  action* prev_recv = 0;
+  for (int k=1; k < nproc; ++k){
+    int send_partner = (me + k) % nproc;
+    int recv_partner = (me + nproc - k) % nproc;
+
+    //empty blocks are skipped by both sides since both know the counts
+    action* recv_ac = 0;
+    if (recv_counts_[me]){
+      recv_ac = new recv_action(0, recv_partner, recv_action::reduce);
+      recv_ac->offset = 0;
+      recv_ac->nelems = nelems_;
+      add_dependency(prev_recv, recv_ac);
+    }
+
+    if (recv_counts_[send_partner]){
+      action* send_ac = new send_action(0, send_partner, send_action::temp_send);
+      send_ac->offset = displs_[send_partner];
+      send_ac->nelems = recv_counts_[send_partner];
+      //step through the rounds together with the receives
+      //rather than flooding the network with every block at once
+      add_dependency(prev_recv, send_ac);
+    }
+
+    if (recv_ac) prev_recv = recv_ac;
+  }
+}
+
+void
+pairwise_reduce_scatter_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  (fxn_)(dst_buffer, msg_buffer, ac->nelems);
+}
+
+}
@@ -0,0 +1,96 @@
+#ifndef sumi_api_REDUCE_SCATTER_H
+#define sumi_api_REDUCE_SCATTER_H
+
+#include <sumi/collective.h>
+#include <sumi/collective_actor.h>
+#include <sumi/collective_message.h>
+#include <sumi/comm_functions.h>
+#include <vector>
+
+namespace sumi {
+
+/**
+ * In round k every rank sends the block owned by the rank k to its right
+ * and reduces the block it receives from the rank k to its left into its own.
+ * Takes p-1 rounds but every block crosses the network exactly once,
+ * which also works for the irregular block sizes of MPI_Reduce_scatter.
+ */
+class pairwise_reduce_scatter_actor :
+  public dag_collective_actor
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "pairwise reduce scatter actor";
+  }
+
+  void
+  buffer_action(void *dst_buffer,
+                void *msg_buffer, action* ac) override;
+
+  pairwise_reduce_scatter_actor(reduce_fxn fxn, const std::vector<int>& recv_counts) :
+    fxn_(fxn), recv_counts_(recv_counts) {}
+
+ private:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+
+ private:
+  reduce_fxn fxn_;
+
+  std::vector<int> recv_counts_;
+
+  std::vector<int> displs_;
+
+  int total_nelems_;
+
+};
+
+class pairwise_reduce_scatter :
+  public dag_collective
+{
+ public:
+  std::string
+  to_string() const override {
+    return "sumi pairwise reduce scatter";
+  }
+
+  pairwise_reduce_scatter(reduce_fxn fxn) : fxn_(fxn) {}
+
+  pairwise_reduce_scatter(){}
+
+  virtual void
+  init_reduce(reduce_fxn fxn) override {
+    fxn_ = fxn;
+  }
+
+  /**
+   * The counts are copied since the collective can outlive the caller's array
+   */
+  void
+  init_recv_counts(int* counts) override {
+    recv_counts_.assign(counts, counts + comm_->nproc());
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new pairwise_reduce_scatter_actor(fxn_, recv_counts_);
+  }
+
+  dag_collective*
+  clone() const override {
+    return new pairwise_reduce_scatter(fxn_);
+  }
+
+ private:
+  reduce_fxn fxn_;
+
+  std::vector<int> recv_counts_;
+
+};
+
+}
+
+#endif // REDUCE_SCATTER_H
@@ -0,0 +1,106 @@
+#include <sumi/scan.h>
+#include <sumi/transport.h>
+#include <sumi/communicator.h>
+#include <sprockit/output.h>
+#include <cstring>
+
+using namespace sprockit::dbg;
+
+namespace sumi
+{
+
+SpktRegister("recursive_doubling_scan", dag_collective, recursive_doubling_scan);
+SpktRegister("recursive_doubling_exscan", dag_collective, recursive_doubling_exscan);
+
+void
+recursive_doubling_scan_actor::finalize_buffers()
+{
+  if (result_buffer_.ptr){
+    long buffer_size = nelems_ * type_size_;
+    my_api_->unmake_public_buffer(result_buffer_, buffer_size);
+    my_api_->free_public_buffer(recv_buffer_, buffer_size);
+    my_api_->free_public_buffer(send_buffer_, buffer_size);
+  }
+}
+
+void
+recursive_doubling_scan_actor::init_buffers(void* dst, void* src)
+{
+  int size = nelems_ * type_size_;
+  if (src){
+    //the partial over my block of ranks is what gets sent each round
+    //copy it out first since the result may overwrite the input in place
+    send_buffer_ = my_api_->allocate_public_buffer(size);
+    std::memcpy(send_buffer_, src, size);
+    if (inclusive_ && src != dst)
+      std::memcpy(dst, src, size);
+    result_buffer_ = my_api_->make_public_buffer(dst, size);
+    recv_buffer_ = my_api_->allocate_public_buffer(size);
+  }
+}
+
+void
+recursive_doubling_scan_actor::start_shuffle(action* ac)
+{
+  if (result_buffer_.ptr == 0) return;
+
+  //like an MPI user function on (invec, inoutvec), fxn(dst, src)
+  //leaves src op dst in dst - the lower ranks must be on the left
+  if (ac->partner < dense_me_){
+    if (result_started_){
+      (fxn_)(result_buffer_, recv_buffer_, nelems_);
+    } else {
+      std::memcpy(result_buffer_, recv_buffer_, nelems_ * type_size_);
+      result_started_ = true;
+    }
+    (fxn_)(send_buffer_, recv_buffer_, nelems_);
+  } else {
+    //the partial from above goes on the right of mine
+    (fxn_)(recv_buffer_, send_buffer_, nelems_);
+    std::memcpy(send_buffer_, recv_buffer_, nelems_ * type_size_);
+  }
+}
+
+void
+recursive_doubling_scan_actor::init_dag()
+{
+  int me = dense_me_;
+  int nproc = dense_nproc_;
+
+  debug_printf(sumi_collective,
+    "Rank %s configured recursive doubling %s for tag=%d for nproc=%d",
+    rank_str().c_str(), inclusive_ ? "scan" : "exscan", tag_, nproc);
+
+  action* prev = 0;
+  int round = 0;
+  for (int partner_gap=1; partner_gap < nproc; partner_gap *= 2, ++round){
+    int partner = me ^ partner_gap;
+    if (partner >= nproc){
+      //nobody above me at this distance
+      continue;
+    }
+
+    action* send_ac = new send_action(round, partner, send_action::temp_send);
+    send_ac->offset = 0;
+    send_ac->nelems = nelems_;
+    action* recv_ac = new recv_action(round, partner, recv_action::packed_temp_buf);
+    recv_ac->offset = 0;
+    recv_ac->nelems = nelems_;
+    add_dependency(prev, send_ac);
+    add_dependency(prev, recv_ac);
+
+    //the partial cannot be updated until the send out of it is done
+    action* shuffle_ac = new shuffle_action(round, partner);
+    add_dependency(send_ac, shuffle_ac);
+    add_dependency(recv_ac, shuffle_ac);
+    prev = shuffle_ac;
+  }
+}
+
+void
+recursive_doubling_scan_actor::buffer_action(void *dst_buffer, void *msg_buffer, action* ac)
+{
+  (fxn_)(dst_buffer, msg_buffer, ac->nelems);
+}
+
+}
@@ -0,0 +1,119 @@
+#ifndef sumi_api_SCAN_H
+#define sumi_api_SCAN_H
+
+#include <sumi/collective.h>
+#include <sumi/collective_actor.h>
+#include <sumi/collective_message.h>
+#include <sumi/comm_functions.h>
+
+namespace sumi {
+
+/**
+ * Every round exchanges the partial reduction over a block of ranks
+ * with the partner at doubling distance, doubling the block. Only the
+ * partials received from lower ranks are folded into the result,
+ * so the prefix is done in log2(p) rounds on any process count.
+ * Partials are always combined in rank order, so the reduce function
+ * need not be commutative.
+ */
+class recursive_doubling_scan_actor :
+  public dag_collective_actor
+{
+
+ public:
+  std::string
+  to_string() const override {
+    return "recursive doubling scan actor";
+  }
+
+  void
+  buffer_action(void *dst_buffer,
+                void *msg_buffer, action* ac) override;
+
+  /**
+   * @param inclusive Whether my own input is part of my result
+   */
+  recursive_doubling_scan_actor(reduce_fxn fxn, bool inclusive) :
+    fxn_(fxn), inclusive_(inclusive), result_started_(inclusive) {}
+
+ private:
+  void finalize_buffers() override;
+  void init_buffers(void *dst, void *src) override;
+  void init_dag() override;
+  void start_shuffle(action* ac) override;
+
+ private:
+  reduce_fxn fxn_;
+
+  bool inclusive_;
+
+  /** An exscan has no result until the first lower partial arrives */
+  bool result_started_;
+
+};
+
+class recursive_doubling_scan :
+  public dag_collective
+{
+ public:
+  std::string
+  to_string() const override {
+    return "sumi recursive doubling scan";
+  }
+
+  recursive_doubling_scan(reduce_fxn fxn) : fxn_(fxn) {}
+
+  recursive_doubling_scan(){}
+
+  virtual void
+  init_reduce(reduce_fxn fxn) override {
+    fxn_ = fxn;
+  }
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new recursive_doubling_scan_actor(fxn_, true);
+  }
+
+  dag_collective*
+  clone() const override {
+    return new recursive_doubling_scan(fxn_);
+  }
+
+ protected:
+  reduce_fxn fxn_;
+
+};
+
+/**
+ * The exclusive scan runs the same exchange as the scan, but rank 0
+ * gets no result and every other rank gets the reduction over the ranks below it.
+ */
+class recursive_doubling_exscan :
+  public recursive_doubling_scan
+{
+ public:
+  std::string
+  to_string() const override {
+    return "sumi recursive doubling exscan";
+  }
+
+  recursive_doubling_exscan(reduce_fxn fxn) : recursive_doubling_scan(fxn) {}
+
+  recursive_doubling_exscan(){}
+
+  dag_collective_actor*
+  new_actor() const override {
+    return new recursive_doubling_scan_actor(fxn_, false);
+  }
+
+  dag_collective*
+  clone() const override {
+    return new recursive_doubling_exscan(fxn_);
+  }
+
+};
+
+}
+
+#endif // SCAN_H
@@ -3,6 +3,8 @@
 #include <sumi/dynamic_tree_vote.h>
 #include <sumi/allreduce.h>
 #include <sumi/reduce.h>
+#include <sumi/reduce_scatter.h>
+#include <sumi/scan.h>
 #include <sumi/allgather.h>
 #include <sumi/allgatherv.h>
 #include <sumi/alltoall.h>
@@ -13,6 +15,8 @@
 #include <sumi/scatter.h>
 #include <sumi/gatherv.h>
 #include <sumi/scatterv.h>
+#include <sumi/cost_table_selector.h>
+#include <sumi/collective_model.h>
 #include <sprockit/stl_string.h>
 #include <sprockit/sim_parameters.h>
 #include <sprockit/keyword_registration.h>
@@ -22,9 +26,12 @@ RegisterKeywords(
 "eager_cutoff",
 "use_put_protocol",
 "algorithm",
+"cost_table",
 "comm_sync_stats",
 );
 
+RegisterNamespaces("allreduce", "allgather", "alltoall", "bcast");
+
 
 RegisterDebugSlot(sumi);
 
@@ -127,7 +134,8 @@ transport::transport(sprockit::sim_parameters* params) :
   monitor_(nullptr),
   notify_cb_(nullptr),
   nspares_(0),
-  recovery_lock_(0)
+  recovery_lock_(0),
+  collective_model_(nullptr)
 {
   heartbeat_tag_start_ = 1e9;
   heartbeat_tag_stop_ = heartbeat_tag_start_ + 10000;
@@ -141,6 +149,24 @@ transport::transport(sprockit::sim_parameters* params) :
 
   lazy_watch_ = params->get_optional_bool_param("lazy_watch", true);
 
+  //selectors are shared by all ranks, the first transport configures them
+  if (!allreduce_selector_ && params->has_namespace("allreduce")){
+    allreduce_selector_ = new cost_table_selector(params->get_namespace("allreduce"),
+                                                  collective::allreduce, "wilke");
+  }
+  if (!allgather_selector_ && params->has_namespace("allgather")){
+    allgather_selector_ = new cost_table_selector(params->get_namespace("allgather"),
+                                                  collective::allgather, "bruck");
+  }
+  if (!alltoall_selector_ && params->has_namespace("alltoall")){
+    alltoall_selector_ = new cost_table_selector(params->get_namespace("alltoall"),
+                                                 collective::alltoall, "bruck");
+  }
+  if (!bcast_selector_ && params->has_namespace("bcast")){
+    bcast_selector_ = new cost_table_selector(params->get_namespace("bcast"),
+                                              collective::bcast, "binary_tree");
+  }
+
 #if 0
   bool track_comm_stats = params->get_optional_bool_param("comm_sync_stats", false);
   if (track_comm_stats){
@@ -805,9 +831,25 @@ transport::skip_collective(collective::type_t ty,
     dmsg->set_result(dst);
     handle(dmsg);
     return true; //null indicates no work to do
-  } else {
-    return false;
   }
+
+  //the model moves no data, so only calls without buffers can use it
+  if (collective_model_ && !dst && !src && collective_model_->covers(ty)){
+    collective_done_message::ptr dmsg = new collective_done_message(tag, ty, dom);
+    dmsg->set_comm_rank(dom->my_comm_rank());
+    schedule_collective_done(dmsg,
+      collective_model_->time(ty, dom->nproc(), long(nelems)*type_size));
+    return true;
+  }
+
+  return false;
+}
+
+void
+transport::schedule_collective_done(const collective_done_message::ptr& msg, double delay)
+{
+  spkt_throw(sprockit::unimplemented_error,
+    "transport::schedule_collective_done: transport does not support the collective model");
 }
 
 void
@@ -818,7 +860,7 @@ transport::allreduce(void* dst, void *src, int nelems, int type_size, int tag, r
 
   dag_collective* coll = allreduce_selector_ == 0
       ? new wilke_halving_allreduce
-      : allreduce_selector_->select(dom->nproc(), nelems);
+      : allreduce_selector_->select(dom->nproc(), nelems, type_size);
   coll->init(collective::allreduce, this, dom, dst, src, nelems, type_size, tag, fault_aware, context);
   coll->init_reduce(fxn);
   start_collective(coll);
@@ -832,13 +874,59 @@ transport::reduce(int root, void* dst, void *src, int nelems, int type_size, int
 
   dag_collective* coll = reduce_selector_ == 0
       ? new wilke_halving_reduce
-      : reduce_selector_->select(dom->nproc(), nelems);
+      : reduce_selector_->select(dom->nproc(), nelems, type_size);
   coll->init(collective::reduce, this, dom, dst, src, nelems, type_size, tag, fault_aware, context);
   coll->init_root(root);
   coll->init_reduce(fxn);
   start_collective(coll);
 }
 
+void
+transport::scan(void* dst, void *src, int nelems, int type_size, int tag, reduce_fxn fxn, bool fault_aware, int context, communicator* dom)
+{
+  if (skip_collective(collective::scan, dom, dst, src, nelems, type_size, tag))
+    return;
+
+  dag_collective* coll = new recursive_doubling_scan;
+  coll->init(collective::scan, this, dom, dst, src, nelems, type_size, tag, fault_aware, context);
+  coll->init_reduce(fxn);
+  start_collective(coll);
+}
+
+void
+transport::exscan(void* dst, void *src, int nelems, int type_size, int tag, reduce_fxn fxn, bool fault_aware, int context, communicator* dom)
+{
+  if (dom == 0) dom = global_domain_;
+  if (dom->nproc() == 1){
+    //there is nothing below rank 0 to reduce
+    src = dst;
+  }
+
+  //an exscan is a scan to anyone waiting on it
+  if (skip_collective(collective::scan, dom, dst, src, nelems, type_size, tag))
+    return;
+
+  dag_collective* coll = new recursive_doubling_exscan;
+  coll->init(collective::scan, this, dom, dst, src, nelems, type_size, tag, fault_aware, context);
+  coll->init_reduce(fxn);
+  start_collective(coll);
+}
+
+void
+transport::reduce_scatter(void* dst, void *src, int* recv_counts, int type_size, int tag, reduce_fxn fxn, bool fault_aware, int context, communicator* dom)
+{
+  if (dom == 0) dom = global_domain_;
+  int nelems = recv_counts[dom->my_comm_rank()];
+  if (skip_collective(collective::reduce_scatter, dom, dst, src, nelems, type_size, tag))
+    return;
+
+  dag_collective* coll = new pairwise_reduce_scatter;
+  coll->init(collective::reduce_scatter, this, dom, dst, src, nelems, type_size, tag, fault_aware, context);
+  coll->init_reduce(fxn);
+  coll->init_recv_counts(recv_counts);
+  start_collective(coll);
+}
+
 void
 transport::bcast(int root, void *buf, int nelems, int type_size, int tag, bool fault_aware, int context, communicator* dom)
 {
@@ -847,7 +935,7 @@ transport::bcast(int root, void *buf, int nelems, int type_size, int tag, bool f
 
   dag_collective* coll = bcast_selector_ == 0
       ? new binary_tree_bcast_collective
-      : bcast_selector_->select(dom->nproc(), nelems);
+      : bcast_selector_->select(dom->nproc(), nelems, type_size);
 
   coll->init(collective::bcast, this, dom, buf, buf, nelems, type_size, tag, fault_aware, context);
   coll->init_root(root);
@@ -864,7 +952,7 @@ transport::gatherv(int root, void *dst, void *src,
 
   dag_collective* coll = gatherv_selector_ == 0
       ? new btree_gatherv
-      : gatherv_selector_->select(dom->nproc(), recv_counts);
+      : gatherv_selector_->select(dom->nproc(), recv_counts, type_size);
   coll->init(collective::gatherv, this, dom, dst, src, sendcnt, type_size, tag, fault_aware, context);
   coll->init_root(root);
   coll->init_recv_counts(recv_counts);
@@ -881,7 +969,7 @@ transport::gather(int root, void *dst, void *src, int nelems,
 
   dag_collective* coll = gather_selector_ == 0
       ? new btree_gather
-      : gather_selector_->select(dom->nproc(), nelems);
+      : gather_selector_->select(dom->nproc(), nelems, type_size);
 
   coll->init(collective::gather, this, dom, dst, src, nelems, type_size, tag, fault_aware, context);
   coll->init_root(root);
@@ -897,7 +985,7 @@ transport::scatter(int root, void *dst, void *src, int nelems,
 
   dag_collective* coll = scatter_selector_ == 0
       ? new btree_scatter
-      : scatter_selector_->select(dom->nproc(), nelems);
+      : scatter_selector_->select(dom->nproc(), nelems, type_size);
 
   coll->init(collective::scatter, this, dom, dst, src, nelems, type_size, tag, fault_aware, context);
   coll->init_root(root);
@@ -913,7 +1001,7 @@ transport::scatterv(int root, void *dst, void *src, int* send_counts, int recvcn
 
   dag_collective* coll = scatterv_selector_ == 0
       ? new btree_scatterv
-      : scatterv_selector_->select(dom->nproc(), send_counts);
+      : scatterv_selector_->select(dom->nproc(), send_counts, type_size);
 
   coll->init(collective::scatterv, this, dom, dst, src, recvcnt,
              type_size, tag, fault_aware, context);
@@ -932,7 +1020,7 @@ transport::alltoall(void *dst, void *src, int nelems, int type_size,
 
   dag_collective* coll = alltoall_selector_ == 0
       ? new bruck_alltoall_collective
-      : alltoall_selector_->select(dom->nproc(), nelems);
+      : alltoall_selector_->select(dom->nproc(), nelems, type_size);
 
   coll->init(collective::alltoall, this, dom, dst, src, nelems, type_size, tag, fault_aware, context);
   start_collective(coll);
@@ -947,7 +1035,7 @@ transport::alltoallv(void *dst, void *src, int* send_counts, int* recv_counts, i
 
   dag_collective* coll = alltoallv_selector_ == 0
       ? new direct_alltoallv_collective
-      : alltoallv_selector_->select(dom->nproc(), send_counts);
+      : alltoallv_selector_->select(dom->nproc(), send_counts, type_size);
 
   coll->init(collective::alltoallv, this, dom, dst, src, 0, type_size, tag, fault_aware, context);
   coll->init_recv_counts(recv_counts);
@@ -964,7 +1052,7 @@ transport::allgather(void *dst, void *src, int nelems, int type_size,
 
   dag_collective* coll = allgather_selector_ == 0
       ? new bruck_allgather_collective
-      : allgather_selector_->select(dom->nproc(), nelems);
+      : allgather_selector_->select(dom->nproc(), nelems, type_size);
 
   coll->init(collective::allgather, this, dom, dst, src, nelems, type_size, tag, fault_aware, context);
   start_collective(coll);
@@ -980,7 +1068,7 @@ transport::allgatherv(void *dst, void *src, int* recv_counts, int type_size, int
 
   dag_collective* coll = allgatherv_selector_ == 0
       ? new bruck_allgatherv_collective
-      : allgatherv_selector_->select(dom->nproc(), recv_counts);
+      : allgatherv_selector_->select(dom->nproc(), recv_counts, type_size);
 
   //for the time being, ignore size and use the small-message algorithm
   coll->init(collective::allgatherv, this, dom, dst, src, 0, type_size, tag, fault_aware, context);
@@ -25,6 +25,8 @@ DeclareDebugSlot(sumi);
 
 namespace sumi {
 
+class collective_model;
+
 class transport
 {
 
@@ -234,6 +236,32 @@ class transport
   supports_hardware_ack() const {
     return false;
   }
+
+  /**
+   * Where a rank sits in the machine, used to build topology-aware collectives
+   * @param global_rank
+   * @param node [out] The node the rank runs on
+   * @param group [out] The group of switches the node is attached to
+   * @return Whether the location of the rank is known
+   */
+  virtual bool
+  rank_location(int global_rank, int& node, int& group) const {
+    return false;
+  }
+
+  /**
+   * @return The model that resolves collectives without sending messages,
+   *         null if every collective is simulated message by message
+   */
+  collective_model*
+  collective_cost_model() const {
+    return collective_model_;
+  }
+
+  void
+  set_collective_cost_model(collective_model* model){
+    collective_model_ = model;
+  }
   
   virtual void
   init_spares(int nspares);
@@ -357,6 +385,30 @@ class transport
     reduce(root, dst, src, nelems, sizeof(data_t), tag, &op_class_type::op, fault_aware, context, dom);
   }
 
+  /**
+   * Inclusive prefix reduction, rank i gets the reduction over ranks 0..i
+   * @param nelems The number of elements in the input and result buffer.
+   */
+  virtual void
+  scan(void* dst, void* src, int nelems, int type_size, int tag,
+    reduce_fxn fxn, bool fault_aware = false, int context = options::initial_context, communicator* dom = 0);
+
+  /**
+   * Exclusive prefix reduction, rank i gets the reduction over ranks 0..i-1
+   * and the result buffer of rank 0 is left untouched
+   */
+  virtual void
+  exscan(void* dst, void* src, int nelems, int type_size, int tag,
+    reduce_fxn fxn, bool fault_aware = false, int context = options::initial_context, communicator* dom = 0);
+
+  /**
+   * Reduces a vector of sum(recv_counts) elements and leaves the i-th block on rank i
+   * @param recv_counts The number of elements in the block of each rank
+   */
+  virtual void
+  reduce_scatter(void* dst, void* src, int* recv_counts, int type_size, int tag,
+    reduce_fxn fxn, bool fault_aware = false, int context = options::initial_context, communicator* dom = 0);
+
 
   /**
    * The total size of the input/result buffer in bytes is nelems*type_size
@@ -484,6 +536,15 @@ class transport
   virtual void
   delayed_transport_handle(const message::ptr& msg) = 0;
 
+  /**
+   * Deliver the completion of a collective whose time
+   * comes from the collective model
+   * @param msg
+   * @param delay The time in seconds the collective takes
+   */
+  virtual void
+  schedule_collective_done(const collective_done_message::ptr& msg, double delay);
+
   virtual void
   cq_notify() = 0;
   
@@ -781,6 +842,8 @@ class transport
   static collective_algorithm_selector* scatter_selector_;
   static collective_algorithm_selector* scatterv_selector_;
 
+  collective_model* collective_model_;
+
 
 #if SUMI_COMM_SYNC_STATS
  public:
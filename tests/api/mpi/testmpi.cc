@@ -66,8 +66,8 @@ enum TEST_MODE
   COLL_COLL7 = 48,
   COLL_COLL8 = 49,
   COLL_COLL9 = 50,
-  //COLL_EXSCAN = 51,
-  //COLL_EXSCAN2 = 52,
+  COLL_EXSCAN = 51,
+  COLL_EXSCAN2 = 52,
   COLL_GATHER = 53,
   COLL_GATHER2 = 54,
   COLL_IALLRED = 55,
@@ -98,7 +98,7 @@ enum TEST_MODE
   COLL_OPMINLOC = 83,
   COLL_OPPROD = 84,
   COLL_OPSUM = 85,
-  //COLL_RED_SCAT_BLOCK = 88,
+  COLL_RED_SCAT_BLOCK = 88,
   //COLL_RED_SCAT_BLOCK2 = 89,
   COLL_REDSCAT = 90,
   COLL_REDSCAT3 = 92,
@@ -376,8 +376,8 @@ enum TEST_MODE
 #include "coll/coll7.cc"
 #include "coll/coll8.cc"
 #include "coll/coll9.cc"
-//#include "coll/exscan.cc"
-//#include "coll/exscan2.cc"
+#include "coll/exscan.cc"
+#include "coll/exscan2.cc"
 #include "coll/gather.cc"
 #include "coll/gather2.cc"
 #include "coll/iallred.cc"
@@ -814,13 +814,12 @@ int USER_MAIN(int argc, char *argv[])
   case COLL_COLL9:
     coll9::coll9(argc, argv);
     break;
-  /***
   case COLL_EXSCAN:
     exscan::exscan(argc, argv);
     break;
   case COLL_EXSCAN2:
     exscan2::exscan2(argc, argv);
-    break; */
+    break;
   case COLL_GATHER:
     gather::gather(argc, argv);
     break;
@@ -905,7 +904,7 @@ int USER_MAIN(int argc, char *argv[])
   case COLL_OPSUM:
     opsum::opsum(argc, argv);
     break;
-  /*** case COLL_RED_SCAT_BLOCK:
+  case COLL_RED_SCAT_BLOCK:
     red_scat_block::red_scat_block(argc, argv);
     break;
   case COLL_REDSCAT:
@@ -913,7 +912,7 @@ int USER_MAIN(int argc, char *argv[])
     break;
   case COLL_REDSCAT3:
     redscat3::redscat3(argc, argv);
-    break; */
+    break;
   /*** case COLL_REDSCATBKINTER:
     redscatbkinter::redscatbkinter(argc, argv);
     break;
@@ -0,0 +1,239 @@
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <sstmac/util.h>
+#include <sstmac/compute.h>
+#include <sstmac/software/process/app.h>
+#include <sstmac/software/process/operating_system.h>
+#include <sstmac/software/process/thread.h>
+#include <sstmac/libraries/sumi/sumi.h>
+#include <sstmac/common/runtime.h>
+#include <sumi/transport.h>
+#include <sstmac/skeleton.h>
+
+#define sstmac_app_name user_app_cxx
+
+using namespace sumi;
+
+/**
+ * Checks the results of the allreduce, allgather and alltoall algorithms
+ * picked by the transport's cost table on communicators of every size
+ * up to the number of ranks, including sizes that are not powers of two.
+ * Run once per algorithm through the ini file. The scan and exscan are
+ * checked with a reduction that is not commutative.
+ */
+
+static void
+wait_collective(const char* name)
+{
+  message::ptr msg = comm_poll();
+  if (msg->class_type() != message::collective_done){
+    spkt_throw_printf(sprockit::value_error,
+      "%s test: expected collective message, but got %s",
+      name, message::tostr(msg->class_type()));
+  }
+}
+
+static void
+test_allreduce(communicator* dom, int nelems, int tag)
+{
+  int me = dom->my_comm_rank();
+  int nproc = dom->nproc();
+  int* src = new int[nelems];
+  int* dst = new int[nelems];
+  for (int i=0; i < nelems; ++i){
+    src[i] = me*(i+1) + 1;
+  }
+
+  comm_allreduce<int,Add>(dst, src, nelems, tag, false, options::initial_context, dom);
+  wait_collective("allreduce");
+
+  int failures = 0;
+  for (int i=0; i < nelems; ++i){
+    int correct = (i+1)*nproc*(nproc-1)/2 + nproc;
+    if (dst[i] != correct){
+      std::cout << sprockit::printf("FAILED: allreduce nproc=%d nelems=%d rank %d A[%d] = %d != %d\n",
+                                    nproc, nelems, me, i, dst[i], correct);
+      ++failures;
+    }
+  }
+  if (me == 0 && failures == 0){
+    printf("Passed allreduce nproc=%d nelems=%d\n", nproc, nelems);
+  }
+  delete[] src;
+  delete[] dst;
+}
+
+static void
+test_allgather(communicator* dom, int nelems, int tag)
+{
+  int me = dom->my_comm_rank();
+  int nproc = dom->nproc();
+  int* src = new int[nelems];
+  int* dst = new int[nproc*nelems];
+  for (int i=0; i < nelems; ++i){
+    src[i] = me*1000 + i;
+  }
+
+  comm_allgather(dst, src, nelems, sizeof(int), tag, false, options::initial_context, dom);
+  wait_collective("allgather");
+
+  int failures = 0;
+  for (int p=0; p < nproc; ++p){
+    for (int i=0; i < nelems; ++i){
+      int correct = p*1000 + i;
+      if (dst[p*nelems+i] != correct){
+        std::cout << sprockit::printf("FAILED: allgather nproc=%d nelems=%d rank %d section %d\n",
+                                      nproc, nelems, me, p);
+        ++failures;
+      }
+    }
+  }
+  if (me == 0 && failures == 0){
+    printf("Passed allgather nproc=%d nelems=%d\n", nproc, nelems);
+  }
+  delete[] src;
+  delete[] dst;
+}
+
+static void
+test_alltoall(communicator* dom, int nelems, int tag)
+{
+  int me = dom->my_comm_rank();
+  int nproc = dom->nproc();
+  int* src = new int[nproc*nelems];
+  int* dst = new int[nproc*nelems];
+  for (int p=0; p < nproc; ++p){
+    for (int i=0; i < nelems; ++i){
+      src[p*nelems+i] = me*10000 + p*100 + i;
+    }
+  }
+
+  comm_alltoall(dst, src, nelems, sizeof(int), tag, false, options::initial_context, dom);
+  wait_collective("alltoall");
+
+  int failures = 0;
+  for (int p=0; p < nproc; ++p){
+    for (int i=0; i < nelems; ++i){
+      int correct = p*10000 + me*100 + i;
+      if (dst[p*nelems+i] != correct){
+        std::cout << sprockit::printf("FAILED: alltoall nproc=%d nelems=%d rank %d partner %d\n",
+                                      nproc, nelems, me, p);
+        ++failures;
+      }
+    }
+  }
+  if (me == 0 && failures == 0){
+    printf("Passed alltoall nproc=%d nelems=%d\n", nproc, nelems);
+  }
+  delete[] src;
+  delete[] dst;
+}
+
+/**
+ * An affine map x -> m*x + c. Composing maps is associative,
+ * but not commutative, so a scan must keep the ranks in order.
+ */
+struct affine {
+  unsigned m;
+  unsigned c;
+};
+
+static void
+compose(void* dst_buf, const void* src_buf, int nelems)
+{
+  //like an MPI user function: dst = src then dst
+  affine* dst = (affine*) dst_buf;
+  const affine* src = (const affine*) src_buf;
+  for (int i=0; i < nelems; ++i){
+    dst[i].c = dst[i].m * src[i].c + dst[i].c;
+    dst[i].m = dst[i].m * src[i].m;
+  }
+}
+
+static affine
+rank_map(int rank, int i)
+{
+  affine a;
+  a.m = 2 + i % 3;
+  a.c = rank + i + 1;
+  return a;
+}
+
+static void
+test_scan(communicator* dom, int nelems, int tag, bool inclusive)
+{
+  int me = dom->my_comm_rank();
+  int nproc = dom->nproc();
+  affine* src = new affine[nelems];
+  affine* dst = new affine[nelems];
+  for (int i=0; i < nelems; ++i){
+    src[i] = rank_map(me, i);
+  }
+
+  if (inclusive){
+    sumi_api()->scan(dst, src, nelems, sizeof(affine), tag, &compose,
+                     false, options::initial_context, dom);
+  } else {
+    sumi_api()->exscan(dst, src, nelems, sizeof(affine), tag, &compose,
+                       false, options::initial_context, dom);
+  }
+  wait_collective(inclusive ? "scan" : "exscan");
+
+  const char* name = inclusive ? "scan" : "exscan";
+  int last = inclusive ? me : me - 1;
+  int failures = 0;
+  for (int i=0; last >= 0 && i < nelems; ++i){
+    affine correct = rank_map(0, i);
+    for (int r=1; r <= last; ++r){
+      affine next = rank_map(r, i);
+      compose(&next, &correct, 1);
+      correct = next;
+    }
+    if (dst[i].m != correct.m || dst[i].c != correct.c){
+      std::cout << sprockit::printf("FAILED: %s nproc=%d nelems=%d rank %d A[%d]\n",
+                                    name, nproc, nelems, me, i);
+      ++failures;
+    }
+  }
+  if (me == 0 && failures == 0){
+    printf("Passed %s nproc=%d nelems=%d\n", name, nproc, nelems);
+  }
+  delete[] src;
+  delete[] dst;
+}
+
+int
+main(int argc, char **argv)
+{
+  comm_init();
+
+  sstmac::runtime::enter_deadlock_region();
+  sstmac::runtime::add_deadlock_check(
+    sstmac::new_deadlock_check(sumi_api(), &sumi::transport::deadlock_check));
+
+  int rank = comm_rank();
+  int tag = 1;
+  for (int nproc=2; nproc <= comm_nproc(); ++nproc){
+    //fewer elements than ranks, an uneven split and an even split
+    int sizes[] = { 1, nproc + 1, 2*nproc };
+    communicator* dom = nullptr;
+    if (rank < nproc){
+      dom = new subrange_communicator(rank, 0, nproc);
+    }
+    for (int nelems : sizes){
+      if (dom){
+        test_allreduce(dom, nelems, tag);
+        test_allgather(dom, nelems, tag+1);
+        test_alltoall(dom, nelems, tag+2);
+        test_scan(dom, nelems, tag+3, true);
+        test_scan(dom, nelems, tag+4, false);
+      }
+      tag += 5;
+    }
+    delete dom;
+  }
+
+  comm_finalize();
+  sstmac::runtime::exit_deadlock_region();
+  return 0;
+}
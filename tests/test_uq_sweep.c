@@ -0,0 +1,75 @@
+#include <sstmac/libraries/uq/uq.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+/**
+ * Runs the same points from scratch and as a warm-start sweep that forks
+ * after the traffic matrix setup, and checks the results agree.
+ */
+int main(int argc, char** argv)
+{
+  int nproc = 64;
+  int npartners = 4;
+  int niterations = 2;
+  int nresults = nproc*npartners*niterations;
+  int nparams = 1;
+  int njobs = 3;
+  const char* param_names[] = {
+    "app1.intensity",
+  };
+  double intensities[] = { 0.5, 1.0, 4.0 };
+  const char* units[] = { "" };
+
+  int worker_id;
+  void* queue = sstmac_uq_init(argc, argv, &worker_id);
+
+  double** param_values = allocate_values(queue, njobs, nparams);
+  double** cold = allocate_results(queue, njobs, nresults);
+  int job, i;
+  for (job=0; job < njobs; ++job){
+    param_values[job][0] = intensities[job];
+  }
+
+  int max_nthread = njobs;
+  sstmac_uq_run_units(queue,
+    njobs, nparams, nresults, max_nthread,
+    param_names, param_values, units,
+    cold, Fork);
+
+  double* cold_copy = (double*) malloc(njobs*nresults*sizeof(double));
+  for (job=0; job < njobs; ++job){
+    memcpy(cold_copy + job*nresults, cold[job], nresults*sizeof(double));
+  }
+
+  double** warm = allocate_results(queue, njobs, nresults);
+  sstmac_uq_run_units(queue,
+    njobs, nparams, nresults, max_nthread,
+    param_names, param_values, units,
+    warm, ForkAtDivergence);
+
+  int differ = 0;
+  for (job=0; job < njobs; ++job){
+    for (i=0; i < nresults; ++i){
+      double bw = warm[job][i];
+      if (bw <= 0 || bw > 10.0){
+        printf("UQ sweep test failed: got invalid bandwidths\n");
+        return 1;
+      }
+      if (bw != cold_copy[job*nresults + i]){
+        printf("UQ sweep test failed: job %d result %d differs %12.8f != %12.8f\n",
+          job, i, bw, cold_copy[job*nresults + i]);
+        return 1;
+      }
+      if (bw != warm[0][i]) differ = 1;
+    }
+  }
+  if (!differ){
+    printf("UQ sweep test failed: parameters did not change the results\n");
+    return 1;
+  }
+  printf("UQ sweep test passed: warm starts match cold starts\n");
+
+  free(cold_copy);
+  return 0;
+}
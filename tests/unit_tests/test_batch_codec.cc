@@ -0,0 +1,162 @@
+#include <sstmac/backends/common/batch_codec.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <string>
+#include <vector>
+
+using namespace sstmac;
+
+/**
+ * Round trips the encoding used for events batched between ranks:
+ * varints, zigzag deltas of both signs, device ids, and payloads
+ * written raw or as runs of changed bytes against the previous payload.
+ */
+
+static void
+test_varints(UnitTest& unit)
+{
+  uint64_t vals[] = { 0, 1, 127, 128, 300, 1ULL << 35, ~0ULL };
+  std::vector<char> buf;
+  for (uint64_t val : vals) put_varint(buf, val);
+
+  const char* ptr = buf.data();
+  bool all_match = true;
+  for (uint64_t val : vals){
+    all_match = all_match && get_varint(ptr) == val;
+  }
+  assertTrue(unit, "varints round trip", all_match);
+  assertEqual(unit, "varints consume whole buffer", int(ptr - buf.data()), int(buf.size()));
+
+  buf.clear();
+  put_varint(buf, 127);
+  assertEqual(unit, "varint 127 is one byte", int(buf.size()), 1);
+  buf.clear();
+  put_varint(buf, 128);
+  assertEqual(unit, "varint 128 is two bytes", int(buf.size()), 2);
+}
+
+static void
+test_deltas(UnitTest& unit)
+{
+  int64_t deltas[] = { 0, 1, -1, 63, -64, 64, -65, 1000000, -1000000,
+                       INT64_MAX, INT64_MIN };
+  std::vector<char> buf;
+  for (int64_t delta : deltas) put_delta(buf, delta);
+
+  const char* ptr = buf.data();
+  bool all_match = true;
+  for (int64_t delta : deltas){
+    all_match = all_match && get_delta(ptr) == delta;
+  }
+  assertTrue(unit, "deltas of both signs round trip", all_match);
+  assertEqual(unit, "deltas consume whole buffer", int(ptr - buf.data()), int(buf.size()));
+
+  buf.clear();
+  put_delta(buf, -64);
+  put_delta(buf, 63);
+  assertEqual(unit, "small deltas of either sign are one byte", int(buf.size()), 2);
+
+  buf.clear();
+  device_id first(12, device_id::router);
+  device_id second(3, device_id::logp_overlay);
+  put_device(buf, first, device_id(0, device_id::null));
+  put_device(buf, second, first);
+  ptr = buf.data();
+  device_id got_first = get_device(ptr, device_id(0, device_id::null));
+  device_id got_second = get_device(ptr, got_first);
+  assertTrue(unit, "device ids round trip",
+             got_first.id() == 12 && got_first.type() == device_id::router
+             && got_second.id() == 3 && got_second.type() == device_id::logp_overlay);
+}
+
+/**
+ * Encode payloads one after another the way a batch does
+ * and check that each decodes to the original.
+ * @param used_delta [out] Whether each payload was delta encoded
+ */
+static bool
+round_trip(const std::vector<std::string>& payloads, std::vector<bool>& used_delta)
+{
+  std::vector<char> buf;
+  std::vector<char> scratch;
+  const std::string* prev = nullptr;
+  for (const std::string& p : payloads){
+    used_delta.push_back(put_payload(buf, scratch, p.data(), p.size(),
+                           prev ? prev->data() : nullptr, prev ? prev->size() : 0));
+    prev = &p;
+  }
+
+  const char* ptr = buf.data();
+  std::vector<char> prev_decoded;
+  for (const std::string& p : payloads){
+    int size = peek_payload_size(ptr);
+    if (size != int(p.size())) return false;
+    std::vector<char> decoded(size);
+    get_payload(ptr, decoded.data(), prev_decoded.data());
+    if (std::string(decoded.begin(), decoded.end()) != p) return false;
+    prev_decoded.swap(decoded);
+  }
+  return ptr == buf.data() + buf.size();
+}
+
+static void
+test_payloads(UnitTest& unit)
+{
+  std::string base(64, 'a');
+  for (int i=0; i < base.size(); ++i) base[i] = char('a' + i % 26);
+
+  std::string middle = base;
+  middle[30] = 'X';
+  middle[31] = 'Y';
+
+  //no unchanged run at either end
+  std::string ends = middle;
+  ends[0] = '0';
+  ends[63] = '9';
+
+  //changes separated by unchanged runs shorter than a run header
+  std::string gaps = ends;
+  gaps[10] = '#';
+  gaps[12] = '#';
+  gaps[15] = '#';
+
+  std::string shorter = base.substr(0, 40);
+  std::string unrelated(40, '\0');
+  for (int i=0; i < unrelated.size(); ++i) unrelated[i] = char(200 - i);
+
+  std::vector<std::string> payloads = {
+    base, middle, ends, gaps, gaps, shorter, unrelated, std::string()
+  };
+  std::vector<bool> used_delta;
+  assertTrue(unit, "payloads round trip", round_trip(payloads, used_delta));
+  assertFalse(unit, "first payload is raw", used_delta[0]);
+  assertTrue(unit, "unchanged start and end use delta", used_delta[1]);
+  assertTrue(unit, "changed start and end use delta", used_delta[2]);
+  assertTrue(unit, "short unchanged gaps use delta", used_delta[3]);
+  assertTrue(unit, "identical payload uses delta", used_delta[4]);
+  assertFalse(unit, "different size is raw", used_delta[5]);
+  assertFalse(unit, "fully changed payload is raw", used_delta[6]);
+  assertFalse(unit, "empty payload is raw", used_delta[7]);
+
+  std::vector<char> buf;
+  std::vector<char> scratch;
+  put_payload(buf, scratch, middle.data(), middle.size(), base.data(), base.size());
+  assertTrue(unit, "two changed bytes encode small", buf.size() < 10);
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    test_varints(unit);
+    test_deltas(unit);
+    test_payloads(unit);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
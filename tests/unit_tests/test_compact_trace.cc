@@ -0,0 +1,137 @@
+#include <sstmac/dumpi_util/compact_trace.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace sstmac::sw;
+
+/**
+ * Checks that records survive a round trip through the compact trace
+ * format across block boundaries, and that a typical halo exchange
+ * takes only a few bytes per call.
+ */
+
+static compact_record
+record(compact_record::op_t op, int64_t compute, int64_t peer, int64_t tag,
+       int64_t bytes, int64_t request)
+{
+  compact_record rec;
+  rec.op = op;
+  rec.compute = compute;
+  rec.peer = peer;
+  rec.tag = tag;
+  rec.bytes = bytes;
+  rec.request = request;
+  return rec;
+}
+
+static void
+test_round_trip(UnitTest& unit)
+{
+  const char* fname = "test_compact_trace-0000.sct";
+  std::vector<compact_record> written;
+  written.push_back(record(compact_record::init, 0, 0, 0, 0, compact_record::null_request));
+  written.push_back(record(compact_record::send, 1500, 3, 7, 1 << 20, compact_record::null_request));
+  written.push_back(record(compact_record::recv, 0, compact_record::any_source,
+                           compact_record::any_tag, 64, compact_record::null_request));
+  written.push_back(record(compact_record::isend, 10, 1, 0, 8, 12));
+  written.push_back(record(compact_record::irecv, 10, 2, 0, 8, 13));
+  compact_record waitall = record(compact_record::waitall, 0, 0, 0, 0, compact_record::null_request);
+  waitall.aux = { 12, 13, compact_record::null_request };
+  written.push_back(waitall);
+  compact_record sendrecv = record(compact_record::sendrecv, 5, 1, 4, 256, compact_record::null_request);
+  sendrecv.aux = { 3, 4, 512 };
+  written.push_back(sendrecv);
+  compact_record split = record(compact_record::comm_split, 0, 1, 5, 0, 2);
+  written.push_back(split);
+  compact_record bcast = record(compact_record::bcast, 0, 0, 0, 4096, compact_record::null_request);
+  bcast.comm = 2;
+  written.push_back(bcast);
+  written.push_back(record(compact_record::wait, 1000000000L, 0, 0, 0, 14));
+  written.push_back(record(compact_record::finalize, 20, 0, 0, 0, compact_record::null_request));
+
+  {
+    //a block size of 4 splits the records over several blocks
+    compact_trace_writer writer(fname, 4);
+    for (const compact_record& rec : written){
+      writer.append(rec);
+    }
+  }
+
+  compact_trace_reader reader(fname);
+  compact_record rec;
+  int nrec = 0;
+  bool all_match = true;
+  while (reader.next(rec)){
+    const compact_record& w = written[nrec++];
+    bool match = rec.op == w.op && rec.compute == w.compute && rec.aux == w.aux;
+    if (rec.op != compact_record::init && rec.op != compact_record::finalize
+      && rec.op != compact_record::wait && rec.op != compact_record::waitall){
+      match = match && rec.peer == w.peer && rec.comm == w.comm;
+    }
+    if (rec.op == compact_record::isend || rec.op == compact_record::irecv
+      || rec.op == compact_record::wait || rec.op == compact_record::comm_split){
+      match = match && rec.request == w.request;
+    }
+    if (rec.op == compact_record::send || rec.op == compact_record::recv
+      || rec.op == compact_record::sendrecv || rec.op == compact_record::bcast){
+      match = match && rec.tag == w.tag && rec.bytes == w.bytes;
+    }
+    if (!match){
+      cerr0 << "mismatch on " << compact_record::tostr(rec.op) << std::endl;
+      all_match = false;
+    }
+  }
+  assertEqual(unit, "reads every record", nrec, int(written.size()));
+  assertTrue(unit, "fields survive the round trip", all_match);
+  remove(fname);
+}
+
+static void
+test_size(UnitTest& unit)
+{
+  const char* fname = "test_compact_trace-0001.sct";
+  const int iters = 10000;
+  long bytes;
+  {
+    compact_trace_writer writer(fname);
+    int64_t req = 100;
+    for (int i=0; i < iters; ++i){
+      writer.append(record(compact_record::irecv, 2000, 1, 0, 8192, req));
+      writer.append(record(compact_record::isend, 50, 3, 0, 8192, req+1));
+      compact_record waitall = record(compact_record::waitall, 10, 0, 0, 0, 0);
+      waitall.aux = { req, req+1 };
+      writer.append(waitall);
+      req += 2;
+    }
+    writer.close();
+    bytes = writer.bytes_written();
+  }
+  double per_call = double(bytes) / (3*iters);
+  assertTrue(unit, "halo exchange takes under 8 bytes per call", per_call < 8);
+
+  compact_trace_reader reader(fname);
+  compact_record rec;
+  int nrec = 0;
+  while (reader.next(rec)) ++nrec;
+  assertEqual(unit, "reads every block", nrec, 3*iters);
+  remove(fname);
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    test_round_trip(unit);
+    test_size(unit);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
@@ -0,0 +1,148 @@
+#include <sstmac/software/threading/threading_interface.h>
+#include <sstmac/software/threading/threading_ucontext.h>
+#include <sstmac/software/threading/threading_fcontext.h>
+#include <sstmac/software/process/time.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <sprockit/spkt_string.h>
+#include <cstdlib>
+#include <cstring>
+#include <stdlib.h>
+
+using namespace sstmac;
+using namespace sstmac::sw;
+
+/**
+ * Ping-pongs between a main context and a virtual thread context
+ * and checks that both resume with their state intact.
+ * Run with --bench <nswitches> to print the cost of a context switch
+ * for every available threading backend instead.
+ */
+
+static const size_t stacksize = 1 << 16;
+
+struct ping_pong {
+  threading_interface* main;
+  threading_interface* thread;
+  int num_switches;
+  int count;
+  double sum;
+};
+
+static void
+run_thread(void* args)
+{
+  ping_pong* pp = (ping_pong*) args;
+  //kept live across every swap to check registers are restored
+  double sum = 0;
+  for (int i=0; i < pp->num_switches; ++i){
+    sum += 0.5;
+    pp->count++;
+    pp->thread->swap_context(pp->main);
+  }
+  pp->sum = sum;
+  pp->thread->complete_context(pp->main);
+}
+
+/**
+ * @return The wall time for num_switches round trips
+ */
+static double
+run_ping_pong(threading_interface* proto, int num_switches, ping_pong& pp)
+{
+  void* stack = nullptr;
+  if (posix_memalign(&stack, stacksize, stacksize) != 0){
+    spkt_abort_printf("could not allocate thread stack");
+  }
+
+  pp.main = proto->copy();
+  pp.main->init_context();
+  pp.thread = proto->copy();
+  pp.num_switches = num_switches;
+  pp.count = 0;
+  pp.sum = 0;
+  pp.thread->start_context(0, stack, stacksize, run_thread, &pp, pp.main);
+
+  double start = sstmac_wall_time();
+  //one extra to let the thread complete
+  for (int i=0; i <= num_switches; ++i){
+    pp.main->swap_context(pp.thread);
+  }
+  double stop = sstmac_wall_time();
+
+  pp.thread->destroy_context();
+  pp.main->destroy_context();
+  delete pp.thread;
+  delete pp.main;
+  ::free(stack);
+  return stop - start;
+}
+
+static void
+check_backend(UnitTest& unit, const char* name, threading_interface* proto)
+{
+  ping_pong pp;
+  int num_switches = 1000;
+  double local_sum = 0;
+  for (int i=0; i < num_switches; ++i){
+    local_sum += 0.25;
+  }
+  run_ping_pong(proto, num_switches, pp);
+  assertEqual(unit, sprockit::printf("%s thread resumed every switch", name).c_str(),
+              pp.count, num_switches);
+  assertEqual(unit, sprockit::printf("%s thread kept its state", name).c_str(),
+              pp.sum, 0.5*num_switches);
+  assertEqual(unit, sprockit::printf("%s main kept its state", name).c_str(),
+              local_sum, 0.25*num_switches);
+}
+
+static void
+benchmark(const char* name, threading_interface* proto, int num_switches)
+{
+  ping_pong pp;
+  //best of a few runs to filter out noise
+  double best = 1e100;
+  for (int trial=0; trial < 3; ++trial){
+    double t = run_ping_pong(proto, num_switches, pp);
+    best = std::min(best, t);
+  }
+  //every round trip is two switches
+  double ns_per_switch = best / (2.0*num_switches) * 1e9;
+  printf("  %-9s %10.4fs %8.2f ns/switch\n", name, best, ns_per_switch);
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc > 1 && ::strcmp(argv[1], "--bench") == 0){
+    int num_switches = argc > 2 ? atoi(argv[2]) : 10000000;
+    printf("context switch round trips: %d\n", num_switches);
+#ifdef SSTMAC_HAVE_UCONTEXT
+    threading_ucontext ucontext;
+    benchmark("ucontext", &ucontext, num_switches);
+#endif
+#ifdef SSTMAC_HAVE_FCONTEXT
+    threading_fcontext fcontext;
+    benchmark("fcontext", &fcontext, num_switches);
+#endif
+    return 0;
+  }
+
+  UnitTest unit;
+  try {
+#ifdef SSTMAC_HAVE_UCONTEXT
+    threading_ucontext ucontext;
+    check_backend(unit, "ucontext", &ucontext);
+#endif
+#ifdef SSTMAC_HAVE_FCONTEXT
+    threading_fcontext fcontext;
+    check_backend(unit, "fcontext", &fcontext);
+#endif
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
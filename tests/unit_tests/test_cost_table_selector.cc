@@ -0,0 +1,98 @@
+#include <sumi/cost_table_selector.h>
+#include <sumi/allreduce.h>
+#include <sumi/allgather.h>
+#include <sumi/alltoall.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <string>
+
+using namespace sumi;
+
+/**
+ * Checks that the cost table selector applies its rules in order,
+ * honors the process count cutoffs, and builds the selected algorithm.
+ */
+
+static void
+test_custom_table(UnitTest& unit)
+{
+  sprockit::sim_parameters params;
+  params["algorithm"] = "ring";
+  params["cost_table"] = "recursive_doubling:2KB wilke:1MB:64";
+  cost_table_selector sel(&params, collective::allreduce, "wilke");
+
+  assertEqual(unit, "small messages", sel.algorithm(128, 1024),
+              std::string("recursive_doubling"));
+  assertEqual(unit, "cutoff is inclusive", sel.algorithm(128, 2000),
+              std::string("recursive_doubling"));
+  assertEqual(unit, "medium messages on few ranks", sel.algorithm(64, 4096),
+              std::string("wilke"));
+  assertEqual(unit, "medium messages on many ranks", sel.algorithm(65, 4096),
+              std::string("ring"));
+  assertEqual(unit, "large messages", sel.algorithm(16, 1 << 24),
+              std::string("ring"));
+
+  dag_collective* coll = sel.select(16, 128, 8);
+  assertTrue(unit, "builds recursive doubling",
+             dynamic_cast<recursive_doubling_allreduce*>(coll) != nullptr);
+  delete coll;
+  coll = sel.select(16, 1 << 20, 8);
+  assertTrue(unit, "builds ring",
+             dynamic_cast<ring_allreduce*>(coll) != nullptr);
+  delete coll;
+}
+
+static void
+test_mpich_tables(UnitTest& unit)
+{
+  sprockit::sim_parameters params;
+  params["cost_table"] = "mpich";
+
+  cost_table_selector allreduce(&params, collective::allreduce, "wilke");
+  assertEqual(unit, "mpich small allreduce", allreduce.algorithm(16, 2048),
+              std::string("recursive_doubling"));
+  assertEqual(unit, "mpich large allreduce", allreduce.algorithm(16, 2049),
+              std::string("rabenseifner"));
+
+  //allgather cutoffs are on the size of the gathered result
+  cost_table_selector allgather(&params, collective::allgather, "bruck");
+  dag_collective* coll = allgather.select(64, 1024, 1);
+  assertTrue(unit, "mpich small allgather is bruck",
+             dynamic_cast<bruck_allgather_collective*>(coll) != nullptr);
+  delete coll;
+  coll = allgather.select(64, 4096, 1);
+  assertTrue(unit, "mpich medium allgather is recursive doubling",
+             dynamic_cast<recursive_doubling_allgather_collective*>(coll) != nullptr);
+  delete coll;
+  coll = allgather.select(64, 1 << 16, 1);
+  assertTrue(unit, "mpich large allgather is ring",
+             dynamic_cast<ring_allgather_collective*>(coll) != nullptr);
+  delete coll;
+
+  cost_table_selector alltoall(&params, collective::alltoall, "bruck");
+  assertEqual(unit, "mpich small alltoall", alltoall.algorithm(8, 256),
+              std::string("bruck"));
+  assertEqual(unit, "mpich small alltoall on few ranks", alltoall.algorithm(4, 256),
+              std::string("pairwise"));
+  coll = alltoall.select(8, 4096, 4);
+  assertTrue(unit, "mpich large alltoall is pairwise",
+             dynamic_cast<pairwise_alltoall_collective*>(coll) != nullptr);
+  delete coll;
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    test_custom_table(unit);
+    test_mpich_tables(unit);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
@@ -0,0 +1,189 @@
+#include <sstmac/hardware/pisces/pisces.h>
+#include <sstmac/hardware/pisces/pisces_arbitrator.h>
+#include <sstmac/software/process/time.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+using namespace sstmac;
+using namespace sstmac::hw;
+
+/**
+ * Drives random packet streams through the cut-through arbitrator,
+ * checks that no packet leaves before it arrives or faster than the link,
+ * and compares a digest of every head/tail/credit time and bandwidth
+ * against the values recorded from the original linked-list arbitrator.
+ * Packets arrive back to back with random gaps so the link is often busy,
+ * and some arrive at a fraction of the link bandwidth so epochs get split.
+ * Run with --bench <npackets> to print timings instead.
+ */
+
+struct arbitrated_packet {
+  int64_t arrival;
+  int64_t head;
+  int64_t tail;
+  int64_t credit;
+  double bw;
+};
+
+class packet_stream_rng
+{
+ public:
+  packet_stream_rng(uint32_t seed) : state_(seed) {}
+
+  uint32_t
+  next(){
+    //xorshift so every arbitrator sees the exact same stream
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+ private:
+  uint32_t state_;
+};
+
+static const double link_bw = 10e9;
+
+template <class Arbitrator>
+double
+run_stream(int npackets, uint32_t seed, std::vector<arbitrated_packet>& results)
+{
+  sprockit::sim_parameters params;
+  params["bandwidth"] = "10GB/s";
+  Arbitrator arb(&params);
+  packet_stream_rng rng(seed);
+
+  std::vector<pisces_payload*> pkts(npackets);
+  std::vector<timestamp> arrivals(npackets);
+  timestamp now(0);
+  for (int i=0; i < npackets; ++i){
+    int bytes = 8 + rng.next() % 4096;
+    pkts[i] = new pisces_default_packet(nullptr, i, bytes, false, node_id(0), node_id(1));
+    uint32_t r = rng.next() % 100;
+    if (r < 30){
+      //arriving from a slower link
+      pkts[i]->set_bw(link_bw * (0.2 + 0.1*(rng.next() % 8)));
+    }
+    pkts[i]->set_max_incoming_bw(link_bw);
+    //gaps average out to the serialization time
+    now += timestamp((rng.next() % (2*bytes)) / link_bw);
+    arrivals[i] = now;
+    //some packets have been queued up waiting for credits
+    timestamp queued((rng.next() % 4 == 0 ? bytes : 0) / link_bw);
+    pkts[i]->set_arrival(now > queued ? now - queued : now);
+  }
+
+  pkt_arbitration_t st;
+  double start = sstmac_wall_time();
+  for (int i=0; i < npackets; ++i){
+    st.now = arrivals[i];
+    st.pkt = pkts[i];
+    arb.arbitrate(st);
+    arbitrated_packet p;
+    p.arrival = arrivals[i].ticks_int64();
+    p.head = st.head_leaves.ticks_int64();
+    p.tail = st.tail_leaves.ticks_int64();
+    p.credit = st.credit_leaves.ticks_int64();
+    p.bw = pkts[i]->bw();
+    results.push_back(p);
+  }
+  double stop = sstmac_wall_time();
+
+  for (pisces_payload* pkt : pkts){
+    delete pkt;
+  }
+  return stop - start;
+}
+
+static uint64_t
+digest(const std::vector<arbitrated_packet>& results)
+{
+  //FNV-1a over the exact times and bandwidth bits
+  uint64_t hash = 14695981039346656037ULL;
+  for (const arbitrated_packet& p : results){
+    int64_t fields[4] = { p.head, p.tail, p.credit, 0 };
+    ::memcpy(&fields[3], &p.bw, sizeof(double));
+    const unsigned char* bytes = (const unsigned char*) fields;
+    for (int i=0; i < sizeof(fields); ++i){
+      hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+static bool
+causal(const std::vector<arbitrated_packet>& results)
+{
+  for (const arbitrated_packet& p : results){
+    if (p.head < p.arrival || p.tail < p.head || p.credit > p.tail
+      || p.bw <= 0 || p.bw > link_bw){
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool
+any_delayed(const std::vector<arbitrated_packet>& results)
+{
+  for (int i=1; i < results.size(); ++i){
+    if (results[i].head == results[i-1].tail) return true;
+  }
+  return false;
+}
+
+void
+benchmark(int npackets)
+{
+  std::vector<arbitrated_packet> results;
+  results.reserve(npackets);
+  //best of a few runs to filter out noise
+  double time = 1e100;
+  for (int trial=0; trial < 3; ++trial){
+    results.clear();
+    time = std::min(time,
+      run_stream<pisces_cut_through_arbitrator>(npackets, 42, results));
+  }
+
+  printf("cut through arbitration: %d packets\n", npackets);
+  printf("  %10.4fs %8.2f Mpkts/s\n", time, npackets/time/1e6);
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc > 1 && ::strcmp(argv[1], "--bench") == 0){
+    int npackets = argc > 2 ? atoi(argv[2]) : 5000000;
+    benchmark(npackets);
+    return 0;
+  }
+
+  UnitTest unit;
+  try {
+    //digests recorded from the linked-list arbitrator this one replaced
+    struct { uint32_t seed; uint64_t digest; } recorded[] = {
+      { 42, 0xf27996d0a1feab61ULL },
+      { 7, 0x91ba4d6e66a558b4ULL },
+      { 123456, 0x32d24c6fa6d0d027ULL },
+    };
+    for (auto& rec : recorded){
+      std::vector<arbitrated_packet> results;
+      run_stream<pisces_cut_through_arbitrator>(20000, rec.seed, results);
+      assertTrue(unit, "stream contends for the link", any_delayed(results));
+      assertTrue(unit, "packets leave after arriving within link bandwidth", causal(results));
+      assertEqual(unit, "arbitrated times match recorded", digest(results), rec.digest);
+    }
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include <sstmac/dumpi_util/dumpi_prefetch.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace sstmac::sw;
+
+/**
+ * Checks that the prefetcher reads every byte of the queued trace files
+ * exactly once, that it skips files that are missing or done,
+ * and that it never holds more files open than its limit.
+ */
+
+static std::string
+write_file(const std::string& name, long size)
+{
+  FILE* f = fopen(name.c_str(), "w");
+  std::vector<char> bytes(size, 'x');
+  if (size) fwrite(bytes.data(), 1, size, f);
+  fclose(f);
+  return name;
+}
+
+static void
+test_round_robin(UnitTest& unit)
+{
+  dumpi_prefetcher prefetcher(4096, 2);
+  long window = prefetcher.window();
+  assertTrue(unit, "window is whole pages", window >= 4096 && window % 4096 == 0);
+
+  long sizes[] = { 100, 3*window + 1, 0, 2*window };
+  long total = 0;
+  std::vector<std::string> files;
+  for (int i=0; i < 4; ++i){
+    files.push_back(write_file("test_dumpi_prefetch-" + std::to_string(i) + ".bin", sizes[i]));
+    total += sizes[i];
+  }
+
+  for (const std::string& f : files){
+    prefetcher.add(f);
+  }
+  prefetcher.add("test_dumpi_prefetch-missing.bin");
+  prefetcher.wait();
+  assertEqual(unit, "reads every byte once", prefetcher.bytes_read(), total);
+  assertTrue(unit, "keeps open files under limit",
+             prefetcher.peak_open_files() >= 1 && prefetcher.peak_open_files() <= 2);
+
+  //a rank finishing after its file was fully read leaves nothing behind
+  prefetcher.done(files[1]);
+  prefetcher.add(files[1]);
+  prefetcher.wait();
+  total += sizes[1];
+  assertEqual(unit, "rereads a finished file added again", prefetcher.bytes_read(), total);
+
+  //a file that is done is dropped from the queue
+  std::string big = write_file("test_dumpi_prefetch-big.bin", 64*window);
+  prefetcher.add(big);
+  prefetcher.done(big);
+  prefetcher.wait();
+  assertTrue(unit, "stops reading a done file",
+             prefetcher.bytes_read() <= total + 64*window);
+
+  files.push_back(big);
+  for (const std::string& f : files){
+    remove(f.c_str());
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    test_round_robin(unit);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
@@ -0,0 +1,215 @@
+#include <sstmac/backends/native/event_map.h>
+#include <sstmac/backends/native/event_heap.h>
+#include <sstmac/backends/native/event_ladder.h>
+#include <sstmac/backends/native/serial_runtime.h>
+#include <sstmac/software/process/time.h>
+#include <sstmac/util.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/test/test.h>
+#include <sprockit/util.h>
+#include <sprockit/output.h>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace sstmac;
+using namespace sstmac::native;
+
+/**
+ * Drives the different event queues through the classic hold model:
+ * pop the next event, push a new one at now + random delay.
+ * The delay distribution mimics a pisces network - most events are a short
+ * credit/hop latency away, some are a longer serialization delay away,
+ * and a few are far in the future (compute, timeouts).
+ * Run with --bench <nevents> <nops> to print timings instead of checking order.
+ */
+
+class hold_event :
+  public event_queue_entry
+{
+ public:
+  hold_event(uint32_t src) :
+    event_queue_entry(device_id(src, device_id::router),
+                      device_id(src, device_id::router))
+  {
+  }
+
+  void
+  execute(){}
+};
+
+struct popped_event {
+  int64_t ticks;
+  uint32_t src;
+  uint32_t seqnum;
+};
+
+class hold_model_rng
+{
+ public:
+  hold_model_rng(uint32_t seed) : state_(seed) {}
+
+  uint32_t
+  next(){
+    //xorshift so every queue sees the exact same stream
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+  int64_t
+  delay(){
+    uint32_t r = next() % 100;
+    if (r < 70){
+      //hop/credit latency: exact ties are common here
+      return 100 + (next() % 4) * 50;
+    } else if (r < 98){
+      //packet serialization delay
+      return 1000 + next() % 20000;
+    } else {
+      //compute or timeout far in the future
+      return 10000000 + next() % 10000000;
+    }
+  }
+
+ private:
+  uint32_t state_;
+};
+
+template <class Queue>
+class test_queue :
+  public Queue
+{
+ public:
+  test_queue(sprockit::sim_parameters* params, parallel_runtime* rt) :
+    Queue(params, rt)
+  {
+  }
+
+  void
+  push(timestamp t, uint32_t src, uint32_t seqnum){
+    event_queue_entry* ev = new hold_event(src);
+    ev->set_time(t);
+    ev->set_seqnum(seqnum);
+    Queue::add_event(ev);
+  }
+
+  event_queue_entry*
+  pop(){
+    return Queue::pop_next_event();
+  }
+};
+
+template <class Queue>
+double
+run_hold_model(sprockit::sim_parameters* params, parallel_runtime* rt,
+               int nevents, int nops, std::vector<popped_event>& popped)
+{
+  test_queue<Queue> queue(params, rt);
+  hold_model_rng rng(42);
+  uint32_t nsrc = 64;
+  std::vector<uint32_t> seqnums(nsrc, 0);
+
+  for (int i=0; i < nevents; ++i){
+    uint32_t src = rng.next() % nsrc;
+    queue.push(timestamp(rng.delay(), timestamp::exact), src, seqnums[src]++);
+  }
+
+  double start = sstmac_wall_time();
+  for (int i=0; i < nops; ++i){
+    event_queue_entry* ev = queue.pop();
+    popped_event p;
+    p.ticks = ev->time().ticks_int64();
+    p.src = ev->src_location().id();
+    p.seqnum = ev->seqnum();
+    popped.push_back(p);
+    delete ev;
+
+    uint32_t src = rng.next() % nsrc;
+    timestamp t(p.ticks + rng.delay(), timestamp::exact);
+    queue.push(t, src, seqnums[src]++);
+  }
+  double stop = sstmac_wall_time();
+
+  while (!queue.empty()){
+    delete queue.pop();
+  }
+  return stop - start;
+}
+
+static bool
+same_order(const std::vector<popped_event>& lhs, const std::vector<popped_event>& rhs)
+{
+  if (lhs.size() != rhs.size()) return false;
+  for (int i=0; i < lhs.size(); ++i){
+    if (lhs[i].ticks != rhs[i].ticks
+     || lhs[i].src != rhs[i].src
+     || lhs[i].seqnum != rhs[i].seqnum){
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool
+is_sorted(const std::vector<popped_event>& events)
+{
+  for (int i=1; i < events.size(); ++i){
+    if (events[i].ticks < events[i-1].ticks) return false;
+  }
+  return true;
+}
+
+void
+benchmark(sprockit::sim_parameters* params, parallel_runtime* rt, int nevents, int nops)
+{
+  std::vector<popped_event> popped;
+  popped.reserve(nops);
+  double map_time = run_hold_model<event_map>(params, rt, nevents, nops, popped);
+  popped.clear();
+  double heap_time = run_hold_model<event_heap>(params, rt, nevents, nops, popped);
+  popped.clear();
+  double ladder_time = run_hold_model<event_ladder>(params, rt, nevents, nops, popped);
+
+  printf("hold model: %d pending events, %d operations\n", nevents, nops);
+  printf("  map:    %10.4fs %8.2f Mops/s\n", map_time, nops/map_time/1e6);
+  printf("  heap:   %10.4fs %8.2f Mops/s\n", heap_time, nops/heap_time/1e6);
+  printf("  ladder: %10.4fs %8.2f Mops/s\n", ladder_time, nops/ladder_time/1e6);
+}
+
+int
+main(int argc, char** argv)
+{
+  sprockit::sim_parameters params;
+  params["ladder_bucket_threshold"] = "16";
+  parallel_runtime* rt = new native::serial_runtime(&params);
+
+  if (argc > 1 && ::strcmp(argv[1], "--bench") == 0){
+    int nevents = argc > 2 ? atoi(argv[2]) : 1000000;
+    int nops = argc > 3 ? atoi(argv[3]) : 10000000;
+    benchmark(&params, rt, nevents, nops);
+    return 0;
+  }
+
+  UnitTest unit;
+  try {
+    int sizes[] = { 1, 100, 10000 };
+    for (int nevents : sizes){
+      int nops = 20000;
+      std::vector<popped_event> map_order, heap_order, ladder_order;
+      run_hold_model<event_map>(&params, rt, nevents, nops, map_order);
+      run_hold_model<event_heap>(&params, rt, nevents, nops, heap_order);
+      run_hold_model<event_ladder>(&params, rt, nevents, nops, ladder_order);
+      assertTrue(unit, "map order is time sorted", is_sorted(map_order));
+      assertTrue(unit, "heap matches map order", same_order(map_order, heap_order));
+      assertTrue(unit, "ladder matches map order", same_order(map_order, ladder_order));
+    }
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include <sstmac/hardware/flow/flow_network.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <algorithm>
+#include <vector>
+
+using namespace sstmac;
+using namespace sstmac::hw;
+
+static bool
+contains(const std::vector<int>& ids, int id)
+{
+  return std::find(ids.begin(), ids.end(), id) != ids.end();
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    std::vector<int> changed;
+
+    //two flows split a single link evenly
+    flow_network single;
+    int l0 = single.add_link(10);
+    std::vector<int> path(1, l0);
+    int f0 = single.add_flow(path, 100, 0);
+    single.update_rates(0, changed);
+    assertEqual(unit, "lone flow gets whole link", single.rate(f0), 10.0);
+    assertEqual(unit, "lone flow completion", single.completion_time(f0), 10.0);
+
+    changed.clear();
+    int f1 = single.add_flow(path, 100, 5);
+    single.update_rates(5, changed);
+    assertEqual(unit, "shared link first flow", single.rate(f0), 5.0);
+    assertEqual(unit, "shared link second flow", single.rate(f1), 5.0);
+    assertTrue(unit, "both flows changed", contains(changed, f0) && contains(changed, f1));
+    //half of the first flow was sent before the second arrived
+    assertEqual(unit, "first flow slowed down", single.completion_time(f0), 15.0);
+
+    changed.clear();
+    single.remove_flow(f0);
+    single.update_rates(15, changed);
+    assertEqual(unit, "departure frees bandwidth", single.rate(f1), 10.0);
+    assertEqual(unit, "second flow sped up", single.completion_time(f1), 20.0);
+    assertEqual(unit, "one flow left", single.num_active_flows(), 1);
+
+    //the narrow link caps the flows crossing it
+    //and the wide link gives the leftover to its other flow
+    flow_network mm;
+    int wide = mm.add_link(10);
+    int narrow = mm.add_link(4);
+    int other = mm.add_link(1);
+    std::vector<int> wide_only(1, wide);
+    std::vector<int> both;
+    both.push_back(wide);
+    both.push_back(narrow);
+    std::vector<int> narrow_only(1, narrow);
+    std::vector<int> other_only(1, other);
+    int fo = mm.add_flow(other_only, 8, 0);
+    mm.update_rates(0, changed);
+    //arrivals at the same time are batched into one update
+    int fa = mm.add_flow(wide_only, 8, 0);
+    int fb = mm.add_flow(both, 8, 0);
+    int fc = mm.add_flow(narrow_only, 8, 0);
+    changed.clear();
+    mm.update_rates(0, changed);
+    assertEqual(unit, "max-min wide only", mm.rate(fa), 8.0);
+    assertEqual(unit, "max-min both", mm.rate(fb), 2.0);
+    assertEqual(unit, "max-min narrow only", mm.rate(fc), 2.0);
+    assertTrue(unit, "unrelated flow untouched", !contains(changed, fo));
+    assertEqual(unit, "unrelated flow rate", mm.rate(fo), 1.0);
+
+    //freed slots are reused
+    changed.clear();
+    mm.remove_flow(fb);
+    int fd = mm.add_flow(both, 8, 1);
+    assertEqual(unit, "flow id reused", fd, fb);
+    mm.update_rates(1, changed);
+    assertEqual(unit, "reused flow rate", mm.rate(fd), 2.0);
+    assertEqual(unit, "reused flow completion", mm.completion_time(fd), 5.0);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <sstmac/backends/common/graph_partitioner.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <map>
+#include <vector>
+
+using namespace sstmac;
+
+typedef graph_partitioner::graph graph;
+
+class graph_builder
+{
+ public:
+  graph_builder(int nvtx) : adj_(nvtx){}
+
+  void
+  add_edge(int u, int v, int64_t wgt){
+    adj_[u][v] += wgt;
+    adj_[v][u] += wgt;
+  }
+
+  void
+  build(graph& g){
+    g.xadj.assign(1, 0);
+    g.vwgt.assign(adj_.size(), 1);
+    for (auto& edges : adj_){
+      for (auto& pair : edges){
+        g.adjncy.push_back(pair.first);
+        g.adjwgt.push_back(pair.second);
+      }
+      g.xadj.push_back(g.adjncy.size());
+    }
+  }
+
+ private:
+  std::vector<std::map<int,int64_t> > adj_;
+};
+
+static void
+make_grid(int nx, int ny, graph& g)
+{
+  graph_builder b(nx*ny);
+  for (int x=0; x < nx; ++x){
+    for (int y=0; y < ny; ++y){
+      int v = x*ny + y;
+      if (x+1 < nx) b.add_edge(v, v + ny, 1);
+      if (y+1 < ny) b.add_edge(v, v + 1, 1);
+    }
+  }
+  b.build(g);
+}
+
+static bool
+all_parts_used(const std::vector<int>& part, int nparts)
+{
+  std::vector<bool> used(nparts, false);
+  for (int p : part){
+    if (p < 0 || p >= nparts) return false;
+    used[p] = true;
+  }
+  for (bool u : used){
+    if (!u) return false;
+  }
+  return true;
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    graph_partitioner partitioner(1.05);
+    std::vector<int> part;
+
+    //the best 4-way cut of a 16x16 grid is two straight lines
+    graph grid;
+    make_grid(16, 16, grid);
+    partitioner.partition(grid, 4, part);
+    assertTrue(unit, "grid uses all 4 parts", all_parts_used(part, 4));
+    assertTrue(unit, "grid 4-way cut near optimal",
+               graph_partitioner::edge_cut(grid, part) <= 40);
+    assertTrue(unit, "grid 4-way balanced",
+               graph_partitioner::load_imbalance(grid, part, 4) <= 1.1);
+
+    partitioner.partition(grid, 16, part);
+    assertTrue(unit, "grid uses all 16 parts", all_parts_used(part, 16));
+    assertTrue(unit, "grid 16-way cut near optimal",
+               graph_partitioner::edge_cut(grid, part) <= 120);
+    assertTrue(unit, "grid 16-way balanced",
+               graph_partitioner::load_imbalance(grid, part, 16) <= 1.2);
+
+    //two heavy cliques joined by a single light edge
+    int clique = 40;
+    graph_builder b(2*clique);
+    for (int c=0; c < 2; ++c){
+      for (int i=0; i < clique; ++i){
+        for (int j=i+1; j < clique; ++j){
+          b.add_edge(c*clique + i, c*clique + j, 10);
+        }
+      }
+    }
+    b.add_edge(0, clique, 1);
+    graph cliques;
+    b.build(cliques);
+    partitioner.partition(cliques, 2, part);
+    assertEqual(unit, "cliques split on light edge",
+                graph_partitioner::edge_cut(cliques, part), int64_t(1));
+    assertEqual(unit, "cliques perfectly balanced",
+                graph_partitioner::load_imbalance(cliques, part, 2), 1.0);
+
+    //heavy vertices should be spread out, not just counted
+    graph weighted;
+    make_grid(8, 8, weighted);
+    for (int v=0; v < 8; ++v) weighted.vwgt[v] = 8;
+    partitioner.partition(weighted, 2, part);
+    assertTrue(unit, "weighted grid balanced",
+               graph_partitioner::load_imbalance(weighted, part, 2) <= 1.1);
+
+    //more parts than vertices leaves parts empty but still places everything
+    graph tiny;
+    make_grid(2, 1, tiny);
+    partitioner.partition(tiny, 4, part);
+    assertTrue(unit, "tiny graph parts in range",
+               part[0] >= 0 && part[0] < 4 && part[1] >= 0 && part[1] < 4 && part[0] != part[1]);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
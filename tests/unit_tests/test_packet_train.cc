@@ -0,0 +1,80 @@
+#include <sstmac/hardware/pisces/pisces.h>
+#include <sstmac/hardware/network/network_message.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <vector>
+
+using namespace sstmac;
+using namespace sstmac::hw;
+
+/**
+ * Checks that splitting a packet train gives back the packets
+ * the packetizer would have injected individually, each keeping
+ * the routing and statistics state the train had collected.
+ */
+
+static const int packet_size = 1000;
+
+static void
+check_split(UnitTest& unit, int num_bytes)
+{
+  network_message* msg = new network_message;
+  int num_packets = (num_bytes + packet_size - 1) / packet_size;
+  pisces_delay_stats_packet* train = new pisces_delay_stats_packet(
+        msg, 42, num_bytes, true, node_id(1), node_id(0));
+  train->set_train(num_packets, packet_size);
+  train->set_bw(1e9);
+  train->current_path().outport = 3;
+  train->current_path().vc = 1;
+  train->accumulate_delay(1e-6);
+
+  std::vector<pisces_payload*> pkts;
+  train->split_train(pkts);
+
+  assertEqual(unit, "split packet count", int(pkts.size()), num_packets);
+  assertTrue(unit, "train reused as last packet", pkts.back() == train);
+
+  bool same_state = true;
+  bool only_last_is_tail = true;
+  int total_bytes = 0;
+  for (int i=0; i < pkts.size(); ++i){
+    pisces_delay_stats_packet* pkt = static_cast<pisces_delay_stats_packet*>(pkts[i]);
+    bool last = i == (pkts.size() - 1);
+    total_bytes += pkt->num_bytes();
+    same_state = same_state && pkt->train_length() == 1
+        && pkt->flow_id() == 42 && pkt->bw() == 1e9
+        && pkt->next_port() == 3 && pkt->next_vc() == 1
+        && pkt->congestion_delay() == 1e-6;
+    only_last_is_tail = only_last_is_tail && pkt->is_tail() == last
+        && (pkt->orig() == msg) == last;
+    if (!last){
+      same_state = same_state && pkt->num_bytes() == packet_size;
+    }
+  }
+  assertEqual(unit, "split packets cover train", total_bytes, num_bytes);
+  assertTrue(unit, "split packets keep train state", same_state);
+  assertTrue(unit, "only last packet carries message", only_last_is_tail);
+
+  for (pisces_payload* pkt : pkts){
+    delete pkt;
+  }
+  delete msg;
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    //full packets only
+    check_split(unit, 8*packet_size);
+    //short tail packet
+    check_split(unit, 4*packet_size + packet_size/2);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
@@ -0,0 +1,180 @@
+#include <sstmac/hardware/router/routing_table.h>
+#include <sstmac/hardware/topology/topology.h>
+#include <sstmac/software/process/time.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <sprockit/spkt_string.h>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace sstmac;
+using namespace sstmac::hw;
+
+/**
+ * Checks that routing table lookups match topology::minimal_route_to_switch
+ * for every pair of switches and every incoming metadata state.
+ * Run with --bench <torus size> <nroutes> to print route throughput instead.
+ */
+
+static topology*
+torus(int size)
+{
+  sprockit::sim_parameters params;
+  params["name"] = "hdtorus";
+  params["geometry"] = sprockit::printf("%d %d %d", size, size, size);
+  params["concentration"] = "1";
+  return topology_factory::get_param("name", &params);
+}
+
+static topology*
+dragonfly()
+{
+  sprockit::sim_parameters params;
+  params["name"] = "dragonfly";
+  params["geometry"] = "4 4 8";
+  params["group_connections"] = "3";
+  params["concentration"] = "1";
+  params["seed"] = "14";
+  return topology_factory::get_param("name", &params);
+}
+
+static topology*
+hypercube()
+{
+  sprockit::sim_parameters params;
+  params["name"] = "hypercube";
+  params["geometry"] = "4 4 4";
+  params["concentration"] = "1";
+  return topology_factory::get_param("name", &params);
+}
+
+static bool
+same_path(const routable::path& lhs, const routable::path& rhs)
+{
+  return lhs.outport == rhs.outport && lhs.vc == rhs.vc
+      && lhs.metadata.bit_integer() == rhs.metadata.bit_integer();
+}
+
+static void
+check_all_routes(UnitTest& unit, const char* name, topology* top, bool eager)
+{
+  bool all_match = true;
+  int nsw = top->num_switches();
+  for (int src=0; src < nsw; ++src){
+    routing_table table(top, switch_id(src), eager);
+    //twice so the second pass comes out of the table
+    for (int pass=0; pass < 2; ++pass){
+      for (int dst=0; dst < nsw; ++dst){
+        if (dst == src || !top->minimal_route_cacheable(src, dst)) continue;
+        for (uint32_t state=0; state < 8; ++state){
+          routable::path live, cached;
+          live.metadata.set_bit_integer(state);
+          cached.metadata.set_bit_integer(state);
+          top->minimal_route_to_switch(switch_id(src), switch_id(dst), live);
+          table.route(switch_id(dst), cached);
+          all_match = all_match && same_path(live, cached);
+        }
+      }
+    }
+    if (src == 0){
+      assertTrue(unit, sprockit::printf("%s table served repeat lookups", name).c_str(),
+                 table.num_hits() > 0);
+    }
+  }
+  assertTrue(unit, sprockit::printf("%s table matches live routes", name).c_str(), all_match);
+}
+
+static void
+benchmark(int size, int nroutes)
+{
+  topology* top = torus(size);
+  int nsw = top->num_switches();
+  routing_table table(top, switch_id(0), true);
+
+  std::vector<int> dsts(nroutes);
+  uint32_t state = 42;
+  for (int i=0; i < nroutes; ++i){
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    dsts[i] = 1 + state % (nsw - 1);
+  }
+
+  long checksum = 0;
+  double start = sstmac_wall_time();
+  for (int i=0; i < nroutes; ++i){
+    routable::path path;
+    top->minimal_route_to_switch(switch_id(0), switch_id(dsts[i]), path);
+    checksum += path.outport;
+  }
+  double live_time = sstmac_wall_time() - start;
+
+  start = sstmac_wall_time();
+  for (int i=0; i < nroutes; ++i){
+    routable::path path;
+    table.route(switch_id(dsts[i]), path);
+    checksum -= path.outport;
+  }
+  double table_time = sstmac_wall_time() - start;
+
+  printf("route throughput: %d switch torus, %d routes, %lu table bytes/switch\n",
+         nsw, nroutes, table.num_bytes());
+  printf("  live:  %10.4fs %8.2f Mroutes/s\n", live_time, nroutes/live_time/1e6);
+  printf("  table: %10.4fs %8.2f Mroutes/s\n", table_time, nroutes/table_time/1e6);
+  if (checksum != 0){
+    printf("  routes differ!\n");
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc > 1 && ::strcmp(argv[1], "--bench") == 0){
+    int size = argc > 2 ? atoi(argv[2]) : 16;
+    int nroutes = argc > 3 ? atoi(argv[3]) : 10000000;
+    benchmark(size, nroutes);
+    return 0;
+  }
+
+  UnitTest unit;
+  try {
+    topology* top = torus(5);
+    check_all_routes(unit, "eager torus", top, true);
+    check_all_routes(unit, "lazy torus", top, false);
+
+    check_all_routes(unit, "hypercube", hypercube(), true);
+
+    topology* dfly = dragonfly();
+    check_all_routes(unit, "dragonfly", dfly, true);
+    int nsw = dfly->num_switches();
+    int num_random = 0;
+    for (int dst=1; dst < nsw; ++dst){
+      if (!dfly->minimal_route_cacheable(switch_id(0), switch_id(dst))) ++num_random;
+    }
+    assertTrue(unit, "dragonfly has random gateway routes", num_random > 0);
+
+    //random gateways are never stored
+    routing_table table(dfly, switch_id(0), true);
+    for (int dst=1; dst < nsw; ++dst){
+      routable::path path;
+      table.route(switch_id(dst), path);
+    }
+    assertEqual(unit, "dragonfly random routes computed live",
+                int(table.num_live()), num_random);
+
+    //lazy tables only allocate pages for destinations that were used
+    routing_table eager(top, switch_id(0), true);
+    routing_table lazy(top, switch_id(0), false);
+    routable::path path;
+    lazy.route(switch_id(1), path);
+    assertTrue(unit, "lazy table is smaller", lazy.num_bytes() < eager.num_bytes());
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include <sprockit/sim_parameters.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+
+/**
+ * Checks that values parsed with units are cached until overwritten,
+ * that combining namespaces copies values and subspaces,
+ * and that a copied scope is independent of the original tree.
+ */
+
+static void
+test_cached_units(UnitTest& unit)
+{
+  sprockit::sim_parameters params;
+  params["latency"] = "100ns";
+  params["bandwidth"] = "10GB/s";
+  params["size"] = "4KB";
+
+  assertEqual(unit, "parses time", params.get_time_param("latency"), 100e-9);
+  assertEqual(unit, "rereads cached time", params.get_time_param("latency"), 100e-9);
+  assertEqual(unit, "parses bandwidth", params.get_bandwidth_param("bandwidth"), 10e9);
+  assertEqual(unit, "parses byte length", params.get_byte_length_param("size"), 4000L);
+  //parsing with other units does not reuse the cached value
+  assertEqual(unit, "parses other units", params.get_quantity("size"), 4000.);
+
+  params.add_param_override("latency", "2us");
+  assertEqual(unit, "override replaces cached time",
+              params.get_time_param("latency"), 2e-6);
+  params["bandwidth"] = "1GB/s";
+  assertEqual(unit, "assignment replaces cached bandwidth",
+              params.get_bandwidth_param("bandwidth"), 1e9);
+
+  double bw = 1.2345678912e9;
+  assertEqual(unit, "missing optional keeps exact default",
+              params.get_optional_bandwidth_param("injection_bandwidth", bw), bw);
+}
+
+static void
+test_combine(UnitTest& unit)
+{
+  sprockit::sim_parameters src;
+  src["latency"] = "100ns";
+  src["link.bandwidth"] = "10GB/s";
+
+  sprockit::sim_parameters dst;
+  dst["latency"] = "50ns";
+  dst["credits"] = "8KB";
+  //parse before combining so the cached value is stale
+  dst.get_time_param("latency");
+  src.combine_into(&dst);
+
+  assertEqual(unit, "combine overrides value",
+              dst.get_time_param("latency"), 100e-9);
+  assertEqual(unit, "combine keeps other values",
+              dst.get_byte_length_param("credits"), 8000L);
+  assertEqual(unit, "combine copies namespaces",
+              dst.get_namespace("link")->get_bandwidth_param("bandwidth"), 10e9);
+
+  sprockit::sim_parameters keep;
+  keep["latency"] = "50ns";
+  src.combine_into(&keep, false, false/*no override*/);
+  assertEqual(unit, "combine without override keeps value",
+              keep.get_time_param("latency"), 50e-9);
+}
+
+static void
+test_copy_scope(UnitTest& unit)
+{
+  sprockit::sim_parameters params;
+  params["latency"] = "100ns";
+  params["switch.model"] = "pisces";
+  params["switch.link.bandwidth"] = "10GB/s";
+  sprockit::sim_parameters* sw = params.get_namespace("switch");
+
+  sprockit::sim_parameters* root = nullptr;
+  sprockit::sim_parameters* copy = sw->copy_scope(root);
+  assertTrue(unit, "copy is a new tree", copy != sw && root != &params);
+  assertEqual(unit, "copy keeps scope values",
+              copy->get_param("model"), std::string("pisces"));
+  assertEqual(unit, "copy keeps subspaces",
+              copy->get_namespace("link")->get_bandwidth_param("bandwidth"), 10e9);
+  assertEqual(unit, "copy reads parent scope",
+              copy->get_time_param("latency"), 100e-9);
+  assertEqual(unit, "copy root holds scope",
+              root->get_namespace("switch"), copy);
+
+  copy->add_param_override("id", 7);
+  copy->get_namespace("link")->add_param_override("bandwidth", "1GB/s");
+  assertFalse(unit, "override stays on copy", sw->has_param("id"));
+  assertEqual(unit, "nested override stays on copy",
+              sw->get_namespace("link")->get_bandwidth_param("bandwidth"), 10e9);
+  delete root;
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    test_cached_units(unit);
+    test_combine(unit);
+    test_copy_scope(unit);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
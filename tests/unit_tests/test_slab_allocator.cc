@@ -0,0 +1,102 @@
+#include <sstmac/common/slab_allocator.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace sstmac;
+
+/**
+ * Checks that freed chunks are reused within their size class,
+ * that large requests bypass the pools, and that chunks freed
+ * on another thread go back to the pool that allocated them.
+ */
+
+static const size_t chunk_size = 200;
+static const int num_chunks = 1000;
+
+static void
+test_round_trip(UnitTest& unit)
+{
+  void* first = slab_allocator::allocate(chunk_size);
+  slab_allocator::free(first, chunk_size);
+  uint64_t misses = slab_allocator::num_misses();
+  //rounds to the same size class
+  void* next = slab_allocator::allocate(chunk_size + 4);
+  assertEqual(unit, "freed chunk reused in size class", next, first);
+  assertEqual(unit, "reuse is not a miss", slab_allocator::num_misses(), misses);
+  assertTrue(unit, "chunks are aligned",
+             reinterpret_cast<uintptr_t>(next) % slab_allocator::size_class_bytes == 0);
+  slab_allocator::free(next, chunk_size + 4);
+
+  uint64_t hits = slab_allocator::num_hits();
+  size_t big = slab_allocator::max_pooled_size + 1;
+  void* oversize = slab_allocator::allocate(big);
+  slab_allocator::free(oversize, big);
+  assertEqual(unit, "oversize is not pooled",
+              slab_allocator::num_hits() + slab_allocator::num_misses(), hits + misses);
+}
+
+static void
+test_remote_free(UnitTest& unit)
+{
+  std::vector<void*> chunks;
+  std::set<void*> mine;
+  for (int i=0; i < num_chunks; ++i){
+    void* chunk = slab_allocator::allocate(chunk_size);
+    chunks.push_back(chunk);
+    mine.insert(chunk);
+  }
+
+  int taken_by_other = 0;
+  std::thread other([&]{
+    for (void* chunk : chunks){
+      slab_allocator::free(chunk, chunk_size);
+    }
+    //the freeing thread must not get the chunks
+    std::vector<void*> own;
+    for (int i=0; i < num_chunks; ++i){
+      void* chunk = slab_allocator::allocate(chunk_size);
+      if (mine.count(chunk)) ++taken_by_other;
+      own.push_back(chunk);
+    }
+    for (void* chunk : own){
+      slab_allocator::free(chunk, chunk_size);
+    }
+  });
+  other.join();
+  assertEqual(unit, "remote frees skip the freeing thread", taken_by_other, 0);
+
+  //leftovers of the last slab come first, then everything freed remotely
+  uint64_t misses = slab_allocator::num_misses();
+  std::vector<void*> again;
+  int returned = 0;
+  while (returned < num_chunks && slab_allocator::num_misses() == misses){
+    void* chunk = slab_allocator::allocate(chunk_size);
+    if (mine.count(chunk)) ++returned;
+    again.push_back(chunk);
+  }
+  assertEqual(unit, "remote frees return to owner", returned, num_chunks);
+  assertEqual(unit, "owner reuses remote frees without a new slab",
+              slab_allocator::num_misses(), misses);
+  for (void* chunk : again){
+    slab_allocator::free(chunk, chunk_size);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    test_round_trip(unit);
+    test_remote_free(unit);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
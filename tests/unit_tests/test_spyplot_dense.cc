@@ -0,0 +1,75 @@
+#include <sstmac/common/stats/stat_spyplot.h>
+#include <sprockit/sim_parameters.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace sstmac;
+
+/**
+ * Checks that the dense spyplot accumulates and merges counts across
+ * blocks, and that its binary output is the expected sparse rows.
+ */
+
+static void
+test_merge(UnitTest& unit)
+{
+  sprockit::sim_parameters params;
+  params["fileroot"] = "test_spyplot_dense";
+  params["block_size"] = "4";
+
+  stat_spyplot_dense thread0(&params);
+  stat_spyplot_dense thread1(&params);
+  thread0.add_one(0, 1);
+  thread0.add(0, 1, 9);
+  thread0.add(2, 13, 5);
+  thread1.add(0, 1, 10);
+  thread1.add(9, 3, 7);
+
+  thread0.reduce(&thread1);
+  assertEqual(unit, "dimension", thread0.dim(), 14);
+  bool counts = thread0.get(0, 1) == 20 && thread0.get(2, 13) == 5
+    && thread0.get(9, 3) == 7 && thread0.get(3, 9) == 0
+    && thread0.get(100, 100) == 0;
+  assertTrue(unit, "merges counts across blocks", counts);
+
+  thread0.dump_global_data();
+  std::ifstream in("test_spyplot_dense.bin", std::ios::binary);
+  char magic[8];
+  int64_t dim, nnz;
+  in.read(magic, 8);
+  in.read((char*) &dim, sizeof(int64_t));
+  in.read((char*) &nnz, sizeof(int64_t));
+  std::vector<int64_t> offsets(dim+1);
+  std::vector<int32_t> cols(nnz);
+  std::vector<int64_t> vals(nnz);
+  in.read((char*) offsets.data(), offsets.size()*sizeof(int64_t));
+  in.read((char*) cols.data(), cols.size()*sizeof(int32_t));
+  in.read((char*) vals.data(), vals.size()*sizeof(int64_t));
+  bool csr = in.good() && std::string(magic, 8) == "SSTMSPY1"
+    && dim == 14 && nnz == 3
+    && offsets[1] == 1 && offsets[3] == 2 && offsets[9] == 2 && offsets[14] == 3
+    && cols[0] == 1 && vals[0] == 20
+    && cols[1] == 13 && vals[1] == 5
+    && cols[2] == 3 && vals[2] == 7;
+  assertTrue(unit, "writes compressed sparse rows", csr);
+  remove("test_spyplot_dense.bin");
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    test_merge(unit);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
@@ -0,0 +1,154 @@
+#include <sstmac/software/threading/stack_alloc.h>
+#include <sprockit/test/test.h>
+#include <sprockit/output.h>
+#include <thread>
+#include <vector>
+#include <stdint.h>
+
+using namespace sstmac;
+using namespace sstmac::sw;
+
+/**
+ * Checks the committed/reserved accounting of the stack allocator
+ * and that lazily committed stacks are usable, reused by later jobs,
+ * and handed back zeroed after their memory was released.
+ * Stacks freed from another thread go back to the pool that allocated them.
+ */
+
+static const size_t stacksize = 1 << 16;
+static const int num_stacks = 20;
+
+static bool
+touch_stacks(const std::vector<char*>& stacks, char val)
+{
+  bool aligned = true;
+  for (char* stack : stacks){
+    aligned = aligned && ((uintptr_t) stack % stacksize) == 0;
+    for (size_t i=0; i < stacksize; i += 4096){
+      stack[i] = val;
+    }
+  }
+  return aligned;
+}
+
+static void
+check_mode(UnitTest& unit, bool lazy_commit)
+{
+  const char* mode = lazy_commit ? "lazy" : "eager";
+  stack_alloc salloc;
+  salloc.init(stacksize, 4*stacksize, false, lazy_commit);
+
+  std::vector<char*> stacks;
+  for (int i=0; i < num_stacks; ++i){
+    stacks.push_back((char*) salloc.alloc());
+  }
+  assertTrue(unit, sprockit::printf("%s stacks aligned to stack size", mode).c_str(),
+             touch_stacks(stacks, 1));
+  assertEqual(unit, sprockit::printf("%s committed bytes", mode).c_str(),
+              salloc.committed_bytes(), num_stacks*stacksize);
+  assertTrue(unit, sprockit::printf("%s reserved covers committed", mode).c_str(),
+             salloc.reserved_bytes() >= salloc.committed_bytes());
+
+  //free half, as if one job finished
+  for (int i=0; i < num_stacks/2; ++i){
+    salloc.free(stacks[i]);
+  }
+  assertEqual(unit, sprockit::printf("%s committed after free", mode).c_str(),
+              salloc.committed_bytes(), num_stacks/2*stacksize);
+
+  size_t reserved = salloc.reserved_bytes();
+  std::vector<char*> next_job;
+  for (int i=0; i < num_stacks/2; ++i){
+    next_job.push_back((char*) salloc.alloc());
+  }
+  assertEqual(unit, sprockit::printf("%s pooled stacks reused", mode).c_str(),
+              salloc.reserved_bytes(), reserved);
+  assertEqual(unit, sprockit::printf("%s peak committed bytes", mode).c_str(),
+              salloc.peak_committed_bytes(), num_stacks*stacksize);
+
+  if (lazy_commit){
+    bool zeroed = true;
+    for (char* stack : next_job){
+      for (size_t i=0; i < stacksize; i += 4096){
+        zeroed = zeroed && stack[i] == 0;
+      }
+    }
+    assertTrue(unit, "released stacks come back zeroed", zeroed);
+  }
+  touch_stacks(next_job, 2);
+
+  for (char* stack : next_job){
+    salloc.free(stack);
+  }
+  for (int i=num_stacks/2; i < num_stacks; ++i){
+    salloc.free(stacks[i]);
+  }
+  assertEqual(unit, sprockit::printf("%s nothing committed at end", mode).c_str(),
+              salloc.committed_bytes(), size_t(0));
+}
+
+static void
+check_remote_free(UnitTest& unit)
+{
+  //one pool per worker thread, as in the operating system
+  stack_alloc owner;
+  stack_alloc other;
+  owner.init(stacksize, 4*stacksize, false, true);
+  other.init(stacksize, 4*stacksize, false, true);
+
+  std::vector<char*> stacks;
+  for (int i=0; i < num_stacks; ++i){
+    stacks.push_back((char*) owner.alloc());
+  }
+  touch_stacks(stacks, 1);
+  size_t reserved = owner.reserved_bytes();
+
+  //a thread whose switch group moved is deleted on the other worker
+  std::thread worker([&]{
+    for (char* stack : stacks){
+      owner.free_remote(stack);
+    }
+  });
+  worker.join();
+  assertEqual(unit, "remote free leaves other pool alone",
+              other.committed_bytes(), size_t(0));
+
+  std::vector<char*> next_job;
+  for (int i=0; i < num_stacks; ++i){
+    next_job.push_back((char*) owner.alloc());
+  }
+  assertEqual(unit, "owner reuses remotely freed stacks",
+              owner.reserved_bytes(), reserved);
+  assertEqual(unit, "owner committed bytes after remote free",
+              owner.committed_bytes(), num_stacks*stacksize);
+  assertEqual(unit, "owner peak after remote free",
+              owner.peak_committed_bytes(), num_stacks*stacksize);
+
+  std::thread second_worker([&]{
+    for (char* stack : next_job){
+      owner.free_remote(stack);
+    }
+  });
+  second_worker.join();
+  //taking back the remote frees lets the next job change the stack size
+  owner.init(2*stacksize, 8*stacksize, false, true);
+  assertEqual(unit, "nothing committed after remote frees",
+              owner.committed_bytes(), size_t(0));
+}
+
+int
+main(int argc, char** argv)
+{
+  UnitTest unit;
+  try {
+    check_mode(unit, false);
+    check_mode(unit, true);
+    check_remote_free(unit);
+  } catch (std::exception& e) {
+    cerr0 << e.what() << std::endl;
+    return 1;
+  }
+
+  unit.validate();
+  return 0;
+}
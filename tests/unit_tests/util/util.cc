@@ -130,6 +130,12 @@ class routable_pisces :
     return routable::vc();
   }
 
+ protected:
+  pisces_payload*
+  clone_payload() const override {
+    return new routable_pisces(*this);
+  }
+
 };
 
 pisces_payload*